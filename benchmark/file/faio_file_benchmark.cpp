@@ -0,0 +1,132 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// 普通 read/write 与注册缓冲区 read_fixed/write_fixed 的吞吐对比
+// 在 tmpfs（/dev/shm）和 ext4 上分别运行即可对比两种文件系统
+struct FileBenchmarkConfig {
+  std::string dir = "/tmp";
+  std::size_t total_bytes = 256uz << 20; // 每种块大小读写的总量
+  std::size_t depth = 8;                 // 并发请求数
+};
+
+constexpr std::array<std::size_t, 5> BLOCK_SIZES{4uz << 10, 16uz << 10, 64uz << 10,
+                                                 256uz << 10, 1uz << 20};
+
+enum class Mode { Plain, Fixed };
+enum class Op { Write, Read };
+
+auto stripe(int fd, Mode mode, Op op, std::size_t block, std::size_t blocks,
+            std::size_t id, std::size_t depth,
+            faio::sync::channel<int>::Sender done_sender) -> faio::task<void> {
+  std::vector<char> plain;
+  faio::io::FixedBuffer fixed;
+  if (mode == Mode::Plain) {
+    plain.resize(block, 'x');
+  } else {
+    fixed = faio::io::fixed_buffer(block);
+    std::fill_n(fixed.data(), block, 'x');
+  }
+
+  for (auto i = id; i < blocks; i += depth) {
+    auto offset = static_cast<uint64_t>(i * block);
+    faio::expected<std::size_t> res{0};
+    if (mode == Mode::Plain) {
+      res = op == Op::Write
+                ? co_await faio::io::write(fd, plain.data(), block, offset)
+                : co_await faio::io::read(fd, plain.data(), block, offset);
+    } else {
+      res = op == Op::Write ? co_await faio::io::write_fixed(fd, fixed, block, offset)
+                            : co_await faio::io::read_fixed(fd, fixed, block, offset);
+    }
+    if (!res || res.value() != block) {
+      fastlog::console.error("io failed at offset {}: {}", offset,
+                             res ? "short io" : res.error().message());
+      break;
+    }
+  }
+  co_await done_sender.send(1);
+}
+
+auto run_phase(int fd, Mode mode, Op op, std::size_t block,
+               const FileBenchmarkConfig &config) -> faio::task<double> {
+  auto blocks = config.total_bytes / block;
+  auto [done_sender, done_receiver] = faio::sync::channel<int>::make(config.depth);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    faio::spawn(stripe(fd, mode, op, block, blocks, id, config.depth, done_sender));
+  }
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    co_await done_receiver.recv();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const double secs = std::chrono::duration<double>(end - start).count();
+  co_return secs > 0.0 ? static_cast<double>(blocks * block) / secs / (1 << 20) : 0.0;
+}
+
+auto run_benchmark(const FileBenchmarkConfig config) -> faio::task<int> {
+  auto path = config.dir + "/faio_file_benchmark.XXXXXX";
+  const int fd = ::mkstemp(path.data());
+  if (fd < 0) {
+    fastlog::console.error("create file in {} failed", config.dir);
+    co_return 1;
+  }
+  ::unlink(path.c_str());
+  if (::ftruncate(fd, static_cast<off_t>(config.total_bytes)) != 0) {
+    fastlog::console.error("ftruncate failed");
+    ::close(fd);
+    co_return 1;
+  }
+
+  fastlog::console.info("dir={}, total={}MB, depth={}", config.dir,
+                        config.total_bytes >> 20, config.depth);
+  fastlog::console.info("{:>8} {:>14} {:>14} {:>14} {:>14}", "block", "write MB/s",
+                        "write_fixed", "read MB/s", "read_fixed");
+  for (auto block : BLOCK_SIZES) {
+    auto write_plain = co_await run_phase(fd, Mode::Plain, Op::Write, block, config);
+    auto write_fixed = co_await run_phase(fd, Mode::Fixed, Op::Write, block, config);
+    auto read_plain = co_await run_phase(fd, Mode::Plain, Op::Read, block, config);
+    auto read_fixed = co_await run_phase(fd, Mode::Fixed, Op::Read, block, config);
+    fastlog::console.info("{:>7}K {:>14.1f} {:>14.1f} {:>14.1f} {:>14.1f}", block >> 10,
+                          write_plain, write_fixed, read_plain, read_fixed);
+  }
+  ::close(fd);
+  co_return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+
+  FileBenchmarkConfig config;
+  if (argc > 1) {
+    config.dir = argv[1];
+  }
+  if (argc > 2) {
+    config.total_bytes = static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) << 20;
+  }
+  if (argc > 3) {
+    config.depth = static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10));
+  }
+
+  // 单个 worker，保证缓冲区始终在注册它的 ring 上使用
+  faio::runtime_context ctx{faio::ConfigBuilder{}
+                                .set_num_workers(1)
+                                .set_fixed_buffer_size(config.depth * BLOCK_SIZES.back())
+                                .build()};
+  return faio::block_on(ctx, run_benchmark(config));
+}
@@ -0,0 +1,261 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// faio::fs 与阻塞 open/pread/close 的对比
+// 1. 大量小文件：fs::read_small（链式 open+read+close）、fs::read、阻塞读取
+// 2. 大文件顺序流式读取：File::read_at（可选 O_DIRECT）与阻塞 pread
+// 每个阶段前用 POSIX_FADV_DONTNEED 丢弃页缓存，O_DIRECT 不经过页缓存
+struct FsBenchmarkConfig {
+  std::string dir = "/tmp";
+  std::size_t num_files = 100000;        // 小文件数量
+  std::size_t file_size = 4096;          // 小文件大小
+  std::size_t big_bytes = 2048uz << 20;  // 大文件大小
+  std::size_t block = 1uz << 20;         // 流式读取的块大小
+  std::size_t depth = 32;                // 并发请求数
+  bool direct = false;                   // 大文件是否使用 O_DIRECT
+};
+
+enum class SmallMode { ReadSmall, Read };
+
+auto small_path(const FsBenchmarkConfig &config, std::size_t i) -> std::string {
+  return config.dir + "/faio_fs_bench/" + std::to_string(i);
+}
+
+auto drop_cache(const std::string &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd >= 0) {
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+  }
+}
+
+bool prepare_small_files(const FsBenchmarkConfig &config) {
+  ::mkdir((config.dir + "/faio_fs_bench").c_str(), 0755);
+  std::string content(config.file_size, 'x');
+  for (std::size_t i = 0; i < config.num_files; ++i) {
+    auto path = small_path(config, i);
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || ::write(fd, content.data(), content.size()) !=
+                      static_cast<ssize_t>(content.size())) {
+      fastlog::console.error("create {} failed", path);
+      return false;
+    }
+    ::close(fd);
+  }
+  return true;
+}
+
+void cleanup_small_files(const FsBenchmarkConfig &config) {
+  for (std::size_t i = 0; i < config.num_files; ++i) {
+    ::unlink(small_path(config, i).c_str());
+  }
+  ::rmdir((config.dir + "/faio_fs_bench").c_str());
+}
+
+auto small_worker(const FsBenchmarkConfig &config, SmallMode mode, std::size_t id,
+                  faio::sync::channel<std::size_t>::Sender done_sender)
+    -> faio::task<void> {
+  std::size_t bytes = 0;
+  for (auto i = id; i < config.num_files; i += config.depth) {
+    auto res = mode == SmallMode::ReadSmall
+                   ? co_await faio::fs::read_small(small_path(config, i))
+                   : co_await faio::fs::read(small_path(config, i));
+    if (!res) {
+      fastlog::console.error("read file {} failed: {}", i, res.error().message());
+      break;
+    }
+    bytes += res.value().size();
+  }
+  co_await done_sender.send(bytes);
+}
+
+auto run_small(const FsBenchmarkConfig &config, SmallMode mode) -> faio::task<double> {
+  auto [done_sender, done_receiver] =
+      faio::sync::channel<std::size_t>::make(config.depth);
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    faio::spawn(small_worker(config, mode, id, done_sender));
+  }
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    co_await done_receiver.recv();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  const double secs = std::chrono::duration<double>(end - start).count();
+  co_return secs > 0.0 ? static_cast<double>(config.num_files) / secs : 0.0;
+}
+
+auto run_small_blocking(const FsBenchmarkConfig &config) -> double {
+  std::vector<char> buf(config.file_size);
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < config.num_files; ++i) {
+    const int fd = ::open(small_path(config, i).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0 || ::pread(fd, buf.data(), buf.size(), 0) < 0) {
+      fastlog::console.error("blocking read file {} failed", i);
+    }
+    ::close(fd);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  const double secs = std::chrono::duration<double>(end - start).count();
+  return secs > 0.0 ? static_cast<double>(config.num_files) / secs : 0.0;
+}
+
+auto stream_worker(faio::fs::File &file, const FsBenchmarkConfig &config, std::size_t id,
+                   std::size_t alignment,
+                   faio::sync::channel<int>::Sender done_sender) -> faio::task<void> {
+  auto buf = faio::fs::aligned_buffer(config.block, alignment);
+  const auto blocks = config.big_bytes / config.block;
+  for (auto i = id; i < blocks; i += config.depth) {
+    auto res = co_await file.read_exact_at(buf.span(), i * config.block);
+    if (!res) {
+      fastlog::console.error("read block {} failed: {}", i, res.error().message());
+      break;
+    }
+  }
+  co_await done_sender.send(1);
+}
+
+auto run_stream(const std::string &path, const FsBenchmarkConfig &config)
+    -> faio::task<double> {
+  auto file = co_await faio::fs::File::open(path.c_str(),
+                                            O_RDONLY | (config.direct ? O_DIRECT : 0));
+  if (!file) {
+    fastlog::console.error("open {} failed: {}", path, file.error().message());
+    co_return 0.0;
+  }
+  // O_DIRECT 按 statx 报告的对齐要求分配缓冲区
+  std::size_t alignment = faio::fs::AlignedBuffer::DEFAULT_ALIGNMENT;
+  if (auto meta = co_await file.value().metadata(); meta && meta.value().dio_mem_align() > 0) {
+    alignment = std::max<std::size_t>(alignment, meta.value().dio_mem_align());
+  }
+  co_await file.value().advise(0, 0, POSIX_FADV_SEQUENTIAL);
+
+  auto [done_sender, done_receiver] = faio::sync::channel<int>::make(config.depth);
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    faio::spawn(stream_worker(file.value(), config, id, alignment, done_sender));
+  }
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    co_await done_receiver.recv();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  const double secs = std::chrono::duration<double>(end - start).count();
+  co_return secs > 0.0 ? static_cast<double>(config.big_bytes) / secs / (1 << 20) : 0.0;
+}
+
+auto run_stream_blocking(const std::string &path, const FsBenchmarkConfig &config)
+    -> double {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return 0.0;
+  }
+  std::vector<char> buf(config.block);
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t offset = 0; offset < config.big_bytes; offset += config.block) {
+    if (::pread(fd, buf.data(), buf.size(), static_cast<off_t>(offset)) <= 0) {
+      break;
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  ::close(fd);
+  const double secs = std::chrono::duration<double>(end - start).count();
+  return secs > 0.0 ? static_cast<double>(config.big_bytes) / secs / (1 << 20) : 0.0;
+}
+
+bool prepare_big_file(const std::string &path, const FsBenchmarkConfig &config) {
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  std::vector<char> buf(config.block, 'y');
+  for (std::size_t offset = 0; offset < config.big_bytes; offset += config.block) {
+    if (::write(fd, buf.data(), buf.size()) != static_cast<ssize_t>(buf.size())) {
+      ::close(fd);
+      return false;
+    }
+  }
+  ::fsync(fd);
+  ::close(fd);
+  return true;
+}
+
+auto run_benchmark(const FsBenchmarkConfig config) -> faio::task<int> {
+  fastlog::console.info("dir={}, files={}x{}B, big={}MB, block={}KB, depth={}, direct={}",
+                        config.dir, config.num_files, config.file_size,
+                        config.big_bytes >> 20, config.block >> 10, config.depth,
+                        config.direct);
+
+  if (!prepare_small_files(config)) {
+    co_return 1;
+  }
+  auto drop_small = [&config]() {
+    for (std::size_t i = 0; i < config.num_files; ++i) {
+      drop_cache(small_path(config, i));
+    }
+  };
+  drop_small();
+  const auto blocking_small = run_small_blocking(config);
+  drop_small();
+  const auto read_small = co_await run_small(config, SmallMode::ReadSmall);
+  drop_small();
+  const auto read_whole = co_await run_small(config, SmallMode::Read);
+  cleanup_small_files(config);
+  fastlog::console.info("{:>22} {:>14}", "small files", "files/s");
+  fastlog::console.info("{:>22} {:>14.0f}", "blocking open/pread", blocking_small);
+  fastlog::console.info("{:>22} {:>14.0f}", "fs::read_small", read_small);
+  fastlog::console.info("{:>22} {:>14.0f}", "fs::read", read_whole);
+
+  const auto big_path = config.dir + "/faio_fs_bench.big";
+  if (!prepare_big_file(big_path, config)) {
+    fastlog::console.error("create {} failed", big_path);
+    co_return 1;
+  }
+  drop_cache(big_path);
+  const auto blocking_stream = run_stream_blocking(big_path, config);
+  drop_cache(big_path);
+  const auto faio_stream = co_await run_stream(big_path, config);
+  co_await faio::fs::remove_file(big_path);
+  fastlog::console.info("{:>22} {:>14}", "streaming", "MB/s");
+  fastlog::console.info("{:>22} {:>14.1f}", "blocking pread", blocking_stream);
+  fastlog::console.info("{:>22} {:>14.1f}", config.direct ? "File::read_at O_DIRECT"
+                                                          : "File::read_at",
+                        faio_stream);
+  co_return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+
+  FsBenchmarkConfig config;
+  if (argc > 1) {
+    config.dir = argv[1];
+  }
+  if (argc > 2) {
+    config.num_files = static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10));
+  }
+  if (argc > 3) {
+    config.big_bytes = static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)) << 20;
+  }
+  if (argc > 4) {
+    config.depth = static_cast<std::size_t>(std::strtoull(argv[4], nullptr, 10));
+  }
+  if (argc > 5) {
+    config.direct = std::string_view{argv[5]} == "direct";
+  }
+
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  return faio::block_on(ctx, run_benchmark(config));
+}
@@ -0,0 +1,148 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// io-wq 线程数与文件写吞吐
+// 缓冲写在多数文件系统上会被推给 io-wq 执行，每个 worker 的 ring 各有一套 iou-wrk 线程；
+// 对比共享 io-wq（IORING_SETUP_ATTACH_WQ）与独立 io-wq，以及 io-wq 线程上限的影响。
+// 运行期间每 100ms 统计一次进程中 iou-wrk 线程数，输出峰值
+struct IowqBenchmarkConfig {
+  std::string dir = "/tmp";
+  bool shared = true;                // 是否共享 io-wq
+  std::size_t seconds = 10;          // 运行时间
+  std::size_t workers = std::thread::hardware_concurrency(); // worker 数
+  std::size_t depth = 64;            // 并发写协程数
+  uint32_t max_bounded = 0;          // io-wq 有界线程上限，0为内核默认
+  std::size_t block = 64uz << 10;    // 每次写的大小
+  std::size_t file_limit = 64uz << 20; // 每个文件写满后从头覆盖
+};
+
+std::atomic<uint64_t> g_bytes{0};
+
+// 进程中 io-wq 线程的数量
+auto count_iowq_threads() -> std::size_t {
+  std::size_t count = 0;
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator("/proc/self/task", ec)) {
+    std::ifstream comm(entry.path() / "comm");
+    std::string name;
+    std::getline(comm, name);
+    if (name.starts_with("iou-wrk")) {
+      count += 1;
+    }
+  }
+  return count;
+}
+
+auto bench_path(const IowqBenchmarkConfig &config, std::size_t i) -> std::string {
+  return config.dir + "/faio_iowq_bench." + std::to_string(i);
+}
+
+auto writer(const IowqBenchmarkConfig &config, std::size_t id,
+            std::chrono::steady_clock::time_point deadline,
+            faio::sync::channel<int>::Sender done_sender) -> faio::task<void> {
+  auto file = co_await faio::fs::File::create(bench_path(config, id).c_str());
+  if (!file) {
+    fastlog::console.error("create file {} failed: {}", id, file.error().message());
+    co_await done_sender.send(1);
+    co_return;
+  }
+  std::vector<char> buf(config.block, 'w');
+  std::size_t offset = 0;
+  while (std::chrono::steady_clock::now() < deadline) {
+    auto res = co_await file.value().write_all_at(buf, offset);
+    if (!res) {
+      fastlog::console.error("write file {} failed: {}", id, res.error().message());
+      break;
+    }
+    g_bytes.fetch_add(config.block, std::memory_order_relaxed);
+    offset = (offset + config.block) % config.file_limit;
+  }
+  co_await done_sender.send(1);
+}
+
+auto run_benchmark(const IowqBenchmarkConfig &config) -> faio::task<int> {
+  auto [done_sender, done_receiver] = faio::sync::channel<int>::make(config.depth);
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + std::chrono::seconds(config.seconds);
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    faio::spawn(writer(config, id, deadline, done_sender));
+  }
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    co_await done_receiver.recv();
+  }
+  const auto secs =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fastlog::console.info("write throughput: {:.1f} MB/s",
+                        static_cast<double>(g_bytes.load(std::memory_order_relaxed)) / secs /
+                            (1 << 20));
+  for (std::size_t id = 0; id < config.depth; ++id) {
+    co_await faio::fs::remove_file(bench_path(config, id));
+  }
+  co_return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+
+  IowqBenchmarkConfig config;
+  if (argc > 1) {
+    config.shared = std::string_view{argv[1]} != "private";
+  }
+  if (argc > 2) {
+    config.seconds = static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10));
+  }
+  if (argc > 3) {
+    config.workers = static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10));
+  }
+  if (argc > 4) {
+    config.depth = static_cast<std::size_t>(std::strtoull(argv[4], nullptr, 10));
+  }
+  if (argc > 5) {
+    config.max_bounded = static_cast<uint32_t>(std::strtoul(argv[5], nullptr, 10));
+  }
+  if (argc > 6) {
+    config.dir = argv[6];
+  }
+  fastlog::console.info("io-wq: {}, workers={}, depth={}, max_bounded={}, block={}KB",
+                        config.shared ? "shared" : "private", config.workers, config.depth,
+                        config.max_bounded, config.block >> 10);
+
+  // 采样 iou-wrk 线程数
+  std::atomic<bool> stop{false};
+  std::size_t peak_threads = 0;
+  std::jthread sampler([&]() {
+    while (!stop.load(std::memory_order_relaxed)) {
+      peak_threads = std::max(peak_threads, count_iowq_threads());
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  });
+
+  int ret = 0;
+  {
+    faio::runtime_context ctx{faio::ConfigBuilder{}
+                                  .set_num_workers(config.workers)
+                                  .set_share_iowq(config.shared)
+                                  .set_iowq_max_workers(config.max_bounded, 0)
+                                  .build()};
+    ret = faio::block_on(ctx, run_benchmark(config));
+  }
+  stop.store(true, std::memory_order_relaxed);
+  sampler.join();
+  fastlog::console.info("peak iou-wrk threads: {}", peak_threads);
+  return ret;
+}
@@ -2,17 +2,49 @@
 #include "faio/http.hpp"
 #include "fastlog/fastlog.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <string>
+#include <string_view>
 
 namespace {
 
 struct HttpStressServerConfig {
   std::string host = "0.0.0.0";
   uint16_t port = 9998;
+  faio::SubmitPolicy submit_policy = faio::SubmitPolicy::Tick;
 };
 
-auto run_server(const HttpStressServerConfig &config) -> faio::task<int> {
+std::atomic<uint64_t> g_requests{0};
+
+// 每 5 秒输出一次请求数和平均每个请求的 io_uring 系统调用次数
+auto report_metrics(const faio::runtime_context &ctx) -> faio::task<void> {
+  auto last = ctx.metrics();
+  auto last_requests = g_requests.load(std::memory_order_relaxed);
+  while (true) {
+    co_await faio::time::sleep(std::chrono::seconds(5));
+    auto now = ctx.metrics();
+    auto requests = g_requests.load(std::memory_order_relaxed);
+    auto delta_requests = requests - last_requests;
+    auto delta_syscalls = now.syscalls() - last.syscalls();
+    if (delta_requests > 0) {
+      fastlog::console.info(
+          "requests: {}/s, syscalls: {}/s (submit {}, wait {}), "
+          "syscalls/request: {:.3f}",
+          delta_requests / 5, delta_syscalls / 5,
+          now.submit_syscalls - last.submit_syscalls,
+          now.wait_syscalls - last.wait_syscalls,
+          static_cast<double>(delta_syscalls) /
+              static_cast<double>(delta_requests));
+    }
+    last = now;
+    last_requests = requests;
+  }
+}
+
+auto run_server(const faio::runtime_context &ctx,
+                const HttpStressServerConfig &config) -> faio::task<int> {
   auto server_res = faio::http::HttpServer::bind(config.host, config.port);
   if (!server_res) {
     fastlog::console.error("http bind failed: {}", server_res.error().message());
@@ -24,6 +56,7 @@ auto run_server(const HttpStressServerConfig &config) -> faio::task<int> {
   faio::http::HttpRouter router;
   router.get("/health", [&](const faio::http::HttpRequest &)
                  -> faio::task<faio::http::HttpResponse> {
+    g_requests.fetch_add(1, std::memory_order_relaxed);
     co_return faio::http::HttpResponseBuilder(200)
         .header("content-type", "text/plain; charset=utf-8")
         .body("ok")
@@ -32,6 +65,7 @@ auto run_server(const HttpStressServerConfig &config) -> faio::task<int> {
 
   router.get("/index", [&](const faio::http::HttpRequest &)
                 -> faio::task<faio::http::HttpResponse> {
+    g_requests.fetch_add(1, std::memory_order_relaxed);
     co_return faio::http::HttpResponseBuilder(200)
         .header("content-type", "text/plain; charset=utf-8")
         .body("hello from http_stress server")
@@ -50,6 +84,11 @@ auto run_server(const HttpStressServerConfig &config) -> faio::task<int> {
                         config.port);
   fastlog::console.info("ready endpoints: GET /health, GET /index");
   fastlog::console.info("use external tools (wrk/hey/ab/vegeta) for load generation");
+  fastlog::console.info("submit policy: {}",
+                        config.submit_policy == faio::SubmitPolicy::Tick
+                            ? "tick"
+                            : "interval");
+  faio::spawn(report_metrics(ctx));
 
   co_await server.run(router);
   co_return 0;
@@ -67,8 +106,12 @@ int main(int argc, char **argv) {
   if (argc > 2) {
     config.port = static_cast<uint16_t>(std::strtoul(argv[2], nullptr, 10));
   }
+  if (argc > 3 && std::string_view{argv[3]} == "interval") {
+    config.submit_policy = faio::SubmitPolicy::Interval;
+  }
 
-
-  faio::runtime_context ctx;
-  return faio::block_on(ctx, run_server(config));
+  faio::runtime_context ctx{faio::ConfigBuilder{}
+                                .set_submit_policy(config.submit_policy)
+                                .build()};
+  return faio::block_on(ctx, run_server(ctx, config));
 }
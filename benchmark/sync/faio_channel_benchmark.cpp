@@ -0,0 +1,312 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string_view>
+
+// 无锁通道与旧实现（协程互斥锁 + std::list 等待队列）的对比：
+//   single <count>                           单个任务先连续发送再连续接收，每批不超过容量，
+//                                            全部走快路径；另外单独测 try_send / try_recv
+//   mpmc <workers> <producers> <consumers> <count> <cap>
+//                                            多 worker 下多生产者多消费者，容量小于总量，
+//                                            发送和接收都会频繁挂起
+//   throughput <workers> <producers> <count> <cap>
+//                                            单消费者吞吐：MPMC 与 MPSC 对比，只有一个生产者时
+//                                            再加上 SPSC
+//   pingpong <workers> <rounds>              两个任务通过两个容量为 1 的通道来回传递，
+//                                            每轮都要挂起和唤醒，测往返延迟
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 旧实现：send/recv 都是协程，先 co_await 协程互斥锁，再在 awaiter 中操作缓冲区和等待队列
+template <typename T> class LegacyChannel {
+  struct SendAwaiter {
+    auto await_ready() const noexcept -> bool { return false; }
+
+    auto await_suspend(std::coroutine_handle<> handle) -> bool {
+      std::lock_guard lock(_channel._mutex, std::adopt_lock);
+      _handle = handle;
+      if (!_channel._waiting_receivers.empty()) {
+        auto receiver = _channel._waiting_receivers.front();
+        _channel._waiting_receivers.pop_front();
+        receiver->_result = std::move(_value);
+        faio::runtime::detail::push_task_to_local_queue(receiver->_handle);
+        _result.emplace();
+        return false;
+      }
+      if (_channel._buffer.size() == _channel._cap) {
+        if (_channel._is_closed) {
+          return false;
+        }
+        _channel._waiting_senders.push_back(this);
+        return true;
+      }
+      _channel._buffer.push_back(std::move(_value));
+      _result.emplace();
+      return false;
+    }
+
+    auto await_resume() const noexcept { return _result; }
+
+    LegacyChannel &_channel;
+    T &_value;
+    faio::expected<void> _result{
+        std::unexpected{faio::make_error(faio::Error::ClosedChannel)}};
+    std::coroutine_handle<> _handle;
+  };
+
+  struct RecvAwaiter {
+    auto await_ready() const noexcept -> bool { return false; }
+
+    auto await_suspend(std::coroutine_handle<> handle) -> bool {
+      std::lock_guard lock(_channel._mutex, std::adopt_lock);
+      _handle = handle;
+      if (!_channel._waiting_senders.empty()) {
+        auto sender = _channel._waiting_senders.front();
+        _channel._waiting_senders.pop_front();
+        sender->_result.emplace();
+        _result.emplace(std::move(sender->_value));
+        faio::runtime::detail::push_task_to_local_queue(sender->_handle);
+        return false;
+      }
+      if (_channel._buffer.empty()) {
+        if (_channel._is_closed) {
+          return false;
+        }
+        _channel._waiting_receivers.push_back(this);
+        return true;
+      }
+      _result.emplace(std::move(_channel._buffer.front()));
+      _channel._buffer.pop_front();
+      return false;
+    }
+
+    auto await_resume() noexcept -> faio::expected<T> { return std::move(_result); }
+
+    LegacyChannel &_channel;
+    faio::expected<T> _result{
+        std::unexpected{faio::make_error(faio::Error::ClosedChannel)}};
+    std::coroutine_handle<> _handle;
+  };
+
+public:
+  // 与 Channel 的构造参数一致，发送者、接收者计数在这里用不到
+  LegacyChannel(std::size_t, std::size_t, std::size_t cap) : _cap{cap} {}
+
+  auto send(T value) -> faio::task<faio::expected<void>> {
+    co_await _mutex.lock();
+    co_return co_await SendAwaiter{*this, value};
+  }
+
+  auto recv() -> faio::task<faio::expected<T>> {
+    co_await _mutex.lock();
+    co_return co_await RecvAwaiter{*this};
+  }
+
+private:
+  std::size_t _cap;
+  std::deque<T> _buffer;
+  std::list<SendAwaiter *> _waiting_senders;
+  std::list<RecvAwaiter *> _waiting_receivers;
+  bool _is_closed{false};
+  faio::sync::mutex _mutex;
+};
+
+using NewChannel = faio::sync::detail::Channel<std::size_t>;
+using MpscChannel =
+    faio::sync::detail::Channel<std::size_t, faio::sync::detail::MpscRingBuffer<std::size_t>>;
+using SpscChannel =
+    faio::sync::detail::Channel<std::size_t, faio::sync::detail::SpscRingBuffer<std::size_t>>;
+using OldChannel = LegacyChannel<std::size_t>;
+
+auto per_op(Clock::duration elapsed, std::size_t ops) -> double {
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         static_cast<double>(std::max<std::size_t>(ops, 1));
+}
+
+// 每批发送 batch 个再全部接收，缓冲区不会满也不会空
+template <typename Channel>
+auto bench_single(std::string_view name, std::size_t count) -> faio::task<void> {
+  constexpr std::size_t batch = 512;
+  Channel channel{1, 1, batch};
+  std::size_t sum = 0;
+  const auto start = Clock::now();
+  for (std::size_t done = 0; done < count; done += batch) {
+    for (std::size_t i = 0; i < batch; ++i) {
+      (void)co_await channel.send(done + i);
+    }
+    for (std::size_t i = 0; i < batch; ++i) {
+      auto value = co_await channel.recv();
+      sum += value.value();
+    }
+  }
+  const auto elapsed = Clock::now() - start;
+  const auto ops = (count + batch - 1) / batch * batch;
+  fastlog::console.info("{:>8} single: {} send+recv, {:.1f}ns/pair (sum {})", name, ops,
+                        per_op(elapsed, ops), sum);
+}
+
+auto bench_try(std::size_t count) -> faio::task<void> {
+  constexpr std::size_t batch = 512;
+  NewChannel channel{1, 1, batch};
+  std::size_t sum = 0;
+  const auto start = Clock::now();
+  for (std::size_t done = 0; done < count; done += batch) {
+    for (std::size_t i = 0; i < batch; ++i) {
+      (void)channel.try_send(done + i);
+    }
+    for (std::size_t i = 0; i < batch; ++i) {
+      sum += channel.try_recv().value();
+    }
+  }
+  const auto elapsed = Clock::now() - start;
+  const auto ops = (count + batch - 1) / batch * batch;
+  fastlog::console.info("{:>8} single: {} try_send+try_recv, {:.1f}ns/pair (sum {})", "try",
+                        ops, per_op(elapsed, ops), sum);
+  co_return;
+}
+
+template <typename Channel>
+auto producer(Channel &channel, std::size_t count) -> faio::task<void> {
+  for (std::size_t i = 0; i < count; ++i) {
+    (void)co_await channel.send(i);
+  }
+}
+
+template <typename Channel>
+auto consumer(Channel &channel, std::size_t count, std::atomic<std::size_t> &received)
+    -> faio::task<void> {
+  for (std::size_t i = 0; i < count; ++i) {
+    if (co_await channel.recv()) {
+      received.fetch_add(1, std::memory_order::relaxed);
+    }
+  }
+}
+
+template <typename Channel>
+auto spawn_mpmc(Channel &channel, std::size_t producers, std::size_t consumers,
+                std::size_t count, std::atomic<std::size_t> &received) -> faio::task<void> {
+  // 总量平均分给每个消费者，不依赖关闭通道来结束
+  const auto total = producers * count;
+  for (std::size_t i = 0; i < consumers; ++i) {
+    faio::spawn(consumer(channel, total / consumers + (i < total % consumers ? 1 : 0),
+                         received));
+  }
+  for (std::size_t i = 0; i < producers; ++i) {
+    faio::spawn(producer(channel, count));
+  }
+  co_return;
+}
+
+template <typename Channel>
+void bench_mpmc(std::string_view name, std::size_t workers, std::size_t producers,
+                std::size_t consumers, std::size_t count, std::size_t cap) {
+  Channel channel{1, 1, cap};
+  std::atomic<std::size_t> received{0};
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(workers).build()};
+  const auto start = Clock::now();
+  faio::block_on(ctx, spawn_mpmc(channel, producers, consumers, count, received));
+  const auto elapsed = Clock::now() - start;
+  const auto total = received.load();
+  const auto rate =
+      static_cast<double>(total) / std::chrono::duration<double, std::micro>(elapsed).count();
+  fastlog::console.info("{:>8}: workers={} {}x{} cap={} msgs={}, {:.1f}ns/msg, {:.2f}M msg/s",
+                        name, workers, producers, consumers, cap, total, per_op(elapsed, total),
+                        rate);
+}
+
+template <typename Channel>
+auto pinger(Channel &ping, Channel &pong, std::size_t rounds) -> faio::task<void> {
+  for (std::size_t i = 0; i < rounds; ++i) {
+    (void)co_await ping.send(i);
+    (void)co_await pong.recv();
+  }
+}
+
+template <typename Channel>
+auto ponger(Channel &ping, Channel &pong, std::size_t rounds) -> faio::task<void> {
+  for (std::size_t i = 0; i < rounds; ++i) {
+    auto value = co_await ping.recv();
+    (void)co_await pong.send(value.value());
+  }
+}
+
+template <typename Channel>
+auto spawn_pingpong(Channel &ping, Channel &pong, std::size_t rounds) -> faio::task<void> {
+  faio::spawn(ponger(ping, pong, rounds));
+  faio::spawn(pinger(ping, pong, rounds));
+  co_return;
+}
+
+template <typename Channel>
+void bench_pingpong(std::string_view name, std::size_t workers, std::size_t rounds) {
+  Channel ping{1, 1, 1};
+  Channel pong{1, 1, 1};
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(workers).build()};
+  const auto start = Clock::now();
+  faio::block_on(ctx, spawn_pingpong(ping, pong, rounds));
+  fastlog::console.info("{:>8} pingpong: workers={} rounds={}, {:.1f}ns/round trip", name,
+                        workers, rounds, per_op(Clock::now() - start, rounds));
+}
+
+auto arg(int argc, char **argv, int index, std::size_t fallback) -> std::size_t {
+  return argc > index ? static_cast<std::size_t>(std::strtoull(argv[index], nullptr, 10))
+                      : fallback;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+  const std::string_view mode{argc > 1 ? argv[1] : "single"};
+  if (mode == "single") {
+    const auto count = arg(argc, argv, 2, 10000000);
+    faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+    faio::block_on(ctx, bench_single<NewChannel>("lockfree", count));
+    faio::block_on(ctx, bench_try(count));
+    faio::block_on(ctx, bench_single<OldChannel>("legacy", count));
+    return 0;
+  }
+  if (mode == "mpmc") {
+    const auto workers = arg(argc, argv, 2, 4);
+    const auto producers = arg(argc, argv, 3, 4);
+    const auto consumers = arg(argc, argv, 4, 4);
+    const auto count = arg(argc, argv, 5, 1000000);
+    const auto cap = arg(argc, argv, 6, 1024);
+    bench_mpmc<NewChannel>("lockfree", workers, producers, consumers, count, cap);
+    bench_mpmc<OldChannel>("legacy", workers, producers, consumers, count, cap);
+    return 0;
+  }
+  if (mode == "throughput") {
+    const auto workers = arg(argc, argv, 2, 2);
+    const auto producers = arg(argc, argv, 3, 1);
+    const auto count = arg(argc, argv, 4, 1000000);
+    const auto cap = arg(argc, argv, 5, 1024);
+    bench_mpmc<NewChannel>("mpmc", workers, producers, 1, count, cap);
+    bench_mpmc<MpscChannel>("mpsc", workers, producers, 1, count, cap);
+    if (producers == 1) {
+      bench_mpmc<SpscChannel>("spsc", workers, producers, 1, count, cap);
+    }
+    return 0;
+  }
+  if (mode == "pingpong") {
+    const auto workers = arg(argc, argv, 2, 2);
+    const auto rounds = arg(argc, argv, 3, 1000000);
+    bench_pingpong<NewChannel>("mpmc", workers, rounds);
+    bench_pingpong<MpscChannel>("mpsc", workers, rounds);
+    bench_pingpong<SpscChannel>("spsc", workers, rounds);
+    return 0;
+  }
+  fastlog::console.error("usage: {} single [count] | mpmc [workers] [producers] [consumers] "
+                         "[count] [cap] | throughput [workers] [producers] [count] [cap] | "
+                         "pingpong [workers] [rounds]",
+                         argv[0]);
+  return 1;
+}
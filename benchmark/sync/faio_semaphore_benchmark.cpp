@@ -0,0 +1,175 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// 信号量的争用测试：
+//   uncontended <count>                      单个任务反复 acquire/release，只走快路径，
+//                                            与 mutex 的 lock/unlock 对比
+//   contention <workers> <tasks> <ops> <limit>
+//                                            tasks 个任务在 workers 个线程上反复
+//                                            acquire -> 短临界区 -> release -> 让出，
+//                                            最多 limit 个同时持有；
+//                                            limit 为 1 时再与 mutex 对比。
+//                                            第一个完成 ops 次的任务让所有任务停下，
+//                                            统计每次操作的耗时和各任务完成次数的最小/最大值（公平性）
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+auto per_op(Clock::duration elapsed, std::size_t ops) -> double {
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         static_cast<double>(std::max<std::size_t>(ops, 1));
+}
+
+// 临界区里的短工作，结果写回调用者的变量，防止被优化掉
+void short_work(std::size_t &shared) {
+  for (std::size_t i = 0; i < 16; ++i) {
+    shared = shared * 31 + i;
+  }
+}
+
+// 获取锁 -> 短工作 -> 释放；semaphore 用 RAII 许可，mutex 手动解锁
+// 让出当前 worker：放回全局队列，模拟任务在两次获取之间去做 IO。
+// 不能放回本地队列，本地队列的下一个任务槽会让它立刻再次运行
+struct Yield {
+  auto await_ready() const noexcept -> bool { return false; }
+  void await_suspend(std::coroutine_handle<> handle) const {
+    faio::runtime::detail::push_task_to_global_queue(handle);
+  }
+  void await_resume() const noexcept {}
+};
+
+template <typename Lock>
+auto critical_section(Lock &lock, std::size_t &shared) -> faio::task<void> {
+  if constexpr (std::is_same_v<Lock, faio::sync::semaphore>) {
+    auto permit = co_await lock.acquire();
+    short_work(shared);
+  } else {
+    co_await lock.lock();
+    short_work(shared);
+    lock.unlock();
+  }
+}
+
+template <typename Lock> auto make_lock(std::size_t limit) -> std::unique_ptr<Lock> {
+  if constexpr (std::is_same_v<Lock, faio::sync::semaphore>) {
+    return std::make_unique<Lock>(limit);
+  } else {
+    return std::make_unique<Lock>();
+  }
+}
+
+template <typename Lock>
+auto bench_uncontended(std::string_view name, std::size_t count) -> faio::task<void> {
+  auto lock = make_lock<Lock>(1);
+  std::size_t shared = 0;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    co_await critical_section(*lock, shared);
+  }
+  const auto elapsed = Clock::now() - start;
+  const auto checksum = shared % 10;
+  fastlog::console.info("{:>10} uncontended: {} ops, {:.1f}ns/op (checksum {})", name, count,
+                        per_op(elapsed, count), checksum);
+}
+
+struct Contention {
+  std::vector<std::size_t> done;        // 每个任务完成的次数
+  std::atomic<bool> stop{false};        // 第一个完成 ops 次的任务置位
+  std::atomic<std::size_t> running{0};  // 还在运行的任务数
+  std::atomic<std::size_t> checksum{0}; // 各任务短工作的结果，防止被优化掉
+};
+
+template <typename Lock>
+auto contender(Lock &lock, Contention &state, std::size_t index, std::size_t ops)
+    -> faio::task<void> {
+  // 多个许可时临界区会并发执行，短工作只写任务自己的变量
+  std::size_t local = index;
+  std::size_t done = 0;
+  while (!state.stop.load(std::memory_order::relaxed)) {
+    co_await critical_section(lock, local);
+    if (++done == ops) {
+      state.stop.store(true, std::memory_order::relaxed);
+    }
+    co_await Yield{};
+  }
+  state.done[index] = done;
+  state.checksum.fetch_add(local, std::memory_order::relaxed);
+  state.running.fetch_sub(1, std::memory_order::release);
+}
+
+template <typename Lock>
+auto spawn_contention(Lock &lock, Contention &state, std::size_t tasks, std::size_t ops)
+    -> faio::task<void> {
+  for (std::size_t i = 0; i < tasks; ++i) {
+    faio::spawn(contender(lock, state, i, ops));
+  }
+  while (state.running.load(std::memory_order::acquire) != 0) {
+    co_await faio::time::sleep(std::chrono::milliseconds(1));
+  }
+}
+
+template <typename Lock>
+void bench_contention(std::string_view name, std::size_t workers, std::size_t tasks,
+                      std::size_t ops, std::size_t limit) {
+  auto lock = make_lock<Lock>(limit);
+  Contention state;
+  state.done.resize(tasks);
+  state.running.store(tasks);
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(workers).build()};
+  const auto start = Clock::now();
+  faio::block_on(ctx, spawn_contention(*lock, state, tasks, ops));
+  const auto elapsed = Clock::now() - start;
+  std::size_t total = 0;
+  for (auto done : state.done) {
+    total += done;
+  }
+  const auto min = *std::min_element(state.done.begin(), state.done.end());
+  const auto max = *std::max_element(state.done.begin(), state.done.end());
+  fastlog::console.info("{:>10}: workers={} tasks={} limit={} ops={}, {:.1f}ns/op, "
+                        "per task min={} max={}",
+                        name, workers, tasks, limit, total, per_op(elapsed, total), min, max);
+}
+
+auto arg(int argc, char **argv, int index, std::size_t fallback) -> std::size_t {
+  return argc > index ? static_cast<std::size_t>(std::strtoull(argv[index], nullptr, 10))
+                      : fallback;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+  const std::string_view mode{argc > 1 ? argv[1] : "contention"};
+  if (mode == "uncontended") {
+    const auto count = arg(argc, argv, 2, 10000000);
+    faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+    faio::block_on(ctx, bench_uncontended<faio::sync::semaphore>("semaphore", count));
+    faio::block_on(ctx, bench_uncontended<faio::sync::mutex>("mutex", count));
+    return 0;
+  }
+  if (mode == "contention") {
+    const auto workers = arg(argc, argv, 2, 4);
+    const auto tasks = arg(argc, argv, 3, 16);
+    const auto ops = arg(argc, argv, 4, 100000);
+    const auto limit = std::max<std::size_t>(arg(argc, argv, 5, 1), 1);
+    bench_contention<faio::sync::semaphore>("semaphore", workers, tasks, ops, limit);
+    if (limit == 1) {
+      bench_contention<faio::sync::mutex>("mutex", workers, tasks, ops, limit);
+    }
+    return 0;
+  }
+  fastlog::console.error("usage: {} uncontended [count] | contention [workers] [tasks] [ops] "
+                         "[limit]",
+                         argv[0]);
+  return 1;
+}
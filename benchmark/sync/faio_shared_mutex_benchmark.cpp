@@ -0,0 +1,153 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+#include <type_traits>
+
+// 读写锁与协程互斥锁在读多写少负载下的对比：
+//   uncontended <count>                      单个任务反复加读锁/解读锁，只走读者快路径，
+//                                            与 mutex 的 lock/unlock 对比
+//   mixed <workers> <tasks> <ops> <write_percent>
+//                                            tasks 个任务在 workers 个线程上各执行 ops 次操作，
+//                                            每 100 次中有 write_percent 次写（改一项），其余为读
+//                                            （遍历整张表求和），输出每次操作的耗时
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+auto per_op(Clock::duration elapsed, std::size_t ops) -> double {
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         static_cast<double>(std::max<std::size_t>(ops, 1));
+}
+
+// 被保护的共享状态：一张小表，读是遍历求和，写是改其中一项
+struct Table {
+  std::array<std::uint64_t, 64> entries{};
+
+  auto read() const -> std::uint64_t {
+    std::uint64_t sum = 0;
+    for (auto entry : entries) {
+      sum += entry;
+    }
+    return sum;
+  }
+
+  void write(std::size_t i) { entries[i % entries.size()] += i; }
+};
+
+template <typename Lock>
+auto bench_uncontended(std::string_view name, std::size_t count) -> faio::task<void> {
+  Lock lock;
+  Table table;
+  std::uint64_t sum = 0;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    if constexpr (std::is_same_v<Lock, faio::sync::shared_mutex>) {
+      co_await lock.lock_shared();
+      sum += table.read();
+      lock.unlock_shared();
+    } else {
+      co_await lock.lock();
+      sum += table.read();
+      lock.unlock();
+    }
+  }
+  const auto elapsed = Clock::now() - start;
+  fastlog::console.info("{:>12} uncontended read: {} ops, {:.1f}ns/op (sum {})", name, count,
+                        per_op(elapsed, count), sum);
+}
+
+template <typename Lock>
+auto worker(Lock &lock, Table &table, std::size_t ops, std::size_t write_percent,
+            std::size_t seed, std::atomic<std::uint64_t> &checksum,
+            std::atomic<std::size_t> &running) -> faio::task<void> {
+  std::uint64_t sum = 0;
+  for (std::size_t i = 0; i < ops; ++i) {
+    // 写操作在各任务之间错开，不集中在同一时刻
+    if ((i + seed) % 100 < write_percent) {
+      co_await lock.lock();
+      table.write(i);
+      lock.unlock();
+    } else {
+      if constexpr (std::is_same_v<Lock, faio::sync::shared_mutex>) {
+        co_await lock.lock_shared();
+        sum += table.read();
+        lock.unlock_shared();
+      } else {
+        co_await lock.lock();
+        sum += table.read();
+        lock.unlock();
+      }
+    }
+  }
+  checksum.fetch_add(sum, std::memory_order::relaxed);
+  running.fetch_sub(1, std::memory_order::release);
+}
+
+template <typename Lock>
+auto spawn_mixed(Lock &lock, Table &table, std::size_t tasks, std::size_t ops,
+                 std::size_t write_percent, std::atomic<std::uint64_t> &checksum,
+                 std::atomic<std::size_t> &running) -> faio::task<void> {
+  for (std::size_t i = 0; i < tasks; ++i) {
+    faio::spawn(worker(lock, table, ops, write_percent, i * 37, checksum, running));
+  }
+  while (running.load(std::memory_order::acquire) != 0) {
+    co_await faio::time::sleep(std::chrono::milliseconds(1));
+  }
+}
+
+template <typename Lock>
+void bench_mixed(std::string_view name, std::size_t workers, std::size_t tasks,
+                 std::size_t ops, std::size_t write_percent) {
+  Lock lock;
+  Table table;
+  std::atomic<std::uint64_t> checksum{0};
+  std::atomic<std::size_t> running{tasks};
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(workers).build()};
+  const auto start = Clock::now();
+  faio::block_on(ctx, spawn_mixed(lock, table, tasks, ops, write_percent, checksum, running));
+  const auto elapsed = Clock::now() - start;
+  const auto total = tasks * ops;
+  const auto sum = checksum.load() % 1000;
+  fastlog::console.info("{:>12}: workers={} tasks={} writes={}/100 ops={}, {:.1f}ns/op (sum {})",
+                        name, workers, tasks, write_percent, total, per_op(elapsed, total),
+                        sum);
+}
+
+auto arg(int argc, char **argv, int index, std::size_t fallback) -> std::size_t {
+  return argc > index ? static_cast<std::size_t>(std::strtoull(argv[index], nullptr, 10))
+                      : fallback;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+  const std::string_view mode{argc > 1 ? argv[1] : "mixed"};
+  if (mode == "uncontended") {
+    const auto count = arg(argc, argv, 2, 10000000);
+    faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+    faio::block_on(ctx, bench_uncontended<faio::sync::shared_mutex>("shared_mutex", count));
+    faio::block_on(ctx, bench_uncontended<faio::sync::mutex>("mutex", count));
+    return 0;
+  }
+  if (mode == "mixed") {
+    const auto workers = arg(argc, argv, 2, 4);
+    const auto tasks = arg(argc, argv, 3, 16);
+    const auto ops = arg(argc, argv, 4, 200000);
+    const auto write_percent = std::min<std::size_t>(arg(argc, argv, 5, 1), 100);
+    bench_mixed<faio::sync::shared_mutex>("shared_mutex", workers, tasks, ops, write_percent);
+    bench_mixed<faio::sync::mutex>("mutex", workers, tasks, ops, write_percent);
+    return 0;
+  }
+  fastlog::console.error("usage: {} uncontended [count] | mixed [workers] [tasks] [ops] "
+                         "[write_percent]",
+                         argv[0]);
+  return 1;
+}
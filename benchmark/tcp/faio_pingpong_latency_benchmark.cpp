@@ -0,0 +1,155 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// TCP ping-pong 往返延迟，两个角色分别在不同进程中运行：
+//   echo   <port> [napi_us] [spin_us] [trace]                                回显服务
+//   client <host> <port> <iterations> [payload] [napi_us] [spin_us] [trace]  单连接逐个往返，输出分位数
+// napi_us 大于0时在 worker 的 ring 上注册 NAPI 忙轮询（6.9+ 内核，回环设备没有 NAPI，
+// 需要在真实网卡上对比）；spin_us 为 worker 休眠前的自旋窗口；
+// trace 为1时开启延迟追踪，结束时按 opcode 输出内核延迟和调度延迟
+namespace {
+
+auto build_config(int argc, char **argv, int first) -> faio::runtime::detail::Config {
+  const auto napi_us =
+      argc > first ? static_cast<uint32_t>(std::strtoul(argv[first], nullptr, 10)) : 0u;
+  const auto spin_us =
+      argc > first + 1 ? static_cast<uint32_t>(std::strtoul(argv[first + 1], nullptr, 10)) : 0u;
+  const auto trace = argc > first + 2 && std::string_view{argv[first + 2]} == "1";
+  fastlog::console.info("napi_busy_poll={}us, spin_window={}us, latency_tracing={}", napi_us,
+                        spin_us, trace);
+  return faio::ConfigBuilder{}
+      .set_num_workers(1)
+      .set_napi_busy_poll(std::chrono::microseconds(napi_us), napi_us > 0)
+      .set_spin_window(std::chrono::microseconds(spin_us))
+      .set_latency_tracing(trace)
+      .build();
+}
+
+// 按 opcode 输出内核延迟（提交 → CQE）和调度延迟（CQE → 协程恢复），数值为所在桶的上界
+void report_latency(const faio::runtime_context &ctx) {
+  for (const auto &op : ctx.metrics().latency) {
+    fastlog::console.info("opcode {:>2}: kernel p50 {}, p99 {}, p999 {} | schedule p50 {}, p99 "
+                          "{}, p999 {} | samples {}",
+                          op.opcode, op.kernel.percentile(0.50), op.kernel.percentile(0.99),
+                          op.kernel.percentile(0.999), op.schedule.percentile(0.50),
+                          op.schedule.percentile(0.99), op.schedule.percentile(0.999),
+                          op.kernel.count());
+  }
+}
+
+auto echo_connection(faio::net::TcpStream stream) -> faio::task<void> {
+  (void)stream.set_nodelay(true);
+  std::vector<char> buf(64 * 1024);
+  while (true) {
+    auto n = co_await stream.read(buf);
+    if (!n || n.value() == 0) {
+      break;
+    }
+    if (!co_await stream.write_all(std::span<const char>(buf.data(), n.value()))) {
+      break;
+    }
+  }
+}
+
+auto run_echo(uint16_t port) -> faio::task<int> {
+  auto listener = faio::net::TcpListener::bind(faio::net::address::parse("0.0.0.0", port).value());
+  if (!listener) {
+    fastlog::console.error("bind failed: {}", listener.error().message());
+    co_return 1;
+  }
+  fastlog::console.info("echo listening on 0.0.0.0:{}", port);
+  while (true) {
+    auto accepted = co_await listener.value().accept();
+    if (!accepted) {
+      fastlog::console.error("accept failed: {}", accepted.error().message());
+      co_return 1;
+    }
+    auto [stream, _peer] = std::move(accepted.value());
+    faio::spawn(echo_connection(std::move(stream)));
+  }
+}
+
+auto percentile(const std::vector<double> &sorted, double p) -> double {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+  return sorted[index];
+}
+
+// 写一个 payload 再读回同样大小的回显，记录每次往返的时间
+auto run_client(faio::net::address addr, std::size_t iterations, std::size_t payload)
+    -> faio::task<int> {
+  auto stream = co_await faio::net::TcpStream::connect(addr);
+  if (!stream) {
+    fastlog::console.error("connect failed: {}", stream.error().message());
+    co_return 1;
+  }
+  (void)stream.value().set_nodelay(true);
+  std::vector<char> out(payload, 'p');
+  std::vector<char> in(payload);
+  // 预热，排除建连和缓存的影响
+  const auto warmup = std::min<std::size_t>(iterations / 10, 10000);
+  std::vector<double> rtts;
+  rtts.reserve(iterations);
+  for (std::size_t i = 0; i < warmup + iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    if (!co_await stream.value().write_all(out)) {
+      fastlog::console.error("write failed");
+      co_return 1;
+    }
+    if (!co_await stream.value().read_bytes(in)) {
+      fastlog::console.error("read failed");
+      co_return 1;
+    }
+    if (i >= warmup) {
+      rtts.push_back(
+          std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+              .count());
+    }
+  }
+  std::ranges::sort(rtts);
+  fastlog::console.info("iterations={}, payload={}B", iterations, payload);
+  fastlog::console.info("rtt p50: {:.1f}us, p99: {:.1f}us, p999: {:.1f}us, max: {:.1f}us",
+                        percentile(rtts, 0.50), percentile(rtts, 0.99),
+                        percentile(rtts, 0.999), rtts.empty() ? 0.0 : rtts.back());
+  co_return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+  const std::string_view role{argc > 1 ? argv[1] : ""};
+  if (role == "echo" && argc > 2) {
+    const auto port = static_cast<uint16_t>(std::strtoul(argv[2], nullptr, 10));
+    faio::runtime_context ctx{build_config(argc, argv, 3)};
+    return faio::block_on(ctx, run_echo(port));
+  }
+  if (role == "client" && argc > 4) {
+    auto addr = faio::net::address::parse(argv[2],
+                                          static_cast<uint16_t>(std::strtoul(argv[3], nullptr, 10)));
+    if (!addr) {
+      fastlog::console.error("invalid address {}:{}", argv[2], argv[3]);
+      return 1;
+    }
+    const auto iterations = static_cast<std::size_t>(std::strtoull(argv[4], nullptr, 10));
+    const auto payload =
+        argc > 5 ? static_cast<std::size_t>(std::strtoull(argv[5], nullptr, 10)) : 64uz;
+    faio::runtime_context ctx{build_config(argc, argv, 6)};
+    auto ret = faio::block_on(ctx, run_client(addr.value(), iterations, payload));
+    report_latency(ctx);
+    return ret;
+  }
+  fastlog::console.error("usage: {} echo <port> [napi_us] [spin_us] [trace] | client <host> "
+                         "<port> <iterations> [payload] [napi_us] [spin_us] [trace]",
+                         argv[0]);
+  return 1;
+}
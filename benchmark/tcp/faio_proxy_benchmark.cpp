@@ -0,0 +1,198 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <vector>
+
+// L4 代理基准，三个角色分别在不同进程中运行：
+//   echo   <port>                                   回显服务（上游）
+//   proxy  <listen_port> <upstream_port> [splice|copy]  代理，每 5 秒输出 CPU 占用
+//   client <port> <conns> <seconds> [block_kb]      压测客户端，输出吞吐
+// splice 模式使用 net::copy_bidirectional，copy 模式是 read + write_all 循环
+namespace {
+
+std::atomic<uint64_t> g_bytes{0};
+
+auto parse_addr(uint16_t port) -> faio::net::address {
+  return faio::net::address::parse("127.0.0.1", port).value();
+}
+
+auto cpu_seconds() -> double {
+  rusage usage{};
+  ::getrusage(RUSAGE_SELF, &usage);
+  auto to_secs = [](const timeval &tv) {
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+  };
+  return to_secs(usage.ru_utime) + to_secs(usage.ru_stime);
+}
+
+// 每 5 秒输出一次进程 CPU 占用（100% 为一个核）
+auto report_cpu() -> faio::task<void> {
+  auto last_cpu = cpu_seconds();
+  while (true) {
+    co_await faio::time::sleep(std::chrono::seconds(5));
+    auto cpu = cpu_seconds();
+    fastlog::console.info("proxy cpu: {:.1f}%", (cpu - last_cpu) / 5.0 * 100.0);
+    last_cpu = cpu;
+  }
+}
+
+auto echo_connection(faio::net::TcpStream stream) -> faio::task<void> {
+  std::vector<char> buf(64 * 1024);
+  while (true) {
+    auto n = co_await stream.read(buf);
+    if (!n || n.value() == 0) {
+      break;
+    }
+    if (!co_await stream.write_all(std::span<const char>(buf.data(), n.value()))) {
+      break;
+    }
+  }
+}
+
+struct ProxyPair {
+  faio::net::TcpStream downstream;
+  faio::net::TcpStream upstream;
+};
+
+// 用户态转发：read 到缓冲区再 write_all，读到EOF后半关闭对端
+auto pump(std::shared_ptr<ProxyPair> pair, bool down_to_up) -> faio::task<void> {
+  auto &from = down_to_up ? pair->downstream : pair->upstream;
+  auto &to = down_to_up ? pair->upstream : pair->downstream;
+  std::vector<char> buf(16 * 1024);
+  while (true) {
+    auto n = co_await from.read(buf);
+    if (!n || n.value() == 0) {
+      break;
+    }
+    if (!co_await to.write_all(std::span<const char>(buf.data(), n.value()))) {
+      break;
+    }
+  }
+  co_await to.shutdown(faio::io::ShutdownBehavior::Write);
+}
+
+auto proxy_connection(faio::net::TcpStream downstream, uint16_t upstream_port,
+                      bool splice) -> faio::task<void> {
+  auto upstream = co_await faio::net::TcpStream::connect(parse_addr(upstream_port));
+  if (!upstream) {
+    fastlog::console.error("connect upstream failed: {}", upstream.error().message());
+    co_return;
+  }
+  if (splice) {
+    auto stats = co_await faio::net::copy_bidirectional(downstream, upstream.value());
+    if (!stats) {
+      fastlog::console.debug("proxy failed: {}", stats.error().message());
+    }
+    co_return;
+  }
+  auto pair = std::make_shared<ProxyPair>(std::move(downstream), std::move(upstream.value()));
+  faio::spawn(pump(pair, false));
+  co_await pump(std::move(pair), true);
+}
+
+auto run_server(uint16_t port, bool proxy, uint16_t upstream_port, bool splice)
+    -> faio::task<int> {
+  auto listener = faio::net::TcpListener::bind(parse_addr(port));
+  if (!listener) {
+    fastlog::console.error("bind failed: {}", listener.error().message());
+    co_return 1;
+  }
+  if (proxy) {
+    fastlog::console.info("proxy 127.0.0.1:{} -> 127.0.0.1:{}, mode: {}", port, upstream_port,
+                          splice ? "splice" : "copy");
+    faio::spawn(report_cpu());
+  } else {
+    fastlog::console.info("echo listening on 127.0.0.1:{}", port);
+  }
+  while (true) {
+    auto accepted = co_await listener.value().accept();
+    if (!accepted) {
+      fastlog::console.error("accept failed: {}", accepted.error().message());
+      co_return 1;
+    }
+    auto [stream, _peer] = std::move(accepted.value());
+    if (proxy) {
+      faio::spawn(proxy_connection(std::move(stream), upstream_port, splice));
+    } else {
+      faio::spawn(echo_connection(std::move(stream)));
+    }
+  }
+}
+
+// 发送一块数据并读回同样大小的回显
+auto client_connection(uint16_t port, std::size_t block,
+                       std::chrono::steady_clock::time_point deadline) -> faio::task<void> {
+  auto stream = co_await faio::net::TcpStream::connect(parse_addr(port));
+  if (!stream) {
+    fastlog::console.error("connect failed: {}", stream.error().message());
+    co_return;
+  }
+  std::vector<char> out(block, 'x');
+  std::vector<char> in(block);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (!co_await stream.value().write_all(out)) {
+      break;
+    }
+    if (!co_await stream.value().read_bytes(in)) {
+      break;
+    }
+    g_bytes.fetch_add(block * 2, std::memory_order_relaxed);
+  }
+}
+
+auto run_client(uint16_t port, std::size_t conns, std::size_t seconds, std::size_t block)
+    -> faio::task<int> {
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + std::chrono::seconds(seconds);
+  for (std::size_t i = 0; i < conns; ++i) {
+    faio::spawn(client_connection(port, block, deadline));
+  }
+  co_await faio::time::sleep(std::chrono::seconds(seconds));
+  const double secs =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fastlog::console.info("conns={}, block={}KB, throughput: {:.1f} MB/s (both directions)", conns,
+                        block >> 10,
+                        static_cast<double>(g_bytes.load(std::memory_order_relaxed)) / secs /
+                            (1 << 20));
+  co_return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+  if (argc < 3) {
+    fastlog::console.error(
+        "usage: {} echo <port> | proxy <port> <upstream_port> [splice|copy] | client <port> "
+        "<conns> <seconds> [block_kb]",
+        argv[0]);
+    return 1;
+  }
+  const std::string_view role{argv[1]};
+  const auto port = static_cast<uint16_t>(std::strtoul(argv[2], nullptr, 10));
+  faio::runtime_context ctx;
+  if (role == "echo") {
+    return faio::block_on(ctx, run_server(port, false, 0, false));
+  }
+  if (role == "proxy" && argc > 3) {
+    const auto upstream_port = static_cast<uint16_t>(std::strtoul(argv[3], nullptr, 10));
+    const bool splice = argc <= 4 || std::string_view{argv[4]} != "copy";
+    return faio::block_on(ctx, run_server(port, true, upstream_port, splice));
+  }
+  if (role == "client" && argc > 4) {
+    const auto conns = static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10));
+    const auto seconds = static_cast<std::size_t>(std::strtoull(argv[4], nullptr, 10));
+    const auto block_kb =
+        argc > 5 ? static_cast<std::size_t>(std::strtoull(argv[5], nullptr, 10)) : 64uz;
+    return faio::block_on(ctx, run_client(port, conns, seconds, block_kb << 10));
+  }
+  fastlog::console.error("invalid arguments");
+  return 1;
+}
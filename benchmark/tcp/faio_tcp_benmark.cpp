@@ -2,16 +2,57 @@
 #include "fastlog/fastlog.hpp"
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <string>
+#include <string_view>
 
 namespace {
 
 struct TcpBenchmarkConfig {
 	std::string host = "0.0.0.0";
 	uint16_t port = 18081;
+	faio::SubmitPolicy submit_policy = faio::SubmitPolicy::Tick;
+	faio::IOBackend io_backend = faio::IOBackend::Auto;
 };
 
+std::atomic<uint64_t> g_requests{0};
+
+auto backend_name(faio::IOBackend backend) -> std::string_view {
+	switch (backend) {
+	case faio::IOBackend::IOuring:
+		return "io_uring";
+	case faio::IOBackend::Epoll:
+		return "epoll";
+	default:
+		return "auto";
+	}
+}
+
+// 每 5 秒输出一次请求数和平均每个请求的 io_uring 系统调用次数
+auto report_metrics(const faio::runtime_context &ctx) -> faio::task<void> {
+	auto last = ctx.metrics();
+	auto last_requests = g_requests.load(std::memory_order_relaxed);
+	while (true) {
+		co_await faio::time::sleep(std::chrono::seconds(5));
+		auto now = ctx.metrics();
+		auto requests = g_requests.load(std::memory_order_relaxed);
+		auto delta_requests = requests - last_requests;
+		auto delta_syscalls = now.syscalls() - last.syscalls();
+		if (delta_requests > 0) {
+			fastlog::console.info(
+					"requests: {}/s, syscalls: {}/s (submit {}, wait {}), syscalls/request: {:.3f}",
+					delta_requests / 5, delta_syscalls / 5,
+					now.submit_syscalls - last.submit_syscalls,
+					now.wait_syscalls - last.wait_syscalls,
+					static_cast<double>(delta_syscalls) / static_cast<double>(delta_requests));
+		}
+		last = now;
+		last_requests = requests;
+	}
+}
+
 auto handle_connection(faio::net::TcpStream stream) -> faio::task<void> {
 	std::array<char, 8192> buf{};
 	std::string request_buffer;
@@ -51,6 +92,7 @@ auto handle_connection(faio::net::TcpStream stream) -> faio::task<void> {
 				fastlog::console.debug("tcp write failed: {}", write_res.error().message());
 				co_return;
 			}
+			g_requests.fetch_add(1, std::memory_order_relaxed);
 			request_buffer.erase(0, end + 4);
 		}
 	}
@@ -58,7 +100,8 @@ auto handle_connection(faio::net::TcpStream stream) -> faio::task<void> {
 	co_return;
 }
 
-auto run_server(const TcpBenchmarkConfig &config) -> faio::task<int> {
+auto run_server(const faio::runtime_context &ctx, const TcpBenchmarkConfig &config)
+		-> faio::task<int> {
 	auto addr_res = faio::net::address::parse(config.host, config.port);
 	if (!addr_res) {
 		fastlog::console.error("parse address failed: {}", addr_res.error().message());
@@ -72,7 +115,11 @@ auto run_server(const TcpBenchmarkConfig &config) -> faio::task<int> {
 	}
 
 	auto listener = std::move(listener_res.value());
-	fastlog::console.info("faio tcp benchmark listening on {}:{}", config.host, config.port);
+	fastlog::console.info("faio tcp benchmark listening on {}:{}, submit policy: {}, io backend: {}",
+												config.host, config.port,
+												config.submit_policy == faio::SubmitPolicy::Tick ? "tick" : "interval",
+												backend_name(config.io_backend));
+	faio::spawn(report_metrics(ctx));
 
 	while (true) {
 		auto accept_res = co_await listener.accept();
@@ -97,6 +144,20 @@ int main(int argc, char **argv) {
 	if (argc > 2) {
 		config.port = static_cast<uint16_t>(std::strtoul(argv[2], nullptr, 10));
 	}
-	faio::runtime_context ctx;
-	return faio::block_on(ctx, run_server(config));
+	if (argc > 3 && std::string_view{argv[3]} == "interval") {
+		config.submit_policy = faio::SubmitPolicy::Interval;
+	}
+	if (argc > 4) {
+		const std::string_view backend{argv[4]};
+		if (backend == "epoll") {
+			config.io_backend = faio::IOBackend::Epoll;
+		} else if (backend == "uring") {
+			config.io_backend = faio::IOBackend::IOuring;
+		}
+	}
+	faio::runtime_context ctx{faio::ConfigBuilder{}
+																.set_submit_policy(config.submit_policy)
+																.set_io_backend(config.io_backend)
+																.build()};
+	return faio::block_on(ctx, run_server(ctx, config));
 }
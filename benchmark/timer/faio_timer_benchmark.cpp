@@ -0,0 +1,207 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdlib>
+#include <string_view>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+// 定时器 add/cancel 开销，对应“IO 超时在 IO 完成后取消”的典型用法：
+//   pairs   <count>           每个定时器挂入后立即取消
+//   window  <count> [live]    始终保持 live 个在途定时器，每次取消最早的一个再挂入一个新的
+//   extend  <count>           反复延长同一个定时器：reset_task（惰性推迟）与 remove + add 对比
+//   runtime <count>           在运行时中对已经有数据的 socket 执行 count 次带超时的 recv
+//   idle    <conns> [seconds] [slack_ms]
+//                             conns 个连接各自反复等待约 1 秒的空闲超时（到期时间互不相同），
+//                             输出 worker 每秒的唤醒（等待系统调用）次数，对比不同 slack
+namespace {
+
+using faio::runtime::detail::timer::Timer;
+using faio::runtime::detail::timer::TimerTask;
+
+// 定时器不会到期，队列不会被调用
+struct NullQueue {
+  void push_back(std::coroutine_handle<>, NullQueue &) {}
+};
+
+auto report(std::string_view mode, std::size_t count,
+            std::chrono::steady_clock::duration elapsed) {
+  const auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  fastlog::console.info("{}: {} add/cancel pairs in {:.1f}ms, {:.1f}ns/pair", mode, count,
+                        ns / 1e6, ns / static_cast<double>(count));
+}
+
+// 超时分布在 1~30 秒，覆盖时间轮的多个层级
+auto deadline_of(std::chrono::steady_clock::time_point now, std::size_t i) {
+  return now + std::chrono::milliseconds(1000 + (i * 7919) % 29000);
+}
+
+void bench_pairs(std::size_t count) {
+  Timer timer;
+  NullQueue queue;
+  TimerTask task;
+  const auto now = std::chrono::steady_clock::now();
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    task = TimerTask{deadline_of(now, i), std::noop_coroutine()};
+    timer.add_task(&task);
+    timer.remove_task(&task);
+    if ((i & 1023) == 0) {
+      timer.poll(queue, queue);
+    }
+  }
+  report("pairs", count, std::chrono::steady_clock::now() - start);
+}
+
+void bench_window(std::size_t count, std::size_t live) {
+  Timer timer;
+  NullQueue queue;
+  std::vector<TimerTask> tasks(live);
+  const auto now = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < live; ++i) {
+    tasks[i] = TimerTask{deadline_of(now, i), std::noop_coroutine()};
+    timer.add_task(&tasks[i]);
+  }
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    auto &task = tasks[i % live];
+    timer.remove_task(&task);
+    task = TimerTask{deadline_of(now, i + live), std::noop_coroutine()};
+    timer.add_task(&task);
+    if ((i & 1023) == 0) {
+      timer.poll(queue, queue);
+    }
+  }
+  report("window", count, std::chrono::steady_clock::now() - start);
+  fastlog::console.info("live timers: {}", timer.num_entries());
+}
+
+// 保活连接每个请求都把空闲超时延长到 30 秒之后
+void bench_extend(std::size_t count) {
+  Timer timer;
+  NullQueue queue;
+  TimerTask task{std::chrono::steady_clock::now() + std::chrono::seconds(30),
+                 std::noop_coroutine()};
+  timer.add_task(&task);
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    timer.reset_task(&task, std::chrono::steady_clock::now() + std::chrono::seconds(30));
+  }
+  const auto lazy = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    timer.remove_task(&task);
+    task._deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    timer.add_task(&task);
+  }
+  const auto eager = std::chrono::steady_clock::now() - start;
+  timer.poll(queue, queue);
+  const auto per = [count](auto elapsed) {
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(count);
+  };
+  fastlog::console.info("extend: {} resets, reset_task {:.1f}ns/op, remove + add {:.1f}ns/op",
+                        count, per(lazy), per(eager));
+}
+
+auto bench_runtime(std::size_t count) -> faio::task<int> {
+  int fds[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+    fastlog::console.error("socketpair failed");
+    co_return 1;
+  }
+  char buf[1];
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (::send(fds[0], "x", 1, 0) != 1) {
+      fastlog::console.error("send failed");
+      co_return 1;
+    }
+    auto res = co_await faio::time::timeout(faio::io::recv(fds[1], buf, sizeof(buf), 0),
+                                            std::chrono::seconds(5));
+    if (!res) {
+      fastlog::console.error("recv failed: {}", res.error().message());
+      co_return 1;
+    }
+  }
+  report("runtime", count, std::chrono::steady_clock::now() - start);
+  ::close(fds[0]);
+  ::close(fds[1]);
+  co_return 0;
+}
+
+// 模拟保活连接的空闲超时：每个连接的周期在 1~2 秒之间错开
+auto idle_connection(std::size_t id, std::chrono::milliseconds slack,
+                     const std::atomic<bool> &stop) -> faio::task<void> {
+  const auto period = std::chrono::microseconds(1000000 + (id * 7919) % 1000000);
+  while (!stop.load(std::memory_order::relaxed)) {
+    co_await faio::time::sleep(period).with_slack(slack);
+  }
+}
+
+auto bench_idle(faio::runtime_context &ctx, std::size_t conns, std::chrono::seconds duration,
+                std::chrono::milliseconds slack) -> faio::task<int> {
+  std::atomic<bool> stop{false};
+  for (std::size_t i = 0; i < conns; ++i) {
+    faio::spawn(idle_connection(i, slack, stop));
+  }
+  // 跳过第一轮，所有连接都进入稳定的周期后再统计
+  co_await faio::time::sleep(std::chrono::seconds(2));
+  const auto before = ctx.metrics();
+  co_await faio::time::sleep(duration);
+  const auto after = ctx.metrics();
+  stop.store(true, std::memory_order::relaxed);
+  const auto secs = static_cast<double>(duration.count());
+  fastlog::console.info("idle: conns={}, slack={}ms, wakeups {:.1f}/s, completions {:.1f}/s",
+                        conns, slack.count(),
+                        static_cast<double>(after.wait_syscalls - before.wait_syscalls) / secs,
+                        static_cast<double>(after.completed_cqes - before.completed_cqes) / secs);
+  // 等待所有连接看到停止标志后退出
+  co_await faio::time::sleep(std::chrono::seconds(2));
+  co_return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+  const std::string_view mode{argc > 1 ? argv[1] : "pairs"};
+  const auto count =
+      argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 1000000uz;
+  if (mode == "pairs") {
+    bench_pairs(count);
+    return 0;
+  }
+  if (mode == "window") {
+    const auto live =
+        argc > 3 ? static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)) : 10000uz;
+    bench_window(count, std::max<std::size_t>(live, 1));
+    return 0;
+  }
+  if (mode == "extend") {
+    bench_extend(count);
+    return 0;
+  }
+  if (mode == "runtime") {
+    faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+    return faio::block_on(ctx, bench_runtime(count));
+  }
+  if (mode == "idle") {
+    const std::chrono::seconds duration{
+        argc > 3 ? std::strtoll(argv[3], nullptr, 10) : 10};
+    const std::chrono::milliseconds slack{
+        argc > 4 ? std::strtoll(argv[4], nullptr, 10) : 0};
+    faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+    return faio::block_on(ctx, bench_idle(ctx, argc > 2 ? count : 100000uz,
+                                          duration, slack));
+  }
+  fastlog::console.error("usage: {} pairs|window|extend|runtime [count] [live] | idle <conns> "
+                         "[seconds] [slack_ms]",
+                         argv[0]);
+  return 1;
+}
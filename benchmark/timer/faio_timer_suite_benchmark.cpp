@@ -0,0 +1,296 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// 时间轮与 4 叉堆在同一套场景下的对比，全部使用模拟时间，不进入运行时：
+//   spread <max_live>   到期时间均匀分布在 4 小时内，经过多层级联
+//   near   <max_live>   到期时间分布在 1~30 秒，IO 超时的典型分布
+//   same   <max_live>   全部落在同一个到期时间（同一个槽位）
+//   hover  <cycles>     在途定时器数在 0 和 1 之间来回：挂入一个、查询下一个到期时间、到期，
+//                       对应低负载 worker 每次休眠前的开销
+// 前三种从 1k 开始每次乘 10 直到 max_live（默认 1M，10M 需要约 1GB 内存），每一档输出
+// 挂入、取消、按时间推进到期、查询下一个到期时间的单次开销（ns/op）
+namespace {
+
+using faio::runtime::detail::timer::Timer;
+using faio::runtime::detail::timer::TimerTask;
+using Clock = std::chrono::steady_clock;
+
+// 统计到期任务数的队列
+struct CountingQueue {
+  std::size_t fired{0};
+  void push_back(std::coroutine_handle<>, CountingQueue &) { ++fired; }
+};
+
+// 时间轮，每个定时器一个嵌入的节点
+class WheelTimers {
+public:
+  static constexpr std::string_view name = "wheel";
+
+  explicit WheelTimers(std::size_t capacity) : _tasks(capacity) {}
+
+  void insert(std::size_t id, Clock::time_point deadline) {
+    _tasks[id] = TimerTask{deadline, std::noop_coroutine()};
+    _timer.add_task(&_tasks[id]);
+  }
+
+  void cancel(std::size_t id) { _timer.remove_task(&_tasks[id]); }
+
+  auto expire(Clock::time_point now) -> std::size_t {
+    return _timer.poll_at(now, _queue, _queue);
+  }
+
+  auto next_deadline() const -> std::optional<Clock::time_point> {
+    return _timer.next_deadline();
+  }
+
+  auto size() const -> std::size_t { return _timer.num_entries(); }
+
+private:
+  Timer _timer;
+  CountingQueue _queue;
+  std::vector<TimerTask> _tasks;
+};
+
+// 4 叉最小堆，按截止时间排序；记录每个定时器在堆中的位置，取消为 O(log n)
+class QuaternaryHeapTimers {
+public:
+  static constexpr std::string_view name = "4-heap";
+
+  explicit QuaternaryHeapTimers(std::size_t capacity) : _position(capacity, npos) {
+    _heap.reserve(capacity);
+  }
+
+  void insert(std::size_t id, Clock::time_point deadline) {
+    _heap.push_back(Entry{deadline, id});
+    _position[id] = _heap.size() - 1;
+    sift_up(_heap.size() - 1);
+  }
+
+  void cancel(std::size_t id) {
+    auto index = _position[id];
+    if (index == npos) {
+      return;
+    }
+    _position[id] = npos;
+    auto last = _heap.back();
+    _heap.pop_back();
+    if (index == _heap.size()) {
+      return;
+    }
+    _heap[index] = last;
+    _position[last.id] = index;
+    sift_down(index);
+    sift_up(index);
+  }
+
+  auto expire(Clock::time_point now) -> std::size_t {
+    std::size_t count = 0;
+    while (!_heap.empty() && _heap.front().deadline <= now) {
+      _position[_heap.front().id] = npos;
+      auto last = _heap.back();
+      _heap.pop_back();
+      if (!_heap.empty()) {
+        _heap.front() = last;
+        _position[last.id] = 0;
+        sift_down(0);
+      }
+      ++count;
+    }
+    return count;
+  }
+
+  auto next_deadline() const -> std::optional<Clock::time_point> {
+    if (_heap.empty()) {
+      return std::nullopt;
+    }
+    return _heap.front().deadline;
+  }
+
+  auto size() const -> std::size_t { return _heap.size(); }
+
+private:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  struct Entry {
+    Clock::time_point deadline;
+    std::size_t id;
+  };
+
+  void place(std::size_t index, Entry entry) {
+    _heap[index] = entry;
+    _position[entry.id] = index;
+  }
+
+  void sift_up(std::size_t index) {
+    auto entry = _heap[index];
+    while (index > 0) {
+      auto parent = (index - 1) / 4;
+      if (_heap[parent].deadline <= entry.deadline) {
+        break;
+      }
+      place(index, _heap[parent]);
+      index = parent;
+    }
+    place(index, entry);
+  }
+
+  void sift_down(std::size_t index) {
+    auto entry = _heap[index];
+    while (true) {
+      auto first = index * 4 + 1;
+      if (first >= _heap.size()) {
+        break;
+      }
+      auto last = std::min(first + 4, _heap.size());
+      auto smallest = first;
+      for (auto child = first + 1; child < last; ++child) {
+        if (_heap[child].deadline < _heap[smallest].deadline) {
+          smallest = child;
+        }
+      }
+      if (entry.deadline <= _heap[smallest].deadline) {
+        break;
+      }
+      place(index, _heap[smallest]);
+      index = smallest;
+    }
+    place(index, entry);
+  }
+
+  std::vector<Entry> _heap;
+  std::vector<std::size_t> _position;
+};
+
+enum class Distribution { Spread, Near, Same };
+
+// 第 i 个定时器相对起点的到期时间
+auto offset_of(Distribution distribution, std::size_t i) -> std::chrono::milliseconds {
+  constexpr std::uint64_t four_hours = 4ull * 3600 * 1000;
+  switch (distribution) {
+  case Distribution::Spread:
+    return std::chrono::milliseconds(1 + (i * 0x9E3779B97F4A7C15ull >> 16) % four_hours);
+  case Distribution::Near:
+    return std::chrono::milliseconds(1000 + (i * 7919) % 29000);
+  case Distribution::Same:
+    return std::chrono::milliseconds(5000);
+  }
+  return {};
+}
+
+auto per_op(Clock::duration elapsed, std::size_t ops) -> double {
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         static_cast<double>(std::max<std::size_t>(ops, 1));
+}
+
+template <typename Timers>
+void run_scenario(Distribution distribution, std::size_t live) {
+  Timers timers{live};
+  const auto base = Clock::now();
+  auto horizon = std::chrono::milliseconds{0};
+
+  // 挂入
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < live; ++i) {
+    auto offset = offset_of(distribution, i);
+    horizon = std::max(horizon, offset);
+    timers.insert(i, base + offset);
+  }
+  const auto insert = Clock::now() - start;
+
+  // 查询下一个到期时间，每次休眠前都会调用
+  constexpr std::size_t queries = 100000;
+  std::size_t found = 0;
+  start = Clock::now();
+  for (std::size_t i = 0; i < queries; ++i) {
+    found += timers.next_deadline().has_value() ? 1 : 0;
+    // 阻止编译器把不变的查询提出循环
+    asm volatile("" ::: "memory");
+  }
+  const auto next = Clock::now() - start;
+
+  // 取消一半（IO 先完成），剩下的按时间推进到期
+  start = Clock::now();
+  for (std::size_t i = 0; i < live; i += 2) {
+    timers.cancel(i);
+  }
+  const auto cancel = Clock::now() - start;
+  const auto cancelled = (live + 1) / 2;
+
+  // 分 1000 步推进到最晚的到期时间，高层槽位到期时级联
+  constexpr std::size_t steps = 1000;
+  std::size_t expired = 0;
+  start = Clock::now();
+  for (std::size_t step = 1; step <= steps; ++step) {
+    expired += timers.expire(base + horizon * step / steps + std::chrono::milliseconds(1));
+  }
+  const auto expire = Clock::now() - start;
+
+  fastlog::console.info("{:>6} live={:>8}: insert {:7.1f}ns, cancel {:7.1f}ns, expire {:7.1f}ns, "
+                        "next_deadline {:7.1f}ns (expired {}, left {}, found {})",
+                        Timers::name, live, per_op(insert, live), per_op(cancel, cancelled),
+                        per_op(expire, expired), per_op(next, queries), expired, timers.size(),
+                        found);
+}
+
+// 在途定时器数在 0 和 1 之间来回，模拟时间每轮前进 1ms
+template <typename Timers>
+void run_hover(std::size_t cycles) {
+  Timers timers{1};
+  auto now = Clock::now();
+  std::size_t fired = 0;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < cycles; ++i) {
+    timers.insert(0, now + std::chrono::milliseconds(1));
+    if (auto deadline = timers.next_deadline(); deadline) {
+      now = std::max(now + std::chrono::milliseconds(1), *deadline);
+    }
+    fired += timers.expire(now);
+  }
+  fastlog::console.info("{:>6} hover: {} cycles, {:.1f}ns/cycle (fired {})", Timers::name,
+                        cycles, per_op(Clock::now() - start, cycles), fired);
+}
+
+template <typename Timers>
+void run_distribution(Distribution distribution, std::size_t max_live) {
+  for (std::size_t live = 1000; live <= max_live; live *= 10) {
+    run_scenario<Timers>(distribution, live);
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+  const std::string_view mode{argc > 1 ? argv[1] : "spread"};
+  const auto count =
+      argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 1000000uz;
+  if (mode == "hover") {
+    run_hover<WheelTimers>(count);
+    run_hover<QuaternaryHeapTimers>(count);
+    return 0;
+  }
+  std::optional<Distribution> distribution;
+  if (mode == "spread") {
+    distribution = Distribution::Spread;
+  } else if (mode == "near") {
+    distribution = Distribution::Near;
+  } else if (mode == "same") {
+    distribution = Distribution::Same;
+  }
+  if (!distribution) {
+    fastlog::console.error("usage: {} spread|near|same [max_live] | hover [cycles]", argv[0]);
+    return 1;
+  }
+  run_distribution<WheelTimers>(*distribution, count);
+  run_distribution<QuaternaryHeapTimers>(*distribution, count);
+  return 0;
+}
@@ -0,0 +1,195 @@
+#include "faio/faio.hpp"
+#include "fastlog/fastlog.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <vector>
+
+// 回环上的 UDP 包速率，三种模式：
+//   single     逐包 send_to / recv_from
+//   batch      GSO/GRO 批量 send_batch / recv_batch
+//   multishot  逐包 send_to，接收端使用 recv_stream（multishot recvmsg + 缓冲区环）
+// 同时输出每个包平均的 io_uring 系统调用次数和 CQE 数
+namespace {
+
+enum class Mode { Single, Batch, Multishot };
+
+struct UdpBenchmarkConfig {
+  std::size_t seconds = 10;       // 运行时间
+  std::size_t payload = 64;       // 每个包的负载
+  std::size_t senders = 2;        // 发送协程数
+  std::size_t batch = 64;         // 每次 send_batch 的包数
+  Mode mode = Mode::Batch;        // 收发接口
+};
+
+auto mode_name(Mode mode) -> std::string_view {
+  switch (mode) {
+  case Mode::Single:
+    return "single";
+  case Mode::Batch:
+    return "batch";
+  case Mode::Multishot:
+    return "multishot";
+  }
+  return "unknown";
+}
+
+std::atomic<uint64_t> g_sent{0};
+std::atomic<uint64_t> g_received{0};
+
+auto sender(faio::net::address target, const UdpBenchmarkConfig &config,
+            std::chrono::steady_clock::time_point deadline) -> faio::task<void> {
+  auto socket = faio::net::UdpDatagram::bind(faio::net::address::parse("127.0.0.1", 0).value());
+  if (!socket) {
+    fastlog::console.error("bind sender failed: {}", socket.error().message());
+    co_return;
+  }
+  std::string payload(config.payload, 'u');
+  std::vector<faio::net::datagram> datagrams(config.batch,
+                                             faio::net::datagram{payload, target});
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (config.mode == Mode::Batch) {
+      auto sent = co_await socket.value().send_batch(datagrams);
+      if (!sent) {
+        fastlog::console.error("send_batch failed: {}", sent.error().message());
+        co_return;
+      }
+      g_sent.fetch_add(sent.value(), std::memory_order_relaxed);
+    } else {
+      auto sent = co_await socket.value().send_to(payload, target);
+      if (!sent) {
+        fastlog::console.error("send_to failed: {}", sent.error().message());
+        co_return;
+      }
+      g_sent.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+auto receiver(faio::net::UdpDatagram &socket, const UdpBenchmarkConfig &config,
+              std::chrono::steady_clock::time_point deadline) -> faio::task<void> {
+  std::vector<char> buf(64 * 1024);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (config.mode == Mode::Batch) {
+      auto batch = co_await faio::time::timeout(socket.recv_batch(buf),
+                                                std::chrono::milliseconds(100));
+      if (batch) {
+        g_received.fetch_add(batch.value().size(), std::memory_order_relaxed);
+      }
+    } else {
+      auto res = co_await faio::time::timeout(socket.recv_from(buf),
+                                              std::chrono::milliseconds(100));
+      if (res) {
+        g_received.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+// multishot 的 next() 没有超时，结束后由 stop_receiver 发一个空包唤醒
+auto stream_receiver(faio::net::UdpDatagram &socket,
+                     std::chrono::steady_clock::time_point deadline) -> faio::task<void> {
+  auto stream = socket.recv_stream({.buffer_size = 2048, .buffer_count = 4096});
+  if (!stream) {
+    fastlog::console.error("recv_stream failed: {}", stream.error().message());
+    co_return;
+  }
+  while (std::chrono::steady_clock::now() < deadline) {
+    auto packet = co_await stream.value().next();
+    if (!packet) {
+      fastlog::console.error("next failed: {}", packet.error().message());
+      co_return;
+    }
+    if (!packet.value().data.empty()) {
+      g_received.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  auto stats = stream.value().stats();
+  fastlog::console.info("recv_stream: truncated: {}, socket overflow: {}, rearmed: {}",
+                        stats.truncated, stats.dropped, stats.rearmed);
+}
+
+auto stop_receiver(faio::net::address target, std::chrono::steady_clock::time_point deadline)
+    -> faio::task<void> {
+  co_await faio::time::sleep_until(deadline + std::chrono::milliseconds(10));
+  auto socket = faio::net::UdpDatagram::bind(faio::net::address::parse("127.0.0.1", 0).value());
+  if (socket) {
+    co_await socket.value().send_to(std::span<const char>{}, target);
+  }
+}
+
+auto run_benchmark(const faio::runtime_context &ctx, const UdpBenchmarkConfig config)
+    -> faio::task<int> {
+  auto socket = faio::net::UdpDatagram::bind(faio::net::address::parse("127.0.0.1", 0).value());
+  if (!socket) {
+    fastlog::console.error("bind receiver failed: {}", socket.error().message());
+    co_return 1;
+  }
+  // 放大接收缓冲区，减少突发时的丢包
+  const int rcvbuf = 16 << 20;
+  (void)::setsockopt(socket.value().fd(), SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  auto target = socket.value().local_addr().value();
+
+  const auto before = ctx.metrics();
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + std::chrono::seconds(config.seconds);
+  for (std::size_t i = 0; i < config.senders; ++i) {
+    faio::spawn(sender(target, config, deadline));
+  }
+  if (config.mode == Mode::Multishot) {
+    faio::spawn(stop_receiver(target, deadline));
+    co_await stream_receiver(socket.value(), deadline);
+  } else {
+    co_await receiver(socket.value(), config, deadline);
+  }
+  const auto secs =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const auto after = ctx.metrics();
+
+  const auto sent = g_sent.load(std::memory_order_relaxed);
+  const auto received = g_received.load(std::memory_order_relaxed);
+  const auto packets = static_cast<double>(std::max<uint64_t>(sent + received, 1));
+  fastlog::console.info("mode={}, payload={}B, senders={}, batch={}", mode_name(config.mode),
+                        config.payload, config.senders, config.batch);
+  fastlog::console.info("sent: {:.0f} pps, received: {:.0f} pps, dropped: {}",
+                        static_cast<double>(sent) / secs, static_cast<double>(received) / secs,
+                        sent > received ? sent - received : 0);
+  fastlog::console.info("syscalls/packet: {:.4f}, cqes/packet: {:.4f}",
+                        static_cast<double>(after.syscalls() - before.syscalls()) / packets,
+                        static_cast<double>(after.completed_cqes - before.completed_cqes) /
+                            packets);
+  co_return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  fastlog::set_consolelog_level(fastlog::LogLevel::Info);
+
+  UdpBenchmarkConfig config;
+  if (argc > 1) {
+    const std::string_view mode{argv[1]};
+    config.mode = mode == "single"      ? Mode::Single
+                  : mode == "multishot" ? Mode::Multishot
+                                        : Mode::Batch;
+  }
+  if (argc > 2) {
+    config.seconds = static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10));
+  }
+  if (argc > 3) {
+    config.payload = static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10));
+  }
+  if (argc > 4) {
+    config.senders = static_cast<std::size_t>(std::strtoull(argv[4], nullptr, 10));
+  }
+  if (argc > 5) {
+    config.batch = static_cast<std::size_t>(std::strtoull(argv[5], nullptr, 10));
+  }
+
+  faio::runtime_context ctx;
+  return faio::block_on(ctx, run_benchmark(ctx, config));
+}
@@ -3,9 +3,34 @@
 
 // ============================================================================
 // 示例: UDP echo server
-// 绑定端口后循环 recv_from / send_to，将收到的内容回显给对端。
+// 绑定端口后通过 recv_stream（multishot recvmsg）持续接收，将收到的内容回显给对端；
+// 内核不支持时退化为 recv_from / send_to 循环。
 // ============================================================================
 
+// 内核不支持缓冲区环时的逐包接收
+faio::task<void> recv_from_loop(faio::net::UdpDatagram &socket) {
+  char buf[1024];
+  while (true) {
+    auto result = co_await socket.recv_from(buf);
+    if (!result) {
+      fastlog::console.error("  recv_from failed: {}",
+                             result.error().message());
+      break;
+    }
+
+    auto &[len, peer_addr] = result.value();
+    fastlog::console.info("  received {} bytes from {}: {}", len, peer_addr,
+                          std::string_view{buf, len});
+
+    auto send_result = co_await socket.send_to({buf, len}, peer_addr);
+    if (!send_result) {
+      fastlog::console.error("  send_to failed: {}",
+                             send_result.error().message());
+      break;
+    }
+  }
+}
+
 faio::task<void> server(uint16_t port) {
   auto addr = faio::net::address::parse("0.0.0.0", port);
   if (!addr) {
@@ -21,28 +46,40 @@ faio::task<void> server(uint16_t port) {
 
   fastlog::console.info("  udp echo server listening on 0.0.0.0:{}", port);
   auto socket = std::move(has_socket.value());
-  char buf[1024];
+
+  // multishot recvmsg：一次提交持续接收，内核从缓冲区环中挑选缓冲区
+  auto stream = socket.recv_stream();
+  if (!stream) {
+    fastlog::console.warn("  recv_stream unavailable ({}), fallback to recv_from",
+                          stream.error().message());
+    co_await recv_from_loop(socket);
+    co_return;
+  }
 
   while (true) {
-    auto result = co_await socket.recv_from(buf);
-    if (!result) {
-      fastlog::console.error("  recv_from failed: {}",
-                             result.error().message());
+    auto packet = co_await stream.value().next();
+    if (!packet) {
+      fastlog::console.error("  recv failed: {}", packet.error().message());
       break;
     }
 
-    auto &[len, peer_addr] = result.value();
-    buf[len] = '\0';
-    fastlog::console.info("  received {} bytes from {}: {}", len, peer_addr,
-                          buf);
+    auto &[data, peer_addr, truncated] = packet.value();
+    fastlog::console.info("  received {} bytes from {}{}: {}", data.size(), peer_addr,
+                          truncated ? " (truncated)" : "",
+                          std::string_view{data.data(), data.size()});
 
-    auto send_result = co_await socket.send_to({buf, len}, peer_addr);
+    // data 在下一次 next() 之前有效，可以直接发送
+    auto send_result = co_await socket.send_to(data, peer_addr);
     if (!send_result) {
       fastlog::console.error("  send_to failed: {}",
                              send_result.error().message());
       break;
     }
   }
+
+  auto stats = stream.value().stats();
+  fastlog::console.info("  received: {}, truncated: {}, dropped: {}", stats.received,
+                        stats.truncated, stats.dropped);
 }
 
 int main() {
@@ -23,6 +23,10 @@ public:
     PassedTime,
     InvalidSocketType,
     ReuniteFailed,
+    TimedOut,
+    FullChannel,
+    EmptyChannel,
+    Lagged,
     // HTTP/2 errors
     Http2Protocol = 2000,
     Http2ExpectedPreface,  // 客户端未发 HTTP/2 连接前言（例如浏览器发的是 HTTP/1.1）
@@ -67,6 +71,14 @@ public:
       return "Invalid socket type";
     case ReuniteFailed:
       return "Tried to reunite halves that are not from the same socket";
+    case TimedOut:
+      return "Operation timed out";
+    case FullChannel:
+      return "Channel is full";
+    case EmptyChannel:
+      return "Channel is empty";
+    case Lagged:
+      return "Receiver lagged behind and missed values";
     case Http2Protocol:
       return "HTTP/2 protocol error";
     case Http2ExpectedPreface:
@@ -47,6 +47,10 @@ task1的awaiter描述的是task2的挂起逻辑和恢复逻辑
 
 */
 
+namespace faio::time::detail {
+class CancelToken;
+}
+
 namespace faio {
 template <typename T> class task;
 
@@ -110,6 +114,8 @@ struct base_task_promise {
   std::coroutine_handle<> _caller{nullptr}; // 调用者协程句柄
 
   std::exception_ptr _exception{nullptr}; // 异常
+
+  time::detail::CancelToken *_cancel_token{nullptr}; // 取消令牌，见 time::timeout
 };
 
 // 继承base_task_promise,实现返回值相关处理
@@ -268,10 +274,16 @@ private:
 
     // 协程挂起逻辑
     //  如果此接口调用者自身还有调用者，则设置调用者为协程的调用者,并返回协程句柄
+    //  子任务继承调用者的取消令牌（见 time::timeout），已经有令牌时保留自己的
     template <typename promisetype>
     std::coroutine_handle<>
     await_suspend(std::coroutine_handle<promisetype> caller) const noexcept {
       _callee.promise()._caller = caller;
+      if constexpr (std::is_base_of_v<detail::base_task_promise, promisetype>) {
+        if (_callee.promise()._cancel_token == nullptr) {
+          _callee.promise()._cancel_token = caller.promise()._cancel_token;
+        }
+      }
       return _callee;
     }
   };
@@ -0,0 +1,11 @@
+#ifndef FAIO_DETAIL_FS_HPP
+#define FAIO_DETAIL_FS_HPP
+#include "faio/detail/fs/fs.hpp"
+
+namespace faio::fs {
+using File = detail::File;
+using Metadata = detail::Metadata;
+using AlignedBuffer = detail::AlignedBuffer;
+} // namespace faio::fs
+
+#endif // FAIO_DETAIL_FS_HPP
@@ -0,0 +1,74 @@
+#ifndef FAIO_DETAIL_FS_ALIGNED_BUFFER_HPP
+#define FAIO_DETAIL_FS_ALIGNED_BUFFER_HPP
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace faio::fs::detail {
+
+// 按指定边界对齐的缓冲区，满足 O_DIRECT 对内存地址和长度的要求
+// 大小向上取整到对齐边界的整数倍
+class AlignedBuffer {
+public:
+  static constexpr std::size_t DEFAULT_ALIGNMENT{4096uz};
+
+  AlignedBuffer() = default;
+
+  explicit AlignedBuffer(std::size_t size,
+                         std::size_t alignment = DEFAULT_ALIGNMENT)
+      : _size((size + alignment - 1) / alignment * alignment),
+        _alignment(alignment) {
+    if (_size > 0) {
+      _data = static_cast<char *>(
+          ::operator new(_size, std::align_val_t{_alignment}));
+    }
+  }
+
+  ~AlignedBuffer() { release(); }
+
+  AlignedBuffer(const AlignedBuffer &) = delete;
+  AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+  AlignedBuffer(AlignedBuffer &&other) noexcept
+      : _data(std::exchange(other._data, nullptr)),
+        _size(std::exchange(other._size, 0)), _alignment(other._alignment) {}
+
+  AlignedBuffer &operator=(AlignedBuffer &&other) noexcept {
+    if (this != &other) {
+      release();
+      _data = std::exchange(other._data, nullptr);
+      _size = std::exchange(other._size, 0);
+      _alignment = other._alignment;
+    }
+    return *this;
+  }
+
+public:
+  [[nodiscard]] char *data() noexcept { return _data; }
+  [[nodiscard]] const char *data() const noexcept { return _data; }
+  [[nodiscard]] std::size_t size() const noexcept { return _size; }
+  [[nodiscard]] std::size_t alignment() const noexcept { return _alignment; }
+  [[nodiscard]] std::span<char> span() noexcept { return {_data, _size}; }
+  [[nodiscard]] std::span<const char> span() const noexcept {
+    return {_data, _size};
+  }
+
+private:
+  void release() noexcept {
+    if (_data != nullptr) {
+      ::operator delete(_data, std::align_val_t{_alignment});
+      _data = nullptr;
+    }
+  }
+
+private:
+  char *_data{nullptr};                      // 缓冲区
+  std::size_t _size{0};                      // 对齐后的大小
+  std::size_t _alignment{DEFAULT_ALIGNMENT}; // 对齐边界
+};
+
+} // namespace faio::fs::detail
+
+#endif // FAIO_DETAIL_FS_ALIGNED_BUFFER_HPP
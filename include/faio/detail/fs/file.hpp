@@ -0,0 +1,177 @@
+#ifndef FAIO_DETAIL_FS_FILE_HPP
+#define FAIO_DETAIL_FS_FILE_HPP
+
+#include "faio/detail/coroutine/task.hpp"
+#include "faio/detail/fs/metadata.hpp"
+#include "faio/detail/io/io.hpp"
+#include <fcntl.h>
+#include <span>
+#include <string>
+#include <unistd.h>
+
+namespace faio::fs::detail {
+
+// 异步文件
+// 所有读写都带显式偏移（pread/pwrite 语义），同一个文件可以被多个协程并发读写；
+// 析构时异步关闭，需要关注关闭结果时显式 co_await close()
+class File : public io::detail::FileDescriptor {
+public:
+  explicit File(int fd) : FileDescriptor{fd} {}
+
+public:
+  /// 打开文件，flags 会自动加上 O_CLOEXEC
+  [[nodiscard]]
+  static auto open(const char *path, int flags = O_RDONLY, mode_t mode = 0) {
+    class OpenFile : public io::detail::IORegistrantAwaiter<OpenFile> {
+    private:
+      using Base = io::detail::IORegistrantAwaiter<OpenFile>;
+
+    public:
+      OpenFile(const char *path, int flags, mode_t mode)
+          : Base{io_uring_prep_openat, AT_FDCWD, path, flags | O_CLOEXEC,
+                 mode} {}
+
+      auto await_resume() const noexcept -> expected<File> {
+        if (this->_user_data.result >= 0) [[likely]] {
+          return File{this->_user_data.result};
+        } else {
+          return ::std::unexpected{make_error(-this->_user_data.result)};
+        }
+      }
+    };
+    return OpenFile{path, flags, mode};
+  }
+
+  /// 以只写方式创建文件，已存在时截断
+  [[nodiscard]]
+  static auto create(const char *path, mode_t mode = 0644) {
+    return open(path, O_WRONLY | O_CREAT | O_TRUNC, mode);
+  }
+
+public:
+  /// 从offset处读取，返回读到的字节数，0表示EOF
+  auto read_at(std::span<char> buf, std::uint64_t offset) noexcept {
+    return io::detail::Read{_fd, buf.data(), buf.size_bytes(), offset};
+  }
+
+  /// 从offset处读取到注册缓冲区
+  auto read_at(io::FixedBuffer &buf, std::uint64_t offset) noexcept {
+    return io::detail::ReadFixed{_fd, buf, buf.size(), offset};
+  }
+
+  /// 在offset处写入，返回写入的字节数
+  auto write_at(std::span<const char> buf, std::uint64_t offset) noexcept {
+    return io::detail::Write{_fd, buf.data(),
+                             static_cast<unsigned>(buf.size_bytes()), offset};
+  }
+
+  /// 从注册缓冲区在offset处写入len个字节
+  auto write_at(const io::FixedBuffer &buf, std::size_t len,
+                std::uint64_t offset) noexcept {
+    return io::detail::WriteFixed{_fd, buf, len, offset};
+  }
+
+  /// 从offset处读满buf，文件提前结束时返回 UnexpectedEOF
+  task<expected<void>> read_exact_at(std::span<char> buf,
+                                     std::uint64_t offset) noexcept {
+    while (!buf.empty()) {
+      auto res = co_await this->read_at(buf, offset);
+      if (!res) {
+        co_return std::unexpected{std::move(res.error())};
+      }
+      if (res.value() == 0) {
+        co_return std::unexpected{Error{Error::UnexpectedEOF}};
+      }
+      buf = buf.subspan(res.value());
+      offset += res.value();
+    }
+    co_return expected<void>{};
+  }
+
+  /// 在offset处写完buf
+  task<expected<void>> write_all_at(std::span<const char> buf,
+                                    std::uint64_t offset) noexcept {
+    while (!buf.empty()) {
+      auto res = co_await this->write_at(buf, offset);
+      if (!res) {
+        co_return std::unexpected{std::move(res.error())};
+      }
+      if (res.value() == 0) {
+        co_return std::unexpected{Error{Error::WriteZero}};
+      }
+      buf = buf.subspan(res.value());
+      offset += res.value();
+    }
+    co_return expected<void>{};
+  }
+
+  /// 读取整个文件，先用 statx 取得大小一次分配好，再读到EOF（文件可能在读取时增长）
+  task<expected<std::string>> read_to_end() noexcept {
+    auto meta = co_await this->metadata(STATX_SIZE);
+    if (!meta) {
+      co_return std::unexpected{std::move(meta.error())};
+    }
+    std::string buf;
+    // 多留一个字节，一次读就能确认EOF
+    buf.resize(static_cast<std::size_t>(meta.value().size()) + 1);
+    auto len = 0uz;
+    while (true) {
+      if (len == buf.size()) {
+        buf.resize(buf.size() * 2);
+      }
+      auto res = co_await this->read_at(
+          std::span<char>{buf.data() + len, buf.size() - len}, len);
+      if (!res) {
+        co_return std::unexpected{std::move(res.error())};
+      }
+      if (res.value() == 0) {
+        break;
+      }
+      len += res.value();
+    }
+    buf.resize(len);
+    co_return buf;
+  }
+
+  /// 查询文件元数据
+  [[nodiscard]]
+  auto metadata(unsigned mask = METADATA_MASK) noexcept -> MetadataAwaiter {
+    return MetadataAwaiter{_fd, "", AT_EMPTY_PATH, mask};
+  }
+
+  /// 预分配磁盘空间，mode 为0时会扩展文件大小
+  auto allocate(std::uint64_t offset, std::uint64_t len,
+                int mode = 0) noexcept {
+    return io::detail::Fallocate{_fd, mode, offset, len};
+  }
+
+  /// 截断或扩展文件到len字节
+  /// IORING_OP_FTRUNCATE 需要 6.9 以上内核，旧内核上退化为同步 ftruncate
+  task<expected<void>> set_len(std::uint64_t len) noexcept {
+    auto res = co_await io::detail::Ftruncate{_fd, static_cast<loff_t>(len)};
+    if (res || res.error().value() != EINVAL) {
+      co_return res;
+    }
+    if (::ftruncate(_fd, static_cast<off_t>(len)) == -1) [[unlikely]] {
+      co_return std::unexpected{make_error(errno)};
+    }
+    co_return expected<void>{};
+  }
+
+  /// 数据和元数据落盘
+  auto sync_all() noexcept { return io::detail::Fsync{_fd, 0}; }
+
+  /// 只保证数据落盘（fdatasync）
+  auto sync_data() noexcept {
+    return io::detail::Fsync{_fd, IORING_FSYNC_DATASYNC};
+  }
+
+  /// 给内核访问模式提示，如 POSIX_FADV_SEQUENTIAL、POSIX_FADV_DONTNEED
+  auto advise(std::uint64_t offset, std::uint32_t len, int advice) noexcept {
+    return io::detail::Fadvise{_fd, offset, len, advice};
+  }
+};
+
+} // namespace faio::fs::detail
+
+#endif // FAIO_DETAIL_FS_FILE_HPP
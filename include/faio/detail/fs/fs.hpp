@@ -0,0 +1,108 @@
+#ifndef FAIO_DETAIL_FS_FS_HPP
+#define FAIO_DETAIL_FS_FS_HPP
+
+#include "faio/detail/fs/aligned_buffer.hpp"
+#include "faio/detail/fs/file.hpp"
+#include <string>
+#include <string_view>
+
+namespace faio::fs {
+
+// 路径参数按值保存在协程帧中，调用方不需要保证字符串在 co_await 期间有效
+
+/// 读取整个文件：open + statx + read + 异步close
+static inline auto read(std::string path) -> task<expected<std::string>> {
+  auto file = co_await detail::File::open(path.c_str());
+  if (!file) {
+    co_return std::unexpected{std::move(file.error())};
+  }
+  co_return co_await file.value().read_to_end();
+}
+
+/// 读取不超过 max_size 字节的小文件
+/// open_direct + read + close_direct 链接成一条链，只需要一次提交、一次唤醒，
+/// 文件只进入当前 worker 的固定文件表，不占用进程的 fd；
+/// 文件比 max_size 大、固定文件表不可用或槽位耗尽时退化为 fs::read
+static inline auto read_small(std::string path, std::size_t max_size = 64 * 1024)
+    -> task<expected<std::string>> {
+  auto table = io::detail::current_uring->fixed_files();
+  auto slot = table != nullptr ? table->allocate() : -1;
+  if (slot < 0) {
+    co_return co_await read(std::move(path));
+  }
+  // 多读一个字节用于判断文件是否超过 max_size
+  std::string buf(max_size + 1, '\0');
+  auto index = static_cast<unsigned>(slot);
+  // 读操作使用硬链接：短读不会中断链，保证 close_direct 一定执行
+  // open 失败时后面两个操作以 -ECANCELED 完成，槽位没有被占用
+  auto [opened, nread, closed] = co_await io::chain(
+      io::open_direct(AT_FDCWD, path.c_str(), O_RDONLY, 0, index),
+      io::read(slot, buf.data(), buf.size(), 0)
+          .with_flags(IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK),
+      io::close_direct(index));
+  table->deallocate(slot);
+  if (!opened) {
+    co_return std::unexpected{std::move(opened.error())};
+  }
+  if (!nread) {
+    co_return std::unexpected{std::move(nread.error())};
+  }
+  if (nread.value() > max_size) {
+    co_return co_await fs::read(std::move(path));
+  }
+  buf.resize(nread.value());
+  co_return buf;
+}
+
+/// 创建或截断文件并写入全部数据
+static inline auto write(std::string path, std::string_view data)
+    -> task<expected<void>> {
+  auto file = co_await detail::File::create(path.c_str());
+  if (!file) {
+    co_return std::unexpected{std::move(file.error())};
+  }
+  auto res = co_await file.value().write_all_at(data, 0);
+  if (!res) {
+    co_return res;
+  }
+  co_return co_await file.value().close();
+}
+
+/// 查询路径的元数据，不跟随最后一级符号链接时 flags 传 AT_SYMLINK_NOFOLLOW
+static inline auto metadata(std::string path, int flags = 0)
+    -> task<expected<detail::Metadata>> {
+  co_return co_await detail::MetadataAwaiter{AT_FDCWD, path.c_str(), flags,
+                                             detail::METADATA_MASK};
+}
+
+/// 删除文件
+static inline auto remove_file(std::string path) -> task<expected<void>> {
+  co_return co_await io::detail::Unlink{path.c_str(), 0};
+}
+
+/// 删除空目录
+static inline auto remove_dir(std::string path) -> task<expected<void>> {
+  co_return co_await io::detail::Unlink{path.c_str(), AT_REMOVEDIR};
+}
+
+/// 重命名，目标存在时原子替换
+static inline auto rename(std::string from, std::string to)
+    -> task<expected<void>> {
+  co_return co_await io::detail::Rename{from.c_str(), to.c_str(), 0};
+}
+
+/// 给内核内存访问模式提示，如 MADV_SEQUENTIAL、MADV_WILLNEED
+static inline auto madvise(void *addr, std::uint32_t len, int advice) {
+  return io::detail::Madvise{addr, len, advice};
+}
+
+/// 分配满足 O_DIRECT 对齐要求的缓冲区，大小向上取整到 alignment 的整数倍
+/// alignment 可以取 File::metadata() 返回的 dio_mem_align()
+static inline auto aligned_buffer(std::size_t size,
+                                  std::size_t alignment = 4096) {
+  return detail::AlignedBuffer{size, alignment};
+}
+
+} // namespace faio::fs
+
+#endif // FAIO_DETAIL_FS_FS_HPP
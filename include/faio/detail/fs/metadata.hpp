@@ -0,0 +1,97 @@
+#ifndef FAIO_DETAIL_FS_METADATA_HPP
+#define FAIO_DETAIL_FS_METADATA_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+#include <chrono>
+#include <cstdint>
+#include <sys/stat.h>
+
+namespace faio::fs::detail {
+
+// 文件元数据，对 struct statx 的薄封装
+class Metadata {
+public:
+  Metadata() = default;
+  explicit Metadata(const struct statx &stx) : _stx{stx} {}
+
+public:
+  [[nodiscard]] std::uint64_t size() const noexcept { return _stx.stx_size; }
+  [[nodiscard]] bool is_file() const noexcept { return S_ISREG(_stx.stx_mode); }
+  [[nodiscard]] bool is_dir() const noexcept { return S_ISDIR(_stx.stx_mode); }
+  [[nodiscard]] bool is_symlink() const noexcept {
+    return S_ISLNK(_stx.stx_mode);
+  }
+  [[nodiscard]] mode_t permissions() const noexcept {
+    return _stx.stx_mode & 07777;
+  }
+  [[nodiscard]] std::uint32_t block_size() const noexcept {
+    return _stx.stx_blksize;
+  }
+
+  [[nodiscard]] auto modified() const noexcept
+      -> std::chrono::system_clock::time_point {
+    return std::chrono::system_clock::time_point{
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::seconds{_stx.stx_mtime.tv_sec} +
+            std::chrono::nanoseconds{_stx.stx_mtime.tv_nsec})};
+  }
+
+  /// O_DIRECT 要求的内存对齐，内核不支持 STATX_DIOALIGN 时返回0
+  [[nodiscard]] std::uint32_t dio_mem_align() const noexcept {
+#ifdef STATX_DIOALIGN
+    return (_stx.stx_mask & STATX_DIOALIGN) ? _stx.stx_dio_mem_align : 0;
+#else
+    return 0;
+#endif
+  }
+
+  /// O_DIRECT 要求的偏移和长度对齐，内核不支持 STATX_DIOALIGN 时返回0
+  [[nodiscard]] std::uint32_t dio_offset_align() const noexcept {
+#ifdef STATX_DIOALIGN
+    return (_stx.stx_mask & STATX_DIOALIGN) ? _stx.stx_dio_offset_align : 0;
+#else
+    return 0;
+#endif
+  }
+
+  [[nodiscard]] const struct statx &raw() const noexcept { return _stx; }
+
+private:
+  struct statx _stx{};
+};
+
+// statx 的 awaiter，结果转换成 Metadata
+class MetadataAwaiter : public io::detail::IORegistrantAwaiter<MetadataAwaiter> {
+private:
+  using Base = io::detail::IORegistrantAwaiter<MetadataAwaiter>;
+
+public:
+  MetadataAwaiter(int dfd, const char *path, int flags, unsigned mask)
+      : Base{io_uring_prep_statx, dfd, path, flags, mask, &_statx} {}
+
+  // 移动后重新指向自身的 statx 缓冲区
+  void rebind_sqe() noexcept { this->_sqe->off = reinterpret_cast<unsigned long long>(&_statx); }
+
+  auto await_resume() const noexcept -> expected<Metadata> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return Metadata{_statx};
+    } else {
+      return std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+
+private:
+  struct statx _statx{};
+};
+
+// 默认查询的字段，O_DIRECT 对齐信息在不支持的内核上会被忽略
+#ifdef STATX_DIOALIGN
+static inline constexpr unsigned METADATA_MASK{STATX_BASIC_STATS |
+                                               STATX_DIOALIGN};
+#else
+static inline constexpr unsigned METADATA_MASK{STATX_BASIC_STATS};
+#endif
+
+} // namespace faio::fs::detail
+
+#endif // FAIO_DETAIL_FS_METADATA_HPP
@@ -6,8 +6,12 @@
 #include "faio/detail/http/v1/server_session_v1.hpp"
 #include "faio/detail/http/v2/server_session_v2.hpp"
 #include "faio/detail/runtime/context.hpp"
+#include "faio/detail/sync/semaphore.hpp"
+#include "faio/detail/time/time.hpp"
 #include "fastlog/fastlog.hpp"
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
@@ -52,6 +56,30 @@ private:
 using HttpMiddleware =
     std::function<task<HttpMiddlewareResult>(const HttpRequest &)>;
 
+// 排队超出上限，或者在 time::timeout 中等许可时到了截止时间
+inline auto service_unavailable_response() -> HttpResponse {
+  return HttpResponseBuilder(503)
+      .header("content-type", "text/plain")
+      .body("Service Unavailable\n")
+      .build();
+}
+
+// 限制 handler 同时处理的请求数，超出的请求按到达顺序排队等待。
+// 用于单个路由：router.get("/upload", limit_concurrency(8, handler))
+// 路由器设置了 request_timeout 时排队时间计入处理时限，等到截止时间时整个请求返回 504
+inline auto limit_concurrency(std::size_t max_in_flight, HttpHandler handler)
+    -> HttpHandler {
+  auto limit = std::make_shared<sync::semaphore>(max_in_flight);
+  return [limit, handler = std::move(handler)](
+             const HttpRequest &req) -> task<HttpResponse> {
+    auto permit = co_await limit->acquire();
+    if (!permit) {
+      co_return service_unavailable_response();
+    }
+    co_return co_await handler(req);
+  };
+}
+
 // 轻量路由器：按 method + path 分发。
 //
 // 分发优先级：
@@ -60,6 +88,14 @@ using HttpMiddleware =
 // 3) 静态路由（any method + path）
 // 4) 动态路由（:id / *path）
 // 5) fallback
+//
+// 设置 request_timeout 后整个分发（含中间件）限定在截止时间内，
+// 超时时 handler 在途的 IO、sleep 以及对锁、信号量、通道的等待以 ECANCELED 返回，返回 504。
+// 504 在 handler 返回之后才发出：handler 需要把 ECANCELED 当作错误尽快结束，
+// 不等待、只做计算的 handler 会运行到结束。
+// 设置 limit_concurrency 后同时分发的请求数受限，超出的请求排队，
+// 排队时间不计入 request_timeout：排队本身没有时限，可以用 max_queued 限制排队的请求数，
+// 超出时直接返回 503
 class HttpRouter {
 public:
   static constexpr size_t kHttpMethodCount = 9;
@@ -139,7 +175,85 @@ public:
     return *this;
   }
 
+  // 每个请求的处理时限，0 表示不限时
+  auto request_timeout(std::chrono::nanoseconds timeout) -> HttpRouter & {
+    _request_timeout = timeout;
+    return *this;
+  }
+
+  // 同时分发的请求数上限，0 表示不限；
+  // max_queued 为等待许可的请求数上限，超出时返回 503，0 表示不限
+  auto limit_concurrency(std::size_t max_in_flight, std::size_t max_queued = 0)
+      -> HttpRouter & {
+    _concurrency_limit =
+        max_in_flight == 0
+            ? nullptr
+            : std::make_shared<ConcurrencyLimit>(max_in_flight, max_queued);
+    return *this;
+  }
+
   auto dispatch(const HttpRequest &req) const -> task<HttpResponse> {
+    if (_concurrency_limit) {
+      return dispatch_limited(req);
+    }
+    return dispatch_timed(req);
+  }
+
+private:
+  // 同时分发的请求数上限和排队的请求数
+  struct ConcurrencyLimit {
+    ConcurrencyLimit(std::size_t max_in_flight, std::size_t max_queued)
+        : permits{max_in_flight}, max_queued{max_queued} {}
+
+    sync::semaphore permits;
+    std::size_t max_queued;              // 0 表示不限
+    std::atomic<std::size_t> queued{0}; // 正在等待许可的请求数
+  };
+
+  // 拿到许可后再分发，响应返回时归还
+  // 先复制一份限制：等待许可期间路由器可能重新设置 limit_concurrency
+  auto dispatch_limited(const HttpRequest &req) const -> task<HttpResponse> {
+    auto limit = _concurrency_limit;
+    if (auto permit = limit->permits.try_acquire(); permit) {
+      co_return co_await dispatch_timed(req);
+    }
+    if (limit->max_queued != 0 &&
+        limit->queued.fetch_add(1, std::memory_order::relaxed) >= limit->max_queued) {
+      limit->queued.fetch_sub(1, std::memory_order::relaxed);
+      co_return service_unavailable_response();
+    }
+    auto permit = co_await limit->permits.acquire();
+    if (limit->max_queued != 0) {
+      limit->queued.fetch_sub(1, std::memory_order::relaxed);
+    }
+    // 调用者在 time::timeout 中等到了截止时间
+    if (!permit) {
+      co_return service_unavailable_response();
+    }
+    co_return co_await dispatch_timed(req);
+  }
+
+  auto dispatch_timed(const HttpRequest &req) const -> task<HttpResponse> {
+    if (_request_timeout.count() <= 0) {
+      return route(req);
+    }
+    return dispatch_with_timeout(req);
+  }
+
+  // 限时分发，超时返回 504；handler 总是运行到结束，504 不会早于它返回
+  auto dispatch_with_timeout(const HttpRequest &req) const
+      -> task<HttpResponse> {
+    auto response = co_await faio::time::timeout(_request_timeout, route(req));
+    if (response) {
+      co_return std::move(response.value());
+    }
+    co_return HttpResponseBuilder(504)
+        .header("content-type", "text/plain")
+        .body("Gateway Timeout\n")
+        .build();
+  }
+
+  auto route(const HttpRequest &req) const -> task<HttpResponse> {
     // 快路径：无中间件、无动态路由、无错误处理器时，直接静态分发。
     if (_middlewares.empty() && _dynamic_routes.empty() && !_error_handler) {
       auto clean_path = strip_query(req.path());
@@ -473,6 +587,8 @@ private:
   std::vector<HttpMiddleware> _middlewares;  // 中间件
   HttpHandler _fallback_handler;             // 兜底路由
   HttpErrorHandler _error_handler;           // 错误处理器
+  std::chrono::nanoseconds _request_timeout{0}; // 每个请求的处理时限
+  std::shared_ptr<ConcurrencyLimit> _concurrency_limit; // 同时分发的请求数上限
 };
 
 // 对外的 HTTP 服务端接口。
@@ -203,6 +203,8 @@ private:
       return "Method Not Allowed";
     case 500:
       return "Internal Server Error";
+    case 504:
+      return "Gateway Timeout";
     default:
       return "";
     }
@@ -338,88 +340,17 @@ private:
 
     _header_block_buf.append("\r\n");
 
-    // 如果响应体为空，则直接写入头块缓冲区
-    if (resp.body().empty()) {
-      auto write_res = co_await _stream.write_all(std::span<const char>(
-          _header_block_buf.data(), _header_block_buf.size()));
-      if (!write_res) {
-        co_return std::unexpected(write_res.error());
-      }
-      co_return expected<void>();
-    }
-
-    // 当前头块缓冲区指针位置
-    const char *header_pos = _header_block_buf.data();
-    // 当前头块缓冲区剩余大小
-    std::size_t header_to_write = _header_block_buf.size();
-
-    // 当前响应体指针位置
-    const char *body_pos = reinterpret_cast<const char *>(resp.body().data());
-    std::size_t body_to_write = resp.body().size();
-
-    // 循环写入头块缓冲区和响应体
-    while (header_to_write > 0 || body_to_write > 0) {
-      // 头块缓冲区span
-      std::span<const char> header_span(
-          header_pos, header_to_write > 0 ? header_to_write : 0);
-      // 响应体span
-      std::span<const char> body_span(body_pos,
-                                      body_to_write > 0 ? body_to_write : 0);
-
-      // 写入头块缓冲区和响应体
-      auto write_res = co_await _stream.write_v(header_span, body_span);
-      // 如果写入失败，则返回错误
-      if (!write_res) {
-        co_return std::unexpected(write_res.error());
-      }
-      // 写入的字节数
-      auto written = write_res.value();
-      // 如果写入的字节数为0，则返回错误
-      if (written == 0) {
-        co_return std::unexpected(make_error(Error::WriteZero));
-      }
-
-      // 以下部分都是在通过更新头部缓冲区和body的指针来控制合并写入的优先级
-
-      // 如果头部缓冲区还有剩余，先满足头部缓冲区数据的发送
-      if (header_to_write > 0) {
-        // 如果socket发送成功的字节数大于等于现在头部缓冲区需要写入的所有数据
-        // 说明头部缓冲区一次性发送成功，
-        if (written >= header_to_write) {
-          // 写入的字节数减去头部缓冲区需要写入的所有数据
-          written -= header_to_write;
-          // 头部缓冲区指针位置加上头部缓冲区需要写入的所有数据
-          header_pos += header_to_write;
-          // 头部缓冲区需要写入大小为0
-          header_to_write = 0;
-        } else {
-          // 否则，如果头部没一次性发送完成
-          // 头部缓冲区指针位置加上socket发送成功的字节数
-          header_pos += written;
-          // 头部缓冲区需要写入大小减去socket发送成功的字节数
-          header_to_write -= written;
-          // 写入的字节数为0
-          written = 0;
-        }
-      }
-
-      // 如果响应体还有剩余并且socket发送成功的字节数大于0，剩下的再给body
-      if (written > 0 && body_to_write > 0) {
-        // 如果socket发送成功的字节数大于等于现在响应体需要写入的所有数据
-        // 说明响应体一次性发送成功
-        if (written >= body_to_write) {
-          // 响应体指针位置加上响应体需要写入的所有数据
-          body_pos += body_to_write;
-          // 响应体需要写入大小为0
-          body_to_write = 0;
-        } else {
-          // 否则，如果响应体没一次性发送完成
-          // 响应体指针位置加上socket发送成功的字节数
-          body_pos += written;
-          // 响应体需要写入大小减去socket发送成功的字节数
-          body_to_write -= written;
-        }
-      }
+    // 头块和响应体组成 iovec 链一次 sendmsg 写出（空响应体会被忽略），
+    // 部分写入时 write_all_vectored 原地推进链，继续写剩余部分
+    io::BufferChain chain{
+        std::span<const char>(_header_block_buf.data(),
+                              _header_block_buf.size()),
+        std::span<const char>(
+            reinterpret_cast<const char *>(resp.body().data()),
+            resp.body().size())};
+    auto write_res = co_await _stream.write_all_vectored(chain);
+    if (!write_res) {
+      co_return std::unexpected(write_res.error());
     }
 
     co_return expected<void>();
@@ -284,25 +284,45 @@ private:
     return expected<void>();
   }
 
-  // 把待发送数据写出去。这里先拷贝一份再 co_await，
-  // 避免 nghttp2 返回的内部指针跨挂起失效。
+  // 把待发送数据写出去。nghttp2 返回的指针在下一次 mem_send2 后失效，
+  // 所以每一段都先拷贝；一批最多攒 SEND_BATCH_BYTES 字节，组成 iovec 链后
+  // 一次 sendmsg 写出，避免每个帧一次系统调用。
   auto send_data() -> task<expected<void>> {
+    static constexpr std::size_t SEND_BATCH_BYTES = 64 * 1024;
     while (true) {
-      const uint8_t* data = nullptr;
-      // 让 nghttp2 产出一批待发送字节。
-      auto len = nghttp2_session_mem_send2(_session, &data);
-      if (len < 0) {
-        co_return std::unexpected(nghttp2_error_to_faio(len));
+      std::size_t segments = 0;
+      std::size_t batch_bytes = 0;
+      while (batch_bytes < SEND_BATCH_BYTES &&
+             segments < io::BufferChain::INLINE_CAPACITY * 4) {
+        const uint8_t* data = nullptr;
+        // 让 nghttp2 产出一批待发送字节。
+        auto len = nghttp2_session_mem_send2(_session, &data);
+        if (len < 0) {
+          co_return std::unexpected(nghttp2_error_to_faio(len));
+        }
+        if (len == 0) {
+          break;
+        }
+        if (segments == _send_segments.size()) {
+          _send_segments.emplace_back();
+        }
+        _send_segments[segments].assign(data, data + static_cast<size_t>(len));
+        segments += 1;
+        batch_bytes += static_cast<size_t>(len);
       }
-      if (len == 0) {
+      if (segments == 0) {
         // 当前无待发送数据。
         break;
       }
 
-      // 拷贝后再挂起写，防止跨挂起悬空。
-      std::vector<uint8_t> copy(data, data + static_cast<size_t>(len));
-      auto res = co_await _stream.write_all(
-          std::span(reinterpret_cast<const char*>(copy.data()), copy.size()));
+      // 拷贝都在 _send_segments 里，挂起期间保持有效。
+      io::BufferChain chain;
+      for (std::size_t i = 0; i < segments; ++i) {
+        chain.push_back(std::span(
+            reinterpret_cast<const char*>(_send_segments[i].data()),
+            _send_segments[i].size()));
+      }
+      auto res = co_await _stream.write_all_vectored(chain);
       if (!res) {
         co_return std::unexpected(res.error());
       }
@@ -314,6 +334,7 @@ private:
   nghttp2_session* _session = nullptr;
   std::unique_ptr<ServerSessionState> _state;
   std::vector<ResponseBodySource*> _body_sources;
+  std::vector<std::vector<uint8_t>> _send_segments;  // 待发送数据的拷贝，复用容量
 };
 
 using ServerSessionAdapter = Http2ServerSession;
@@ -2,6 +2,8 @@
 #define FAIO_DETAIL_IO_AWAITER_CANCEL_HPP
 
 #include "faio/detail/io/base/io_registrant.hpp"
+#include "faio/detail/io/uring/fd_cancel.hpp"
+#include <optional>
 
 namespace faio::io::detail {
 
@@ -22,6 +24,31 @@ public:
   }
 };
 
+// 取消所有 worker 的 ring 上与 fd 相关的在途请求
+// 带 IORING_ASYNC_CANCEL_ALL 时结果为取消的请求数之和，没有可取消的请求时为0；
+// 不带时每个 ring 最多取消一个请求
+class CancelFd {
+public:
+  CancelFd(int fd, unsigned int flags) : _fd{fd}, _flags{flags} {}
+
+  auto await_ready() const noexcept -> bool { return false; }
+
+  // 请求对象构造在 awaiter 中：挂起之后 awaiter 不再移动，其他 ring 可以安全地引用它
+  void await_suspend(std::coroutine_handle<> handle) {
+    _cancel.emplace(_fd, _flags, handle);
+    _cancel->start();
+  }
+
+  auto await_resume() const noexcept -> expected<std::size_t> {
+    return _cancel->result();
+  }
+
+private:
+  int _fd;
+  unsigned int _flags;
+  std::optional<FdCancel> _cancel;
+};
+
 } // namespace faio::io::detail
 
 #endif // FAIO_DETAIL_IO_AWAITER_CANCEL_HPP
\ No newline at end of file
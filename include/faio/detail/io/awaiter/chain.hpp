@@ -0,0 +1,201 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_CHAIN_HPP
+#define FAIO_DETAIL_IO_AWAITER_CHAIN_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+#include "faio/detail/runtime/core/timer/timer.hpp"
+#include "faio/detail/time/cancel.hpp"
+#include <array>
+#include <tuple>
+#include <utility>
+
+namespace faio::io::detail {
+
+// 链式操作：用 IOSQE_IO_LINK 把多个 IO 串成一条链一次提交
+// 内核在前一个操作完成后才开始下一个；前一个失败（包括短读写）时，
+// 后续操作以 -ECANCELED 完成。全部操作完成后才恢复协程，
+// 结果按参数顺序以 tuple 返回。
+// 子操作只贡献 prep 好的 sqe，不会调用子操作自身的 await_suspend；
+// 子操作移动进来之后，sqe 中指向其成员的地址在挂起时重新填写。
+// 在 time::timeout 中时，令牌到期后取消链上所有尚未完成的操作，它们以 -ECANCELED 返回。
+template <class... IOs> class Chain : runtime::detail::timer::TimerHandler {
+  static_assert(sizeof...(IOs) > 0, "chain requires at least one operation");
+  static_assert((std::derived_from<IOs, IORegistrantAwaiter<IOs>> && ...),
+                "chain only accepts io_uring operations");
+
+  static constexpr std::size_t N = sizeof...(IOs);
+
+public:
+  explicit Chain(IOs &&...ios) : _ios{std::move(ios)...} {}
+
+public:
+  bool await_ready() const noexcept { return false; }
+
+  template <typename Promise>
+  bool await_suspend(std::coroutine_handle<Promise> handle) {
+    auto &uring = *current_uring;
+    auto token = time::detail::cancel_token_of(handle);
+    // 截止时间已经过去，整条链都不提交
+    if (token != nullptr && token->expired()) [[unlikely]] {
+      token->mark_cancelled();
+      fail_all(-ECANCELED);
+      return false;
+    }
+    _group.handle = handle;
+    _group.pending = N;
+    for_each_io([&](auto &io, std::size_t) {
+      io.rebind();
+      io._user_data.group = &_group;
+      io.trace_submit(uring);
+      io.record_ring();
+    });
+
+    // 链比提交队列还长，永远放不进去
+    if (N > uring.sq_entries()) [[unlikely]] {
+      fail_all(-EINVAL);
+      return false;
+    }
+
+    // 令牌的节点由整条链共用，最后一个操作完成时 drive 通过 _group.timer_task 摘除
+    if (token != nullptr) [[unlikely]] {
+      _token = token;
+      _timer_task = runtime::detail::timer::TimerTask{
+          token->deadline(), static_cast<runtime::detail::timer::TimerHandler *>(this)};
+      runtime::detail::timer::current_timer->add_task(&_timer_task);
+      _group.timer_task = &_timer_task;
+    }
+
+    if (!link_in_place(uring)) {
+      relink(uring);
+    }
+    return true;
+  }
+
+  auto await_resume() noexcept {
+    return std::apply(
+        [](auto &...io) { return std::tuple{io.await_resume()...}; }, _ios);
+  }
+
+private:
+  // 令牌到期：还在等待队列中的操作直接摘除，已经提交的逐个取消
+  auto on_expire() noexcept -> std::coroutine_handle<> override {
+    auto &uring = *current_uring;
+    _token->mark_cancelled();
+    _group.timer_task = nullptr;
+    for_each_io([&](auto &io, std::size_t) {
+      if (uring.unpark(&io._user_data)) {
+        io._user_data.result = -ECANCELED;
+        _group.pending -= 1;
+        return;
+      }
+      auto sqe = uring.get_detached_sqe();
+      io_uring_prep_cancel(sqe, &io._user_data, 0);
+      io_uring_sqe_set_data(sqe, nullptr);
+    });
+    // 整条链都还没有提交时没有 CQE 会到来，直接恢复
+    return _group.pending == 0 ? _group.handle : nullptr;
+  }
+
+  // 不提交，所有操作以 result 返回
+  void fail_all(int result) {
+    for_each_io([result](auto &io, std::size_t) {
+      io._user_data.result = result;
+      if (!io.parked()) {
+        io_uring_prep_nop(io._sqe);
+        io_uring_sqe_set_data(io._sqe, nullptr);
+      }
+    });
+  }
+
+  template <typename F> void for_each_io(F &&f) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (f(std::get<I>(_ios), I), ...);
+    }(std::make_index_sequence<N>{});
+  }
+
+  // 快速路径：各子操作的 sqe 恰好占据提交队列末尾 N 个未刷新的位置，
+  // 参数求值顺序不确定，原地按参数顺序重排后设置链接标志即可
+  bool link_in_place(IOuring &uring) {
+    if (uring.unflushed_sqes() < N) {
+      return false;
+    }
+    bool adjacent = true;
+    for_each_io([&](auto &io, std::size_t) {
+      auto found = false;
+      for (auto k = 0uz; k < N; k += 1) {
+        found = found || io._sqe == uring.tail_sqe(N, k);
+      }
+      adjacent = adjacent && found;
+    });
+    if (!adjacent) {
+      return false;
+    }
+    std::array<io_uring_sqe, N> sqes;
+    for_each_io([&](auto &io, std::size_t i) { sqes[i] = *io._sqe; });
+    for_each_io([&](auto &io, std::size_t i) {
+      io._sqe = uring.tail_sqe(N, i);
+      *io._sqe = sqes[i];
+      if (i + 1 < N) {
+        io._sqe->flags |= IOSQE_IO_LINK;
+      }
+    });
+    uring.submit();
+    return true;
+  }
+
+  // 慢速路径：把子操作原来的 sqe 改成 nop，重新取 N 个相邻的 sqe
+  // 取 sqe 时已经被刷新给内核的子操作无法再加入链，只参与完成计数
+  void relink(IOuring &uring) {
+    std::array<io_uring_sqe, N> sqes;
+    std::array<std::size_t, N> owners;
+    auto count = 0uz;
+    for_each_io([&](auto &io, std::size_t i) {
+      if (io.parked()) {
+        sqes[count] = *io._sqe;
+      } else if (uring.is_unflushed_sqe(io._sqe)) {
+        sqes[count] = *io._sqe;
+        io_uring_prep_nop(io._sqe);
+        io_uring_sqe_set_data(io._sqe, nullptr);
+      } else {
+        return;
+      }
+      owners[count] = i;
+      count += 1;
+    });
+    for (auto i = 0uz; i + 1 < count; i += 1) {
+      sqes[i].flags |= IOSQE_IO_LINK;
+    }
+
+    if (uring.sq_space_left() < count) {
+      uring.reset_and_submit();
+    }
+    if (uring.sq_space_left() >= count) [[likely]] {
+      for (auto i = 0uz; i < count; i += 1) {
+        *uring.try_get_sqe() = sqes[i];
+      }
+      uring.submit();
+      return;
+    }
+    // 仍然放不下：整条链挂入等待队列，补交时保证相邻
+    for_each_io([&](auto &io, std::size_t i) {
+      for (auto k = 0uz; k < count; k += 1) {
+        if (owners[k] != i) {
+          continue;
+        }
+        io._waiter.sqe = sqes[k];
+        io._waiter.user_data = &io._user_data;
+        io._waiter.linked = k == 0 ? static_cast<std::uint32_t>(count - 1) : 0;
+        uring.park(&io._waiter);
+      }
+    });
+  }
+
+private:
+  std::tuple<IOs...> _ios;
+  io_user_data_t _group{};
+  runtime::detail::timer::TimerTask _timer_task{}; // 取消令牌的定时器节点
+  time::detail::CancelToken *_token{nullptr};      // 所在 time::timeout 的取消令牌
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_CHAIN_HPP
@@ -2,6 +2,7 @@
 #define FAIO_DETAIL_IO_AWAITER_CLOSE_HPP
 
 #include "faio/detail/io/base/io_registrant.hpp"
+#include "faio/detail/io/uring/fd_cancel.hpp"
 
 namespace faio::io::detail {
 
@@ -21,6 +22,58 @@ public:
   }
 };
 
+// FileDescriptor::close 的关闭请求
+// cancel 为 true 时（cancel_on_close 的 socket）先取消各 worker 的 ring 上 fd 的在途请求再关闭
+class CloseFd {
+public:
+  CloseFd(int fd, bool cancel) : _fd{fd}, _cancel{cancel} {}
+
+  auto await_ready() const noexcept -> bool { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    _user_data.handle = handle;
+    if (_cancel) {
+      FdCancel::cancel_and_close(_fd, &_user_data);
+      return;
+    }
+    forget_fd_rings(_fd);
+    auto sqe = current_uring->get_detached_sqe();
+    io_uring_prep_close(sqe, _fd);
+    io_uring_sqe_set_data(sqe, &_user_data);
+  }
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (_user_data.result >= 0) {
+      return {};
+    } else {
+      return ::std::unexpected{make_error(-_user_data.result)};
+    }
+  }
+
+private:
+  int _fd;
+  bool _cancel;
+  io_user_data_t _user_data{};
+};
+
+// 关闭固定文件表中的槽位
+class CloseDirect : public IORegistrantAwaiter<CloseDirect> {
+private:
+  using Base = IORegistrantAwaiter<CloseDirect>;
+
+public:
+  CloseDirect(unsigned file_index)
+      : Base{io_uring_prep_close_direct, file_index} {}
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (this->_user_data.result >= 0) {
+      return {};
+    } else {
+      return ::std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
 } // namespace faio::io::detail
 
 #endif // FAIO_DETAIL_IO_AWAITER_CLOSE_HPP
\ No newline at end of file
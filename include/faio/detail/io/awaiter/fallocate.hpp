@@ -0,0 +1,27 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_FALLOCATE_HPP
+#define FAIO_DETAIL_IO_AWAITER_FALLOCATE_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+
+namespace faio::io::detail {
+
+class Fallocate : public IORegistrantAwaiter<Fallocate> {
+private:
+  using Base = IORegistrantAwaiter<Fallocate>;
+
+public:
+  Fallocate(int fd, int mode, __u64 offset, __u64 len)
+      : Base{io_uring_prep_fallocate, fd, mode, offset, len} {}
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return {};
+    } else {
+      return std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_FALLOCATE_HPP
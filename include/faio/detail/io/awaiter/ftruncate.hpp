@@ -0,0 +1,27 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_FTRUNCATE_HPP
+#define FAIO_DETAIL_IO_AWAITER_FTRUNCATE_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+
+namespace faio::io::detail {
+
+// IORING_OP_FTRUNCATE 需要 6.9 以上的内核，旧内核返回 -EINVAL
+class Ftruncate : public IORegistrantAwaiter<Ftruncate> {
+private:
+  using Base = IORegistrantAwaiter<Ftruncate>;
+
+public:
+  Ftruncate(int fd, loff_t len) : Base{io_uring_prep_ftruncate, fd, len} {}
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return {};
+    } else {
+      return std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_FTRUNCATE_HPP
@@ -0,0 +1,44 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_MADVISE_HPP
+#define FAIO_DETAIL_IO_AWAITER_MADVISE_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+
+namespace faio::io::detail {
+
+class Madvise : public IORegistrantAwaiter<Madvise> {
+private:
+  using Base = IORegistrantAwaiter<Madvise>;
+
+public:
+  Madvise(void *addr, __u32 length, int advice)
+      : Base{io_uring_prep_madvise, addr, length, advice} {}
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return {};
+    } else {
+      return std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+class Fadvise : public IORegistrantAwaiter<Fadvise> {
+private:
+  using Base = IORegistrantAwaiter<Fadvise>;
+
+public:
+  Fadvise(int fd, __u64 offset, __u32 len, int advice)
+      : Base{io_uring_prep_fadvise, fd, offset, len, advice} {}
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return {};
+    } else {
+      return std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_MADVISE_HPP
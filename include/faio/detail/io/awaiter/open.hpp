@@ -25,6 +25,27 @@ public:
   }
 };
 
+// 打开到固定文件表的 file_index 槽位（直接描述符），完成时不返回 fd
+// 后续操作以 IOSQE_FIXED_FILE 和槽位号引用该文件，不能带 O_CLOEXEC
+class OpenDirect : public IORegistrantAwaiter<OpenDirect> {
+private:
+  using Base = IORegistrantAwaiter<OpenDirect>;
+
+public:
+  OpenDirect(int dfd, const char *path, int flags, mode_t mode,
+             unsigned file_index)
+      : Base{io_uring_prep_openat_direct, dfd, path, flags, mode, file_index} {
+  }
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return {};
+    } else {
+      return ::std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
 class Open2 : public IORegistrantAwaiter<Open2> {
 private:
   using Base = IORegistrantAwaiter<Open2>;
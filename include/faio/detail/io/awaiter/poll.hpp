@@ -0,0 +1,30 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_POLL_HPP
+#define FAIO_DETAIL_IO_AWAITER_POLL_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+#include <poll.h>
+
+namespace faio::io::detail {
+
+// 单次 poll，fd 就绪时完成，返回就绪的事件
+// 用于不支持内部 poll 重试的操作（如对非阻塞 socket 的 splice）
+class PollAdd : public IORegistrantAwaiter<PollAdd> {
+private:
+  using Base = IORegistrantAwaiter<PollAdd>;
+
+public:
+  PollAdd(int fd, unsigned poll_mask)
+      : Base{io_uring_prep_poll_add, fd, poll_mask} {}
+
+  auto await_resume() const noexcept -> expected<unsigned> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return static_cast<unsigned>(this->_user_data.result);
+    } else {
+      return ::std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_POLL_HPP
@@ -19,12 +19,18 @@ public:
         msg_{.msg_name = addr,
              .msg_namelen = addrlen != nullptr ? *addrlen : 0,
              .msg_iov = &iovec_,
-             .msg_iovlen = len,
+             .msg_iovlen = 1,
              .msg_control = nullptr,
              .msg_controllen = 0,
              .msg_flags = flags},
         addrlen_{addrlen} {}
 
+  // 移动后重新指向自身的 msghdr 和 iovec
+  void rebind_sqe() noexcept {
+    msg_.msg_iov = &iovec_;
+    this->_sqe->addr = reinterpret_cast<unsigned long long>(&msg_);
+  }
+
   auto await_resume() const noexcept -> expected<std::size_t> {
     if (addrlen_) {
       *addrlen_ = msg_.msg_namelen;
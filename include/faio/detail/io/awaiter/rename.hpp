@@ -0,0 +1,32 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_RENAME_HPP
+#define FAIO_DETAIL_IO_AWAITER_RENAME_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+
+namespace faio::io::detail {
+
+class Rename : public IORegistrantAwaiter<Rename> {
+private:
+  using Base = IORegistrantAwaiter<Rename>;
+
+public:
+  Rename(int old_dfd, const char *old_path, int new_dfd, const char *new_path,
+         unsigned flags)
+      : Base{io_uring_prep_renameat, old_dfd, old_path, new_dfd, new_path,
+             flags} {}
+
+  Rename(const char *old_path, const char *new_path, unsigned flags)
+      : Rename{AT_FDCWD, old_path, AT_FDCWD, new_path, flags} {}
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return {};
+    } else {
+      return std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_RENAME_HPP
@@ -2,6 +2,8 @@
 #define FAIO_DETAIL_IO_AWAITER_SEND_HPP
 
 #include "faio/detail/io/base/io_registrant.hpp"
+#include "faio/detail/io/uring/fixed_buffer.hpp"
+#include <algorithm>
 
 namespace faio::io::detail {
 
@@ -15,6 +17,11 @@ public:
     // std::cout << "send fd is" << sockfd << std::endl;
   }
 
+  // 从注册缓冲区发送（IORING_RECVSEND_FIXED_BUF），省去每次发送时锁定用户页；
+  // 缓冲区不属于当前 ring 时退化为普通发送。不支持这个标志的旧内核返回 EINVAL
+  Send(int sockfd, const FixedBuffer &buf, size_t len, int flags)
+      : Base{prep_fixed, sockfd, buf, len, flags} {}
+
   auto await_resume() const noexcept -> expected<std::size_t> {
     if (this->_user_data.result >= 0) [[likely]] {
       return static_cast<std::size_t>(this->_user_data.result);
@@ -22,6 +29,17 @@ public:
       return ::std::unexpected{make_error(-this->_user_data.result)};
     }
   }
+
+private:
+  static void prep_fixed(io_uring_sqe *sqe, int sockfd, const FixedBuffer &buf,
+                         size_t len, int flags) {
+    len = std::min(len, buf.size());
+    io_uring_prep_send(sqe, sockfd, buf.data(), len, flags);
+    if (buf.usable_on(current_uring->uring())) [[likely]] {
+      sqe->ioprio |= IORING_RECVSEND_FIXED_BUF;
+      sqe->buf_index = FixedBuffer::buf_index();
+    }
+  }
 };
 
 class SendZC : public IORegistrantAwaiter<SendZC> {
@@ -32,6 +50,12 @@ public:
   SendZC(int sockfd, const void *buf, size_t len, int flags, unsigned zc_flags)
       : Base{io_uring_prep_send_zc, sockfd, buf, len, flags, zc_flags} {}
 
+  // 从注册缓冲区发送（IORING_RECVSEND_FIXED_BUF），缓冲区不属于当前 ring 时
+  // 退化为普通的零拷贝发送
+  SendZC(int sockfd, const FixedBuffer &buf, size_t len, int flags,
+         unsigned zc_flags)
+      : Base{prep_fixed, sockfd, buf, len, flags, zc_flags} {}
+
   auto await_resume() const noexcept -> expected<std::size_t> {
     if (this->_user_data.result >= 0) [[likely]] {
       return static_cast<std::size_t>(this->_user_data.result);
@@ -39,6 +63,18 @@ public:
       return ::std::unexpected{make_error(-this->_user_data.result)};
     }
   }
+
+private:
+  static void prep_fixed(io_uring_sqe *sqe, int sockfd, const FixedBuffer &buf,
+                         size_t len, int flags, unsigned zc_flags) {
+    len = std::min(len, buf.size());
+    if (buf.usable_on(current_uring->uring())) [[likely]] {
+      io_uring_prep_send_zc_fixed(sqe, sockfd, buf.data(), len, flags,
+                                  zc_flags, FixedBuffer::buf_index());
+    } else {
+      io_uring_prep_send_zc(sqe, sockfd, buf.data(), len, flags, zc_flags);
+    }
+  }
 };
 
 } // namespace faio::io::detail
@@ -0,0 +1,50 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_SPLICE_HPP
+#define FAIO_DETAIL_IO_AWAITER_SPLICE_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+
+namespace faio::io::detail {
+
+// 在两个fd之间移动数据，其中一端必须是管道，数据不经过用户态
+// off 为 -1 表示使用（或不支持）文件位置
+class Splice : public IORegistrantAwaiter<Splice> {
+private:
+  using Base = IORegistrantAwaiter<Splice>;
+
+public:
+  Splice(int fd_in, int64_t off_in, int fd_out, int64_t off_out,
+         unsigned nbytes, unsigned splice_flags)
+      : Base{io_uring_prep_splice, fd_in,  off_in,
+             fd_out,               off_out, nbytes,
+             splice_flags} {}
+
+  auto await_resume() const noexcept -> expected<std::size_t> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return static_cast<std::size_t>(this->_user_data.result);
+    } else {
+      return ::std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+// 复制管道中的数据到另一个管道，不消费源管道
+class Tee : public IORegistrantAwaiter<Tee> {
+private:
+  using Base = IORegistrantAwaiter<Tee>;
+
+public:
+  Tee(int fd_in, int fd_out, unsigned nbytes, unsigned splice_flags)
+      : Base{io_uring_prep_tee, fd_in, fd_out, nbytes, splice_flags} {}
+
+  auto await_resume() const noexcept -> expected<std::size_t> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return static_cast<std::size_t>(this->_user_data.result);
+    } else {
+      return ::std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_SPLICE_HPP
@@ -0,0 +1,34 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_STATX_HPP
+#define FAIO_DETAIL_IO_AWAITER_STATX_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+#include <sys/stat.h>
+
+namespace faio::io::detail {
+
+class Statx : public IORegistrantAwaiter<Statx> {
+private:
+  using Base = IORegistrantAwaiter<Statx>;
+
+public:
+  Statx(int dfd, const char *path, int flags, unsigned mask)
+      : Base{io_uring_prep_statx, dfd, path, flags, mask, &_statx} {}
+
+  // 移动后重新指向自身的 statx 缓冲区
+  void rebind_sqe() noexcept { this->_sqe->off = reinterpret_cast<unsigned long long>(&_statx); }
+
+  auto await_resume() const noexcept -> expected<struct statx> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return _statx;
+    } else {
+      return std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+
+private:
+  struct statx _statx{};
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_STATX_HPP
@@ -0,0 +1,29 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_UNLINK_HPP
+#define FAIO_DETAIL_IO_AWAITER_UNLINK_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+
+namespace faio::io::detail {
+
+class Unlink : public IORegistrantAwaiter<Unlink> {
+private:
+  using Base = IORegistrantAwaiter<Unlink>;
+
+public:
+  Unlink(int dfd, const char *path, int flags)
+      : Base{io_uring_prep_unlinkat, dfd, path, flags} {}
+
+  Unlink(const char *path, int flags) : Unlink{AT_FDCWD, path, flags} {}
+
+  auto await_resume() const noexcept -> expected<void> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return {};
+    } else {
+      return std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_UNLINK_HPP
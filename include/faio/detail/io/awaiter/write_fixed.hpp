@@ -0,0 +1,43 @@
+#ifndef FAIO_DETAIL_IO_AWAITER_WRITE_FIXED_HPP
+#define FAIO_DETAIL_IO_AWAITER_WRITE_FIXED_HPP
+
+#include "faio/detail/io/base/io_registrant.hpp"
+#include "faio/detail/io/uring/fixed_buffer.hpp"
+#include <algorithm>
+
+namespace faio::io::detail {
+
+// 从注册缓冲区写出，缓冲区不属于当前 ring 时退化为普通 write
+class WriteFixed : public IORegistrantAwaiter<WriteFixed> {
+private:
+  using Base = IORegistrantAwaiter<WriteFixed>;
+
+public:
+  WriteFixed(int fd, const FixedBuffer &buf, std::size_t nbytes,
+             uint64_t offset)
+      : Base{prep, fd, buf, nbytes, offset} {}
+
+  auto await_resume() const noexcept -> expected<std::size_t> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return static_cast<std::size_t>(this->_user_data.result);
+    } else {
+      return ::std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+
+private:
+  static void prep(io_uring_sqe *sqe, int fd, const FixedBuffer &buf,
+                   std::size_t nbytes, uint64_t offset) {
+    auto len = static_cast<unsigned>(std::min(nbytes, buf.size()));
+    if (buf.usable_on(current_uring->uring())) [[likely]] {
+      io_uring_prep_write_fixed(sqe, fd, buf.data(), len, offset,
+                                FixedBuffer::buf_index());
+    } else {
+      io_uring_prep_write(sqe, fd, buf.data(), len, offset);
+    }
+  }
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_AWAITER_WRITE_FIXED_HPP
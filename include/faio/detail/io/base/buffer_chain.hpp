@@ -0,0 +1,119 @@
+#ifndef FAIO_DETAIL_IO_BASE_BUFFER_CHAIN_HPP
+#define FAIO_DETAIL_IO_BASE_BUFFER_CHAIN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <limits.h>
+#include <span>
+#include <sys/uio.h>
+#include <vector>
+
+namespace faio::io {
+
+// 运行时长度的 iovec 链，用于分散读/集中写
+// 段数不超过 INLINE_CAPACITY 时存放在对象内部，超过后转移到堆上；
+// 部分写入后通过 advance() 原地推进，不需要重新组装
+// 链只引用各段内存，不持有；co_await 期间链本身和各段内存都必须保持有效
+class BufferChain {
+public:
+  static constexpr std::size_t INLINE_CAPACITY{8uz};
+
+  BufferChain() = default;
+
+  BufferChain(std::initializer_list<std::span<const char>> segments) {
+    for (auto segment : segments) {
+      push_back(segment);
+    }
+  }
+
+public:
+  /// 追加一段，空段直接忽略
+  void push_back(std::span<const char> segment) {
+    if (segment.empty()) {
+      return;
+    }
+    iovec iov{.iov_base = const_cast<char *>(segment.data()),
+              .iov_len = segment.size_bytes()};
+    if (_heap.empty() && _tail < INLINE_CAPACITY) {
+      _inline[_tail] = iov;
+    } else {
+      if (_heap.empty()) {
+        // 内部空间用完，整体转移到堆上
+        _heap.assign(_inline.begin() + _head, _inline.begin() + _tail);
+        _tail -= _head;
+        _head = 0;
+      }
+      _heap.push_back(iov);
+    }
+    _tail += 1;
+    _bytes += iov.iov_len;
+  }
+
+  /// 追加一段可写内存（用于分散读）
+  void push_back(std::span<char> segment) {
+    push_back(std::span<const char>{segment});
+  }
+
+  /// 从头部消费n个字节，完整消费的段被跳过，部分消费的段原地调整
+  void advance(std::size_t n) noexcept {
+    n = std::min(n, _bytes);
+    _bytes -= n;
+    auto iov = storage();
+    while (n > 0) {
+      auto &front = iov[_head];
+      if (n < front.iov_len) {
+        front.iov_base = static_cast<char *>(front.iov_base) + n;
+        front.iov_len -= n;
+        return;
+      }
+      n -= front.iov_len;
+      _head += 1;
+    }
+  }
+
+  /// 清空，保留已经分配的堆空间
+  void clear() noexcept {
+    _heap.clear();
+    _head = 0;
+    _tail = 0;
+    _bytes = 0;
+  }
+
+  /// 剩余的第一段
+  [[nodiscard]] iovec *data() noexcept { return storage() + _head; }
+  [[nodiscard]] const iovec *data() const noexcept { return storage() + _head; }
+
+  /// 剩余段数
+  [[nodiscard]] std::size_t size() const noexcept { return _tail - _head; }
+
+  /// 单次系统调用可以提交的段数（受 IOV_MAX 限制）
+  [[nodiscard]] unsigned io_count() const noexcept {
+    return static_cast<unsigned>(std::min<std::size_t>(size(), IOV_MAX));
+  }
+
+  /// 剩余字节数
+  [[nodiscard]] std::size_t total_bytes() const noexcept { return _bytes; }
+
+  [[nodiscard]] bool empty() const noexcept { return _bytes == 0; }
+
+private:
+  [[nodiscard]] iovec *storage() noexcept {
+    return _heap.empty() ? _inline.data() : _heap.data();
+  }
+  [[nodiscard]] const iovec *storage() const noexcept {
+    return _heap.empty() ? _inline.data() : _heap.data();
+  }
+
+private:
+  std::array<iovec, INLINE_CAPACITY> _inline{}; // 内部存储
+  std::vector<iovec> _heap{};                   // 超出内部容量后的存储
+  std::size_t _head{0};                         // 第一个未消费的段
+  std::size_t _tail{0};                         // 段的结束位置
+  std::size_t _bytes{0};                        // 剩余字节数
+};
+
+} // namespace faio::io
+
+#endif // FAIO_DETAIL_IO_BASE_BUFFER_CHAIN_HPP
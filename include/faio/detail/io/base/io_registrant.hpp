@@ -1,72 +1,172 @@
 #ifndef FAIO_DETAIL_IO_BASE_IO_REGISTRANT_HPP
 #define FAIO_DETAIL_IO_BASE_IO_REGISTRANT_HPP
 #include "faio/detail/common/error.hpp"
+#include "faio/detail/io/uring/fd_cancel.hpp"
 #include "faio/detail/io/uring/io_uring.hpp"
 #include "faio/detail/io/uring/io_user_data.hpp"
+#include "faio/detail/time/cancel.hpp"
 #include "faio/detail/time/timeout.hpp"
+#include <cerrno>
 #include <functional>
 #include <liburing.h>
 #include <utility>
 namespace faio::io::detail {
 
+template <class... IOs> class Chain;
+
 // IO操作注册器，通过构造函数传入IO操作函数和参数。
 // 将io操作注册到uring里，并设置用户数据。
 // 将IO操作封装成awaiter。
 template <class IO> class IORegistrantAwaiter {
+  // 链式操作需要重排各子操作的sqe
+  template <class... IOs> friend class Chain;
+
 public:
   template <typename F, typename... Args>
     requires std::is_invocable_v<F, io_uring_sqe *, Args...>
-  IORegistrantAwaiter(F &&f, Args &&...args) : _sqe(current_uring->get_sqe()) {
-    if (_sqe != nullptr) {
-      // 调用函数（io_uring_prep_* 会将 sqe->user_data 置零）
-      std::invoke(std::forward<F>(f), _sqe, std::forward<Args>(args)...);
-      // 必须在 prep 之后设置 user_data，否则完成事件无法关联回协程
-      io_uring_sqe_set_data(_sqe, &_user_data);
-    } else {
-      _user_data.result = -Error::EmptySqe;
+  IORegistrantAwaiter(F &&f, Args &&...args)
+      : _sqe(current_uring->try_get_sqe()) {
+    // 构造时不刷新提交队列：awaiter 还可能被移动（set_timeout、io::chain），
+    // 此时刷新会把指向旧地址的 sqe 交给内核。
+    // 没有空位时先prep到暂存区，挂起时再取sqe或进入等待队列
+    if (_sqe == nullptr) [[unlikely]] {
+      _sqe = &_waiter.sqe;
     }
+    // 调用函数（io_uring_prep_* 会将 sqe->user_data 置零）
+    std::invoke(std::forward<F>(f), _sqe, std::forward<Args>(args)...);
+    // 必须在 prep 之后设置 user_data，否则完成事件无法关联回协程
+    io_uring_sqe_set_data(_sqe, &_user_data);
   }
 
   IORegistrantAwaiter(const IORegistrantAwaiter &) = delete;
   IORegistrantAwaiter &operator=(const IORegistrantAwaiter &) = delete;
   IORegistrantAwaiter(IORegistrantAwaiter &&other)
       : _user_data(std::move(other._user_data)), _sqe(other._sqe) {
-    io_uring_sqe_set_data(_sqe, &this->_user_data);
-    other._sqe = nullptr;
+    take_sqe(other);
   }
   IORegistrantAwaiter &operator=(IORegistrantAwaiter &&other) {
     _user_data = std::move(other._user_data);
     _sqe = other._sqe;
-    io_uring_sqe_set_data(_sqe, &this->_user_data);
-    other._sqe = nullptr;
+    take_sqe(other);
     return *this;
   };
 
-  ~IORegistrantAwaiter() = default;
+  ~IORegistrantAwaiter() {
+    // co_await 表达式结束时析构，此时协程刚恢复，记录收割到恢复的调度延迟
+    if (_user_data.reaped_ns != 0) [[unlikely]] {
+      if (auto uring = current_uring; uring != nullptr) {
+        uring->trace_schedule(_user_data);
+      }
+    }
+  }
 
 public:
-  // 是否挂起逻辑，如果sqe不为空就挂起
-  bool await_ready() const noexcept { return _sqe == nullptr; }
+  // sqe 一定可以拿到（提交队列或暂存区），总是挂起
+  bool await_ready() const noexcept { return false; }
 
   // 挂起逻辑，设置用户数据和提交io请求
-  void await_suspend(std::coroutine_handle<> handle) {
+  // 请求在暂存区时挂入等待队列，等待下一次收割后补交
+  // 在 time::timeout 中且截止时间已经过去时不提交，以 -ECANCELED 直接返回
+  template <typename Promise>
+  bool await_suspend(std::coroutine_handle<Promise> handle) {
+    if (auto token = time::detail::cancel_token_of(handle); token != nullptr)
+        [[unlikely]] {
+      if (token->expired()) {
+        token->mark_cancelled();
+        _user_data.result = -ECANCELED;
+        io_uring_prep_nop(_sqe);
+        io_uring_sqe_set_data(_sqe, nullptr);
+        return false;
+      }
+      // set_timeout 的 IO 已经由 Timeout 计时，截止时间取了两者中较早的一个
+      if (_user_data.timer_task == nullptr && _user_data.group == nullptr) {
+        token->arm(_user_data);
+      }
+    }
+    rebind();
     _user_data.handle = std::move(handle);
-    io::detail::current_uring->submit();
+    auto &uring = *io::detail::current_uring;
+    trace_submit(uring);
+    record_ring();
+    if (parked()) [[unlikely]] {
+      // 已经到达最终地址，可以刷新提交队列腾出空位
+      if (auto sqe = uring.get_sqe(); sqe != nullptr) {
+        *sqe = _waiter.sqe;
+        _sqe = sqe;
+      } else {
+        _waiter.user_data = &_user_data;
+        uring.park(&_waiter);
+        return true;
+      }
+    }
+    uring.submit();
+    return true;
   }
 
 public:
-  auto set_timeout_at(std::chrono::steady_clock::time_point deadline) noexcept {
+  // slack 为允许推迟到期的时长，见 Timer::add_task
+  auto set_timeout_at(std::chrono::steady_clock::time_point deadline,
+                      std::chrono::nanoseconds slack = {}) noexcept {
     _user_data.deadline = deadline;
-    return time::detail::Timeout{std::move(*static_cast<IO *>(this))};
+    return time::detail::Timeout{std::move(*static_cast<IO *>(this)), slack};
+  }
+
+  auto set_timeout(std::chrono::milliseconds interval,
+                   std::chrono::nanoseconds slack = {}) noexcept {
+    return set_timeout_at(std::chrono::steady_clock::now() + interval, slack);
   }
 
-  auto set_timeout(std::chrono::milliseconds interval) noexcept {
-    return set_timeout_at(std::chrono::steady_clock::now() + interval);
+  // 给sqe追加标志，例如 IOSQE_FIXED_FILE、IOSQE_IO_HARDLINK
+  auto with_flags(std::uint8_t flags) && noexcept -> IO && {
+    _sqe->flags |= flags;
+    return std::move(*static_cast<IO *>(this));
+  }
+
+private:
+  // 记下当前 ring 提交了 fd 的请求，cancel_on_close 的 fd 关闭时只取消这些 ring；
+  // 固定文件的 sqe->fd 是槽位号，不记录
+  void record_ring() noexcept {
+    if ((_sqe->flags & IOSQE_FIXED_FILE) == 0) {
+      record_fd_ring(_sqe->fd);
+    }
+  }
+
+  // 开启延迟追踪时记录 opcode 和提交时间，收割时计算内核延迟
+  void trace_submit(IOuring &uring) noexcept {
+    if (uring.latency_tracing()) [[unlikely]] {
+      _user_data.opcode = _sqe->opcode;
+      _user_data.submit_ns = IOuring::now_ns();
+    }
+  }
+
+  // sqe 中指向 awaiter 自身成员的地址（msghdr、iovec、statx 缓冲区等）在构造时填入，
+  // awaiter 被移动之后会悬空。子类提供 rebind_sqe() 重新填写这些地址，
+  // 在 awaiter 到达最终地址、sqe 交给内核之前调用（await_suspend、Chain）
+  void rebind() noexcept {
+    if constexpr (requires(IO &io) { io.rebind_sqe(); }) {
+      static_cast<IO *>(this)->rebind_sqe();
+    }
+  }
+
+  // 请求是否还在暂存区
+  [[nodiscard]] bool parked() const noexcept { return _sqe == &_waiter.sqe; }
+
+  // 接管other的sqe，暂存区的请求需要一并拷贝
+  void take_sqe(IORegistrantAwaiter &other) noexcept {
+    if (other.parked()) {
+      _waiter.sqe = other._waiter.sqe;
+      _sqe = &_waiter.sqe;
+    }
+    if (_sqe != nullptr) {
+      io_uring_sqe_set_data(_sqe, &this->_user_data);
+    }
+    other._sqe = nullptr;
   }
 
 protected:
   io_user_data_t _user_data{};
   io_uring_sqe *_sqe;
+  io_sqe_waiter_t _waiter; // 提交队列耗尽时的暂存区
 };
 
 } // namespace faio::io::detail
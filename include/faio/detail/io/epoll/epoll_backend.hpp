@@ -0,0 +1,788 @@
+#ifndef FAIO_DETAIL_IO_EPOLL_EPOLL_BACKEND_HPP
+#define FAIO_DETAIL_IO_EPOLL_EPOLL_BACKEND_HPP
+
+#include "fastlog/fastlog.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <liburing.h>
+#include <map>
+#include <memory>
+#include <optional>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace faio::io::detail {
+
+// io_uring 不可用（被 seccomp 拦截、内核太旧）时的 epoll 后端
+//
+// awaiter 不区分后端，仍然通过 io_uring_prep_* 把请求写进 sqe。
+// 后端在用户态内存中搭建一份提交/完成队列，挂到 io_uring 结构上：
+// io_uring_get_sqe、io_uring_peek_batch_cqe 等 liburing 的内联函数只读写这些内存，
+// 原样可用；需要进入内核的 submit/wait 由 IOuring 转给本类：
+//   submit  逐个执行新的 sqe，socket 类请求返回 EAGAIN 时按 fd 登记到 epoll，
+//           就绪后重试；文件类请求同步执行
+//   wait    epoll_wait，处理就绪事件和到期的超时
+// 结果按 io_uring 的格式写入完成队列，IOEngine::drive 的收割逻辑不变。
+// 支持 IOSQE_IO_LINK/IOSQE_IO_HARDLINK、IORING_OP_LINK_TIMEOUT、IORING_OP_TIMEOUT
+// 和按 user_data/fd 的取消；注册缓冲区、固定文件、缓冲区环、msg_ring 等
+// 依赖内核注册的功能不可用，调用方按各自的退化路径处理
+class EpollBackend {
+  // 一个在途的请求
+  struct Op {
+    io_uring_sqe sqe;              // 请求的拷贝
+    std::uint64_t id{0};           // 节点编号，回收后清零
+    Op *link{nullptr};             // 链上的下一个请求，本请求完成后才开始
+    int fd{-1};                    // 等待就绪的fd
+    std::uint32_t events{0};       // 等待的就绪事件
+    bool parked{false};            // 是否挂在fd的等待链表上
+    bool connecting{false};        // connect 已经发起，等待可写
+    Op *fd_prev{nullptr};          // 同一个fd的等待链表
+    Op *fd_next{nullptr};
+    Op *prev{nullptr};             // 在途链表
+    Op *next{nullptr};
+    std::optional<std::chrono::steady_clock::time_point> deadline{}; // 超时
+    std::multimap<std::chrono::steady_clock::time_point, Op *>::iterator
+        timer{};
+    bool has_link_timeout{false};  // 后面链接了 IORING_OP_LINK_TIMEOUT
+    bool timed_out{false};         // 被链接的超时取消
+    std::uint64_t timeout_data{0}; // 链接超时的 user_data
+  };
+
+  // 一个fd上等待就绪的请求
+  struct FdWaiters {
+    Op *head{nullptr};
+    Op *tail{nullptr};
+    std::uint32_t armed{0}; // 当前登记到 epoll 的事件，EPOLLONESHOT 触发后清零
+  };
+
+  // 完成队列放不下时暂存的完成事件
+  struct Completion {
+    std::uint64_t user_data;
+    int res;
+    std::uint32_t flags;
+  };
+
+  static constexpr std::size_t MAX_EVENTS{256};
+
+public:
+  EpollBackend() = default;
+  EpollBackend(const EpollBackend &) = delete;
+  EpollBackend &operator=(const EpollBackend &) = delete;
+
+  ~EpollBackend() {
+    while (_in_flight != nullptr) {
+      auto op = _in_flight;
+      _in_flight = op->next;
+      release_chain(op);
+    }
+    for (auto op : _free_ops) {
+      delete op;
+    }
+    if (_epfd >= 0) {
+      ::close(_epfd);
+    }
+  }
+
+public:
+  /// 创建 epoll 实例，在 ring 上搭建用户态的提交/完成队列
+  /// 成功返回0，失败返回负的errno
+  [[nodiscard]] int setup(io_uring *ring, unsigned entries) {
+    _epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epfd < 0) {
+      return -errno;
+    }
+    entries = std::bit_ceil(std::max(entries, 1u));
+    _sqes.resize(entries);
+    _sq_array.resize(entries);
+    _cqes.resize(entries * 2);
+
+    *ring = io_uring{};
+    ring->ring_fd = -1;
+    ring->enter_ring_fd = -1;
+    auto &sq = ring->sq;
+    sq.khead = &_sq_head;
+    sq.ktail = &_sq_tail;
+    sq.kflags = &_sq_flags;
+    sq.kdropped = &_sq_dropped;
+    sq.array = _sq_array.data();
+    sq.sqes = _sqes.data();
+    sq.ring_mask = entries - 1;
+    sq.ring_entries = entries;
+    auto &cq = ring->cq;
+    cq.khead = &_cq_head;
+    cq.ktail = &_cq_tail;
+    cq.kflags = &_cq_flags;
+    cq.koverflow = &_cq_overflow;
+    cq.cqes = _cqes.data();
+    cq.ring_mask = static_cast<unsigned>(_cqes.size() - 1);
+    cq.ring_entries = static_cast<unsigned>(_cqes.size());
+    _ring = ring;
+    return 0;
+  }
+
+  /// 执行提交队列中新放入的请求，返回请求数
+  unsigned submit() {
+    auto &sq = _ring->sq;
+    auto count = sq.sqe_tail - sq.sqe_head;
+    Op *head{nullptr};
+    Op *tail{nullptr};
+    for (; sq.sqe_head != sq.sqe_tail; sq.sqe_head += 1) {
+      const auto &sqe = sq.sqes[sq.sqe_head & sq.ring_mask];
+      auto linked = (sqe.flags & (IOSQE_IO_LINK | IOSQE_IO_HARDLINK)) != 0;
+      if (sqe.opcode == IORING_OP_LINK_TIMEOUT && tail != nullptr) {
+        // 超时挂到链上的前一个请求
+        tail->deadline = to_deadline(sqe);
+        tail->has_link_timeout = true;
+        tail->timeout_data = sqe.user_data;
+      } else {
+        auto op = acquire(sqe);
+        if (tail != nullptr) {
+          tail->link = op;
+        } else {
+          head = op;
+        }
+        tail = op;
+      }
+      if (!linked) {
+        if (head != nullptr) {
+          start(head);
+        }
+        head = tail = nullptr;
+      }
+    }
+    // 链的最后一个请求带了链接标志，和内核一样在提交边界处截断
+    if (head != nullptr) {
+      start(head);
+    }
+    _sq_head = sq.sqe_head;
+    return count;
+  }
+
+  /// 非阻塞地处理一次就绪事件和到期的超时，在收割完成队列之前调用
+  void poll() {
+    flush_overflow();
+    if (_waiting > 0) {
+      dispatch(0);
+    }
+    expire();
+  }
+
+  /// 没有完成事件时等待就绪事件，timeout 为空时一直等待
+  /// 返回是否调用了 epoll_wait
+  bool wait(std::optional<std::chrono::milliseconds> timeout) {
+    flush_overflow();
+    expire();
+    if (ready() > 0) {
+      return false;
+    }
+    auto ms = timeout ? static_cast<int>(timeout->count()) : -1;
+    if (!_timers.empty()) {
+      auto left = std::chrono::ceil<std::chrono::milliseconds>(
+          _timers.begin()->first - std::chrono::steady_clock::now());
+      auto timer_ms = static_cast<int>(std::max<std::int64_t>(left.count(), 0));
+      ms = ms < 0 ? timer_ms : std::min(ms, timer_ms);
+    }
+    dispatch(ms);
+    expire();
+    return true;
+  }
+
+private:
+  // 完成队列中尚未收割的事件数
+  [[nodiscard]] unsigned ready() const noexcept { return _cq_tail - _cq_head; }
+
+  void post(std::uint64_t user_data, int res, std::uint32_t flags = 0) {
+    if (!_overflow.empty() || ready() == _cqes.size()) [[unlikely]] {
+      _overflow.push_back({user_data, res, flags});
+      return;
+    }
+    auto &cqe = _cqes[_cq_tail & (_cqes.size() - 1)];
+    cqe.user_data = user_data;
+    cqe.res = res;
+    cqe.flags = flags;
+    _cq_tail += 1;
+  }
+
+  // 收割之后完成队列有了空位，把暂存的事件搬回去
+  void flush_overflow() {
+    while (!_overflow.empty() && ready() < _cqes.size()) {
+      auto c = _overflow.front();
+      _overflow.pop_front();
+      auto &cqe = _cqes[_cq_tail & (_cqes.size() - 1)];
+      cqe.user_data = c.user_data;
+      cqe.res = c.res;
+      cqe.flags = c.flags;
+      _cq_tail += 1;
+    }
+  }
+
+  Op *acquire(const io_uring_sqe &sqe) {
+    Op *op{nullptr};
+    if (!_free_ops.empty()) {
+      op = _free_ops.back();
+      _free_ops.pop_back();
+      *op = Op{};
+    } else {
+      op = new Op{};
+    }
+    op->sqe = sqe;
+    op->id = ++_next_id;
+    return op;
+  }
+
+  void release(Op *op) {
+    op->id = 0;
+    _free_ops.push_back(op);
+  }
+
+  void release_chain(Op *op) {
+    while (op != nullptr) {
+      auto next = op->link;
+      release(op);
+      op = next;
+    }
+  }
+
+  static auto to_deadline(const io_uring_sqe &sqe)
+      -> std::chrono::steady_clock::time_point {
+    auto ts = reinterpret_cast<const __kernel_timespec *>(sqe.addr);
+    auto duration = std::chrono::seconds(ts->tv_sec) +
+                    std::chrono::nanoseconds(ts->tv_nsec);
+    // steady_clock 即 CLOCK_MONOTONIC
+    if (sqe.timeout_flags & IORING_TIMEOUT_ABS) {
+      return std::chrono::steady_clock::time_point{
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              duration)};
+    }
+    return std::chrono::steady_clock::now() +
+           std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+               duration);
+  }
+
+  // 开始执行链头的请求
+  void start(Op *op) {
+    op->next = _in_flight;
+    if (_in_flight != nullptr) {
+      _in_flight->prev = op;
+    }
+    _in_flight = op;
+    if (op->sqe.opcode == IORING_OP_TIMEOUT) {
+      op->deadline = to_deadline(op->sqe);
+    }
+    if (op->deadline) {
+      op->timer = _timers.emplace(*op->deadline, op);
+    }
+    execute(op);
+  }
+
+  // 执行请求，需要等待就绪时登记到 epoll，否则完成
+  void execute(Op *op) {
+    op->fd = op->sqe.fd;
+    op->events = 0;
+    auto res = perform(op);
+    if (res == -EAGAIN && op->events != 0) {
+      park(op);
+      return;
+    }
+    if (res == -EAGAIN && op->sqe.opcode == IORING_OP_TIMEOUT) {
+      // 纯超时，等待到期
+      return;
+    }
+    complete(op, res);
+  }
+
+  // 完成请求：写入完成事件，继续或取消链上的后续请求
+  void complete(Op *op, int res) {
+    if (op->deadline) {
+      _timers.erase(op->timer);
+      op->deadline.reset();
+    }
+    if (op->prev != nullptr) {
+      op->prev->next = op->next;
+    } else {
+      _in_flight = op->next;
+    }
+    if (op->next != nullptr) {
+      op->next->prev = op->prev;
+    }
+    auto zero_copy = op->sqe.opcode == IORING_OP_SEND_ZC ||
+                     op->sqe.opcode == IORING_OP_SENDMSG_ZC;
+    if (zero_copy && res >= 0) {
+      // 数据已经拷贝进内核，紧跟着给出通知事件
+      post(op->sqe.user_data, res, IORING_CQE_F_MORE);
+      post(op->sqe.user_data, 0, IORING_CQE_F_NOTIF);
+    } else {
+      post(op->sqe.user_data, res);
+    }
+    if (op->has_link_timeout) {
+      post(op->timeout_data, op->timed_out ? -ETIME : -ECANCELED);
+    }
+    auto next = op->link;
+    auto broken = res < 0 && (op->sqe.flags & IOSQE_IO_HARDLINK) == 0;
+    release(op);
+    if (next == nullptr) {
+      return;
+    }
+    if (!broken) {
+      start(next);
+      return;
+    }
+    // 链被打断，后续请求全部以 -ECANCELED 完成
+    for (auto op = next; op != nullptr;) {
+      post(op->sqe.user_data, -ECANCELED);
+      if (op->has_link_timeout) {
+        post(op->timeout_data, -ECANCELED);
+      }
+      auto link = op->link;
+      release(op);
+      op = link;
+    }
+  }
+
+  // 取消一个在途请求
+  void cancel(Op *op) {
+    unpark(op);
+    complete(op, -ECANCELED);
+  }
+
+  void park(Op *op) {
+    auto fd = op->fd;
+    auto &waiters = _fds[fd];
+    op->parked = true;
+    op->fd_prev = waiters.tail;
+    op->fd_next = nullptr;
+    if (waiters.tail != nullptr) {
+      waiters.tail->fd_next = op;
+    } else {
+      waiters.head = op;
+    }
+    waiters.tail = op;
+    _waiting += 1;
+    arm(fd, waiters);
+  }
+
+  void unpark(Op *op) {
+    if (!op->parked) {
+      return;
+    }
+    auto it = _fds.find(op->fd);
+    if (it == _fds.end()) {
+      return;
+    }
+    auto &waiters = it->second;
+    if (op->fd_prev != nullptr) {
+      op->fd_prev->fd_next = op->fd_next;
+    } else {
+      waiters.head = op->fd_next;
+    }
+    if (op->fd_next != nullptr) {
+      op->fd_next->fd_prev = op->fd_prev;
+    } else {
+      waiters.tail = op->fd_prev;
+    }
+    op->parked = false;
+    _waiting -= 1;
+    if (waiters.head == nullptr) {
+      _fds.erase(it);
+    }
+  }
+
+  // 按等待的事件登记 EPOLLONESHOT，fd 没有登记过（或被关闭后复用）时 ADD
+  void arm(int fd, FdWaiters &waiters) {
+    std::uint32_t interest{0};
+    for (auto op = waiters.head; op != nullptr; op = op->fd_next) {
+      interest |= op->events;
+    }
+    if (interest == waiters.armed) {
+      return;
+    }
+    struct epoll_event ev{};
+    ev.events = interest | EPOLLONESHOT;
+    ev.data.fd = fd;
+    if (::epoll_ctl(_epfd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+      if (errno != ENOENT ||
+          ::epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        // 不支持 epoll 的fd（普通文件）不会走到这里，出错时直接完成等待的请求
+        auto err = -errno;
+        while (waiters.head != nullptr) {
+          auto op = waiters.head;
+          unpark(op);
+          complete(op, err);
+          if (!_fds.contains(fd)) {
+            return;
+          }
+        }
+        return;
+      }
+    }
+    waiters.armed = interest;
+  }
+
+  // epoll_wait 并重试就绪fd上的请求
+  void dispatch(int timeout_ms) {
+    std::array<epoll_event, MAX_EVENTS> events;
+    auto n = ::epoll_wait(_epfd, events.data(), events.size(), timeout_ms);
+    if (n < 0) {
+      if (errno != EINTR) {
+        fastlog::console.error("epoll_wait failed, {}", strerror(errno));
+      }
+      return;
+    }
+    for (auto i = 0; i < n; i += 1) {
+      auto fd = events[i].data.fd;
+      auto revents = events[i].events;
+      auto it = _fds.find(fd);
+      if (it == _fds.end()) {
+        continue;
+      }
+      it->second.armed = 0;
+      // 先摘下事件匹配的请求，剩下的重新登记
+      std::vector<std::pair<Op *, std::uint64_t>> ready;
+      for (auto op = it->second.head; op != nullptr;) {
+        auto next = op->fd_next;
+        if ((op->events & revents) != 0 ||
+            (revents & (EPOLLERR | EPOLLHUP)) != 0) {
+          ready.emplace_back(op, op->id);
+          unpark(op);
+        }
+        op = next;
+      }
+      if (auto rest = _fds.find(fd); rest != _fds.end()) {
+        arm(fd, rest->second);
+      }
+      // 重试期间完成的请求可能取消了后面的请求，节点编号变化的跳过
+      for (auto [op, id] : ready) {
+        if (op->id == id && !op->parked) {
+          execute(op);
+        }
+      }
+    }
+  }
+
+  // 处理到期的超时
+  void expire() {
+    auto now = std::chrono::steady_clock::now();
+    while (!_timers.empty() && _timers.begin()->first <= now) {
+      auto op = _timers.begin()->second;
+      _timers.erase(_timers.begin());
+      op->deadline.reset();
+      if (op->sqe.opcode == IORING_OP_TIMEOUT) {
+        complete(op, -ETIME);
+        continue;
+      }
+      op->timed_out = true;
+      cancel(op);
+    }
+  }
+
+  // 按 io_uring 的语义取消请求：默认按 user_data 匹配第一个，
+  // IORING_ASYNC_CANCEL_FD 按fd匹配，IORING_ASYNC_CANCEL_ALL 取消全部匹配项
+  int cancel_matching(const io_uring_sqe &sqe, Op *self) {
+    auto flags = sqe.cancel_flags;
+    std::vector<Op *> matched;
+    for (auto op = _in_flight; op != nullptr; op = op->next) {
+      if (op == self) {
+        continue;
+      }
+      auto match = (flags & IORING_ASYNC_CANCEL_ANY) != 0 ||
+                   ((flags & IORING_ASYNC_CANCEL_FD) != 0
+                        ? op->sqe.fd == sqe.fd
+                        : op->sqe.user_data == sqe.addr);
+      if (match) {
+        matched.push_back(op);
+        if ((flags & (IORING_ASYNC_CANCEL_ALL | IORING_ASYNC_CANCEL_ANY)) == 0) {
+          break;
+        }
+      }
+    }
+    if (matched.empty()) {
+      return -ENOENT;
+    }
+    for (auto op : matched) {
+      cancel(op);
+    }
+    return (flags & (IORING_ASYNC_CANCEL_ALL | IORING_ASYNC_CANCEL_ANY)) != 0
+               ? static_cast<int>(matched.size())
+               : 0;
+  }
+
+  // 删除或更新 IORING_OP_TIMEOUT
+  int remove_timeout(const io_uring_sqe &sqe) {
+    for (auto op = _in_flight; op != nullptr; op = op->next) {
+      if (op->sqe.opcode != IORING_OP_TIMEOUT || op->sqe.user_data != sqe.addr) {
+        continue;
+      }
+      if ((sqe.timeout_flags & IORING_TIMEOUT_UPDATE) != 0) {
+        auto update = sqe;
+        update.addr = sqe.off;
+        _timers.erase(op->timer);
+        op->deadline = to_deadline(update);
+        op->timer = _timers.emplace(*op->deadline, op);
+      } else {
+        cancel(op);
+      }
+      return 0;
+    }
+    return -ENOENT;
+  }
+
+  // 关闭前取消仍在等待这个fd的请求，避免fd号复用后请求永远等不到事件
+  int close_fd(int fd) {
+    if (auto it = _fds.find(fd); it != _fds.end()) {
+      (void)::epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, nullptr);
+      std::vector<std::pair<Op *, std::uint64_t>> waiters;
+      for (auto op = it->second.head; op != nullptr; op = op->fd_next) {
+        waiters.emplace_back(op, op->id);
+      }
+      for (auto [op, id] : waiters) {
+        if (op->id == id) {
+          cancel(op);
+        }
+      }
+    }
+    return ::close(fd) == 0 ? 0 : -errno;
+  }
+
+  // 结果为负的errno；需要等待就绪时返回 -EAGAIN 并设置 op->events
+  static int sys_result(ssize_t ret) noexcept {
+    return ret >= 0 ? static_cast<int>(ret) : -errno;
+  }
+
+  int wait_for(Op *op, int res, std::uint32_t events) {
+    if (res == -EAGAIN || res == -EWOULDBLOCK) {
+      op->events = events;
+      return -EAGAIN;
+    }
+    return res;
+  }
+
+  // 读写：带偏移时先按文件读写，不可seek的fd忽略偏移。
+  // socket 用 MSG_DONTWAIT 收发，阻塞的 socket 也不会卡住 worker；
+  // 管道、eventfd 等其它fd需要是非阻塞的
+  static int rw(const io_uring_sqe &sqe, bool write, bool vectored) {
+    auto fd = sqe.fd;
+    auto addr = reinterpret_cast<void *>(sqe.addr);
+    auto off = static_cast<off_t>(sqe.off);
+    auto iov = static_cast<iovec *>(addr);
+    auto iovcnt = static_cast<int>(sqe.len);
+    ssize_t ret{-1};
+    if (sqe.off != static_cast<std::uint64_t>(-1)) {
+      if (vectored) {
+        ret = write ? ::pwritev(fd, iov, iovcnt, off)
+                    : ::preadv(fd, iov, iovcnt, off);
+      } else {
+        ret = write ? ::pwrite(fd, addr, sqe.len, off)
+                    : ::pread(fd, addr, sqe.len, off);
+      }
+      if (ret >= 0 || errno != ESPIPE) {
+        return sys_result(ret);
+      }
+    }
+    if (vectored) {
+      msghdr msg{};
+      msg.msg_iov = iov;
+      msg.msg_iovlen = static_cast<std::size_t>(iovcnt);
+      ret = write ? ::sendmsg(fd, &msg, MSG_DONTWAIT)
+                  : ::recvmsg(fd, &msg, MSG_DONTWAIT);
+    } else {
+      ret = write ? ::send(fd, addr, sqe.len, MSG_DONTWAIT)
+                  : ::recv(fd, addr, sqe.len, MSG_DONTWAIT);
+    }
+    if (ret >= 0 || errno != ENOTSOCK) {
+      return sys_result(ret);
+    }
+    if (vectored) {
+      ret = write ? ::writev(fd, iov, iovcnt) : ::readv(fd, iov, iovcnt);
+    } else {
+      ret = write ? ::write(fd, addr, sqe.len) : ::read(fd, addr, sqe.len);
+    }
+    return sys_result(ret);
+  }
+
+  int perform(Op *op) {
+    const auto &sqe = op->sqe;
+    if ((sqe.flags & (IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT)) != 0) {
+      return -EOPNOTSUPP;
+    }
+    auto addr = reinterpret_cast<void *>(sqe.addr);
+    auto msg_flags = static_cast<int>(sqe.msg_flags) | MSG_DONTWAIT;
+    switch (sqe.opcode) {
+    case IORING_OP_NOP:
+      return 0;
+    case IORING_OP_READ:
+    case IORING_OP_READ_FIXED:
+      return wait_for(op, rw(sqe, false, false), EPOLLIN);
+    case IORING_OP_WRITE:
+    case IORING_OP_WRITE_FIXED:
+      return wait_for(op, rw(sqe, true, false), EPOLLOUT);
+    case IORING_OP_READV:
+      return wait_for(op, rw(sqe, false, true), EPOLLIN);
+    case IORING_OP_WRITEV:
+      return wait_for(op, rw(sqe, true, true), EPOLLOUT);
+    case IORING_OP_RECV:
+      return wait_for(op, sys_result(::recv(sqe.fd, addr, sqe.len, msg_flags)),
+                      EPOLLIN);
+    case IORING_OP_SEND:
+    case IORING_OP_SEND_ZC:
+      if (sqe.addr2 != 0) {
+        return wait_for(
+            op,
+            sys_result(::sendto(sqe.fd, addr, sqe.len, msg_flags,
+                                reinterpret_cast<sockaddr *>(sqe.addr2),
+                                sqe.addr_len)),
+            EPOLLOUT);
+      }
+      return wait_for(op, sys_result(::send(sqe.fd, addr, sqe.len, msg_flags)),
+                      EPOLLOUT);
+    case IORING_OP_RECVMSG:
+      if ((sqe.ioprio & IORING_RECV_MULTISHOT) != 0) {
+        return -EOPNOTSUPP;
+      }
+      return wait_for(
+          op, sys_result(::recvmsg(sqe.fd, static_cast<msghdr *>(addr), msg_flags)),
+          EPOLLIN);
+    case IORING_OP_SENDMSG:
+    case IORING_OP_SENDMSG_ZC:
+      return wait_for(
+          op,
+          sys_result(::sendmsg(sqe.fd, static_cast<const msghdr *>(addr), msg_flags)),
+          EPOLLOUT);
+    case IORING_OP_ACCEPT:
+      return wait_for(
+          op,
+          sys_result(::accept4(sqe.fd, static_cast<sockaddr *>(addr),
+                               reinterpret_cast<socklen_t *>(sqe.addr2),
+                               static_cast<int>(sqe.accept_flags))),
+          EPOLLIN);
+    case IORING_OP_CONNECT:
+      return connect(op);
+    case IORING_OP_POLL_ADD: {
+      struct pollfd pfd{.fd = sqe.fd,
+                        .events = static_cast<short>(sqe.poll32_events),
+                        .revents = 0};
+      auto ret = ::poll(&pfd, 1, 0);
+      if (ret == 0) {
+        return wait_for(op, -EAGAIN, sqe.poll32_events);
+      }
+      return ret < 0 ? -errno : pfd.revents;
+    }
+    case IORING_OP_SHUTDOWN:
+      return sys_result(::shutdown(sqe.fd, static_cast<int>(sqe.len)));
+    case IORING_OP_CLOSE:
+      if (sqe.file_index != 0) {
+        return -EOPNOTSUPP;
+      }
+      return close_fd(sqe.fd);
+    case IORING_OP_OPENAT:
+      if (sqe.file_index != 0) {
+        return -EOPNOTSUPP;
+      }
+      return sys_result(::openat(sqe.fd, static_cast<const char *>(addr),
+                                 static_cast<int>(sqe.open_flags), sqe.len));
+    case IORING_OP_STATX:
+      return sys_result(::statx(sqe.fd, static_cast<const char *>(addr),
+                                static_cast<int>(sqe.statx_flags), sqe.len,
+                                reinterpret_cast<struct statx *>(sqe.off)));
+    case IORING_OP_FSYNC:
+      return sys_result((sqe.fsync_flags & IORING_FSYNC_DATASYNC) != 0
+                            ? ::fdatasync(sqe.fd)
+                            : ::fsync(sqe.fd));
+    case IORING_OP_FALLOCATE:
+      return sys_result(::fallocate(sqe.fd, static_cast<int>(sqe.len),
+                                    static_cast<off_t>(sqe.off),
+                                    static_cast<off_t>(sqe.addr)));
+    case IORING_OP_FTRUNCATE:
+      return sys_result(::ftruncate(sqe.fd, static_cast<off_t>(sqe.off)));
+    case IORING_OP_FADVISE:
+      return -::posix_fadvise(sqe.fd, static_cast<off_t>(sqe.off), sqe.len,
+                              static_cast<int>(sqe.fadvise_advice));
+    case IORING_OP_MADVISE:
+      return sys_result(::madvise(addr, sqe.len,
+                                  static_cast<int>(sqe.fadvise_advice)));
+    case IORING_OP_UNLINKAT:
+      return sys_result(::unlinkat(sqe.fd, static_cast<const char *>(addr),
+                                   static_cast<int>(sqe.unlink_flags)));
+    case IORING_OP_RENAMEAT:
+      return sys_result(::renameat2(sqe.fd, static_cast<const char *>(addr),
+                                    static_cast<int>(sqe.len),
+                                    reinterpret_cast<const char *>(sqe.addr2),
+                                    sqe.rename_flags));
+    case IORING_OP_SOCKET:
+      return sys_result(::socket(sqe.fd, static_cast<int>(sqe.off),
+                                 static_cast<int>(sqe.len)));
+    case IORING_OP_ASYNC_CANCEL:
+      return cancel_matching(sqe, op);
+    case IORING_OP_TIMEOUT:
+      return -EAGAIN;
+    case IORING_OP_TIMEOUT_REMOVE:
+      return remove_timeout(sqe);
+    default:
+      // msg_ring、uring_cmd 等依赖 io_uring 的请求；
+      // splice 到阻塞 socket 时会阻塞整个 worker，也不在这里执行，
+      // copy_bidirectional 会退化为用户态拷贝
+      return -EOPNOTSUPP;
+    }
+  }
+
+  // 非阻塞 connect：EINPROGRESS 时等待可写，再从 SO_ERROR 取结果
+  int connect(Op *op) {
+    const auto &sqe = op->sqe;
+    if (op->connecting) {
+      int err{0};
+      socklen_t len = sizeof(err);
+      if (::getsockopt(sqe.fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+        return -errno;
+      }
+      return -err;
+    }
+    auto ret = ::connect(sqe.fd, reinterpret_cast<const sockaddr *>(sqe.addr),
+                         static_cast<socklen_t>(sqe.off));
+    if (ret < 0 && errno == EINPROGRESS) {
+      op->connecting = true;
+      op->events = EPOLLOUT;
+      return -EAGAIN;
+    }
+    return sys_result(ret);
+  }
+
+private:
+  io_uring *_ring{nullptr};
+  int _epfd{-1};
+  std::vector<io_uring_sqe> _sqes{};  // 提交队列
+  std::vector<unsigned> _sq_array{};  // 提交队列的索引数组（不使用）
+  std::vector<io_uring_cqe> _cqes{};  // 完成队列
+  unsigned _sq_head{0};
+  unsigned _sq_tail{0};
+  unsigned _sq_flags{0};
+  unsigned _sq_dropped{0};
+  unsigned _cq_head{0};
+  unsigned _cq_tail{0};
+  unsigned _cq_flags{0};
+  unsigned _cq_overflow{0};
+  std::deque<Completion> _overflow{};                  // 完成队列满时暂存
+  std::unordered_map<int, FdWaiters> _fds{};           // 按fd等待就绪的请求
+  std::size_t _waiting{0};                             // 等待就绪的请求数
+  std::multimap<std::chrono::steady_clock::time_point, Op *> _timers{}; // 超时
+  Op *_in_flight{nullptr};                             // 在途请求链表
+  std::uint64_t _next_id{0};                           // 节点编号
+  std::vector<Op *> _free_ops{};                       // 请求节点池
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_EPOLL_EPOLL_BACKEND_HPP
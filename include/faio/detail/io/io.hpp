@@ -3,28 +3,42 @@
 
 #include "faio/detail/io/awaiter/accept.hpp"
 #include "faio/detail/io/awaiter/cancel.hpp"
+#include "faio/detail/io/awaiter/chain.hpp"
 #include "faio/detail/io/awaiter/close.hpp"
 #include "faio/detail/io/awaiter/cmd_sock.hpp"
 #include "faio/detail/io/awaiter/connect.hpp"
+#include "faio/detail/io/awaiter/fallocate.hpp"
 #include "faio/detail/io/awaiter/fsync.hpp"
+#include "faio/detail/io/awaiter/ftruncate.hpp"
+#include "faio/detail/io/awaiter/madvise.hpp"
 #include "faio/detail/io/awaiter/open.hpp"
+#include "faio/detail/io/awaiter/poll.hpp"
 #include "faio/detail/io/awaiter/read.hpp"
+#include "faio/detail/io/awaiter/read_fixed.hpp"
 #include "faio/detail/io/awaiter/readv.hpp"
 #include "faio/detail/io/awaiter/recv.hpp"
 #include "faio/detail/io/awaiter/recvfrom.hpp"
 #include "faio/detail/io/awaiter/recvmsg.hpp"
+#include "faio/detail/io/awaiter/rename.hpp"
 #include "faio/detail/io/awaiter/send.hpp"
 #include "faio/detail/io/awaiter/sendmsg.hpp"
 #include "faio/detail/io/awaiter/sendto.hpp"
 #include "faio/detail/io/awaiter/shutdown.hpp"
 #include "faio/detail/io/awaiter/socket.hpp"
+#include "faio/detail/io/awaiter/splice.hpp"
+#include "faio/detail/io/awaiter/statx.hpp"
+#include "faio/detail/io/awaiter/unlink.hpp"
 #include "faio/detail/io/awaiter/write.hpp"
+#include "faio/detail/io/awaiter/write_fixed.hpp"
 #include "faio/detail/io/awaiter/writev.hpp"
+#include "faio/detail/io/base/buffer_chain.hpp"
 
 namespace faio::io::detail {
 class FileDescriptor {
 protected:
-  explicit FileDescriptor(int fd) : _fd{fd} {}
+  // cancel_on_close 为true时，关闭前先取消提交过这个 fd 的请求的各个 ring 上的全部在途请求（socket）
+  explicit FileDescriptor(int fd, bool cancel_on_close = false)
+      : _fd{fd}, _cancel_on_close{cancel_on_close} {}
 
   ~FileDescriptor() {
     if (_fd >= 0) {
@@ -32,7 +46,8 @@ protected:
     }
   }
 
-  FileDescriptor(FileDescriptor &&other) noexcept : _fd{other._fd} {
+  FileDescriptor(FileDescriptor &&other) noexcept
+      : _fd{other._fd}, _cancel_on_close{other._cancel_on_close} {
     other._fd = -1;
   }
 
@@ -41,6 +56,7 @@ protected:
       do_close();
     }
     _fd = other._fd;
+    _cancel_on_close = other._cancel_on_close;
     other._fd = -1;
     return *this;
   }
@@ -53,7 +69,13 @@ public:
   auto close() noexcept {
     auto fd = _fd;
     _fd = -1;
-    return Close{fd};
+    return CloseFd{fd, _cancel_on_close};
+  }
+
+  /// 取消各 worker 的 ring 上这个 fd 的全部在途请求，结果为取消的请求数
+  /// 被取消的请求以 ECANCELED 完成
+  auto cancel_all() noexcept {
+    return CancelFd{_fd, IORING_ASYNC_CANCEL_ALL};
   }
 
   [[nodiscard]]
@@ -93,13 +115,19 @@ public:
 
 private:
   void do_close() noexcept {
-    auto sqe = current_uring->get_sqe();
-    if (sqe != nullptr) [[likely]] {
-      // async close
-      io_uring_prep_close(sqe, _fd);
-      io_uring_sqe_set_data(sqe, nullptr);
+    if (current_uring != nullptr) [[likely]] {
+      if (_cancel_on_close) {
+        // 各 ring 上的取消全部完成之后再异步关闭
+        FdCancel::cancel_and_close(_fd, nullptr);
+      } else {
+        // async close，提交队列满时暂存到下一次收割后补交
+        forget_fd_rings(_fd);
+        auto sqe = current_uring->get_detached_sqe();
+        io_uring_prep_close(sqe, _fd);
+        io_uring_sqe_set_data(sqe, nullptr);
+      }
     } else {
-      // sync close
+      // 不在 worker 线程上（没有 uring 实例），sync close
       for (auto i = 1; i <= 3; i += 1) {
         auto ret = ::close(_fd);
         if (ret == 0) [[likely]] {
@@ -115,6 +143,7 @@ private:
 
 protected:
   int _fd;
+  bool _cancel_on_close; // 关闭前是否取消在途请求
 };
 } // namespace faio::io::detail
 
@@ -125,12 +154,35 @@ static inline auto accept(int fd, struct sockaddr *addr, socklen_t *addrlen,
   return detail::Accept{fd, addr, addrlen, flags};
 }
 
+// 从当前 worker 的注册缓冲区租借 size 字节
+// 不在 worker 上、注册失败或空间不足时退化为普通内存，*_fixed 操作仍然可用
+static inline auto fixed_buffer(std::size_t size) {
+  if (detail::current_uring == nullptr) [[unlikely]] {
+    return FixedBuffer{nullptr, size};
+  }
+  return FixedBuffer{detail::current_uring->fixed_buffers(), size};
+}
+
 // 取消io操作
 static inline auto cancel(int fd, unsigned int flags) {
   return detail::Cancel{fd, flags};
 }
+// 取消所有 worker 的 ring 上 fd 的在途请求，默认全部取消，结果为取消的请求数
+static inline auto cancel_fd(int fd, unsigned int flags = IORING_ASYNC_CANCEL_ALL) {
+  return detail::CancelFd{fd, flags};
+}
+// 链式提交多个io操作，前一个完成后才开始下一个，结果按顺序以tuple返回
+template <class... IOs>
+  requires(!std::is_lvalue_reference_v<IOs> && ...)
+static inline auto chain(IOs &&...ios) {
+  return detail::Chain<IOs...>{std::forward<IOs>(ios)...};
+}
 // 关闭文件描述符
 static inline auto close(int fd) { return detail::Close{fd}; }
+// 关闭固定文件表中的槽位
+static inline auto close_direct(unsigned file_index) {
+  return detail::CloseDirect{file_index};
+}
 // 获取socket选项
 static inline auto getsockopt(int fd, int level, int optname, void *optval,
                               int optlen) {
@@ -153,16 +205,38 @@ static inline auto connect(int fd, const struct sockaddr *addr,
                            socklen_t addrlen) {
   return detail::Connect{fd, addr, addrlen};
 }
+// 预分配或打洞
+static inline auto fallocate(int fd, int mode, __u64 offset, __u64 len) {
+  return detail::Fallocate{fd, mode, offset, len};
+}
+// 文件访问模式建议
+static inline auto fadvise(int fd, __u64 offset, __u32 len, int advice) {
+  return detail::Fadvise{fd, offset, len, advice};
+}
 // 同步文件
 static inline auto fsync(int fd, unsigned fsync_flags) {
   return detail::Fsync{fd, fsync_flags};
 }
+// 截断文件
+static inline auto ftruncate(int fd, loff_t len) {
+  return detail::Ftruncate{fd, len};
+}
+// 内存访问模式建议
+static inline auto madvise(void *addr, __u32 length, int advice) {
+  return detail::Madvise{addr, length, advice};
+}
 
 // 打开文件
 inline auto open(const char *path, int flags, mode_t mode) {
   return detail::Open{path, flags, mode};
 }
 
+// 打开文件到固定文件表的槽位
+static inline auto open_direct(int dfd, const char *path, int flags,
+                               mode_t mode, unsigned file_index) {
+  return detail::OpenDirect{dfd, path, flags, mode, file_index};
+}
+
 // 打开文件2
 static inline auto open2(const char *path, struct open_how *how) {
   return detail::Open2{path, how};
@@ -177,17 +251,32 @@ static inline auto openat(int dfd, const char *path, int flags, mode_t mode) {
 static inline auto openat2(int dfd, const char *path, struct open_how *how) {
   return detail::Open2{dfd, path, how};
 }
+// 等待fd就绪
+static inline auto poll_add(int fd, unsigned poll_mask) {
+  return detail::PollAdd{fd, poll_mask};
+}
 // 读取文件
 static inline auto read(int fd, void *buf, std::size_t nbytes,
                         uint64_t offset) {
   return detail::Read{fd, buf, nbytes, offset};
 }
 
+// 读取到注册缓冲区
+static inline auto read_fixed(int fd, FixedBuffer &buf, std::size_t nbytes,
+                              uint64_t offset) {
+  return detail::ReadFixed{fd, buf, nbytes, offset};
+}
+
 // 读取文件v
 static inline auto readv(int fd, const struct iovec *iovecs, unsigned nr_vecs,
                          __u64 offset, int flags = 0) {
   return detail::ReadV{fd, iovecs, nr_vecs, offset, flags};
 }
+// 分散读取到iovec链，一次最多提交 IOV_MAX 段
+static inline auto readv(int fd, BufferChain &chain, __u64 offset,
+                         int flags = 0) {
+  return detail::ReadV{fd, chain.data(), chain.io_count(), offset, flags};
+}
 // 接收数据
 static inline auto recv(int sockfd, void *buf, size_t len, int flags) {
   return detail::Recv{sockfd, buf, len, flags};
@@ -209,12 +298,24 @@ static inline auto send(int sockfd, const void *buf, size_t len, int flags) {
   return detail::Send{sockfd, buf, len, flags};
 }
 
+// 从注册缓冲区发送
+static inline auto send(int sockfd, const FixedBuffer &buf, size_t len,
+                        int flags) {
+  return detail::Send{sockfd, buf, len, flags};
+}
+
 // 发送数据零拷贝
 static inline auto send_zc(int sockfd, const void *buf, size_t len, int flags,
                            unsigned zc_flags) {
   return detail::SendZC{sockfd, buf, len, flags, zc_flags};
 }
 
+// 从注册缓冲区零拷贝发送
+static inline auto send_zc(int sockfd, const FixedBuffer &buf, size_t len,
+                           int flags, unsigned zc_flags) {
+  return detail::SendZC{sockfd, buf, len, flags, zc_flags};
+}
+
 // 发送消息
 static inline auto sendmsg(int fd, const struct msghdr *msg, unsigned flags) {
   return detail::SendMsg{fd, msg, flags};
@@ -230,6 +331,11 @@ static inline auto sendto(int sockfd, const void *buf, size_t len, int flags,
                           const struct sockaddr *addr, socklen_t addrlen) {
   return detail::SendTo{sockfd, buf, len, flags, addr, addrlen};
 }
+// 重命名
+static inline auto renameat(int old_dfd, const char *old_path, int new_dfd,
+                            const char *new_path, unsigned flags) {
+  return detail::Rename{old_dfd, old_path, new_dfd, new_path, flags};
+}
 // 关闭连接
 static inline auto shutdown(int fd, int how) {
   return detail::Shutdown{fd, how};
@@ -239,16 +345,45 @@ static inline auto socket(int domain, int type, int protocol,
                           unsigned int flags) {
   return detail::Socket{domain, type, protocol, flags};
 }
+// 经由管道在两个fd之间搬运数据
+static inline auto splice(int fd_in, int64_t off_in, int fd_out,
+                          int64_t off_out, unsigned nbytes,
+                          unsigned splice_flags) {
+  return detail::Splice{fd_in, off_in, fd_out, off_out, nbytes, splice_flags};
+}
+// 获取文件元数据
+static inline auto statx(int dfd, const char *path, int flags, unsigned mask) {
+  return detail::Statx{dfd, path, flags, mask};
+}
+// 复制管道数据
+static inline auto tee(int fd_in, int fd_out, unsigned nbytes,
+                       unsigned splice_flags) {
+  return detail::Tee{fd_in, fd_out, nbytes, splice_flags};
+}
+// 删除文件或目录
+static inline auto unlinkat(int dfd, const char *path, int flags) {
+  return detail::Unlink{dfd, path, flags};
+}
 // 写入文件
 static inline auto write(int fd, const void *buf, unsigned nbytes,
                          __u64 offset) {
   return detail::Write(fd, buf, nbytes, offset);
 }
+// 从注册缓冲区写入
+static inline auto write_fixed(int fd, const FixedBuffer &buf,
+                               std::size_t nbytes, __u64 offset) {
+  return detail::WriteFixed{fd, buf, nbytes, offset};
+}
 // 写入文件v
 static inline auto writev(int fd, const struct iovec *iovecs, unsigned nr_vecs,
                           __u64 offset, int flags = 0) {
   return detail::WriteV{fd, iovecs, nr_vecs, offset, flags};
 }
+// 从iovec链集中写入，一次最多提交 IOV_MAX 段
+static inline auto writev(int fd, const BufferChain &chain, __u64 offset,
+                          int flags = 0) {
+  return detail::WriteV{fd, chain.data(), chain.io_count(), offset, flags};
+}
 } // namespace faio::io
 
 #endif // FAIO_DETAIL_IO_IO_HPP
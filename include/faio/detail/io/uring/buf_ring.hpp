@@ -0,0 +1,88 @@
+#ifndef FAIO_DETAIL_IO_URING_BUF_RING_HPP
+#define FAIO_DETAIL_IO_URING_BUF_RING_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <liburing.h>
+#include <memory>
+
+namespace faio::io::detail {
+
+// 提供给内核的缓冲区环（provided buffer ring）
+// 带 IOSQE_BUFFER_SELECT 的请求在数据到达时才由内核从环中挑选缓冲区，
+// CQE 的高16位是缓冲区编号；用户处理完后通过 recycle 把缓冲区还给内核
+// 环的尾指针只由用户态推进，同一时刻只能有一个线程调用 recycle
+class ProvidedBufferRing {
+public:
+  // 内核限制环的长度不超过 32768
+  static constexpr unsigned MAX_BUFFERS{32768};
+
+public:
+  ProvidedBufferRing() = default;
+
+  ProvidedBufferRing(const ProvidedBufferRing &) = delete;
+  ProvidedBufferRing &operator=(const ProvidedBufferRing &) = delete;
+
+public:
+  /// 在ring上注册组号为group的缓冲区环，count向上取整为2的幂
+  /// 成功返回0，失败返回负的errno（旧内核为-EINVAL，组号被占用为-EEXIST，
+  /// epoll 后端为-ENOSYS）
+  [[nodiscard]] int setup(io_uring *ring, std::uint16_t group, unsigned count,
+                          std::size_t size) {
+    if (ring->ring_fd < 0) {
+      // epoll 后端的 ring 只是用户态内存，没有内核的缓冲区环
+      return -ENOSYS;
+    }
+    _count = std::bit_ceil(std::clamp(count, 1u, MAX_BUFFERS));
+    _size = size;
+    _group = group;
+    int ret{0};
+    _ring = io_uring_setup_buf_ring(ring, _count, group, 0, &ret);
+    if (_ring == nullptr) {
+      return ret;
+    }
+    _mask = io_uring_buf_ring_mask(_count);
+    _memory = std::make_unique_for_overwrite<char[]>(_count * _size);
+    for (unsigned bid = 0; bid < _count; bid += 1) {
+      io_uring_buf_ring_add(_ring, buffer(bid), _size, bid, _mask, bid);
+    }
+    io_uring_buf_ring_advance(_ring, _count);
+    return 0;
+  }
+
+  /// 注销并释放环，只能在缓冲区不再被内核使用后调用
+  void release(io_uring *ring) {
+    if (_ring != nullptr) {
+      io_uring_free_buf_ring(ring, _ring, _count, _group);
+      _ring = nullptr;
+    }
+  }
+
+  /// 编号为bid的缓冲区
+  [[nodiscard]] char *buffer(std::uint16_t bid) const noexcept {
+    return _memory.get() + bid * _size;
+  }
+
+  /// 把缓冲区还给内核
+  void recycle(std::uint16_t bid) noexcept {
+    io_uring_buf_ring_add(_ring, buffer(bid), _size, bid, _mask, 0);
+    io_uring_buf_ring_advance(_ring, 1);
+  }
+
+  [[nodiscard]] std::uint16_t group() const noexcept { return _group; }
+  [[nodiscard]] unsigned count() const noexcept { return _count; }
+  [[nodiscard]] std::size_t buffer_size() const noexcept { return _size; }
+
+private:
+  io_uring_buf_ring *_ring{nullptr};  // 与内核共享的环
+  std::unique_ptr<char[]> _memory{};  // 全部缓冲区
+  unsigned _count{0};                 // 缓冲区个数
+  std::size_t _size{0};               // 每个缓冲区的大小
+  int _mask{0};                       // 环的掩码
+  std::uint16_t _group{0};            // 缓冲区组号
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_URING_BUF_RING_HPP
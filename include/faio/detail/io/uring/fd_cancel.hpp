@@ -0,0 +1,289 @@
+#ifndef FAIO_DETAIL_IO_URING_FD_CANCEL_HPP
+#define FAIO_DETAIL_IO_URING_FD_CANCEL_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/io/uring/io_uring.hpp"
+#include "faio/detail/io/uring/io_user_data.hpp"
+#include "faio/detail/io/uring/waker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <liburing.h>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <sys/resource.h>
+#include <vector>
+
+namespace faio::io::detail {
+
+class FdCancel;
+
+// worker 的取消信箱：其他 worker 投递的按 fd 取消请求
+// 请求只能在提交它的 ring 上取消，所以投递之后唤醒目标 worker，由它在 drive 中放入自己的 ring
+class CancelMailbox {
+public:
+  /// 目标 worker 已经退出（没有唤醒器）时返回 false，它的 ring 上不会再有在途请求
+  [[nodiscard]] bool post(FdCancel *cancel) {
+    {
+      std::lock_guard lock{_mutex};
+      if (_waker == nullptr) [[unlikely]] {
+        return false;
+      }
+      _cancels.push_back(cancel);
+      _pending.store(true, std::memory_order::release);
+      _waker->wake_up();
+    }
+    return true;
+  }
+
+  /// 取出全部投递的请求，只由信箱所属的 worker 调用
+  void take(std::vector<FdCancel *> &out) {
+    if (!_pending.exchange(false, std::memory_order::acquire)) [[likely]] {
+      return;
+    }
+    std::lock_guard lock{_mutex};
+    out.swap(_cancels);
+  }
+
+  /// 所属 worker 的 IO 引擎创建、销毁时设置
+  void set_waker(Waker *waker) {
+    std::lock_guard lock{_mutex};
+    _waker = waker;
+  }
+
+private:
+  std::mutex _mutex;
+  std::vector<FdCancel *> _cancels;
+  std::atomic<bool> _pending{false};
+  Waker *_waker{nullptr};
+};
+
+// 每个 fd 提交过请求的 ring 的位图，按 fd 号索引，第 i 位对应第 i 个 worker
+//
+// 请求提交时记下当前 ring 的位，cancel_on_close 的 fd 关闭时取出位图并清零，
+// 取消只投递给位图中的 ring。fd 号超出表的范围（RLIMIT_NOFILE，最多 65536）
+// 或者 worker 超过 64 个时，视为所有 ring 都提交过
+class FdRings {
+public:
+  static constexpr std::uint64_t all = ~std::uint64_t{0};
+
+  explicit FdRings(std::size_t num_rings)
+      : _capacity{num_rings > 64 ? 0 : table_size()},
+        _masks{std::make_unique<std::atomic<std::uint64_t>[]>(_capacity)} {}
+
+  /// 记下 ring 提交了 fd 的请求，位已经置上时只有一次读
+  void record(int fd, std::size_t ring) noexcept {
+    if (fd < 0 || static_cast<std::size_t>(fd) >= _capacity) {
+      return;
+    }
+    auto bit = std::uint64_t{1} << ring;
+    auto &mask = _masks[fd];
+    if ((mask.load(std::memory_order::relaxed) & bit) == 0) [[unlikely]] {
+      mask.fetch_or(bit, std::memory_order::relaxed);
+    }
+  }
+
+  /// 提交过 fd 的请求的 ring
+  [[nodiscard]] auto of(int fd) const noexcept -> std::uint64_t {
+    if (fd < 0 || static_cast<std::size_t>(fd) >= _capacity) {
+      return all;
+    }
+    return _masks[fd].load(std::memory_order::acquire);
+  }
+
+  /// 取出并清零，fd 关闭之后号码会被复用
+  [[nodiscard]] auto take(int fd) noexcept -> std::uint64_t {
+    if (fd < 0 || static_cast<std::size_t>(fd) >= _capacity) {
+      return all;
+    }
+    return _masks[fd].exchange(0, std::memory_order::acq_rel);
+  }
+
+private:
+  static auto table_size() noexcept -> std::size_t {
+    constexpr std::size_t max_size = 65536;
+    struct rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+      return max_size;
+    }
+    return std::min<std::size_t>(limit.rlim_cur, max_size);
+  }
+
+private:
+  std::size_t _capacity;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> _masks;
+};
+
+// 同一个运行时中所有 worker 的信箱，以及当前 worker 的序号
+// 只有一个 worker 时 rings 为空，不记录也不投递
+struct CancelMailboxes {
+  std::span<CancelMailbox> all;
+  std::size_t self{0};
+  FdRings *rings{nullptr};
+};
+
+// 线程局部存储，当前 worker 可以投递的信箱，不在运行时中时为空
+inline thread_local CancelMailboxes current_cancel_mailboxes{};
+
+/// 提交 fd 的请求时调用，记下当前 ring
+inline void record_fd_ring(int fd) noexcept {
+  auto &mailboxes = current_cancel_mailboxes;
+  if (mailboxes.rings != nullptr) [[unlikely]] {
+    mailboxes.rings->record(fd, mailboxes.self);
+  }
+}
+
+/// 不经取消直接关闭 fd 时调用，清除记录，号码复用之后不会多投递
+inline void forget_fd_rings(int fd) noexcept {
+  if (auto rings = current_cancel_mailboxes.rings; rings != nullptr) [[unlikely]] {
+    static_cast<void>(rings->take(fd));
+  }
+}
+
+// 在所有 worker 的 ring 上取消 fd 的在途请求
+//
+// 任务被窃取之后，同一个 fd 的请求可能分散在多个 ring 上。当前 ring 直接放入取消请求，
+// FdRings 中记录提交过这个 fd 的其他 ring 经由信箱放入；每个 ring 的 CQE 都交给 on_cqe 累加结果，
+// 最后一个完成的 ring 负责收尾：恢复等待的协程，或者在全部取消之后再关闭 fd
+// （提前关闭的话 fd 号可能被复用，迟到的取消会误伤新的 fd）
+class FdCancel final : public io_cqe_handler_t {
+public:
+  // 全部取消之后恢复 handle
+  FdCancel(int fd, unsigned flags, std::coroutine_handle<> handle)
+      : _fd{fd}, _flags{flags}, _handle{handle} {}
+
+  /// 取消 fd 的全部在途请求之后关闭它，关闭的结果写入 close_data（可以为空）
+  /// 其他 ring 没有提交过这个 fd 的请求时由 IOSQE_IO_HARDLINK 连接取消和关闭，
+  /// 一次提交完成；否则请求对象在堆上，收尾时自行释放
+  static void cancel_and_close(int fd, io_user_data_t *close_data) {
+    auto rings = others(taken_rings(fd));
+    if (rings == 0) [[likely]] {
+      cancel_linked(fd);
+      auto sqe = current_uring->get_detached_sqe();
+      io_uring_prep_close(sqe, fd);
+      io_uring_sqe_set_data(sqe, close_data);
+      return;
+    }
+    auto cancel = new FdCancel{fd, IORING_ASYNC_CANCEL_ALL, nullptr};
+    cancel->_close_data = close_data;
+    cancel->_close = true;
+    cancel->_owned = true;
+    cancel->fan_out(rings);
+  }
+
+  /// 在当前 ring 上放入取消请求，并投递给提交过这个 fd 的请求的其他 worker
+  void start() {
+    auto rings = current_cancel_mailboxes.rings;
+    fan_out(rings == nullptr ? 0 : others(rings->of(_fd)));
+  }
+
+  /// 放入当前 ring，由投递目标的 worker 在 drive 中调用
+  void submit(IOuring &uring) {
+    auto sqe = uring.get_detached_sqe();
+    io_uring_prep_cancel_fd(sqe, _fd, _flags);
+    io_uring_sqe_set_data(sqe, &_user_data);
+  }
+
+  /// 被取消的请求数，没有可取消的请求时为0
+  [[nodiscard]] auto result() const noexcept -> expected<std::size_t> {
+    if (auto error = _error.load(std::memory_order::relaxed); error != 0) [[unlikely]] {
+      return std::unexpected{make_error(error)};
+    }
+    return _cancelled.load(std::memory_order::relaxed);
+  }
+
+  auto on_cqe(int result, unsigned) -> std::coroutine_handle<> override {
+    if (result > 0) {
+      _cancelled.fetch_add(static_cast<std::size_t>(result), std::memory_order::relaxed);
+    } else if (result < 0 && result != -ENOENT) [[unlikely]] {
+      auto expected = 0;
+      _error.compare_exchange_strong(expected, -result, std::memory_order::relaxed);
+    }
+    // 不是最后一个完成的 ring 时，请求对象随时可能被销毁，不能再访问
+    if (_pending.fetch_sub(1, std::memory_order::acq_rel) != 1) {
+      return nullptr;
+    }
+    if (_close) {
+      auto sqe = current_uring->get_detached_sqe();
+      io_uring_prep_close(sqe, _fd);
+      io_uring_sqe_set_data(sqe, _close_data);
+    }
+    auto handle = _handle;
+    if (_owned) {
+      delete this;
+    }
+    return handle;
+  }
+
+private:
+  // 除当前 ring 之外的位
+  static auto others(std::uint64_t rings) noexcept -> std::uint64_t {
+    auto self = current_cancel_mailboxes.self;
+    return self < 64 ? rings & ~(std::uint64_t{1} << self) : rings;
+  }
+
+  // 关闭时取出记录；只有一个 worker 时没有记录
+  static auto taken_rings(int fd) noexcept -> std::uint64_t {
+    auto rings = current_cancel_mailboxes.rings;
+    return rings == nullptr ? 0 : rings->take(fd);
+  }
+
+  // 第 i 个 worker 是否需要投递，超过 64 个 worker 时位图总是全部置上
+  static auto wanted(std::uint64_t rings, std::size_t i) noexcept -> bool {
+    return i >= 64 || ((rings >> i) & 1) != 0;
+  }
+
+  // 在当前 ring 上放入取消请求，并投递给 rings 中的其他 worker
+  void fan_out(std::uint64_t rings) {
+    auto mailboxes = current_cancel_mailboxes;
+    std::size_t targets = 0;
+    for (std::size_t i = 0; rings != 0 && i < mailboxes.all.size(); ++i) {
+      targets += i != mailboxes.self && wanted(rings, i) ? 1 : 0;
+    }
+    // 先计入全部目标 ring，再放入请求，避免先完成的 ring 提前收尾
+    _pending.store(targets + 1, std::memory_order::relaxed);
+    submit(*current_uring);
+    for (std::size_t i = 0; targets != 0 && i < mailboxes.all.size(); ++i) {
+      if (i != mailboxes.self && wanted(rings, i) && !mailboxes.all[i].post(this)) {
+        // 返回值只在最后一个完成时不为空，而本地 ring 的 CQE 此时还没有收割
+        static_cast<void>(on_cqe(-ENOENT, 0));
+      }
+    }
+  }
+
+  // 在随后取出的 close sqe 之前放入 IORING_ASYNC_CANCEL_ALL 的取消请求
+  // 提交队列有两个空位时两者通过 IOSQE_IO_HARDLINK 相连：取消先于关闭执行，
+  // 没有可取消的请求（-ENOENT）时关闭照常执行
+  static void cancel_linked(int fd) {
+    if (current_uring->sq_space_left() < 2) {
+      current_uring->reset_and_submit();
+    }
+    auto link = current_uring->sq_space_left() >= 2;
+    auto sqe = current_uring->get_detached_sqe();
+    io_uring_prep_cancel_fd(sqe, fd, IORING_ASYNC_CANCEL_ALL);
+    io_uring_sqe_set_data(sqe, nullptr);
+    if (link) {
+      sqe->flags |= IOSQE_IO_HARDLINK;
+    }
+  }
+
+private:
+  int _fd;
+  unsigned _flags;
+  std::coroutine_handle<> _handle;        // 全部取消之后恢复的协程
+  io_user_data_t *_close_data{nullptr};   // 关闭 fd 的请求数据，可以为空
+  bool _close{false};                     // 全部取消之后是否关闭 fd
+  bool _owned{false};                     // 收尾时是否释放自己
+  io_user_data_t _user_data{.handler = this}; // 各 ring 的取消请求共用
+  std::atomic<std::size_t> _pending{0};   // 尚未完成取消的 ring 数
+  std::atomic<std::size_t> _cancelled{0}; // 各 ring 取消的请求数之和
+  std::atomic<int> _error{0};             // 第一个失败的 ring 的错误码
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_URING_FD_CANCEL_HPP
@@ -0,0 +1,240 @@
+#ifndef FAIO_DETAIL_IO_URING_FIXED_BUFFER_HPP
+#define FAIO_DETAIL_IO_URING_FIXED_BUFFER_HPP
+
+#include "fastlog/fastlog.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <liburing.h>
+#include <memory>
+#include <new>
+#include <span>
+#include <sys/uio.h>
+
+namespace faio::io::detail {
+
+// 注册缓冲区的分配粒度，同时也是缓冲区的对齐大小（满足 O_DIRECT 的要求）
+static inline constexpr std::size_t FIXED_BUFFER_CHUNK{4096uz};
+
+// 每个 worker 一块注册到 io_uring 的内存
+// 整块内存作为一个 iovec 通过 io_uring_register_buffers 注册，buf_index 固定为 0，
+// 内核在注册时一次性 pin 住页面，*_FIXED 操作不再逐次 pin/unpin
+// 按 FIXED_BUFFER_CHUNK 分块，用位图记录占用：分配只发生在所属 worker 上，
+// 协程可能被窃取到其他 worker 后才释放缓冲区，因此位图使用原子操作
+class FixedBufferArena {
+public:
+  static constexpr int BUF_INDEX{0};
+
+  explicit FixedBufferArena(std::size_t size)
+      : _num_chunks(size / FIXED_BUFFER_CHUNK),
+        _bitmap(std::make_unique<std::atomic<std::uint64_t>[]>(
+            (_num_chunks + 63) / 64)),
+        _memory(static_cast<char *>(
+            ::operator new(_num_chunks * FIXED_BUFFER_CHUNK,
+                           std::align_val_t{FIXED_BUFFER_CHUNK}))) {}
+
+  ~FixedBufferArena() {
+    ::operator delete(_memory, std::align_val_t{FIXED_BUFFER_CHUNK});
+  }
+
+  FixedBufferArena(const FixedBufferArena &) = delete;
+  FixedBufferArena &operator=(const FixedBufferArena &) = delete;
+
+public:
+  /// 注册到ring，内核不支持或超出 RLIMIT_MEMLOCK 时返回false
+  [[nodiscard]] bool register_to(io_uring *ring) {
+    struct iovec iov{.iov_base = _memory,
+                     .iov_len = _num_chunks * FIXED_BUFFER_CHUNK};
+    if (auto ret = io_uring_register_buffers(ring, &iov, 1); ret < 0) {
+      fastlog::console.warn("register fixed buffers failed, {}",
+                            strerror(-ret));
+      return false;
+    }
+    _ring.store(ring, std::memory_order::release);
+    return true;
+  }
+
+  /// 从ring注销，ring销毁前由所属worker调用
+  void unregister_from(io_uring *ring) {
+    _ring.store(nullptr, std::memory_order::release);
+    io_uring_unregister_buffers(ring);
+  }
+
+  /// 是否注册在给定的ring上
+  [[nodiscard]] bool registered_on(const io_uring *ring) const noexcept {
+    return ring != nullptr && _ring.load(std::memory_order::acquire) == ring;
+  }
+
+  /// 分配count个连续的块，空间不足时返回nullptr，只能在所属worker上调用
+  [[nodiscard]] char *allocate(std::size_t count) noexcept {
+    if (count == 0 || count > _num_chunks) {
+      return nullptr;
+    }
+    // 从上一次分配的位置开始首次适配，绕回一圈
+    for (auto scanned = 0uz; scanned < _num_chunks;) {
+      auto start = (_hint + scanned) % _num_chunks;
+      if (start + count > _num_chunks) {
+        scanned += _num_chunks - start;
+        continue;
+      }
+      auto used = first_used(start, count);
+      if (used == start + count) {
+        // 只有所属worker会置位，检查和置位之间位只会被其他线程清除，不会冲突
+        mark(start, count, true);
+        _hint = start + count;
+        return _memory + start * FIXED_BUFFER_CHUNK;
+      }
+      scanned += used + 1 - start;
+    }
+    return nullptr;
+  }
+
+  /// 归还count个连续的块，可以在任意线程调用
+  void deallocate(char *data, std::size_t count) noexcept {
+    auto start = static_cast<std::size_t>(data - _memory) / FIXED_BUFFER_CHUNK;
+    mark(start, count, false);
+  }
+
+  /// 块的数量
+  [[nodiscard]] std::size_t num_chunks() const noexcept { return _num_chunks; }
+
+private:
+  // [start, start + count) 中第一个被占用的块，全部空闲时返回 start + count
+  [[nodiscard]] std::size_t first_used(std::size_t start,
+                                       std::size_t count) const noexcept {
+    for (auto i = start; i < start + count;) {
+      auto word = _bitmap[i / 64].load(std::memory_order::acquire) >> (i % 64);
+      if (word == 0) {
+        i += 64 - i % 64;
+        continue;
+      }
+      auto index = i + std::countr_zero(word);
+      return index < start + count ? index : start + count;
+    }
+    return start + count;
+  }
+
+  void mark(std::size_t start, std::size_t count, bool used) noexcept {
+    for (auto i = start; i < start + count;) {
+      auto bits = std::min(64 - i % 64, start + count - i);
+      auto mask = (bits == 64 ? ~0ull : ((1ull << bits) - 1)) << (i % 64);
+      if (used) {
+        _bitmap[i / 64].fetch_or(mask, std::memory_order::acq_rel);
+      } else {
+        _bitmap[i / 64].fetch_and(~mask, std::memory_order::acq_rel);
+      }
+      i += bits;
+    }
+  }
+
+private:
+  std::size_t _num_chunks;                               // 块数量
+  std::unique_ptr<std::atomic<std::uint64_t>[]> _bitmap; // 占用位图
+  char *_memory;                                         // 注册的内存
+  std::atomic<io_uring *> _ring{nullptr}; // 注册所在的ring
+  std::size_t _hint{0};                   // 下一次分配的起点
+};
+
+} // namespace faio::io::detail
+
+namespace faio::io {
+
+// 注册缓冲区的租约
+// 析构时归还给所属 worker 的 arena（可以在任意线程析构）；
+// arena 不可用（未在 worker 上、注册失败或空间不足）时退化为按块对齐的堆内存，
+// 此时 *_fixed 操作自动退化为普通的 read/write/send_zc
+class FixedBuffer {
+public:
+  FixedBuffer() = default;
+
+  FixedBuffer(std::shared_ptr<detail::FixedBufferArena> arena, std::size_t size)
+      : _size(size),
+        _num_chunks((size + detail::FIXED_BUFFER_CHUNK - 1) /
+                    detail::FIXED_BUFFER_CHUNK) {
+    if (arena != nullptr) {
+      _data = arena->allocate(_num_chunks);
+    }
+    if (_data != nullptr) {
+      _arena = std::move(arena);
+    } else {
+      _data = static_cast<char *>(
+          ::operator new(_num_chunks * detail::FIXED_BUFFER_CHUNK,
+                         std::align_val_t{detail::FIXED_BUFFER_CHUNK}));
+    }
+  }
+
+  ~FixedBuffer() { release(); }
+
+  FixedBuffer(const FixedBuffer &) = delete;
+  FixedBuffer &operator=(const FixedBuffer &) = delete;
+
+  FixedBuffer(FixedBuffer &&other) noexcept
+      : _arena(std::move(other._arena)), _data(other._data),
+        _size(other._size), _num_chunks(other._num_chunks) {
+    other._data = nullptr;
+    other._size = 0;
+    other._num_chunks = 0;
+  }
+
+  FixedBuffer &operator=(FixedBuffer &&other) noexcept {
+    if (this != &other) {
+      release();
+      _arena = std::move(other._arena);
+      _data = other._data;
+      _size = other._size;
+      _num_chunks = other._num_chunks;
+      other._data = nullptr;
+      other._size = 0;
+      other._num_chunks = 0;
+    }
+    return *this;
+  }
+
+public:
+  [[nodiscard]] char *data() noexcept { return _data; }
+  [[nodiscard]] const char *data() const noexcept { return _data; }
+  [[nodiscard]] std::size_t size() const noexcept { return _size; }
+  [[nodiscard]] std::span<char> span() noexcept { return {_data, _size}; }
+  [[nodiscard]] std::span<const char> span() const noexcept {
+    return {_data, _size};
+  }
+
+  /// 是否来自注册缓冲区
+  [[nodiscard]] bool registered() const noexcept { return _arena != nullptr; }
+
+  /// 能否在给定的ring上使用 *_FIXED 操作
+  /// 协程被窃取到其他 worker 后，缓冲区不属于当前 ring，需要退化为普通操作
+  [[nodiscard]] bool usable_on(const io_uring *ring) const noexcept {
+    return _arena != nullptr && _arena->registered_on(ring);
+  }
+
+  [[nodiscard]] static constexpr int buf_index() noexcept {
+    return detail::FixedBufferArena::BUF_INDEX;
+  }
+
+private:
+  void release() noexcept {
+    if (_data == nullptr) {
+      return;
+    }
+    if (_arena != nullptr) {
+      _arena->deallocate(_data, _num_chunks);
+      _arena.reset();
+    } else {
+      ::operator delete(_data, std::align_val_t{detail::FIXED_BUFFER_CHUNK});
+    }
+    _data = nullptr;
+  }
+
+private:
+  std::shared_ptr<detail::FixedBufferArena> _arena{nullptr}; // 所属arena
+  char *_data{nullptr};                                      // 缓冲区
+  std::size_t _size{0};                                      // 请求的大小
+  std::size_t _num_chunks{0};                                // 占用的块数
+};
+
+} // namespace faio::io
+
+#endif // FAIO_DETAIL_IO_URING_FIXED_BUFFER_HPP
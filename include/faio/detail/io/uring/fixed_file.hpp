@@ -0,0 +1,59 @@
+#ifndef FAIO_DETAIL_IO_URING_FIXED_FILE_HPP
+#define FAIO_DETAIL_IO_URING_FIXED_FILE_HPP
+
+#include "fastlog/fastlog.hpp"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <liburing.h>
+
+namespace faio::io::detail {
+
+// 每个 worker 一张稀疏注册的固定文件表
+// open_direct 把文件直接装进槽位，后续操作带 IOSQE_FIXED_FILE 引用槽位号，
+// 省去 fd 表的查找和引用计数，适合 open+read+close 这类一次性的链式操作
+// 槽位只在所属 worker 上分配，可以在任意线程归还
+class FixedFileTable {
+public:
+  static constexpr unsigned SLOTS{64};
+
+public:
+  /// 注册稀疏文件表，内核不支持时返回false
+  [[nodiscard]] bool register_to(io_uring *ring) {
+    if (auto ret = io_uring_register_files_sparse(ring, SLOTS); ret < 0) {
+      fastlog::console.warn("register sparse files failed, {}",
+                            strerror(-ret));
+      return false;
+    }
+    return true;
+  }
+
+  /// 从ring注销，ring销毁前由所属worker调用
+  void unregister_from(io_uring *ring) { io_uring_unregister_files(ring); }
+
+  /// 分配一个空闲槽位，没有空位时返回-1，只能在所属worker上调用
+  [[nodiscard]] int allocate() noexcept {
+    auto used = _bitmap.load(std::memory_order::acquire);
+    if (~used == 0) {
+      return -1;
+    }
+    auto slot = std::countr_zero(~used);
+    _bitmap.fetch_or(1ull << slot, std::memory_order::acq_rel);
+    return slot;
+  }
+
+  /// 归还槽位，槽位里的文件必须已经关闭
+  void deallocate(int slot) noexcept {
+    _bitmap.fetch_and(~(1ull << slot), std::memory_order::acq_rel);
+  }
+
+private:
+  static_assert(SLOTS == 64, "slot bitmap is a single 64-bit word");
+
+  std::atomic<std::uint64_t> _bitmap{0}; // 槽位占用位图
+};
+
+} // namespace faio::io::detail
+
+#endif // FAIO_DETAIL_IO_URING_FIXED_FILE_HPP
@@ -11,6 +11,8 @@ struct io_completion_t {
 
   int expected() { return cqe->res; }
 
+  unsigned flags() { return cqe->flags; }
+
   detail::io_user_data_t *data() {
     return reinterpret_cast<detail::io_user_data_t *>(cqe->user_data);
   }
@@ -1,8 +1,14 @@
 #ifndef FAIO_DETAIL_IO_URING_IO_URING_HPP
 #define FAIO_DETAIL_IO_URING_IO_URING_HPP
 
+#include "faio/detail/io/epoll/epoll_backend.hpp"
+#include "faio/detail/io/uring/buf_ring.hpp"
+#include "faio/detail/io/uring/fixed_buffer.hpp"
+#include "faio/detail/io/uring/fixed_file.hpp"
 #include "faio/detail/io/uring/io_completion.hpp"
+#include "faio/detail/io/uring/io_user_data.hpp"
 #include "faio/detail/runtime/core/config.hpp"
+#include "faio/detail/runtime/core/metrics.hpp"
 #include "fastlog/fastlog.hpp"
 #include <cassert>
 #include <chrono>
@@ -12,24 +18,85 @@
 #include <format>
 #include <iterator>
 #include <liburing.h>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+// NAPI 注册需要 liburing 2.6
+#ifdef IO_URING_CHECK_VERSION
+#if !IO_URING_CHECK_VERSION(2, 6)
+#define FAIO_HAS_IO_URING_NAPI 1
+#endif
+#endif
+
 namespace faio::io::detail {
 
 class IOuring;
 
+// 等待 sqe 的挂起节点
+// 提交队列耗尽时，awaiter 先把请求 prep 到暂存的 sqe 中，挂起时进入等待队列，
+// 在下一次收割完成队列后按 FIFO 顺序补交。
+// 等待队列是侵入式双向链表，超时或取消时经由 io_user_data_t::waiter 在 O(1) 内摘除
+struct io_sqe_waiter_t {
+  io_uring_sqe sqe;                   // 暂存的请求
+  io_user_data_t *user_data{nullptr}; // 关联的用户数据，挂入时反向记下节点
+  io_sqe_waiter_t *prev{nullptr};     // 等待队列上一个节点
+  io_sqe_waiter_t *next{nullptr};     // 等待队列下一个节点
+  std::uint32_t linked{0}; // 后续必须与本节点相邻补交的节点数（链式操作）
+};
+
 // 线程局部存储，当前uring实例指针
 inline thread_local IOuring *current_uring{nullptr};
 
 // 封装uring实例，提供uring操作接口
 class IOuring {
 public:
-  IOuring(const runtime::detail::Config &config)
-      : _submit_interval(config._submit_interval) {
-    io_uring_queue_init(config._num_events, &_uring, 0);
+  // wq_fd 不小于0时通过 IORING_SETUP_ATTACH_WQ 共享该ring的io-wq
+  IOuring(const runtime::detail::Config &config,
+          runtime::detail::IOMetrics &metrics, std::size_t worker_id = 0,
+          int wq_fd = -1)
+      : _submit_interval(config._submit_interval),
+        _link_timeout(config._timeout_backend ==
+                      runtime::detail::TimeoutBackend::LinkTimeout),
+        _tick_batching(config._submit_policy ==
+                       runtime::detail::SubmitPolicy::Tick),
+        _fixed_buffer_size(config._fixed_buffer_size), _metrics(&metrics),
+        _latency(metrics.latency.get()) {
+    auto ret = -ENOSYS;
+    if (config._io_backend != runtime::detail::IOBackend::Epoll) {
+      ret = init_uring(config, wq_fd);
+      if (ret < 0 && config._io_backend == runtime::detail::IOBackend::Auto) {
+        // seccomp 拦截 io_uring_setup 时为 -EPERM，内核不支持时为 -ENOSYS
+        fastlog::console.warn("io_uring unavailable, {}, fall back to epoll",
+                              strerror(-ret));
+      } else if (ret < 0) {
+        fastlog::console.error("init io_uring failed, {}", strerror(-ret));
+      }
+    }
+    if (ret < 0 && config._io_backend != runtime::detail::IOBackend::IOuring) {
+      init_epoll(config);
+    } else {
+      configure_iowq(config, worker_id);
+      configure_napi(config);
+    }
     assert(current_uring == nullptr);
     current_uring = this;
   }
 
   ~IOuring() {
+    if (_epoll != nullptr) {
+      // 用户态队列的内存由 epoll 后端持有
+      _epoll.reset();
+      current_uring = nullptr;
+      return;
+    }
+    if (_fixed_buffers != nullptr) {
+      _fixed_buffers->unregister_from(&_uring);
+    }
+    if (_fixed_files != nullptr) {
+      _fixed_files->unregister_from(&_uring);
+    }
     io_uring_queue_exit(&_uring);
     current_uring = nullptr;
   }
@@ -38,13 +105,213 @@ public:
   /// 获取uring实例
   [[nodiscard]] struct io_uring *uring() noexcept { return &_uring; }
 
-  /// 获取sqe
+  /// 获取sqe，提交队列已满时先刷新提交再重试一次
   [[nodiscard]] io_uring_sqe *get_sqe() noexcept {
-    return io_uring_get_sqe(uring());
+    if (auto sqe = io_uring_get_sqe(&_uring); sqe != nullptr) [[likely]] {
+      return sqe;
+    }
+    reset_and_submit();
+    return io_uring_get_sqe(&_uring);
+  }
+
+  /// 只从提交队列取sqe，不触发刷新
+  /// 链接操作要求sqe在提交队列中相邻，中途刷新会把链拆开
+  [[nodiscard]] io_uring_sqe *try_get_sqe() noexcept {
+    return io_uring_get_sqe(&_uring);
+  }
+
+  /// sqe是否已经放入提交队列，但还没有刷新给内核
+  [[nodiscard]] bool is_unflushed_sqe(const io_uring_sqe *sqe) const noexcept {
+    auto &sq = _uring.sq;
+    auto offset = reinterpret_cast<std::uintptr_t>(sqe) -
+                  reinterpret_cast<std::uintptr_t>(sq.sqes);
+    auto index = offset / sizeof(io_uring_sqe);
+    // 暂存区里的sqe不在提交队列中
+    if (offset % sizeof(io_uring_sqe) != 0 || index >= sq.ring_entries) {
+      return false;
+    }
+    return ((index - sq.sqe_head) & sq.ring_mask) < unflushed_sqes();
+  }
+
+  /// sqe是否是最近一次取出且尚未刷新的sqe
+  [[nodiscard]] bool is_last_sqe(const io_uring_sqe *sqe) const noexcept {
+    auto &sq = _uring.sq;
+    return unflushed_sqes() > 0 &&
+           sqe == &sq.sqes[(sq.sqe_tail - 1) & sq.ring_mask];
+  }
+
+  /// 提交队列末尾count个未刷新sqe中的第index个（0为最早取出的那个）
+  [[nodiscard]] io_uring_sqe *tail_sqe(std::size_t count,
+                                       std::size_t index) noexcept {
+    auto &sq = _uring.sq;
+    return &sq.sqes[(sq.sqe_tail - count + index) & sq.ring_mask];
+  }
+
+  /// 已经取出但还没有刷新给内核的sqe数量
+  [[nodiscard]] std::size_t unflushed_sqes() const noexcept {
+    return _uring.sq.sqe_tail - _uring.sq.sqe_head;
+  }
+
+  /// 提交队列剩余空位
+  [[nodiscard]] std::size_t sq_space_left() const noexcept {
+    return io_uring_sq_space_left(&_uring);
+  }
+
+  /// 提交队列容量
+  [[nodiscard]] std::size_t sq_entries() const noexcept {
+    return _uring.sq.ring_entries;
+  }
+
+  /// IO超时是否使用IORING_OP_LINK_TIMEOUT
+  [[nodiscard]] bool link_timeout_enabled() const noexcept {
+    return _link_timeout;
+  }
+
+  /// 是否按调度轮次批量提交
+  [[nodiscard]] bool tick_batching() const noexcept { return _tick_batching; }
+
+  /// 是否注册了 NAPI 忙轮询
+  [[nodiscard]] bool napi_enabled() const noexcept { return _napi_enabled; }
+
+  /// 是否退化为 epoll 后端
+  [[nodiscard]] bool epoll_backend() const noexcept { return _epoll != nullptr; }
+
+  /// 是否开启了延迟追踪
+  [[nodiscard]] bool latency_tracing() const noexcept { return _latency != nullptr; }
+
+  /// 延迟追踪使用的时间戳（steady_clock 纳秒）
+  [[nodiscard]] static std::uint64_t now_ns() noexcept {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  /// 记录请求的内核延迟：提交 → 在 now 收割到 CQE
+  void trace_kernel(const io_user_data_t &data, std::uint64_t now) noexcept {
+    if (data.opcode < IORING_OP_LAST) {
+      record_latency(_latency->kernel[data.opcode], now - data.submit_ns);
+    }
+  }
+
+  /// 记录请求的调度延迟：收割到 CQE → 协程恢复
+  void trace_schedule(const io_user_data_t &data) noexcept {
+    if (_latency != nullptr && data.opcode < IORING_OP_LAST) {
+      record_latency(_latency->schedule[data.opcode], now_ns() - data.reaped_ns);
+    }
+  }
+
+  /// 当前worker的注册缓冲区，第一次使用时才分配并注册
+  /// 未配置或注册失败时返回nullptr，调用方退化为普通内存
+  [[nodiscard]] std::shared_ptr<FixedBufferArena> fixed_buffers() {
+    if (_fixed_buffers == nullptr && _fixed_buffer_size >= FIXED_BUFFER_CHUNK) {
+      auto arena = std::make_shared<FixedBufferArena>(_fixed_buffer_size);
+      if (arena->register_to(&_uring)) {
+        _fixed_buffers = std::move(arena);
+      } else {
+        // 不再重试注册
+        _fixed_buffer_size = 0;
+      }
+    }
+    return _fixed_buffers;
+  }
+
+  /// 当前worker的固定文件表，第一次使用时才注册
+  /// 内核不支持时返回nullptr，调用方退化为普通fd
+  [[nodiscard]] std::shared_ptr<FixedFileTable> fixed_files() {
+    if (_fixed_files == nullptr && !_fixed_files_failed) {
+      auto table = std::make_shared<FixedFileTable>();
+      if (table->register_to(&_uring)) {
+        _fixed_files = std::move(table);
+      } else {
+        _fixed_files_failed = true;
+      }
+    }
+    return _fixed_files;
+  }
+
+  /// 分配一个缓冲区环的组号，组号在当前ring内递增
+  /// 回绕后与仍在使用的组号冲突时，注册会返回-EEXIST，调用方换一个组号重试
+  [[nodiscard]] std::uint16_t allocate_buf_group() noexcept {
+    return _next_buf_group++;
+  }
+
+  /// 获取不关联协程的sqe（异步close、取消、waker等）
+  /// 刷新后仍然没有空位时返回暂存区，在下一次收割后补交，保证请求不会丢失
+  /// 返回的指针只在下一次调用之前有效，必须立即prep
+  [[nodiscard]] io_uring_sqe *get_detached_sqe() {
+    if (auto sqe = get_sqe(); sqe != nullptr) [[likely]] {
+      return sqe;
+    }
+    return &_deferred_sqes.emplace_back();
+  }
+
+  /// 将等待sqe的请求挂入等待队列
+  void park(io_sqe_waiter_t *waiter) noexcept {
+    waiter->prev = _waiters_tail;
+    waiter->next = nullptr;
+    if (_waiters_tail != nullptr) {
+      _waiters_tail->next = waiter;
+    } else {
+      _waiters_head = waiter;
+    }
+    _waiters_tail = waiter;
+    waiter->user_data->waiter = waiter;
+  }
+
+  /// 从等待队列中摘除user_data对应的请求，请求尚未进入提交队列时返回true
+  [[nodiscard]] bool unpark(io_user_data_t *user_data) noexcept {
+    auto waiter = std::exchange(user_data->waiter, nullptr);
+    if (waiter == nullptr) {
+      return false;
+    }
+    (waiter->prev != nullptr ? waiter->prev->next : _waiters_head) = waiter->next;
+    (waiter->next != nullptr ? waiter->next->prev : _waiters_tail) = waiter->prev;
+    return true;
+  }
+
+  /// 补交暂存和挂起的请求，在每次收割完成队列之后调用
+  /// 先补交内部请求，再按FIFO顺序补交挂起的协程请求，sqe再次耗尽时停止
+  void drain_waiters() {
+    if (!_deferred_sqes.empty()) [[unlikely]] {
+      auto count = 0uz;
+      for (; count < _deferred_sqes.size(); count += 1) {
+        auto sqe = get_sqe();
+        if (sqe == nullptr) {
+          break;
+        }
+        *sqe = _deferred_sqes[count];
+      }
+      _deferred_sqes.erase(_deferred_sqes.begin(),
+                           _deferred_sqes.begin() + count);
+    }
+    while (_waiters_head != nullptr) {
+      // 链式操作的节点必须连续放入提交队列
+      auto count = _waiters_head->linked + 1uz;
+      if (sq_space_left() < count) {
+        reset_and_submit();
+        if (sq_space_left() < count) {
+          return;
+        }
+      }
+      for (; count > 0; count -= 1) {
+        *try_get_sqe() = _waiters_head->sqe;
+        _waiters_head->user_data->waiter = nullptr;
+        _waiters_head = _waiters_head->next;
+      }
+      if (_waiters_head != nullptr) {
+        _waiters_head->prev = nullptr;
+      }
+    }
+    _waiters_tail = nullptr;
   }
 
   /// 预读完成队列
   [[nodiscard]] std::size_t peek_batch(std::span<io_completion_t> expected) {
+    if (_epoll != nullptr) [[unlikely]] {
+      // epoll 后端没有内核替它填充完成队列，收割前先检查一次就绪事件
+      _epoll->poll();
+    }
     return io_uring_peek_batch_cqe(
         &_uring, reinterpret_cast<io_uring_cqe **>(expected.data()),
         expected.size());
@@ -56,23 +323,76 @@ public:
   void seen(io_uring_cqe *cqe) { io_uring_cqe_seen(&_uring, cqe); }
 
   // 提交
+  // Tick 策略下只把sqe留在提交队列中，由 flush() 或 wait() 统一提交
   void submit() {
+    if (_tick_batching) {
+      return;
+    }
     _submit_tick += 1;
     if (_submit_tick == _submit_interval) {
       reset_and_submit();
     }
   }
 
-  /// 等待完成队列,可指定超时时间
-  void wait(std::optional<time_t> timeout) {
+  /// 等待完成队列，deadline 为空时一直等待到有完成事件
+  /// 有截止时间时提交一个绝对时间的 IORING_OP_TIMEOUT 作为唤醒源，内核按
+  /// CLOCK_MONOTONIC（即 steady_clock）计时，不受换算和提交延迟影响；
+  /// 已经提交的唤醒还没到且不晚于 deadline 时直接复用，被取消的定时器最多带来一次提前醒来。
+  /// Tick 策略下通过 io_uring_submit_and_wait_timeout 把提交和等待合并为一次系统调用
+  void wait(std::optional<std::chrono::steady_clock::time_point> deadline) {
+    if (_epoll != nullptr) [[unlikely]] {
+      reset_and_submit();
+      std::optional<std::chrono::milliseconds> timeout{};
+      if (deadline) {
+        // epoll_wait 只有毫秒精度，向上取整避免提前醒来
+        timeout = std::max(std::chrono::ceil<std::chrono::milliseconds>(
+                               *deadline - std::chrono::steady_clock::now()),
+                           std::chrono::milliseconds{0});
+      }
+      if (_epoll->wait(timeout)) {
+        runtime::detail::IOMetrics::add(_metrics->wait_syscalls, 1);
+      }
+      return;
+    }
     io_uring_cqe *cqe{nullptr};
+    // 没能提交唤醒请求时退回相对超时
+    struct __kernel_timespec ts{};
+    bool relative = false;
+    if (deadline && !arm_park_timeout(*deadline)) {
+      auto left = std::max(*deadline - std::chrono::steady_clock::now(),
+                           std::chrono::steady_clock::duration{0});
+      auto secs = std::chrono::duration_cast<std::chrono::seconds>(left);
+      ts.tv_sec = secs.count();
+      ts.tv_nsec =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(left - secs)
+              .count();
+      relative = true;
+    }
+    auto ready = io_uring_sq_ready(&_uring);
+    // 完成队列已有结果且没有待提交的sqe时，liburing 不会进入内核
+    if (ready > 0 || io_uring_cq_ready(&_uring) == 0) {
+      runtime::detail::IOMetrics::add(_metrics->wait_syscalls, 1);
+    }
+
+    if (_tick_batching) {
+      _submit_tick = 0;
+      auto res = io_uring_submit_and_wait_timeout(
+          &_uring, &cqe, 1, relative ? &ts : nullptr, nullptr);
+      if (res >= 0) {
+        runtime::detail::IOMetrics::add(_metrics->submitted_sqes, res);
+      } else if (res != -ETIME && res != -EINTR && res != -EBUSY) {
+        // -ETIME 是正常超时，-EBUSY 表示完成队列积压，都不是错误
+        fastlog::console.error("submit and wait cqe failed, {}",
+                               strerror(-res));
+      }
+      return;
+    }
 
-    if (timeout) {
-      // 构造超时时间结构体
-      struct __kernel_timespec ts{
-          .tv_sec = timeout.value() / 1000,
-          .tv_nsec = (timeout.value() % 1000) * 1000000,
-      };
+    // 唤醒请求需要先提交给内核
+    if (ready > 0) {
+      reset_and_submit();
+    }
+    if (relative) {
       if (auto res = io_uring_wait_cqe_timeout(&_uring, &cqe, &ts); res < 0) {
         // -ETIME 是正常超时，不是错误
         if (res != -ETIME) {
@@ -85,18 +405,178 @@ public:
       }
     }
   }
+  /// 提交并等待最多 timeout，用于自旋窗口
+  /// 注册了 NAPI 时内核在等待期间忙轮询网卡队列
+  void busy_wait(std::chrono::microseconds timeout) {
+    io_uring_cqe *cqe{nullptr};
+    struct __kernel_timespec ts{
+        .tv_sec = timeout.count() / 1000000,
+        .tv_nsec = (timeout.count() % 1000000) * 1000,
+    };
+    _submit_tick = 0;
+    runtime::detail::IOMetrics::add(_metrics->wait_syscalls, 1);
+    auto res = io_uring_submit_and_wait_timeout(&_uring, &cqe, 1, &ts, nullptr);
+    if (res > 0) {
+      runtime::detail::IOMetrics::add(_metrics->submitted_sqes, res);
+    }
+  }
+
   // 重置提交计数并提交
   void reset_and_submit() {
     _submit_tick = 0;
+    if (_epoll != nullptr) [[unlikely]] {
+      runtime::detail::IOMetrics::add(_metrics->submitted_sqes,
+                                      _epoll->submit());
+      return;
+    }
+    if (io_uring_sq_ready(&_uring) > 0) {
+      runtime::detail::IOMetrics::add(_metrics->submit_syscalls, 1);
+    }
     if (auto ret = io_uring_submit(&_uring); ret < 0) {
-      fastlog::console.error("submit sqes failed, {}", strerror(-ret));
+      // -EBUSY/-EAGAIN 表示完成队列积压，等待下一次收割后重试
+      if (ret != -EBUSY && ret != -EAGAIN) {
+        fastlog::console.error("submit sqes failed, {}", strerror(-ret));
+      }
+    } else {
+      runtime::detail::IOMetrics::add(_metrics->submitted_sqes, ret);
+    }
+  }
+
+  // 提交所有未刷新的sqe，提交队列为空时不进入内核
+  void flush() {
+    if (io_uring_sq_ready(&_uring) > 0) {
+      reset_and_submit();
+    }
+  }
+
+private:
+  // 创建 io_uring 实例，成功返回0，失败返回负的errno
+  int init_uring(const runtime::detail::Config &config, int wq_fd) {
+    struct io_uring_params params{};
+    if (wq_fd >= 0) {
+      params.flags |= IORING_SETUP_ATTACH_WQ;
+      params.wq_fd = static_cast<std::uint32_t>(wq_fd);
+    }
+    auto ret = io_uring_queue_init_params(config._num_events, &_uring, &params);
+    if (ret < 0 && wq_fd >= 0) {
+      // 不支持共享时退化为独立的io-wq
+      fastlog::console.warn("attach io-wq of ring {} failed, {}", wq_fd,
+                            strerror(-ret));
+      params = {};
+      ret = io_uring_queue_init_params(config._num_events, &_uring, &params);
+    }
+    return ret;
+  }
+
+  // 在用户态内存中搭建提交/完成队列，由 epoll 后端执行请求
+  // 注册缓冲区和固定文件表依赖 io_uring，直接标记为不可用
+  void init_epoll(const runtime::detail::Config &config) {
+    _epoll = std::make_unique<EpollBackend>();
+    if (auto ret = _epoll->setup(&_uring, config._num_events); ret < 0) {
+      fastlog::console.error("init epoll failed, {}", strerror(-ret));
+    }
+    _fixed_buffer_size = 0;
+    _fixed_files_failed = true;
+  }
+
+  // io-wq 的线程上限和CPU亲和性
+  // 较新的内核中io-wq按提交线程划分，每个worker都需要单独设置
+  void configure_iowq(const runtime::detail::Config &config,
+                      std::size_t worker_id) {
+    if (config._iowq_max_bounded > 0 || config._iowq_max_unbounded > 0) {
+      // 0 表示保持原值
+      unsigned values[2]{config._iowq_max_bounded,
+                         config._iowq_max_unbounded};
+      if (auto ret = io_uring_register_iowq_max_workers(&_uring, values);
+          ret < 0) {
+        fastlog::console.warn("set io-wq max workers failed, {}",
+                              strerror(-ret));
+      }
+    }
+    if (!config._iowq_cpus.empty()) {
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET(config._iowq_cpus[worker_id % config._iowq_cpus.size()], &cpus);
+      if (auto ret = io_uring_register_iowq_aff(&_uring, sizeof(cpus), &cpus);
+          ret < 0) {
+        fastlog::console.warn("set io-wq affinity failed, {}", strerror(-ret));
+      }
+    }
+  }
+
+  // NAPI 忙轮询，内核（6.9 之前）或 liburing 不支持时退化为普通等待
+  void configure_napi(const runtime::detail::Config &config) {
+    if (config._napi_busy_poll_us == 0) {
+      return;
+    }
+#ifdef FAIO_HAS_IO_URING_NAPI
+    struct io_uring_napi napi{};
+    napi.busy_poll_to = config._napi_busy_poll_us;
+    napi.prefer_busy_poll = config._napi_prefer_busy_poll ? 1 : 0;
+    if (auto ret = io_uring_register_napi(&_uring, &napi); ret < 0) {
+      fastlog::console.warn("register napi busy poll failed, {}",
+                            strerror(-ret));
+      return;
     }
+    _napi_enabled = true;
+#else
+    fastlog::console.warn("napi busy poll requires liburing 2.6");
+#endif
+  }
+
+  // 为休眠提交一个在 deadline 到期的 IORING_OP_TIMEOUT，完成事件不关联协程，
+  // drive 中直接跳过。返回 false 表示提交队列已满，由调用者退回相对超时
+  bool arm_park_timeout(std::chrono::steady_clock::time_point deadline) noexcept {
+    auto now = std::chrono::steady_clock::now();
+    if (_park_deadline > now && _park_deadline <= deadline) {
+      return true;
+    }
+    if (deadline <= now) {
+      return false;
+    }
+    auto sqe = try_get_sqe();
+    if (sqe == nullptr) {
+      return false;
+    }
+    auto since_epoch = deadline.time_since_epoch();
+    auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    _park_ts.tv_sec = secs.count();
+    _park_ts.tv_nsec =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - secs)
+            .count();
+    io_uring_prep_timeout(sqe, &_park_ts, 0, IORING_TIMEOUT_ABS);
+    io_uring_sqe_set_data(sqe, nullptr);
+    _park_deadline = deadline;
+    return true;
+  }
+
+  // 样本计入所在的桶，只有所属worker写入
+  static void record_latency(runtime::detail::IOLatency::Histogram &histogram,
+                             std::uint64_t ns) noexcept {
+    runtime::detail::IOMetrics::add(
+        histogram[runtime::detail::IOLatency::bucket_of(ns)], 1);
   }
 
 private:
-  io_uring _uring;                // uring实例
-  std::uint32_t _submit_interval; // 提交间隔
-  std::uint32_t _submit_tick{0};  // 提交计数
+  io_uring _uring;                            // uring实例
+  std::uint32_t _submit_interval;             // 提交间隔
+  std::uint32_t _submit_tick{0};              // 提交计数
+  bool _link_timeout;                         // IO超时是否由内核计时
+  bool _tick_batching;                        // 是否按调度轮次批量提交
+  std::size_t _fixed_buffer_size;             // 注册缓冲区大小
+  std::shared_ptr<FixedBufferArena> _fixed_buffers{nullptr}; // 注册缓冲区
+  std::shared_ptr<FixedFileTable> _fixed_files{nullptr};     // 固定文件表
+  bool _fixed_files_failed{false}; // 固定文件表注册失败，不再重试
+  std::uint16_t _next_buf_group{0}; // 下一个缓冲区环组号
+  bool _napi_enabled{false};        // 是否注册了 NAPI 忙轮询
+  std::unique_ptr<EpollBackend> _epoll{nullptr}; // io_uring 不可用时的 epoll 后端
+  runtime::detail::IOMetrics *_metrics;       // 所属worker的统计
+  runtime::detail::IOLatency *_latency;       // 延迟直方图，未开启追踪时为空
+  std::vector<io_uring_sqe> _deferred_sqes{}; // 暂存的内部请求
+  io_sqe_waiter_t *_waiters_head{nullptr};    // 等待sqe的队列头
+  io_sqe_waiter_t *_waiters_tail{nullptr};    // 等待sqe的队列尾
+  struct __kernel_timespec _park_ts{};        // 休眠唤醒的绝对时间，提交前必须有效
+  std::chrono::steady_clock::time_point _park_deadline{}; // 已提交的休眠唤醒时间
 };
 
 } // namespace faio::io::detail
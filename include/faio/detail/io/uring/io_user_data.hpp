@@ -3,17 +3,38 @@
 
 #include <chrono>
 #include <coroutine>
+#include <cstdint>
 namespace faio::runtime::detail::timer {
 class TimerTask;
 
 }
 
 namespace faio::io::detail {
+struct io_sqe_waiter_t;
+
+// 产生多个 CQE 的请求（multishot）的完成处理器
+// 每个 CQE 都交给处理器，不走恢复协程的默认路径
+struct io_cqe_handler_t {
+  /// 处理一个 CQE，在提交请求的 worker 上调用，返回需要恢复的协程（可以为空）
+  virtual auto on_cqe(int result, unsigned flags) -> std::coroutine_handle<> = 0;
+
+protected:
+  ~io_cqe_handler_t() = default;
+};
+
 struct io_user_data_t {
   std::coroutine_handle<> handle{nullptr};                      // 协程句柄
   int result;                                                   // 结果
+  std::uint32_t pending{0}; // 链式操作组内尚未完成的操作数
+  std::uint8_t opcode{0};   // 请求的 opcode，开启延迟追踪时记录
+  bool timed_out{false};    // 定时器到期取消了请求，与显式取消区分
   faio::runtime::detail::timer::TimerTask *timer_task{nullptr}; // 定时器任务
   std::chrono::steady_clock::time_point deadline;               // 截止时间
+  io_user_data_t *group{nullptr}; // 所属的链式操作组，全部完成后才恢复组的协程
+  io_cqe_handler_t *handler{nullptr}; // multishot 请求的完成处理器
+  io_sqe_waiter_t *waiter{nullptr};   // 在等待 sqe 的队列中时指向节点，摘除时不用遍历
+  std::uint64_t submit_ns{0}; // 提交时间（steady_clock 纳秒），0 表示未追踪
+  std::uint64_t reaped_ns{0}; // 收割到 CQE 的时间，恢复协程后记录调度延迟
 };
 } // namespace faio::io::detail
 
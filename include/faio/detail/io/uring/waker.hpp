@@ -31,11 +31,7 @@ public:
   void start_watch() {
     if (_flag != 0) {
       _flag = 0;
-      auto sqe = current_uring->get_sqe();
-      if (sqe == nullptr) {
-        fastlog::console.error("get sqe failed");
-        return;
-      }
+      auto sqe = current_uring->get_detached_sqe();
       io_uring_prep_read(sqe, _fd, &_flag, sizeof(_flag), 0);
       io_uring_sqe_set_data(sqe, nullptr);
     }
@@ -1,6 +1,7 @@
 #ifndef FAIO_DETAIL_NET_HPP
 #define FAIO_DETAIL_NET_HPP
 #include "faio/detail/net/common/address.hpp"
+#include "faio/detail/net/common/copy.hpp"
 #include "faio/detail/net/tcp/tcp_listener.hpp"
 #include "faio/detail/net/tcp/tcp_stream.hpp"
 #include "faio/detail/net/udp/datagram.hpp"
@@ -12,6 +13,10 @@ using v6addr = detail::Ipv6Addr;
 using TcpListener = detail::TcpListener;
 using TcpStream = detail ::TcpStream;
 using UdpDatagram = detail::UdpDatagram;
+using datagram = detail::Datagram<detail::SocketAddr>;
+using DatagramBatch = detail::DatagramBatch<detail::SocketAddr>;
+using RecvPacket = detail::RecvPacket<detail::SocketAddr>;
+using RecvStream = detail::RecvStream<detail::SocketAddr>;
 } // namespace faio::net
 
 #endif // FAIO_DETAIL_NET_HPP
\ No newline at end of file
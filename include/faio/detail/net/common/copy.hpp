@@ -0,0 +1,248 @@
+#ifndef FAIO_DETAIL_NET_COMMON_COPY_HPP
+#define FAIO_DETAIL_NET_COMMON_COPY_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/coroutine/task.hpp"
+#include "faio/detail/io/io.hpp"
+#include "faio/detail/runtime/context.hpp"
+#include <array>
+#include <atomic>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace faio::net {
+
+// copy_bidirectional 的统计
+struct CopyStats {
+  std::size_t a_to_b{0}; // a 读出、写入 b 的字节数
+  std::size_t b_to_a{0}; // b 读出、写入 a 的字节数
+  bool spliced{false};   // 是否至少有一个方向走了 splice 零拷贝
+};
+
+} // namespace faio::net
+
+namespace faio::net::detail {
+
+// 每次 splice 的最大字节数，等于默认的管道容量
+static inline constexpr unsigned SPLICE_CHUNK{64 * 1024};
+// 用户态回退路径的缓冲区大小
+static inline constexpr std::size_t COPY_BUFFER_SIZE{16 * 1024};
+
+// 单向拷贝使用的管道，splice 的中转站
+class Pipe {
+public:
+  Pipe() = default;
+  ~Pipe() {
+    if (_fds[0] >= 0) {
+      ::close(_fds[0]);
+      ::close(_fds[1]);
+    }
+  }
+
+  Pipe(const Pipe &) = delete;
+  Pipe &operator=(const Pipe &) = delete;
+
+public:
+  /// 创建管道，fd 耗尽等情况下返回false
+  [[nodiscard]] bool open() noexcept {
+    return ::pipe2(_fds.data(), O_NONBLOCK | O_CLOEXEC) == 0;
+  }
+
+  [[nodiscard]] int read_fd() const noexcept { return _fds[0]; }
+  [[nodiscard]] int write_fd() const noexcept { return _fds[1]; }
+
+private:
+  std::array<int, 2> _fds{-1, -1};
+};
+
+// 单向拷贝的状态，由 copy_bidirectional 持有
+struct CopyDirection {
+  int from;
+  int to;
+  std::size_t bytes{0};
+  bool spliced{false};
+  expected<void> result{};
+};
+
+// socket → 管道 → socket，数据不进入用户态
+// 管道每次都被完全排空，因此写入管道时总有空位
+// 返回false表示 splice 不可用（旧内核、fd 类型不支持、管道创建失败），
+// 此时还没有消费任何数据，调用方可以安全地退化为用户态拷贝
+static inline auto splice_copy(CopyDirection &dir) -> task<expected<bool>> {
+  Pipe pipe;
+  if (!pipe.open()) {
+    co_return false;
+  }
+  while (true) {
+    // 非阻塞 socket 上的 splice 没有内部 poll 重试，先链一个 poll 等待可读
+    auto [readable, filled] = co_await io::chain(
+        io::poll_add(dir.from, POLLIN | POLLRDHUP),
+        io::splice(dir.from, -1, pipe.write_fd(), -1, SPLICE_CHUNK,
+                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+    if (!readable) {
+      co_return std::unexpected{std::move(readable.error())};
+    }
+    if (!filled) {
+      auto err = filled.error().value();
+      if (err == EAGAIN) {
+        continue;
+      }
+      if (!dir.spliced &&
+          (err == EINVAL || err == EOPNOTSUPP || err == ENOSYS)) {
+        co_return false;
+      }
+      co_return std::unexpected{std::move(filled.error())};
+    }
+    if (filled.value() == 0) {
+      co_return true;
+    }
+    dir.spliced = true;
+
+    // 排空管道
+    auto pending = filled.value();
+    while (pending > 0) {
+      auto drained =
+          co_await io::splice(pipe.read_fd(), -1, dir.to, -1,
+                              static_cast<unsigned>(pending), SPLICE_F_MOVE);
+      if (!drained && drained.error().value() == EAGAIN) {
+        // 对端接收窗口满，等待可写后重试
+        auto [writable, retried] = co_await io::chain(
+            io::poll_add(dir.to, POLLOUT),
+            io::splice(pipe.read_fd(), -1, dir.to, -1,
+                       static_cast<unsigned>(pending), SPLICE_F_MOVE));
+        drained = writable ? std::move(retried)
+                           : std::unexpected{std::move(writable.error())};
+      }
+      if (!drained) {
+        if (drained.error().value() == EAGAIN) {
+          continue;
+        }
+        co_return std::unexpected{std::move(drained.error())};
+      }
+      if (drained.value() == 0) {
+        co_return std::unexpected{Error{Error::WriteZero}};
+      }
+      pending -= drained.value();
+      dir.bytes += drained.value();
+    }
+  }
+}
+
+// 用户态拷贝：recv 到缓冲区再 send 出去
+static inline auto buffered_copy(CopyDirection &dir) -> task<expected<void>> {
+  std::array<char, COPY_BUFFER_SIZE> buf;
+  while (true) {
+    auto n = co_await io::recv(dir.from, buf.data(), buf.size(), 0);
+    if (!n) {
+      co_return std::unexpected{std::move(n.error())};
+    }
+    if (n.value() == 0) {
+      co_return expected<void>{};
+    }
+    std::span<const char> rest{buf.data(), n.value()};
+    while (!rest.empty()) {
+      auto sent =
+          co_await io::send(dir.to, rest.data(), rest.size(), MSG_NOSIGNAL);
+      if (!sent) {
+        co_return std::unexpected{std::move(sent.error())};
+      }
+      if (sent.value() == 0) {
+        co_return std::unexpected{Error{Error::WriteZero}};
+      }
+      rest = rest.subspan(sent.value());
+      dir.bytes += sent.value();
+    }
+  }
+}
+
+// 单向拷贝直到 from 读到EOF，然后关闭 to 的写方向，把半关闭传递给对端
+static inline auto copy_one_direction(CopyDirection &dir) -> task<void> {
+  auto spliced = co_await splice_copy(dir);
+  if (spliced && !spliced.value()) {
+    dir.result = co_await buffered_copy(dir);
+  } else if (!spliced) {
+    dir.result = std::unexpected{std::move(spliced.error())};
+  }
+  if (dir.result) {
+    // 对端可能已经完全关闭
+    if (auto res = co_await io::shutdown(dir.to, SHUT_WR);
+        !res && res.error().value() != ENOTCONN) {
+      dir.result = std::move(res);
+    }
+  }
+  if (!dir.result) {
+    // 出错时同步关闭两端的读写，唤醒另一个方向上挂起的 poll/recv
+    ::shutdown(dir.from, SHUT_RDWR);
+    ::shutdown(dir.to, SHUT_RDWR);
+  }
+}
+
+// 等待另一个方向结束，最后一个结束的一方负责恢复 copy_bidirectional
+class CopyJoin {
+public:
+  // 另一个方向结束时调用，之后不能再访问 CopyJoin
+  void arrive() {
+    if (_remaining.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+      runtime::detail::push_task_to_local_queue(_waiter);
+    }
+  }
+
+  auto wait() noexcept {
+    struct Awaiter {
+      CopyJoin &join;
+      bool await_ready() const noexcept { return false; }
+      bool await_suspend(std::coroutine_handle<> handle) noexcept {
+        join._waiter = handle;
+        return join._remaining.fetch_sub(1, std::memory_order::acq_rel) != 1;
+      }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{*this};
+  }
+
+private:
+  std::atomic<int> _remaining{2};
+  std::coroutine_handle<> _waiter{nullptr};
+};
+
+static inline auto copy_reverse(CopyDirection &dir, CopyJoin &join)
+    -> task<void> {
+  co_await copy_one_direction(dir);
+  join.arrive();
+}
+
+} // namespace faio::net::detail
+
+namespace faio::net {
+
+/// 在两个流之间双向转发数据，直到两个方向都读到EOF
+/// 优先通过每个方向一条管道 splice，数据不经过用户态；splice 不可用时自动退化为
+/// recv/send 拷贝。一个方向读到EOF后关闭另一端的写方向（半关闭），另一个方向继续转发。
+/// 任一方向出错时关闭两端的读写并返回第一个错误。两个流都不会被关闭。
+template <class A, class B>
+static inline auto copy_bidirectional(A &a, B &b)
+    -> task<expected<CopyStats>> {
+  detail::CopyDirection forward{.from = a.fd(), .to = b.fd()};
+  detail::CopyDirection backward{.from = b.fd(), .to = a.fd()};
+  detail::CopyJoin join;
+  runtime::detail::runtime_context::spawn(
+      detail::copy_reverse(backward, join));
+  co_await detail::copy_one_direction(forward);
+  co_await join.wait();
+
+  if (!forward.result) {
+    co_return std::unexpected{std::move(forward.result.error())};
+  }
+  if (!backward.result) {
+    co_return std::unexpected{std::move(backward.result.error())};
+  }
+  co_return CopyStats{.a_to_b = forward.bytes,
+                      .b_to_a = backward.bytes,
+                      .spliced = forward.spliced || backward.spliced};
+}
+
+} // namespace faio::net
+
+#endif // FAIO_DETAIL_NET_COMMON_COPY_HPP
@@ -0,0 +1,285 @@
+#ifndef FAIO_DETAIL_NET_COMMON_DATAGRAM_BATCH_HPP
+#define FAIO_DETAIL_NET_COMMON_DATAGRAM_BATCH_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/coroutine/task.hpp"
+#include "faio/detail/io/base/io_registrant.hpp"
+#include "faio/detail/net/common/sockopt.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <netinet/udp.h>
+#include <span>
+#include <sys/socket.h>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+namespace faio::net::detail {
+
+// 一次 GSO 发送最多的段数（内核的 UDP_MAX_SEGMENTS）
+static inline constexpr std::size_t UDP_GSO_MAX_SEGMENTS{64};
+// 一次 GSO 发送的最大负载，受 IP 包总长 64KB 的限制（预留 IPv6 + UDP 头）
+static inline constexpr std::size_t UDP_GSO_MAX_BYTES{65535 - 40 - 8};
+
+// 待发送的数据报
+template <class Addr> struct Datagram {
+  std::span<const char> data;
+  Addr addr{};
+};
+
+// 一次 recv_batch 收到的数据报
+// 开启 GRO 后内核把同一个源地址的多个数据报合并成一块，除最后一个外大小都是 segment_size
+template <class Addr> struct DatagramBatch {
+  std::span<char> data;         // 收到的全部负载
+  std::size_t segment_size{0};  // 每个数据报的大小
+  Addr addr{};                  // 源地址
+  bool truncated{false};        // 缓冲区不够，负载被截断（MSG_TRUNC）
+
+  /// 数据报个数
+  [[nodiscard]] std::size_t size() const noexcept {
+    return segment_size == 0 ? 0
+                             : (data.size() + segment_size - 1) / segment_size;
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return data.empty(); }
+
+  /// 第i个数据报
+  [[nodiscard]] std::span<char> operator[](std::size_t i) const noexcept {
+    auto offset = i * segment_size;
+    return data.subspan(offset, std::min(segment_size, data.size() - offset));
+  }
+};
+
+// 一次 sendmsg 发出一组数据报
+// segment_size 大于0时附带 UDP_SEGMENT 控制消息，内核（或网卡）按 segment_size 切分负载
+template <class Addr>
+class SendSegments : public io::detail::IORegistrantAwaiter<SendSegments<Addr>> {
+private:
+  using Base = io::detail::IORegistrantAwaiter<SendSegments<Addr>>;
+
+public:
+  SendSegments(int fd, iovec *iov, std::size_t count, const Addr *addr,
+               std::uint16_t segment_size)
+      : Base{io_uring_prep_sendmsg, fd, &_msg, MSG_NOSIGNAL},
+        _msg{.msg_name = addr != nullptr
+                             ? const_cast<struct sockaddr *>(addr->sockaddr())
+                             : nullptr,
+             .msg_namelen = addr != nullptr ? addr->length() : 0,
+             .msg_iov = iov,
+             .msg_iovlen = count,
+             .msg_control = nullptr,
+             .msg_controllen = 0,
+             .msg_flags = 0} {
+    if (segment_size > 0) {
+      _msg.msg_control = _control.data();
+      _msg.msg_controllen = _control.size();
+      auto cmsg = CMSG_FIRSTHDR(&_msg);
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(segment_size));
+      std::memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+    }
+  }
+
+  // 移动后重新指向自身的 msghdr 和控制消息，iovec 数组在外部
+  void rebind_sqe() noexcept {
+    if (_msg.msg_control != nullptr) {
+      _msg.msg_control = _control.data();
+    }
+    this->_sqe->addr = reinterpret_cast<unsigned long long>(&_msg);
+  }
+
+  auto await_resume() const noexcept -> expected<std::size_t> {
+    if (this->_user_data.result >= 0) [[likely]] {
+      return static_cast<std::size_t>(this->_user_data.result);
+    } else {
+      return ::std::unexpected{make_error(-this->_user_data.result)};
+    }
+  }
+
+private:
+  struct msghdr _msg;
+  alignas(struct cmsghdr) std::array<char, CMSG_SPACE(sizeof(std::uint16_t))>
+      _control{};
+};
+
+template <class Addr>
+[[nodiscard]] static inline auto datagram_payload(const Datagram<Addr> &d) noexcept {
+  return d.data;
+}
+
+template <class Addr>
+[[nodiscard]] static inline auto datagram_target(const Datagram<Addr> &d) noexcept
+    -> const Addr * {
+  return &d.addr;
+}
+
+[[nodiscard]] static inline auto
+datagram_payload(const std::span<const char> &d) noexcept {
+  return d;
+}
+
+template <class Addr>
+[[nodiscard]] static inline auto
+datagram_target(const std::span<const char> &) noexcept -> const Addr * {
+  return nullptr;
+}
+
+template <class Addr>
+[[nodiscard]] static inline bool same_target(const Addr *a,
+                                             const Addr *b) noexcept {
+  if (a == nullptr || b == nullptr) {
+    return a == b;
+  }
+  return a->length() == b->length() &&
+         std::memcmp(a->sockaddr(), b->sockaddr(), a->length()) == 0;
+}
+
+// 按 GSO 的要求分组发送：同一组的目标地址相同、大小相同（最后一个可以更小）
+// 内核不支持 GSO（EIO/EINVAL/EOPNOTSUPP/ENOPROTOOPT）时，剩余的数据报逐个发送
+template <class Addr, class Item>
+static inline auto send_datagram_batch(int fd, std::span<const Item> items)
+    -> task<expected<std::size_t>> {
+  std::array<iovec, UDP_GSO_MAX_SEGMENTS> iov;
+  auto gso = true;
+  auto sent = 0uz;
+  while (sent < items.size()) {
+    auto first = datagram_payload(items[sent]);
+    auto target = datagram_target<Addr>(items[sent]);
+    auto segment_size = first.size();
+    auto count = 0uz;
+    auto bytes = 0uz;
+    while (sent + count < items.size() && count < iov.size()) {
+      auto payload = datagram_payload(items[sent + count]);
+      if (count > 0 &&
+          (!gso || segment_size == 0 || payload.size() > segment_size ||
+           payload.empty() || bytes + payload.size() > UDP_GSO_MAX_BYTES ||
+           !same_target(target, datagram_target<Addr>(items[sent + count])))) {
+        break;
+      }
+      iov[count] = iovec{.iov_base = const_cast<char *>(payload.data()),
+                         .iov_len = payload.size()};
+      bytes += payload.size();
+      count += 1;
+      // 比 segment_size 小的数据报只能作为一组的最后一个
+      if (payload.size() < segment_size) {
+        break;
+      }
+    }
+    auto res = co_await SendSegments<Addr>{
+        fd, iov.data(), count, target,
+        static_cast<std::uint16_t>(count > 1 ? segment_size : 0)};
+    if (!res) {
+      auto err = res.error().value();
+      if (count > 1 && (err == EIO || err == EINVAL || err == EOPNOTSUPP ||
+                        err == ENOPROTOOPT)) {
+        gso = false;
+        continue;
+      }
+      if (sent > 0) {
+        break;
+      }
+      co_return std::unexpected{std::move(res.error())};
+    }
+    sent += count;
+  }
+  co_return sent;
+}
+
+template <class T, class Addr> struct ImplDatagramBatch {
+  /// 批量发送到各自的目标地址，返回发出的数据报个数
+  /// 相邻的、目标相同且大小相同的数据报通过 UDP_SEGMENT（GSO）合并成一次 sendmsg；
+  /// 中途出错时返回已经发出的个数，一个都没发出时返回错误
+  /// co_await 期间 datagrams 及其负载必须保持有效
+  auto send_batch(std::span<const Datagram<Addr>> datagrams) noexcept
+      -> task<expected<std::size_t>> {
+    return send_datagram_batch<Addr>(static_cast<T *>(this)->fd(), datagrams);
+  }
+
+  /// 已连接的 socket 上批量发送
+  auto send_batch(std::span<const std::span<const char>> payloads) noexcept
+      -> task<expected<std::size_t>> {
+    return send_datagram_batch<Addr>(static_cast<T *>(this)->fd(), payloads);
+  }
+
+  /// 一次接收多个数据报
+  /// 第一次调用时开启 UDP_GRO，内核把同一来源的连续数据报合并后一次交付，
+  /// 通过 UDP_GRO 控制消息得到每个数据报的大小；buf 至少应为 64KB 才能容纳合并后的负载
+  auto recv_batch(std::span<char> buf) noexcept {
+    class RecvBatch : public io::detail::IORegistrantAwaiter<RecvBatch> {
+    private:
+      using Base = io::detail::IORegistrantAwaiter<RecvBatch>;
+
+    public:
+      RecvBatch(int fd, std::span<char> buf)
+          : Base{io_uring_prep_recvmsg, fd, &_msg, 0},
+            _iov{.iov_base = buf.data(), .iov_len = buf.size_bytes()},
+            _msg{.msg_name = &_addr,
+                 .msg_namelen = sizeof(_addr),
+                 .msg_iov = &_iov,
+                 .msg_iovlen = 1,
+                 .msg_control = _control.data(),
+                 .msg_controllen = _control.size(),
+                 .msg_flags = 0} {}
+
+      // 移动后重新指向自身的 msghdr、地址、iovec 和控制消息缓冲区
+      void rebind_sqe() noexcept {
+        _msg.msg_name = &_addr;
+        _msg.msg_iov = &_iov;
+        _msg.msg_control = _control.data();
+        this->_sqe->addr = reinterpret_cast<unsigned long long>(&_msg);
+      }
+
+      auto await_resume() const noexcept -> expected<DatagramBatch<Addr>> {
+        if (this->_user_data.result < 0) [[unlikely]] {
+          return ::std::unexpected{make_error(-this->_user_data.result)};
+        }
+        auto len = static_cast<std::size_t>(this->_user_data.result);
+        DatagramBatch<Addr> batch{
+            .data = {static_cast<char *>(_iov.iov_base), len},
+            .segment_size = len,
+            .addr = _addr,
+            .truncated = (_msg.msg_flags & MSG_TRUNC) != 0};
+        for (auto cmsg = CMSG_FIRSTHDR(&_msg); cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(const_cast<struct msghdr *>(&_msg), cmsg)) {
+          if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int gso_size{0};
+            std::memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+            if (gso_size > 0) {
+              batch.segment_size = static_cast<std::size_t>(gso_size);
+            }
+          }
+        }
+        return batch;
+      }
+
+    private:
+      struct iovec _iov;
+      Addr _addr{};
+      struct msghdr _msg;
+      alignas(struct cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))>
+          _control{};
+    };
+
+    auto fd = static_cast<T *>(this)->fd();
+    if (!_gro_enabled) {
+      // 不支持 GRO 的内核上每次收到单个数据报，recv_batch 仍然可用
+      int on{1};
+      _gro_enabled = true;
+      (void)set_sock_opt(fd, SOL_UDP, UDP_GRO, &on, sizeof(on));
+    }
+    return RecvBatch{fd, buf};
+  }
+
+private:
+  bool _gro_enabled{false}; // 是否已经尝试开启 UDP_GRO
+};
+
+} // namespace faio::net::detail
+
+#endif // FAIO_DETAIL_NET_COMMON_DATAGRAM_BATCH_HPP
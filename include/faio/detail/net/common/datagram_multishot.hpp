@@ -0,0 +1,400 @@
+#ifndef FAIO_DETAIL_NET_COMMON_DATAGRAM_MULTISHOT_HPP
+#define FAIO_DETAIL_NET_COMMON_DATAGRAM_MULTISHOT_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/io/uring/buf_ring.hpp"
+#include "faio/detail/io/uring/io_uring.hpp"
+#include "faio/detail/io/uring/io_user_data.hpp"
+#include "faio/detail/net/common/sockopt.hpp"
+#include <algorithm>
+#include <coroutine>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <sys/socket.h>
+#include <utility>
+
+namespace faio::net {
+
+// recv_stream 的配置
+struct RecvStreamConfig {
+  // 每个缓冲区的大小，需要容纳 io_uring_recvmsg_out 头、源地址、控制消息和负载，
+  // 负载放不下时数据报被截断
+  std::size_t buffer_size{2048};
+  // 缓冲区个数，向上取整为2的幂；全部被占用时内核停止投递，直到消费者归还
+  unsigned buffer_count{256};
+};
+
+// recv_stream 的统计
+struct RecvStreamStats {
+  std::uint64_t received{0};  // 交付的数据报数
+  std::uint64_t truncated{0}; // 缓冲区放不下而被截断的数据报数
+  std::uint64_t dropped{0};   // socket 接收队列溢出丢弃的数据报数（SO_RXQ_OVFL）
+  std::uint64_t rearmed{0};   // 缓冲区耗尽或出错后重新提交 multishot 请求的次数
+};
+
+} // namespace faio::net
+
+namespace faio::net::detail {
+
+// recv_stream 交付的一个数据报
+// data 指向缓冲区环中的缓冲区，只在下一次 next() 之前有效
+template <class Addr> struct RecvPacket {
+  std::span<const char> data; // 负载
+  Addr addr{};                // 源地址
+  bool truncated{false};      // 缓冲区放不下，负载被截断（MSG_TRUNC）
+};
+
+// multishot recvmsg 的共享状态，由内核请求和 RecvStream 共同持有
+// multishot 请求只能在提交它的 ring 上重新提交或取消，消费者协程被其他 worker
+// 窃取后，通过 IORING_OP_MSG_RING 把命令投递到所属 ring，由所属 worker 执行；
+// 请求结束（最后一个 CQE 不带 IORING_CQE_F_MORE）且没有在途的命令后才释放
+template <class Addr> class MultishotRecv {
+private:
+  // 投递给所属 ring 的命令
+  enum Command : unsigned { Arm = 1, Cancel = 2 };
+
+  // 完成的数据报或错误，缓冲区编号在 flags 的高16位
+  struct Completion {
+    int result;
+    unsigned flags;
+  };
+
+  template <auto Callback> struct Handler : io::detail::io_cqe_handler_t {
+    MultishotRecv *self;
+    auto on_cqe(int result, unsigned flags) -> std::coroutine_handle<> override {
+      return (self->*Callback)(result, flags);
+    }
+  };
+
+public:
+  MultishotRecv(int fd, io::detail::IOuring *owner)
+      : _fd{fd}, _owner{owner},
+        _msg{.msg_name = nullptr,
+             .msg_namelen = sizeof(Addr),
+             .msg_iov = nullptr,
+             .msg_iovlen = 0,
+             .msg_control = nullptr,
+             .msg_controllen = CMSG_SPACE(sizeof(std::uint32_t)),
+             .msg_flags = 0} {
+    _recv_handler.self = this;
+    _signal_handler.self = this;
+    _recv_data.handler = &_recv_handler;
+    _signal_data.handler = &_signal_handler;
+  }
+
+  MultishotRecv(const MultishotRecv &) = delete;
+  MultishotRecv &operator=(const MultishotRecv &) = delete;
+
+public:
+  /// 注册缓冲区环，只能在worker上调用
+  [[nodiscard]] auto setup(const RecvStreamConfig &config) -> expected<void> {
+    auto header = sizeof(io_uring_recvmsg_out) + _msg.msg_namelen +
+                  _msg.msg_controllen;
+    if (config.buffer_size <= header) {
+      return std::unexpected{make_error(EINVAL)};
+    }
+    // 组号回绕后可能与仍在使用的缓冲区环冲突
+    auto ret = -EEXIST;
+    for (auto attempt = 0; attempt < 16 && ret == -EEXIST; attempt += 1) {
+      ret = _buffers.setup(_owner->uring(), _owner->allocate_buf_group(),
+                           config.buffer_count, config.buffer_size);
+    }
+    if (ret < 0) {
+      return std::unexpected{make_error(-ret)};
+    }
+    // 接收队列溢出时，内核在控制消息中附带累计的丢包数
+    int on{1};
+    (void)set_sock_opt(_fd, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));
+    return {};
+  }
+
+  /// 等待下一个数据报，上一个数据报的缓冲区在这里归还
+  auto next() noexcept {
+    struct Awaiter {
+      MultishotRecv &self;
+
+      bool await_ready() const noexcept { return false; }
+
+      bool await_suspend(std::coroutine_handle<> handle) {
+        std::lock_guard lock{self._mutex};
+        if (!self._completions.empty()) {
+          return false;
+        }
+        // 缓冲区已经全部归还，重新提交因缓冲区耗尽或出错而结束的请求
+        if (!self._armed && !self._arm_requested) {
+          self.request_arm();
+        }
+        self._waiter = handle;
+        return true;
+      }
+
+      auto await_resume() -> expected<RecvPacket<Addr>> {
+        Completion completion;
+        {
+          std::lock_guard lock{self._mutex};
+          completion = self._completions.front();
+          self._completions.pop_front();
+        }
+        return self.parse(completion);
+      }
+    };
+    recycle_current();
+    return Awaiter{*this};
+  }
+
+  [[nodiscard]] auto stats() -> RecvStreamStats {
+    std::lock_guard lock{_mutex};
+    auto stats = _stats;
+    stats.rearmed = _arms > 0 ? _arms - 1 : 0;
+    return stats;
+  }
+
+  /// RecvStream 析构时调用，之后不能再访问
+  void close() {
+    recycle_current();
+    bool destroy{false};
+    {
+      std::lock_guard lock{_mutex};
+      _closed = true;
+      if (_armed) {
+        send_command(Cancel);
+      }
+      destroy = !_armed && _commands == 0;
+    }
+    if (destroy) {
+      delete this;
+    }
+  }
+
+private:
+  ~MultishotRecv() { _buffers.release(_owner->uring()); }
+
+  bool on_owner() const noexcept { return io::detail::current_uring == _owner; }
+
+  // 在所属 ring 上提交 multishot recvmsg，调用时持有锁
+  void arm() {
+    _armed = true;
+    _arms += 1;
+    auto sqe = _owner->get_detached_sqe();
+    io_uring_prep_recvmsg_multishot(sqe, _fd, &_msg, 0);
+    io::detail::record_fd_ring(_fd);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = _buffers.group();
+    io_uring_sqe_set_data(sqe, &_recv_data);
+    _owner->submit();
+  }
+
+  // 提交或请求所属 ring 提交，调用时持有锁
+  void request_arm() {
+    if (on_owner()) {
+      arm();
+    } else {
+      _arm_requested = true;
+      send_command(Arm);
+    }
+  }
+
+  // 执行或投递命令，调用时持有锁
+  // 不在 worker 上（例如运行时已经停止）时无法投递，状态随之泄漏
+  void send_command(Command command) {
+    if (on_owner()) {
+      if (command == Cancel) {
+        auto sqe = _owner->get_detached_sqe();
+        io_uring_prep_cancel64(sqe, reinterpret_cast<std::uint64_t>(&_recv_data), 0);
+        io_uring_sqe_set_data(sqe, nullptr);
+        _owner->submit();
+      } else {
+        arm();
+      }
+      return;
+    }
+    auto ring = io::detail::current_uring;
+    if (ring == nullptr) [[unlikely]] {
+      return;
+    }
+    _commands += 1;
+    // 消息在所属 ring 上产生一个 CQE：res 为命令，user_data 为 _signal_data
+    auto sqe = ring->get_detached_sqe();
+    io_uring_prep_msg_ring(sqe, _owner->uring()->ring_fd, command,
+                           reinterpret_cast<std::uint64_t>(&_signal_data), 0);
+    io_uring_sqe_set_data(sqe, nullptr);
+    ring->submit();
+  }
+
+  // 所属 worker 收到命令
+  auto on_signal(int command, unsigned) -> std::coroutine_handle<> {
+    bool destroy{false};
+    {
+      std::lock_guard lock{_mutex};
+      _commands -= 1;
+      if (command == Arm) {
+        _arm_requested = false;
+      }
+      if (!_closed && !_armed && command == Arm) {
+        arm();
+      } else if (_closed && _armed) {
+        send_command(Cancel);
+      }
+      destroy = _closed && !_armed && _commands == 0;
+    }
+    if (destroy) {
+      delete this;
+    }
+    return nullptr;
+  }
+
+  // 所属 worker 收到 multishot 请求的 CQE
+  auto on_recv(int result, unsigned flags) -> std::coroutine_handle<> {
+    std::coroutine_handle<> waiter{nullptr};
+    bool destroy{false};
+    {
+      std::lock_guard lock{_mutex};
+      if ((flags & IORING_CQE_F_MORE) == 0) {
+        _armed = false;
+      }
+      if (_closed) {
+        destroy = !_armed && _commands == 0;
+      } else if (result == -ENOBUFS) {
+        // 缓冲区耗尽，请求已经结束，等消费者归还缓冲区后再重新提交；
+        // 期间到达的数据报留在 socket 接收队列中
+        if (_completions.empty() && _waiter != nullptr) {
+          arm();
+        }
+      } else {
+        _completions.push_back({result, flags});
+        waiter = std::exchange(_waiter, nullptr);
+      }
+    }
+    if (destroy) {
+      delete this;
+    }
+    return waiter;
+  }
+
+  // 解析内核写入缓冲区的 io_uring_recvmsg_out
+  auto parse(Completion completion) -> expected<RecvPacket<Addr>> {
+    if (completion.result < 0) {
+      return std::unexpected{make_error(-completion.result)};
+    }
+    auto bid = static_cast<std::uint16_t>(completion.flags >>
+                                          IORING_CQE_BUFFER_SHIFT);
+    _current = bid;
+    auto out = io_uring_recvmsg_validate(_buffers.buffer(bid),
+                                         completion.result, &_msg);
+    if (out == nullptr) [[unlikely]] {
+      return std::unexpected{make_error(EBADMSG)};
+    }
+    RecvPacket<Addr> packet{
+        .data = {static_cast<const char *>(io_uring_recvmsg_payload(out, &_msg)),
+                 io_uring_recvmsg_payload_length(out, completion.result, &_msg)},
+        .addr = Addr{static_cast<const struct sockaddr *>(
+                         io_uring_recvmsg_name(out)),
+                     std::min<std::size_t>(out->namelen, sizeof(Addr))},
+        .truncated = (out->flags & MSG_TRUNC) != 0};
+    std::optional<std::uint32_t> dropped{};
+    for (auto cmsg = io_uring_recvmsg_cmsg_firsthdr(out, &_msg); cmsg != nullptr;
+         cmsg = io_uring_recvmsg_cmsg_nexthdr(out, &_msg, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+        std::uint32_t count{0};
+        std::memcpy(&count, CMSG_DATA(cmsg), sizeof(count));
+        dropped = count;
+      }
+    }
+    // stats() 可能在其他 worker 上读取，与之共用锁
+    std::lock_guard lock{_mutex};
+    if (dropped) {
+      _stats.dropped = *dropped;
+    }
+    _stats.received += 1;
+    _stats.truncated += packet.truncated ? 1 : 0;
+    return packet;
+  }
+
+  void recycle_current() noexcept {
+    if (_current >= 0) {
+      _buffers.recycle(static_cast<std::uint16_t>(_current));
+      _current = -1;
+    }
+  }
+
+private:
+  int _fd;
+  io::detail::IOuring *_owner;                   // 提交请求的 ring
+  io::detail::ProvidedBufferRing _buffers{};     // 缓冲区环
+  struct msghdr _msg;                            // 只用于告诉内核地址和控制消息的长度
+  io::detail::io_user_data_t _recv_data{};       // multishot 请求
+  io::detail::io_user_data_t _signal_data{};     // 跨 ring 命令
+  Handler<&MultishotRecv::on_recv> _recv_handler{};
+  Handler<&MultishotRecv::on_signal> _signal_handler{};
+  std::mutex _mutex;                             // 保护以下状态
+  std::deque<Completion> _completions{};         // 尚未交付的完成
+  std::coroutine_handle<> _waiter{nullptr};      // 等待数据报的消费者
+  bool _armed{false};                            // 请求是否还在内核中
+  bool _arm_requested{false};                    // 是否有在途的 Arm 命令
+  bool _closed{false};                           // RecvStream 是否已经析构
+  std::uint32_t _commands{0};                    // 在途的命令数
+  int _current{-1};                              // 消费者持有的缓冲区
+  std::uint64_t _arms{0};                        // 提交 multishot 请求的次数
+  RecvStreamStats _stats{};                      // 由消费者在解析时更新
+};
+
+// 基于 multishot recvmsg 的数据报流
+// 一次提交持续接收，每个数据报由内核从缓冲区环中挑选缓冲区，省去逐包的 sqe 和 msghdr
+template <class Addr> class RecvStream {
+public:
+  explicit RecvStream(MultishotRecv<Addr> *inner) : _inner{inner} {}
+  ~RecvStream() {
+    if (_inner != nullptr) {
+      _inner->close();
+    }
+  }
+
+  RecvStream(RecvStream &&other) noexcept
+      : _inner{std::exchange(other._inner, nullptr)} {}
+  RecvStream &operator=(RecvStream &&other) noexcept {
+    if (this != &other) {
+      if (_inner != nullptr) {
+        _inner->close();
+      }
+      _inner = std::exchange(other._inner, nullptr);
+    }
+    return *this;
+  }
+
+public:
+  /// 等待下一个数据报：expected<RecvPacket>
+  /// 返回的负载只在下一次 next() 之前有效；请求因出错结束时返回错误，下一次调用自动重新提交
+  auto next() noexcept { return _inner->next(); }
+
+  /// 统计
+  [[nodiscard]] auto stats() const -> RecvStreamStats { return _inner->stats(); }
+
+private:
+  MultishotRecv<Addr> *_inner;
+};
+
+template <class T, class Addr> struct ImplRecvStream {
+  /// 创建基于 multishot recvmsg + 缓冲区环的接收流，只能在worker上调用
+  /// 内核不支持缓冲区环（5.19 之前）时返回错误，调用方可以退化为 recv_from 循环
+  /// 同一个 socket 同一时刻只能有一个接收流
+  [[nodiscard]] auto recv_stream(const RecvStreamConfig &config = {}) noexcept
+      -> expected<RecvStream<Addr>> {
+    auto owner = io::detail::current_uring;
+    if (owner == nullptr) {
+      return std::unexpected{make_error(EINVAL)};
+    }
+    auto inner = new MultishotRecv<Addr>{static_cast<T *>(this)->fd(), owner};
+    if (auto res = inner->setup(config); !res) {
+      inner->close();
+      return std::unexpected{std::move(res.error())};
+    }
+    return RecvStream<Addr>{inner};
+  }
+};
+
+} // namespace faio::net::detail
+
+#endif // FAIO_DETAIL_NET_COMMON_DATAGRAM_MULTISHOT_HPP
@@ -31,6 +31,13 @@ template <class T, class Addr> struct ImplRecv {
                  .msg_controllen = 0,
                  .msg_flags = static_cast<int>(flags)} {};
 
+      // 移动后重新指向自身的 msghdr、地址和 iovec
+      void rebind_sqe() noexcept {
+        _msg.msg_name = &_addr;
+        _msg.msg_iov = &_iovecs;
+        this->_sqe->addr = reinterpret_cast<unsigned long long>(&_msg);
+      }
+
       auto await_resume() const noexcept
           -> expected<std::pair<std::size_t, Addr>> {
         if (this->_user_data.result >= 0) [[likely]] {
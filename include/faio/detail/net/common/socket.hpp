@@ -10,7 +10,8 @@
 namespace faio::net::detail {
 class Socket : public io::detail::FileDescriptor {
 public:
-  explicit Socket(const int fd) : FileDescriptor{fd} {}
+  // socket 关闭时取消其上的在途请求，挂起的 recv/send/accept 以 ECANCELED 返回
+  explicit Socket(const int fd) : FileDescriptor{fd, true} {}
 
 public:
   template <typename Addr>
@@ -13,7 +13,13 @@ template <class T> struct ImplStreamRead {
   // 基础的读取操作
   auto read(std::span<char> buf) const noexcept {
     return io::detail::Read{static_cast<const T *>(this)->fd(), buf.data(),
-                            buf.size(), 0};
+                            buf.size(), static_cast<std::size_t>(-1)};
+  }
+
+  // 读取到注册缓冲区
+  auto read_fixed(io::FixedBuffer &buf) const noexcept {
+    return io::detail::ReadFixed{static_cast<const T *>(this)->fd(), buf,
+                                 buf.size(), 0};
   }
 
   // 分散读取
@@ -27,13 +33,16 @@ template <class T> struct ImplStreamRead {
       using Base = io::detail::IORegistrantAwaiter<ReadV>;
 
     public:
-      ReadV(int fd, Ts &...buffers)
+      ReadV(int fd, Ts &&...buffers)
           : Base{io_uring_prep_readv, fd, nullptr, N,
                  static_cast<std::size_t>(-1)},
             _iovecs(
                 iovec{.iov_base = std::span<char>(buffers).data(),
-                      .iov_len = std::span<char>(buffers).size_bytes()}...) {
-        this->_sqe = reinterpret_cast<unsigned long long>(_iovecs.data());
+                      .iov_len = std::span<char>(buffers).size_bytes()}...) {}
+
+      // prep 时 iovec 还没有构造，挂起时（移动之后）再回填 sqe 的地址
+      void rebind_sqe() noexcept {
+        this->_sqe->addr = reinterpret_cast<unsigned long long>(_iovecs.data());
       }
 
       auto await_resume() const noexcept -> expected<std::size_t> {
@@ -47,7 +56,14 @@ template <class T> struct ImplStreamRead {
     private:
       std::array<struct iovec, N> _iovecs;
     };
-    return ReadV{static_cast<T *>(this)->fd(), std::forward<Ts>(buffers)...};
+    return ReadV{static_cast<const T *>(this)->fd(),
+                 std::forward<Ts>(buffers)...};
+  }
+
+  // 分散读取到运行时长度的iovec链
+  auto read_vectored(io::BufferChain &chain) const noexcept {
+    return io::detail::ReadV{static_cast<const T *>(this)->fd(), chain.data(),
+                             chain.io_count(), static_cast<__u64>(-1), 0};
   }
 
   // 保证读取指定字节数的字节
@@ -22,6 +22,15 @@ template <class T> struct ImplStreamWrite {
     return io::detail::SendZC{static_cast<T *>(this)->fd(), buf.data(),
                               buf.size_bytes(), MSG_NOSIGNAL, 0};
   }
+  // 从注册缓冲区写入
+  auto write_fixed(const io::FixedBuffer &buf, std::size_t len) noexcept {
+    return io::detail::WriteFixed{static_cast<T *>(this)->fd(), buf, len, 0};
+  }
+  // 从注册缓冲区零拷贝写入，协程在内核不再引用缓冲区后才恢复
+  auto write_zc(const io::FixedBuffer &buf, std::size_t len) noexcept {
+    return io::detail::SendZC{static_cast<T *>(this)->fd(), buf, len,
+                              MSG_NOSIGNAL, 0};
+  }
   // 分散写入操作
   template <typename... Ts>
     requires(constructible_to_char_slice<Ts> && ...)
@@ -48,6 +57,12 @@ template <class T> struct ImplStreamWrite {
                  .msg_controllen = 0,
                  .msg_flags = MSG_NOSIGNAL} {}
 
+      // 移动后重新指向自身的 msghdr 和 iovec 数组
+      void rebind_sqe() noexcept {
+        _msg.msg_iov = _iovecs.data();
+        this->_sqe->addr = reinterpret_cast<unsigned long long>(&_msg);
+      }
+
       auto await_resume() const noexcept -> expected<std::size_t> {
         if (this->_user_data.result >= 0) [[likely]] {
           return static_cast<std::size_t>(this->_user_data.result);
@@ -63,6 +78,58 @@ template <class T> struct ImplStreamWrite {
     return WriteV{static_cast<T *>(this)->fd(), std::forward<Ts>(bufs)...};
   }
 
+  // 集中写入运行时长度的iovec链，一次最多提交 IOV_MAX 段
+  auto write_vectored(const io::BufferChain &chain) noexcept {
+    class WriteVectored
+        : public io::detail::IORegistrantAwaiter<WriteVectored> {
+    private:
+      using Base = io::detail::IORegistrantAwaiter<WriteVectored>;
+
+    public:
+      WriteVectored(int fd, const io::BufferChain &chain)
+          : Base{io_uring_prep_sendmsg, fd, &_msg, MSG_NOSIGNAL},
+            _msg{.msg_name = nullptr,
+                 .msg_namelen = 0,
+                 .msg_iov = const_cast<struct iovec *>(chain.data()),
+                 .msg_iovlen = chain.io_count(),
+                 .msg_control = nullptr,
+                 .msg_controllen = 0,
+                 .msg_flags = MSG_NOSIGNAL} {}
+
+      // 移动后重新指向自身的 msghdr，iovec 链在外部
+      void rebind_sqe() noexcept {
+        this->_sqe->addr = reinterpret_cast<unsigned long long>(&_msg);
+      }
+
+      auto await_resume() const noexcept -> expected<std::size_t> {
+        if (this->_user_data.result >= 0) [[likely]] {
+          return static_cast<std::size_t>(this->_user_data.result);
+        } else {
+          return ::std::unexpected{make_error(-this->_user_data.result)};
+        }
+      }
+
+    private:
+      struct msghdr _msg;
+    };
+    return WriteVectored{static_cast<T *>(this)->fd(), chain};
+  }
+
+  // 保证写完iovec链中的所有字节，部分写入时原地推进链
+  task<expected<void>> write_all_vectored(io::BufferChain &chain) noexcept {
+    while (!chain.empty()) {
+      auto res = co_await this->write_vectored(chain);
+      if (!res) {
+        co_return std::unexpected{std::move(res.error())};
+      }
+      if (res.value() == 0) {
+        co_return std::unexpected{Error{Error::WriteZero}};
+      }
+      chain.advance(res.value());
+    }
+    co_return expected<void>{};
+  }
+
   // 保证写入指定字节数的字节
   task<expected<void>> write_all(std::span<const char> buf) noexcept {
     expected<std::size_t> res{0};
@@ -23,6 +23,12 @@ public:
                  reinterpret_cast<struct sockaddr *>(&addr_), &length_,
                  SOCK_NONBLOCK} {}
 
+      // 移动后重新指向自身的地址缓冲区和长度
+      void rebind_sqe() noexcept {
+        this->_sqe->addr = reinterpret_cast<unsigned long long>(&addr_);
+        this->_sqe->off = reinterpret_cast<unsigned long long>(&length_);
+      }
+
       auto await_resume() const noexcept -> expected<std::pair<Stream, Addr>> {
         if (this->_user_data.result >= 0) [[likely]] {
           return std::make_pair(Stream{Socket{this->_user_data.result}}, addr_);
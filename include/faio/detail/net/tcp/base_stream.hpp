@@ -23,54 +23,59 @@ public:
 
   auto close() noexcept { return _inner_socket.close(); }
 
+  /// 取消当前 worker 上这个连接的全部在途 IO，结果为取消的请求数
+  /// 连接析构和 close() 时会自动取消，不需要在关闭前手动调用
+  auto cancel_all() noexcept { return _inner_socket.cancel_all(); }
+
   [[nodiscard]]
   auto fd() const noexcept {
     return _inner_socket.fd();
   }
 
 public:
-  static auto connect(const Addr &addr) {
-    class Connect : public io::detail::IORegistrantAwaiter<Connect> {
+  static auto connect(const Addr &addr) { return Connect{addr}; }
 
-    private:
-      using Base = io::detail::IORegistrantAwaiter<Connect>;
+private:
+  // 建连的 awaiter，挂起时才创建 socket
+  class Connect : public io::detail::IORegistrantAwaiter<Connect> {
 
-    public:
-      Connect(const Addr &addr)
-          : Base{io_uring_prep_connect, -1, nullptr, sizeof(Addr)},
-            addr_{addr} {}
+  private:
+    using Base = io::detail::IORegistrantAwaiter<Connect>;
 
-      auto await_suspend(std::coroutine_handle<> handle) -> bool {
-        fd_ = ::socket(addr_.family(), SOCK_STREAM | SOCK_NONBLOCK, 0);
-        if (fd_ < 0) [[unlikely]] {
-          this->_user_data.result = errno;
-          io_uring_prep_nop(this->_sqe);
-          io_uring_sqe_set_data(this->_sqe, nullptr);
-          return false;
-        }
-        this->_sqe->fd = fd_;
-        this->_sqe->addr = (unsigned long)addr_.sockaddr();
-        Base::await_suspend(handle);
-        return true;
+  public:
+    Connect(const Addr &addr)
+        : Base{io_uring_prep_connect, -1, nullptr, sizeof(Addr)},
+          addr_{addr} {}
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) -> bool {
+      fd_ = ::socket(addr_.family(), SOCK_STREAM | SOCK_NONBLOCK, 0);
+      if (fd_ < 0) [[unlikely]] {
+        this->_user_data.result = -errno;
+        io_uring_prep_nop(this->_sqe);
+        io_uring_sqe_set_data(this->_sqe, nullptr);
+        return false;
       }
+      this->_sqe->fd = fd_;
+      this->_sqe->addr = (unsigned long)addr_.sockaddr();
+      return Base::await_suspend(handle);
+    }
 
-      auto await_resume() noexcept -> expected<Stream> {
-        if (this->_user_data.result >= 0) [[likely]] {
-          return Stream{Socket{fd_}};
-        } else {
-          if (fd_ >= 0) {
-            ::close(fd_);
-          }
-          return std::unexpected{make_error(-this->_user_data.result)};
+    auto await_resume() noexcept -> expected<Stream> {
+      if (this->_user_data.result >= 0) [[likely]] {
+        return Stream{Socket{fd_}};
+      } else {
+        if (fd_ >= 0) {
+          ::close(fd_);
         }
+        return std::unexpected{make_error(-this->_user_data.result)};
       }
+    }
 
-    private:
-      int fd_;
-      Addr addr_;
-    };
-    return Connect{addr};
-  }
+  private:
+    int fd_;
+    Addr addr_;
+  };
 
 private:
   Socket _inner_socket;
@@ -1,12 +1,16 @@
 #ifndef FAIO_DETAIL_NET_UDP_DATAGRAM_HPP
 #define FAIO_DETAIL_NET_UDP_DATAGRAM_HPP
 #include "faio/detail/net/common/address.hpp"
+#include "faio/detail/net/common/datagram_batch.hpp"
+#include "faio/detail/net/common/datagram_multishot.hpp"
 #include "faio/detail/net/common/sockopt.hpp"
 #include "faio/detail/net/udp/base_datagram.hpp"
 namespace faio::net::detail {
 class UdpDatagram : public detail::BaseDatagram<UdpDatagram, SocketAddr>,
                     public detail::ImplBoradcast<UdpDatagram>,
-                    public detail::ImplTTL<UdpDatagram> {
+                    public detail::ImplTTL<UdpDatagram>,
+                    public detail::ImplDatagramBatch<UdpDatagram, SocketAddr>,
+                    public detail::ImplRecvStream<UdpDatagram, SocketAddr> {
 
 public:
   explicit UdpDatagram(detail::Socket &&inner)
@@ -225,6 +225,15 @@ public:
     return _poller != nullptr;
   }
 
+  // 运行时统计快照（系统调用次数、提交和收割数量），运行时停止后返回空统计
+  [[nodiscard]]
+  runtime::detail::RuntimeMetrics metrics() const {
+    if (!_poller) {
+      return {};
+    }
+    return _poller->metrics();
+  }
+
   // ============================================================================
   // spawn: 轻量提交协程到 runtime，零堆分配
   //
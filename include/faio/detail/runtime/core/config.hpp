@@ -2,7 +2,9 @@
 #define FAIO_DETAIL_RUNTIME_CONFIG_HPP
 
 #include <format>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace faio::runtime::detail {
 static inline constexpr std::size_t MAX_LEVEL{6uz};
@@ -11,12 +13,44 @@ static inline constexpr std::size_t SLOT_SHIFT{6uz}; // log2(SLOT_SIZE)
 static inline constexpr std::size_t SLOT_MASK{SLOT_SIZE - 1uz}; // SLOT_SIZE - 1
 static inline constexpr std::size_t LOCAL_QUEUE_CAPACITY{256uz};
 
+// IO 超时的实现方式
+enum class TimeoutBackend {
+  Timer,       // 用户态时间轮，到期后提交 cancel
+  LinkTimeout, // IORING_OP_LINK_TIMEOUT，和 IO 链接在一起由内核计时
+};
+
+// sqe 的提交时机
+enum class SubmitPolicy {
+  Interval, // 每积累 _submit_interval 个 sqe 提交一次
+  Tick,     // 每轮调度结束时统一提交一次，休眠时与等待合并
+};
+
+// IO 后端
+enum class IOBackend {
+  Auto,    // 优先 io_uring，创建失败（seccomp、旧内核）时退化为 epoll
+  IOuring, // 只使用 io_uring
+  Epoll,   // 只使用 epoll
+};
+
 struct Config {
   std::size_t _num_events{1024}; // iouring队列大小
   uint32_t _submit_interval{4};  // 提交间隔
   std::size_t _num_workers{std::thread::hardware_concurrency()}; // 工作线程数量
   uint32_t _io_interval{61};                                     // io间隔
   uint32_t _global_queue_interval{61};                           // 全局队列间隔
+  TimeoutBackend _timeout_backend{TimeoutBackend::Timer}; // IO超时实现方式
+  SubmitPolicy _submit_policy{SubmitPolicy::Tick};        // sqe提交时机
+  std::size_t _fixed_buffer_size{8uz << 20}; // 每个worker的注册缓冲区大小
+  bool _share_iowq{true}; // 其他worker的ring通过 IORING_SETUP_ATTACH_WQ 共享第一个ring的io-wq
+  uint32_t _iowq_max_bounded{0};   // io-wq 有界（文件/块设备）线程上限，0为内核默认
+  uint32_t _iowq_max_unbounded{0}; // io-wq 无界（socket等）线程上限，0为内核默认
+  std::vector<std::size_t> _iowq_cpus{}; // 第i个worker的io-wq绑定到 _iowq_cpus[i % size]，空为不绑定
+  uint32_t _napi_busy_poll_us{0};     // NAPI 忙轮询时长（微秒），0为不注册
+  bool _napi_prefer_busy_poll{false}; // 忙轮询期间推迟网卡中断
+  uint32_t _spin_window_us{0};        // 没有任务时进入休眠前的自旋时长（微秒）
+  IOBackend _io_backend{IOBackend::Auto}; // IO 后端
+  bool _latency_tracing{false}; // 按 opcode 统计提交到完成、完成到恢复的延迟
+  uint32_t _timer_tick_us{1000}; // 定时器时间轮的基本 tick（微秒）
 };
 
 } // namespace faio::runtime::detail
@@ -40,15 +74,50 @@ public:
 
   auto format(const faio::runtime::detail::Config &config,
               auto &context) const noexcept {
+    std::string cpus;
+    for (auto cpu : config._iowq_cpus) {
+      cpus += cpus.empty() ? std::to_string(cpu) : "," + std::to_string(cpu);
+    }
     return format_to(context.out(),
                      R"(num_events: {},
                          num_workers: {},
                          io_interval: {},
                          global_queue_interval: {},
-                         submit_interval: {})",
+                         submit_interval: {},
+                         timeout_backend: {},
+                         submit_policy: {},
+                         fixed_buffer_size: {},
+                         share_iowq: {},
+                         iowq_max_workers: [{}, {}],
+                         iowq_cpus: {},
+                         napi_busy_poll_us: {},
+                         napi_prefer_busy_poll: {},
+                         spin_window_us: {},
+                         io_backend: {},
+                         latency_tracing: {},
+                         timer_tick_us: {})",
                      config._num_events, config._num_workers,
                      config._io_interval, config._global_queue_interval,
-                     config._submit_interval);
+                     config._submit_interval,
+                     config._timeout_backend ==
+                             faio::runtime::detail::TimeoutBackend::Timer
+                         ? "timer"
+                         : "link_timeout",
+                     config._submit_policy ==
+                             faio::runtime::detail::SubmitPolicy::Tick
+                         ? "tick"
+                         : "interval",
+                     config._fixed_buffer_size, config._share_iowq,
+                     config._iowq_max_bounded, config._iowq_max_unbounded,
+                     cpus.empty() ? "none" : cpus, config._napi_busy_poll_us,
+                     config._napi_prefer_busy_poll, config._spin_window_us,
+                     config._io_backend == faio::runtime::detail::IOBackend::Auto
+                         ? "auto"
+                     : config._io_backend ==
+                             faio::runtime::detail::IOBackend::IOuring
+                         ? "io_uring"
+                         : "epoll",
+                     config._latency_tracing, config._timer_tick_us);
   }
 };
 
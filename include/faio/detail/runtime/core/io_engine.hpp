@@ -1,12 +1,17 @@
 #ifndef FAIO_DETAIL_RUNTIME_CORE_ENGINE_HPP
 #define FAIO_DETAIL_RUNTIME_CORE_ENGINE_HPP
 
+#include "faio/detail/io/uring/fd_cancel.hpp"
 #include "faio/detail/io/uring/io_completion.hpp"
 #include "faio/detail/io/uring/io_uring.hpp"
 #include "faio/detail/io/uring/waker.hpp"
 #include "faio/detail/runtime/core/config.hpp"
+#include "faio/detail/runtime/core/metrics.hpp"
 #include "faio/detail/runtime/core/timer/timer.hpp"
 #include <array>
+#include <chrono>
+#include <span>
+#include <vector>
 namespace faio::runtime::detail {
 
 class IOEngine;
@@ -16,8 +21,30 @@ inline thread_local IOEngine *current_io_engine{nullptr};
 // IOEngine 类，用于IO处理
 class IOEngine {
 public:
-  IOEngine(const Config &config) : _uring(config) { current_io_engine = this; }
-  ~IOEngine() { current_io_engine = nullptr; }
+  // mailboxes 为运行时中所有 worker 的取消信箱，按 worker_id 索引；
+  // fd_rings 记录每个 fd 提交过请求的 worker，只有一个 worker 时不使用
+  IOEngine(const Config &config, IOMetrics &metrics, std::size_t worker_id = 0,
+           int wq_fd = -1, std::span<io::detail::CancelMailbox> mailboxes = {},
+           io::detail::FdRings *fd_rings = nullptr)
+      : _uring(config, metrics, worker_id, wq_fd),
+        _timer(std::chrono::microseconds(config._timer_tick_us)),
+        _metrics(&metrics),
+        _mailbox(worker_id < mailboxes.size() ? &mailboxes[worker_id] : nullptr) {
+    current_io_engine = this;
+    _timer.set_waker(&_waker);
+    if (_mailbox != nullptr) {
+      _mailbox->set_waker(&_waker);
+      io::detail::current_cancel_mailboxes = {
+          mailboxes, worker_id, mailboxes.size() > 1 ? fd_rings : nullptr};
+    }
+  }
+  ~IOEngine() {
+    if (_mailbox != nullptr) {
+      _mailbox->set_waker(nullptr);
+      io::detail::current_cancel_mailboxes = {};
+    }
+    current_io_engine = nullptr;
+  }
 
 public:
   // 等待定时器到期并驱动IO处理
@@ -25,12 +52,31 @@ public:
   template <typename LocalQueue, typename GlobalQueue>
   void wait_and_drive(this IOEngine &engine, LocalQueue &local_queue,
                       GlobalQueue &global_queue) {
-    // 等待定时器到期
-    engine._uring.wait(engine._timer.next_deadline_ms());
+    // 等待定时器到期，没有定时器时一直等待到有完成事件或被唤醒
+    engine._uring.wait(engine._timer.next_deadline());
     // 处理已经完成的IO
     engine.drive(local_queue, global_queue);
   }
 
+  // 自旋窗口内的一轮轮询
+  // 注册了 NAPI 时先在内核中忙轮询网卡队列最多 timeout，否则只收割已经完成的IO
+  template <typename LocalQueue, typename GlobalQueue>
+  bool poll_and_drive(this IOEngine &engine, LocalQueue &local_queue,
+                      GlobalQueue &global_queue,
+                      std::chrono::microseconds timeout) {
+    if (engine._uring.napi_enabled() && timeout.count() > 0) {
+      engine._uring.busy_wait(timeout);
+    }
+    return engine.drive(local_queue, global_queue);
+  }
+
+  // Tick 策略：提交本轮调度积累的sqe，提交队列为空时不进入内核
+  void flush(this IOEngine &engine) {
+    if (engine._uring.tick_batching()) {
+      engine._uring.flush();
+    }
+  }
+
   // 驱动函数 ,用于处理已经完成的IO
   template <typename LocalQueue, typename GlobalQueue>
   bool drive(this IOEngine &engine, LocalQueue &local_queue,
@@ -39,8 +85,16 @@ public:
     constexpr const std::size_t SIZE = LOCAL_QUEUE_CAPACITY;
     std::array<io::detail::io_completion_t, SIZE> completions;
 
+    // 其他 worker 投递的按 fd 取消请求放入本 ring，随本轮一起提交
+    engine.drain_cancels();
+    // Tick 策略：其他路径（自旋、休眠之间）积累的sqe在收割前提交
+    engine.flush();
     // 预读完成队列
     auto completed_count = engine._uring.peek_batch(completions);
+    // 开启延迟追踪时，同一批 CQE 共用一个收割时间
+    const auto reaped_ns = engine._uring.latency_tracing() && completed_count > 0
+                               ? io::detail::IOuring::now_ns()
+                               : 0;
     // 遍历处理
     // 逻辑：如果定时器任务不为空，则移除定时器任务，并设置结果
     // 如果定时器任务为空，则设置结果，并推送到本地队列
@@ -50,32 +104,93 @@ public:
       if (user_data == nullptr) {
         continue;
       }
-      if (user_data->timer_task != nullptr) {
-        engine._timer.remove_task(user_data->timer_task);
+      auto flags = completions[i].flags();
+      // multishot 请求的每个 CQE 交给处理器，由处理器决定是否恢复协程
+      if (user_data->handler != nullptr) {
+        if (auto handle = user_data->handler->on_cqe(completions[i].expected(), flags);
+            handle != nullptr) {
+          local_queue.push_back(handle, global_queue);
+        }
+        continue;
+      }
+      // 零拷贝发送会产生两个 CQE：第一个带 IORING_CQE_F_MORE，携带发送结果；
+      // 第二个带 IORING_CQE_F_NOTIF，表示内核不再引用缓冲区，此时才恢复协程
+      if ((flags & IORING_CQE_F_NOTIF) == 0) {
+        if (user_data->timer_task != nullptr) {
+          engine._timer.remove_task(user_data->timer_task);
+          user_data->timer_task = nullptr;
+        }
+        user_data->result = completions[i].expected();
+        if (flags & IORING_CQE_F_MORE) {
+          continue;
+        }
+      }
+      // 延迟追踪：记录内核延迟；恢复协程的请求再记下收割时间，
+      // awaiter 析构时得到调度延迟
+      auto traced = reaped_ns != 0 && user_data->submit_ns != 0 ? user_data : nullptr;
+      if (traced != nullptr) [[unlikely]] {
+        engine._uring.trace_kernel(*traced, reaped_ns);
+      }
+      // 链式操作：组内最后一个完成的操作负责恢复协程
+      if (user_data->group != nullptr) {
+        user_data = user_data->group;
+        if (--user_data->pending != 0) {
+          continue;
+        }
+        if (user_data->timer_task != nullptr) {
+          engine._timer.remove_task(user_data->timer_task);
+          user_data->timer_task = nullptr;
+        }
+      }
+      if (traced != nullptr) [[unlikely]] {
+        traced->reaped_ns = reaped_ns;
       }
-      user_data->result = completions[i].expected();
       local_queue.push_back(user_data->handle, global_queue);
     }
     // 消费完成队列
     engine._uring.consume(completed_count);
+    IOMetrics::add(engine._metrics->completed_cqes, completed_count);
     // 处理定时器任务
     auto timer_count = engine._timer.poll(local_queue, global_queue);
     // 更新完成队列数量
     completed_count += timer_count;
     // 开始监视唤醒
     engine._waker.start_watch();
-    // 重置提交计数并提交
-    engine._uring.reset_and_submit();
+    // 收割之后提交队列有了空位，补交等待 sqe 的请求
+    engine._uring.drain_waiters();
+    // Interval 策略收割后立即提交；Tick 策略留到下一轮 drive 或休眠前的
+    // submit_and_wait 一起提交
+    if (!engine._uring.tick_batching()) {
+      engine._uring.reset_and_submit();
+    }
     return completed_count > 0;
   }
 
   // 唤醒IO处理引擎
   void wake_up(this IOEngine &engine) { engine._waker.wake_up(); }
 
+  /// uring 实例的fd，供其他ring共享io-wq
+  [[nodiscard]] int ring_fd() noexcept { return _uring.uring()->ring_fd; }
+
+private:
+  void drain_cancels() {
+    if (_mailbox == nullptr) {
+      return;
+    }
+    _mailbox->take(_cancels);
+    for (auto cancel : _cancels) {
+      cancel->submit(_uring);
+    }
+    _cancels.clear();
+  }
+
 private:
   io::detail::IOuring _uring; // uring实例
   io::detail::Waker _waker;   // 唤醒器
   timer::Timer _timer;        // 定时器
+  IOMetrics *_metrics;        // 统计
+  io::detail::CancelMailbox *_mailbox;        // 本 worker 的取消信箱
+  std::vector<io::detail::FdCancel *> _cancels; // 从信箱取出的取消请求
 };
 } // namespace faio::runtime::detail
 #endif // FAIO_DETAIL_RUNTIME_CORE_ENGINE_HPP
\ No newline at end of file
@@ -0,0 +1,146 @@
+#ifndef FAIO_DETAIL_RUNTIME_CORE_METRICS_HPP
+#define FAIO_DETAIL_RUNTIME_CORE_METRICS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <liburing.h>
+#include <memory>
+#include <vector>
+
+namespace faio::runtime::detail {
+
+// 延迟直方图的桶数：第0个桶为 0ns，第 i 个桶为 [2^(i-1), 2^i) ns，
+// 最后一个桶收纳所有更大的值（约 275 秒以上）
+inline constexpr std::size_t LATENCY_BUCKETS = 40;
+
+// 单个 worker 上按 opcode 划分的延迟直方图，开启延迟追踪时才分配
+//   kernel    await_suspend 提交请求 → drive 收割到 CQE
+//   schedule  drive 收割到 CQE → 协程恢复（awaiter 析构）
+struct IOLatency {
+  using Histogram = std::array<std::atomic<std::uint64_t>, LATENCY_BUCKETS>;
+
+  std::array<Histogram, IORING_OP_LAST> kernel{};
+  std::array<Histogram, IORING_OP_LAST> schedule{};
+
+  [[nodiscard]] static auto bucket_of(std::uint64_t ns) noexcept -> std::size_t {
+    return std::min<std::size_t>(std::bit_width(ns), LATENCY_BUCKETS - 1);
+  }
+};
+
+// 单个 worker 的 io_uring 统计
+// 只由所属 worker 线程写入，其他线程可以随时读取，因此写入不需要原子加
+struct IOMetrics {
+  std::atomic<std::uint64_t> submit_syscalls{0}; // 提交的系统调用次数
+  std::atomic<std::uint64_t> wait_syscalls{0};   // 等待的系统调用次数
+  std::atomic<std::uint64_t> submitted_sqes{0};  // 提交的sqe数量
+  std::atomic<std::uint64_t> completed_cqes{0};  // 收割的cqe数量
+  std::unique_ptr<IOLatency> latency{};          // 延迟直方图，未开启追踪时为空
+
+  static void add(std::atomic<std::uint64_t> &counter, std::uint64_t n) {
+    counter.store(counter.load(std::memory_order::relaxed) + n,
+                  std::memory_order::relaxed);
+  }
+};
+
+// 延迟直方图快照
+struct LatencyHistogram {
+  std::array<std::uint64_t, LATENCY_BUCKETS> buckets{};
+
+  /// 样本数
+  [[nodiscard]] auto count() const noexcept -> std::uint64_t {
+    std::uint64_t total{0};
+    for (auto n : buckets) {
+      total += n;
+    }
+    return total;
+  }
+
+  /// 分位数 p（0~1）所在桶的上界，没有样本时为0
+  [[nodiscard]] auto percentile(double p) const noexcept -> std::chrono::nanoseconds {
+    auto total = count();
+    if (total == 0) {
+      return std::chrono::nanoseconds{0};
+    }
+    auto rank = static_cast<std::uint64_t>(p * static_cast<double>(total - 1)) + 1;
+    std::uint64_t seen{0};
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        return std::chrono::nanoseconds{i == 0 ? 0 : (std::int64_t{1} << i) - 1};
+      }
+    }
+    return std::chrono::nanoseconds{(std::int64_t{1} << (LATENCY_BUCKETS - 1)) - 1};
+  }
+
+  void merge(const IOLatency::Histogram &histogram) noexcept {
+    for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+      buckets[i] += histogram[i].load(std::memory_order::relaxed);
+    }
+  }
+};
+
+// 单个 opcode 的延迟，含义见 IOLatency
+struct OpLatency {
+  std::uint8_t opcode{0};
+  LatencyHistogram kernel{};
+  LatencyHistogram schedule{};
+};
+
+// 运行时统计快照，由 runtime_context::metrics() 汇总所有 worker 得到
+struct RuntimeMetrics {
+  std::size_t num_workers{0};       // worker 数量
+  std::uint64_t submit_syscalls{0}; // 提交的系统调用次数
+  std::uint64_t wait_syscalls{0};   // 等待的系统调用次数（含 submit_and_wait）
+  std::uint64_t submitted_sqes{0};  // 提交的sqe数量
+  std::uint64_t completed_cqes{0};  // 收割的cqe数量
+  std::vector<OpLatency> latency{}; // 按 opcode 升序的延迟，只含有样本的 opcode
+
+  /// io_uring 相关的系统调用总数
+  [[nodiscard]] auto syscalls() const noexcept -> std::uint64_t {
+    return submit_syscalls + wait_syscalls;
+  }
+
+  void merge(const IOMetrics &io) noexcept {
+    num_workers += 1;
+    submit_syscalls += io.submit_syscalls.load(std::memory_order::relaxed);
+    wait_syscalls += io.wait_syscalls.load(std::memory_order::relaxed);
+    submitted_sqes += io.submitted_sqes.load(std::memory_order::relaxed);
+    completed_cqes += io.completed_cqes.load(std::memory_order::relaxed);
+    if (io.latency == nullptr) {
+      return;
+    }
+    for (std::size_t op = 0; op < IORING_OP_LAST; ++op) {
+      LatencyHistogram kernel{};
+      LatencyHistogram schedule{};
+      kernel.merge(io.latency->kernel[op]);
+      schedule.merge(io.latency->schedule[op]);
+      if (kernel.count() == 0 && schedule.count() == 0) {
+        continue;
+      }
+      auto opcode = static_cast<std::uint8_t>(op);
+      auto it = std::ranges::lower_bound(latency, opcode, {}, &OpLatency::opcode);
+      if (it == latency.end() || it->opcode != opcode) {
+        it = latency.insert(it, OpLatency{.opcode = opcode});
+      }
+      for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        it->kernel.buckets[i] += kernel.buckets[i];
+        it->schedule.buckets[i] += schedule.buckets[i];
+      }
+    }
+  }
+
+  /// opcode（IORING_OP_*）的延迟，没有样本时为空
+  [[nodiscard]] auto op_latency(std::uint8_t opcode) const noexcept -> const OpLatency * {
+    auto it = std::ranges::lower_bound(latency, opcode, {}, &OpLatency::opcode);
+    return it != latency.end() && it->opcode == opcode ? &*it : nullptr;
+  }
+};
+
+} // namespace faio::runtime::detail
+
+#endif // FAIO_DETAIL_RUNTIME_CORE_METRICS_HPP
@@ -29,6 +29,11 @@ public:
   // 关闭共享资源
   void close() { _shared.close(); }
 
+  // 运行时统计快照
+  [[nodiscard]] RuntimeMetrics metrics() const {
+    return _shared.collect_metrics();
+  }
+
 private:
   // 工作函数，创建线程并运行工作者
   void work() {
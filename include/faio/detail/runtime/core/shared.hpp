@@ -1,12 +1,15 @@
 #ifndef FAIO_DETAIL_RUNTIME_CORE_SHARED_HPP
 #define FAIO_DETAIL_RUNTIME_CORE_SHARED_HPP
 
+#include "faio/detail/io/uring/fd_cancel.hpp"
 #include "faio/detail/runtime/core/config.hpp"
+#include "faio/detail/runtime/core/metrics.hpp"
 #include "faio/detail/runtime/core/queue.hpp"
 #include "faio/detail/runtime/core/state_machine.hpp"
 #include <coroutine>
 #include <cstddef>
 #include <latch>
+#include <memory>
 #include <optional>
 
 namespace faio::runtime::detail {
@@ -22,9 +25,18 @@ class Shared {
 public:
   Shared(const Config &config)
       : _config(config), _state_machine(config._num_workers),
-        _shutdown_latch(static_cast<std::ptrdiff_t>(config._num_workers)) {
+        _shutdown_latch(static_cast<std::ptrdiff_t>(config._num_workers)),
+        _io_metrics(std::make_unique<IOMetrics[]>(config._num_workers)),
+        _cancel_mailboxes(
+            std::make_unique<io::detail::CancelMailbox[]>(config._num_workers)),
+        _fd_rings(config._num_workers) {
     current_shared = this;
     set_workers_size(config._num_workers);
+    if (config._latency_tracing) {
+      for (std::size_t i = 0; i < config._num_workers; ++i) {
+        _io_metrics[i].latency = std::make_unique<IOLatency>();
+      }
+    }
   }
   ~Shared() { current_shared = nullptr; }
 
@@ -77,6 +89,34 @@ public:
     wake_up_one();
   }
 
+  // 共享io-wq时，其他worker需要等第一个worker创建ring后才能attach
+  // 返回需要attach的ring fd，不共享或自己就是第一个worker时返回-1
+  [[nodiscard]]
+  int attach_iowq_fd(std::size_t worker_id) {
+    if (!_config._share_iowq || worker_id == 0) {
+      return -1;
+    }
+    _iowq_ready.wait();
+    return _iowq_fd;
+  }
+
+  // 第一个worker创建ring后发布其fd
+  void publish_iowq_fd(int fd) {
+    _iowq_fd = fd;
+    _iowq_ready.count_down();
+  }
+
+  // 汇总所有worker的统计
+  // 统计数据由Shared持有，worker退出后仍然可以读取
+  [[nodiscard]]
+  RuntimeMetrics collect_metrics() const {
+    RuntimeMetrics metrics{};
+    for (std::size_t i = 0; i < _config._num_workers; ++i) {
+      metrics.merge(_io_metrics[i]);
+    }
+    return metrics;
+  }
+
 public:
   // 预留实现接口，由于shared不持有waker,所以需要在worker实现后实现以下接口
   void wake_up_one();
@@ -89,6 +129,11 @@ private:
   GlobalQueue _global_queue;           // 全局队列
   std::latch _shutdown_latch;          // 关闭latch
   std::vector<Worker *> _workers;      // 工作线程
+  std::unique_ptr<IOMetrics[]> _io_metrics; // 每个worker的IO统计
+  std::unique_ptr<io::detail::CancelMailbox[]> _cancel_mailboxes; // 每个worker的取消信箱
+  io::detail::FdRings _fd_rings;       // 每个fd提交过请求的worker
+  std::latch _iowq_ready{1};           // 第一个worker的ring是否已经创建
+  int _iowq_fd{-1};                    // 第一个worker的ring fd，io-wq 的所有者
 };
 } // namespace faio::runtime::detail
 #endif // FAIO_DETAIL_RUNTIME_CORE_SHARED_HPP
\ No newline at end of file
@@ -6,18 +6,38 @@
 #include <cerrno>
 #include <chrono>
 #include <coroutine>
+#include <cstdint>
 #include <liburing.h>
-#include <memory>
 
 namespace faio::runtime::detail::timer {
 
+class TimerWheel;
+
+// 到期时的回调，用于到期后还要先做清理（从等待链表摘除、取消一组 IO）的场景
+// 在时间轮所属的 worker 上调用，返回需要恢复的协程，不需要恢复时返回空
+struct TimerHandler {
+  virtual auto on_expire() noexcept -> std::coroutine_handle<> = 0;
+
+protected:
+  ~TimerHandler() = default;
+};
+
 // 封装定时器任务实体类
 //
-// 两种使用场景：
+// 三种使用场景：
 //   1. sleep：持有 coroutine_handle，到期后直接恢复协程
 //   2. IO 超时：持有 io_user_data_t*，到期后取消对应的 io_uring 操作
+//   3. 回调：持有 TimerHandler*，到期后交给回调处理
+//
+// 节点嵌入在 awaiter（Sleep、Timeout）中，由协程帧持有，定时器不分配内存。
+// 挂入时间轮后通过双向链表串在槽位上，并记下所在的层级和槽位，
+// 取消只需要摘链，不需要重新根据时间计算位置
 class TimerTask {
+  friend class TimerWheel;
+
 public:
+  TimerTask() = default;
+
   TimerTask(std::chrono::steady_clock::time_point deadline,
             std::coroutine_handle<> handle)
       : _handle(handle), _deadline(deadline) {}
@@ -26,35 +46,74 @@ public:
             io::detail::io_user_data_t *user_data)
       : _handle(nullptr), _deadline(deadline), _user_data(user_data) {}
 
+  TimerTask(std::chrono::steady_clock::time_point deadline, TimerHandler *handler)
+      : _handle(nullptr), _deadline(deadline), _handler(handler) {}
+
+  // 只能在挂入时间轮之前移动，链表指针不随之移动
+  TimerTask(TimerTask &&other) noexcept
+      : _handle(other._handle), _deadline(other._deadline),
+        _user_data(other._user_data), _handler(other._handler) {}
+
+  TimerTask &operator=(TimerTask &&other) noexcept {
+    _handle = other._handle;
+    _deadline = other._deadline;
+    _user_data = other._user_data;
+    _handler = other._handler;
+    return *this;
+  }
+
+  // awaiter 在到期前被销毁（协程帧被销毁）时从时间轮中摘除
+  ~TimerTask();
+
 public:
   /// 执行到期的定时器任务
   ///
   /// sleep 路径：将协程句柄推入本地任务队列等待调度
   /// IO 超时路径：设置超时错误码，通过 io_uring 取消挂起的 IO 操作
+  /// 回调路径：恢复回调返回的协程
   template <typename LocalQueue, typename GlobalQueue>
   void execute(LocalQueue &local_queue, GlobalQueue &global_queue) {
     if (_handle != nullptr) {
       // sleep 路径：直接恢复协程
       local_queue.push_back(_handle, global_queue);
+    } else if (_handler != nullptr) {
+      if (auto handle = _handler->on_expire(); handle) {
+        local_queue.push_back(handle, global_queue);
+      }
     } else if (_user_data != nullptr) {
       // IO 超时路径：设置超时错误并取消 IO 操作
       _user_data->result = -ETIMEDOUT;
+      _user_data->timed_out = true;
       _user_data->timer_task = nullptr;
-      auto sqe = io::detail::current_uring->get_sqe();
-      if (sqe != nullptr) {
-        io_uring_prep_cancel(sqe, _user_data, 0);
-        io_uring_sqe_set_data(sqe, nullptr);
+      // 请求还在等待 sqe，没有进入内核，直接摘除并恢复协程
+      if (io::detail::current_uring->unpark(_user_data)) {
+        local_queue.push_back(_user_data->handle, global_queue);
+        return;
       }
+      auto sqe = io::detail::current_uring->get_detached_sqe();
+      io_uring_prep_cancel(sqe, _user_data, 0);
+      io_uring_sqe_set_data(sqe, nullptr);
     }
   }
 
+  /// 是否挂在时间轮上
+  [[nodiscard]] bool linked() const noexcept { return _wheel != nullptr; }
+
 public:
   std::coroutine_handle<> _handle{nullptr};        // 协程句柄（sleep 场景）
   std::chrono::steady_clock::time_point _deadline; // 截止时间
   io::detail::io_user_data_t *_user_data{nullptr}; // 用户数据（IO 超时场景）
-  std::unique_ptr<TimerTask> _next{nullptr};       // 链表下一个节点
+  TimerHandler *_handler{nullptr};                 // 到期回调（回调场景）
+
+private:
+  TimerWheel *_wheel{nullptr}; // 所在的时间轮，未挂入时为空
+  TimerTask *_prev{nullptr};   // 槽位链表
+  TimerTask *_next{nullptr};
+  std::uint64_t _when{0};      // 到期的 tick
+  std::uint8_t _level{0};      // 所在层级
+  std::uint8_t _slot{0};       // 所在槽位
 };
 
 } // namespace faio::runtime::detail::timer
 
-#endif // FAIO_DETAIL_RUNTIME_CORE_TIMER_TIME_TASK_HPP
\ No newline at end of file
+#endif // FAIO_DETAIL_RUNTIME_CORE_TIMER_TIME_TASK_HPP
@@ -1,43 +1,45 @@
 #ifndef FAIO_DETAIL_RUNTIME_CORE_TIMER_TIMER_HPP
 #define FAIO_DETAIL_RUNTIME_CORE_TIMER_TIMER_HPP
 
+#include "faio/detail/io/uring/waker.hpp"
 #include "faio/detail/runtime/core/config.hpp"
 #include "faio/detail/runtime/core/timer/task.hpp"
 #include "faio/detail/runtime/core/timer/wheel.hpp"
 #include "fastlog/fastlog.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <chrono>
-#include <variant>
+#include <mutex>
+#include <optional>
+#include <vector>
 
 namespace faio::runtime::detail::timer {
 
-// =========================================================================
-// VariantWheelBuilder：利用 std::variant 构造能存放任意层级时间轮的类型
-// 生成 std::variant<std::monostate, unique_ptr<TimerWheel<0>>,
-//                    unique_ptr<TimerWheel<1>>, ...,
-//                    unique_ptr<TimerWheel<N-1>>>
-// =========================================================================
-template <std::size_t... N>
-static inline constexpr auto variant_wheel_impl(std::index_sequence<N...>) {
-  return std::variant<std::monostate, std::unique_ptr<TimerWheel<N>>...>{};
-}
-
-template <std::size_t N> struct VariantWheelBuilder {
-  using Type = decltype(variant_wheel_impl(std::make_index_sequence<N>{}));
-};
-
 // =========================================================================
 // Timer 类 —— 对外暴露的定时器管理器
 //
 // 核心设计：
 //   - 每个 worker 线程拥有一个独立的 Timer 实例（通过 thread_local 指针）
-//   - 内部用 variant 存放不同层级的根时间轮，实现动态升降级
-//   - _start 记录定时器创建时的基准时间点
-//   - 通过 elapsed_ms() 计算自启动以来经过的毫秒数
+//   - _start 记录定时器创建时的基准时间点，之后不再变化；
+//     到期时间换算成自 _start 起的 tick 交给时间轮，tick 默认 1ms，
+//     可以通过 ConfigBuilder::set_timer_tick 配置为亚毫秒
+//   - 任务节点由调用方持有（嵌入在 awaiter 中），Timer 只负责挂入和摘除
 //   - add_task / remove_task / poll 为主要操作接口
 // =========================================================================
 class Timer;
 inline thread_local Timer *current_timer;
 
+// 其他 worker 发来的改期请求
+// 时间轮只能由所属的 worker 修改，请求先放进 Timer 的收件箱，由所属 worker 在 poll 开头处理
+struct TimerReschedule {
+  /// 在时间轮所属的 worker 上调用，调用期间持有收件箱的锁
+  virtual void apply(Timer &timer) noexcept = 0;
+
+protected:
+  ~TimerReschedule() = default;
+};
+
 class Timer {
 public:
   Timer(const Timer &) = delete;
@@ -45,77 +47,79 @@ public:
   Timer(Timer &&) = delete;
   Timer &operator=(Timer &&) = delete;
 
-  Timer() {
+  explicit Timer(std::chrono::nanoseconds tick = std::chrono::milliseconds(1))
+      : _tick(std::max(tick, std::chrono::nanoseconds{1})) {
     current_timer = this;
-    fastlog::console.debug("Timer: initialized at thread");
+    fastlog::console.debug("Timer: initialized at thread, tick={}ns",
+                           _tick.count());
   }
 
   ~Timer() {
     current_timer = nullptr;
     fastlog::console.debug("Timer: destroyed, entries remaining={}",
-                           _num_entries);
+                           _wheel.num_entries());
   }
 
 public:
-  /// 添加定时器任务
-  /// @param deadline 任务的绝对到期时间
-  /// @param handle 任务到期时要恢复的协程句柄
-  /// @return 任务的裸指针（用于后续移除操作），调用者不拥有所有权
-  auto add_task(std::chrono::steady_clock::time_point deadline,
-                std::coroutine_handle<> handle) -> TimerTask * {
-    auto task = std::make_unique<TimerTask>(deadline, handle);
-    auto *raw = task.get();
-    add_task_impl(std::move(task));
-    return raw;
+  /// 添加定时器任务，在 task->_deadline 之后执行
+  /// @param task 任务节点，调用者持有，执行或移除之前必须保持有效
+  /// @param slack 允许推迟到期的时长。到期 tick 向上对齐到不超过 slack 的
+  ///              2 的幂个 tick，同一窗口内的定时器在同一次 poll 中批量到期，
+  ///              休眠的 worker 每个窗口最多醒来一次；实际到期不晚于 deadline + slack
+  void add_task(TimerTask *task, std::chrono::nanoseconds slack = {}) noexcept {
+    // 向上取整，保证不会提前到期
+    auto when = to_tick_ceil(task->_deadline);
+    if (slack >= _tick * 2) {
+      auto window = std::bit_floor(static_cast<std::uint64_t>(slack / _tick));
+      when = (when + window - 1) & ~(window - 1);
+    }
+    _wheel.insert(task, when);
   }
 
-  /// 添加定时器任务（io_user_data 版本，用于 io_uring 超时取消）
-  /// @param deadline 任务的绝对到期时间
-  /// @param user_data io_uring 用户数据指针
-  /// @return 任务的裸指针
-  auto add_task(std::chrono::steady_clock::time_point deadline,
-                io::detail::io_user_data_t *user_data) -> TimerTask * {
-    auto task = std::make_unique<TimerTask>(deadline, user_data);
-    auto *raw = task.get();
-    add_task_impl(std::move(task));
-    return raw;
+  /// 移除定时器任务，O(1) 摘链；已经执行或不在时间轮上时什么也不做
+  /// @param task 要移除的任务
+  void remove_task(TimerTask *task) noexcept {
+    if (task != nullptr) {
+      _wheel.remove(task);
+    }
   }
 
-  /// 移除定时器任务
-  /// @param task 要移除的任务裸指针
-  void remove_task(TimerTask *task) {
-    if (task == nullptr) {
-      return;
-    }
+  /// 修改任务的到期时间
+  /// 推迟时只记下新的时间，原位置到期时再重新检查并挂到新的位置（惰性），
+  /// 反复延长的截止时间在到期前只是一次赋值；提前时才立即重新挂入
+  void reset_task(TimerTask *task,
+                  std::chrono::steady_clock::time_point deadline) noexcept {
+    task->_deadline = deadline;
+    _wheel.reschedule(task, to_tick_ceil(deadline));
+  }
 
-    auto now = std::chrono::steady_clock::now();
-    // 如果任务已过期，无需移除
-    if (task->_deadline <= now) {
-      return;
+  /// 设置所属 worker 的唤醒器，收到需要提前到期的改期请求时唤醒它
+  void set_waker(io::detail::Waker *waker) noexcept { _waker = waker; }
+
+  /// 由其他 worker 调用：放入改期请求，wake 为 true 时唤醒所属 worker
+  void post(TimerReschedule *reschedule, bool wake) {
+    {
+      std::lock_guard lock{_inbox_mutex};
+      _inbox.push_back(reschedule);
+      _inbox_pending.store(true, std::memory_order::release);
     }
+    if (wake) {
+      this->wake();
+    }
+  }
 
-    auto interval_ms = to_ms(task->_deadline - _start);
-    auto elapsed = elapsed_ms();
-    if (interval_ms <= elapsed) {
-      return;
+  /// 唤醒所属 worker，让它尽快处理收件箱
+  void wake() {
+    if (_waker != nullptr) {
+      _waker->wake_up();
     }
-    auto relative_interval = interval_ms - elapsed;
+  }
 
-    // 在根时间轮中递归移除
-    std::visit(
-        [&](auto &wheel_ptr) {
-          using T = std::decay_t<decltype(wheel_ptr)>;
-          if constexpr (!std::is_same_v<T, std::monostate>) {
-            if (wheel_ptr) {
-              wheel_ptr->remove_task(task, relative_interval);
-              if (_num_entries > 0) {
-                --_num_entries;
-              }
-              try_level_down();
-            }
-          }
-        },
-        _root_wheel);
+  /// 撤回尚未处理的改期请求，请求的持有者销毁或换到其他 worker 等待之前调用；
+  /// 正在处理时等待处理完成
+  void retract(TimerReschedule *reschedule) {
+    std::lock_guard lock{_inbox_mutex};
+    std::erase(_inbox, reschedule);
   }
 
   /// 轮询处理到期任务
@@ -124,294 +128,116 @@ public:
   /// @return 本次处理的到期任务数量
   template <typename LocalQueue, typename GlobalQueue>
   auto poll(LocalQueue &local_queue, GlobalQueue &global_queue) -> std::size_t {
-    if (_num_entries == 0) {
-      return 0;
-    }
-
-    auto elapsed = elapsed_ms();
-    if (elapsed == 0) {
+    apply_reschedules();
+    if (_wheel.empty()) {
       return 0;
     }
+    return poll_at(std::chrono::steady_clock::now(), local_queue, global_queue);
+  }
 
-    std::size_t count = 0;
-    std::visit(
-        [&](auto &wheel_ptr) {
-          using T = std::decay_t<decltype(wheel_ptr)>;
-          if constexpr (!std::is_same_v<T, std::monostate>) {
-            if (wheel_ptr) {
-              wheel_ptr->handle_expired_tasks(local_queue, global_queue, count,
-                                              elapsed);
-            }
-          }
-        },
-        _root_wheel);
-
-    // 无论是否有任务被处理，都推进时间基准以保持时钟一致性
-    advance_start(elapsed);
-
+  /// 以 now 为当前时间处理到期任务
+  template <typename LocalQueue, typename GlobalQueue>
+  auto poll_at(std::chrono::steady_clock::time_point now,
+               LocalQueue &local_queue, GlobalQueue &global_queue)
+      -> std::size_t {
+    auto tick = to_tick(now);
+    auto count = _wheel.poll(tick, [&](TimerTask *task) {
+      // 截止时间在挂入之后被推迟，重新挂到新的位置
+      if (auto when = to_tick_ceil(task->_deadline); when > tick) {
+        _wheel.insert(task, when);
+        return false;
+      }
+      task->execute(local_queue, global_queue);
+      return true;
+    });
     if (count > 0) {
-      _num_entries -= std::min(_num_entries, count);
-      // 尝试降级
-      try_level_down();
-
       fastlog::console.trace("Timer::poll: processed {} tasks, {} remaining",
-                             count, _num_entries);
+                             count, _wheel.num_entries());
     }
-
     return count;
   }
 
-  /// 获取下一个到期任务的时间（距 now 的毫秒数）
-  /// @return 下一个到期任务距离现在的毫秒数；若无任务返回 max
+  /// 获取下一个需要处理的时间点，供 worker 休眠时设置唤醒时间
+  /// @return 下一个非空槽位的起始时间；若无任务返回空
   [[nodiscard]]
-  auto next_deadline_ms() const noexcept -> std::size_t {
-    if (_num_entries == 0) {
-      return std::numeric_limits<std::size_t>::max();
+  auto next_deadline() const noexcept
+      -> std::optional<std::chrono::steady_clock::time_point> {
+    auto expiration = _wheel.next_expiration();
+    if (!expiration) {
+      return std::nullopt;
     }
+    return _start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        _tick * expiration->deadline);
+  }
 
-    std::size_t expected = std::numeric_limits<std::size_t>::max();
-    std::visit(
-        [&](const auto &wheel_ptr) {
-          using T = std::decay_t<decltype(wheel_ptr)>;
-          if constexpr (!std::is_same_v<T, std::monostate>) {
-            if (wheel_ptr) {
-              auto deadline_from_start = wheel_ptr->next_deadline_time();
-              auto elapsed = elapsed_ms();
-              if (deadline_from_start > elapsed) {
-                expected = deadline_from_start - elapsed;
-              } else {
-                expected = 0;
-              }
-            }
-          }
-        },
-        _root_wheel);
-
-    return expected;
+  /// 时间轮的基本 tick
+  [[nodiscard]]
+  auto tick() const noexcept -> std::chrono::nanoseconds {
+    return _tick;
   }
 
   /// 获取当前剩余定时器任务数
   [[nodiscard]]
   auto num_entries() const noexcept -> std::size_t {
-    return _num_entries;
+    return _wheel.num_entries();
   }
 
   /// 判断定时器是否为空（没有待处理任务）
   [[nodiscard]]
   auto empty() const noexcept -> bool {
-    return _num_entries == 0;
+    return _wheel.empty();
   }
 
 private:
-  /// 内部添加任务的统一实现
-  void add_task_impl(std::unique_ptr<TimerTask> &&task) {
-    // 计算任务距离启动时间的间隔
-    auto interval_ms = to_ms(task->_deadline - _start);
-    auto elapsed = elapsed_ms();
-
-    // 如果任务已经过期或即将过期，调整到最小间隔
-    std::size_t relative_interval = 0;
-    if (interval_ms > elapsed) {
-      relative_interval = interval_ms - elapsed;
+  /// 处理其他 worker 发来的改期请求
+  void apply_reschedules() noexcept {
+    if (!_inbox_pending.exchange(false, std::memory_order::acquire)) [[likely]] {
+      return;
     }
-
-    // 确保根时间轮已初始化，且层级足够容纳此任务
-    ensure_capacity(relative_interval);
-
-    // 将任务添加到根时间轮
-    std::visit(
-        [&](auto &wheel_ptr) {
-          using T = std::decay_t<decltype(wheel_ptr)>;
-          if constexpr (!std::is_same_v<T, std::monostate>) {
-            if (wheel_ptr) {
-              wheel_ptr->add_task(std::move(task), relative_interval);
-            }
-          }
-        },
-        _root_wheel);
-
-    ++_num_entries;
-  }
-
-  /// 确保根时间轮的容量足够容纳 interval_ms
-  /// 如果当前层级不够，自动升级（level_up）
-  void ensure_capacity(std::size_t interval_ms) {
-    // 如果根时间轮还没初始化，创建 level-0 时间轮
-    if (std::holds_alternative<std::monostate>(_root_wheel)) {
-      if (interval_ms < TimerWheel<0uz>::SPAN_MS) {
-        _root_wheel = std::make_unique<TimerWheel<0uz>>();
-        return;
-      }
-      // 需要更高级别的时间轮
-      _root_wheel = std::make_unique<TimerWheel<0uz>>();
+    std::lock_guard lock{_inbox_mutex};
+    for (auto reschedule : _inbox) {
+      reschedule->apply(*this);
     }
-
-    // 递归升级直到容量足够
-    ensure_capacity_visit(interval_ms);
-  }
-
-  /// 利用 variant visit 实现递归升级
-  void ensure_capacity_visit(std::size_t interval_ms) {
-    std::visit(
-        [&](auto &wheel_ptr) {
-          using T = std::decay_t<decltype(wheel_ptr)>;
-          if constexpr (!std::is_same_v<T, std::monostate>) {
-            if (wheel_ptr) {
-              using WheelType = std::remove_reference_t<decltype(*wheel_ptr)>;
-              // 如果当前轮的跨度不足以容纳 interval_ms，需要升级
-              if (interval_ms >= WheelType::SPAN_MS) {
-                level_up_variant(interval_ms);
-              }
-            }
-          }
-        },
-        _root_wheel);
-  }
-
-  /// 将根时间轮升级一级
-  void level_up_variant(std::size_t interval_ms) {
-    // 使用 index 实现编译期分发升级逻辑
-    // variant 的 index 0 是 monostate，1 对应 TimerWheel<0>,
-    // 2 对应 TimerWheel<1>, ...
-    auto idx = _root_wheel.index();
-
-    // 利用编译期索引序列实现升级分发
-    level_up_dispatch(interval_ms, idx);
-  }
-
-  /// 编译期分发升级逻辑的辅助函数
-  void level_up_dispatch(std::size_t interval_ms, std::size_t current_idx) {
-    // 逐级升级，MAX_LEVEL 为上限
-    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-      (
-          [&] {
-            constexpr std::size_t LEVEL = Is;
-            constexpr std::size_t VARIANT_IDX = LEVEL + 1; // +1 因为 monostate
-            if (current_idx == VARIANT_IDX) {
-              if constexpr (LEVEL < MAX_LEVEL) {
-                auto &current_wheel = std::get<VARIANT_IDX>(_root_wheel);
-                auto new_wheel =
-                    current_wheel->level_up(std::move(current_wheel));
-                _root_wheel = std::move(new_wheel);
-
-                // 继续检查是否需要再升级
-                ensure_capacity_visit(interval_ms);
-              } else {
-                fastlog::console.error(
-                    "Timer: cannot level_up beyond MAX_LEVEL={}", MAX_LEVEL);
-              }
-            }
-          }(),
-          ...);
-    }(std::make_index_sequence<MAX_LEVEL + 1>{});
+    _inbox.clear();
   }
 
-  /// 尝试降级根时间轮
-  /// 当只有第 0 个槽位有子轮时，可以降级以节省内存
-  /// TimerWheel<0> 是最底层，不可再降级
-  void try_level_down() {
-    auto idx = _root_wheel.index();
-    // monostate (idx==0) 或 TimerWheel<0> (idx==1) 不需要降级
-    if (idx <= 1) {
-      // 对 TimerWheel<0>，仅检查是否为空可以释放
-      if (idx == 1) {
-        auto &wheel_ptr = std::get<1>(_root_wheel);
-        if (wheel_ptr && wheel_ptr->empty()) {
-          wheel_ptr.reset();
-          _root_wheel = std::monostate{};
-        }
-      }
-      return;
+  /// 时间点对应的 tick，向下取整
+  [[nodiscard]]
+  auto to_tick(std::chrono::steady_clock::time_point time) const noexcept
+      -> std::uint64_t {
+    if (time <= _start) {
+      return 0;
     }
-
-    // 对 LEVEL >= 1 的时间轮，尝试降级
-    level_down_dispatch();
-  }
-
-  /// 编译期分发降级逻辑
-  void level_down_dispatch() {
-    auto idx = _root_wheel.index();
-    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-      (
-          [&] {
-            constexpr std::size_t LEVEL = Is;
-            constexpr std::size_t VARIANT_IDX = LEVEL + 1;
-            if constexpr (LEVEL >= 1 && LEVEL <= MAX_LEVEL) {
-              if (idx == VARIANT_IDX) {
-                auto &wheel_ptr = std::get<VARIANT_IDX>(_root_wheel);
-                if (!wheel_ptr) {
-                  return;
-                }
-                if (wheel_ptr->empty()) {
-                  wheel_ptr.reset();
-                  _root_wheel = std::monostate{};
-                } else if (wheel_ptr->can_level_down()) {
-                  auto child = wheel_ptr->level_down();
-                  if (child) {
-                    _root_wheel = std::move(child);
-                    // 递归检查是否可以继续降级
-                    try_level_down();
-                  }
-                }
-              }
-            }
-          }(),
-          ...);
-    }(std::make_index_sequence<MAX_LEVEL + 1>{});
+    return static_cast<std::uint64_t>((time - _start) / _tick);
   }
 
-  /// 推进时间基准
-  /// 旋转根时间轮以匹配新的起始时间
-  void advance_start(std::size_t ms) {
-    _start += std::chrono::milliseconds(ms);
-
-    // 旋转根时间轮
-    std::visit(
-        [&](auto &wheel_ptr) {
-          using T = std::decay_t<decltype(wheel_ptr)>;
-          if constexpr (!std::is_same_v<T, std::monostate>) {
-            if (wheel_ptr) {
-              using WheelType = std::remove_reference_t<decltype(*wheel_ptr)>;
-              // 对于 level-0 轮直接旋转
-              if constexpr (std::is_same_v<WheelType, TimerWheel<0uz>>) {
-                wheel_ptr->rotate(ms);
-              } else {
-                // 对于高层级轮，计算需要旋转的槽位数（移位代替除法）
-                auto slots_to_rotate = ms >> WheelType::CHILD_SHIFT;
-                if (slots_to_rotate > 0) {
-                  wheel_ptr->rotate(slots_to_rotate);
-                }
-              }
-            }
-          }
-        },
-        _root_wheel);
-  }
-
-  /// 计算自启动以来经过的毫秒数
+  /// 时间点对应的 tick，向上取整
   [[nodiscard]]
-  auto elapsed_ms() const noexcept -> std::size_t {
-    auto now = std::chrono::steady_clock::now();
-    auto duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(now - _start);
-    return static_cast<std::size_t>(duration.count());
-  }
-
-  /// 将 duration 转换为毫秒数
-  static auto to_ms(std::chrono::steady_clock::duration dur) noexcept
-      -> std::size_t {
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(dur);
-    return static_cast<std::size_t>(std::max(ms.count(), decltype(ms)::rep{0}));
+  auto to_tick_ceil(std::chrono::steady_clock::time_point time) const noexcept
+      -> std::uint64_t {
+    if (time <= _start) {
+      return 0;
+    }
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time - _start);
+    return static_cast<std::uint64_t>((elapsed + _tick - std::chrono::nanoseconds{1}) /
+                                      _tick);
   }
 
 private:
+  /// 时间轮的基本 tick
+  std::chrono::nanoseconds _tick;
   /// 定时器启动的基准时间
   std::chrono::steady_clock::time_point _start{
       std::chrono::steady_clock::now()};
-  /// 当前活跃的定时器任务数
-  std::size_t _num_entries{0};
-  /// 根时间轮（variant 存储，支持不同层级）
-  VariantWheelBuilder<MAX_LEVEL + 1uz>::Type _root_wheel{};
+  /// 时间轮
+  TimerWheel _wheel{};
+  /// 其他 worker 发来的改期请求
+  std::mutex _inbox_mutex;
+  std::vector<TimerReschedule *> _inbox;
+  std::atomic<bool> _inbox_pending{false};
+  /// 所属 worker 的唤醒器
+  io::detail::Waker *_waker{nullptr};
 };
 
 } // namespace faio::runtime::detail::timer
@@ -6,6 +6,8 @@
 #include "faio/detail/runtime/core/queue.hpp"
 #include "faio/detail/runtime/core/shared.hpp"
 #include "fastlog/fastlog.hpp"
+#include <algorithm>
+#include <chrono>
 #include <coroutine>
 #include <cstddef>
 #include <cstdint>
@@ -22,7 +24,14 @@ class Worker {
 
 public:
   Worker(Shared *shared, std::size_t worker_id)
-      : _shared(shared), _worker_id(worker_id), _io_engine{shared->_config} {
+      : _shared(shared), _worker_id(worker_id),
+        _io_engine{shared->_config, shared->_io_metrics[worker_id], worker_id,
+                   shared->attach_iowq_fd(worker_id),
+                   {shared->_cancel_mailboxes.get(), shared->_config._num_workers},
+                   &shared->_fd_rings} {
+    if (worker_id == 0) {
+      _shared->publish_iowq_fd(_io_engine.ring_fd());
+    }
     _shared->register_worker(this, worker_id);
     current_worker = this;
     current_shared = std::addressof(*shared);
@@ -37,7 +46,8 @@ public:
   // worker运行的主函数
   // 逻辑：
   // 1.更新时间戳 2.周期性执行任务，更新线程关闭标志，驱动IO引擎处理IO 3.获取下一个任务
-  // 4.窃取任务 5.处理IO 6.休眠
+  // 4.窃取任务 5.处理IO 6.自旋 7.休眠
+  // 执行完任务的一轮结束时提交这一轮积累的sqe，忙碌的 worker 不必等到下一次 drive
   void run() {
     while (!_is_shutdown) {
       // 更新时间戳
@@ -47,17 +57,23 @@ public:
       // 获取下一个任务
       if (auto task = get_next_task(); task) {
         excute(std::move(task.value()));
+        _io_engine.flush();
         continue;
       }
       // 窃取任务
       if (auto task = task_steal(); task) {
         excute(std::move(task.value()));
+        _io_engine.flush();
         continue;
       }
       // 处理IO
       if (drive_io()) {
         continue;
       }
+      // 自旋
+      if (spin()) {
+        continue;
+      }
       // 休眠
       sleep();
     }
@@ -103,6 +119,33 @@ private:
     }
     return true;
   }
+  // 自旋
+  // 没有任务时先在自旋窗口内反复驱动IO，新任务到来时不必经历休眠和唤醒；
+  // 注册了 NAPI 时每轮在内核中忙轮询网卡队列。返回自旋期间是否有了新任务
+  bool spin() {
+    const std::chrono::microseconds window{_shared->_config._spin_window_us};
+    if (window.count() == 0) {
+      return false;
+    }
+    const std::chrono::microseconds poll{_shared->_config._napi_busy_poll_us};
+    const auto deadline = std::chrono::steady_clock::now() + window;
+    for (auto now = std::chrono::steady_clock::now(); now < deadline;
+         now = std::chrono::steady_clock::now()) {
+      auto remaining =
+          std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+      if (_io_engine.poll_and_drive(_local_queue, _shared->_global_queue,
+                                    std::min(remaining, poll)) &&
+          should_notify()) {
+        _shared->wake_up_one();
+      }
+      update_shutdown_flag();
+      if (_is_shutdown || has_task() || !_shared->_global_queue.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   // 休眠
   // 逻辑：
   // 1.更新线程关闭标志 2.设置休眠状态 3.等待IO引擎处理IO 4.更新线程关闭标志
@@ -1,7 +1,11 @@
 #ifndef FAIO_DETAIL_SYNC_HPP
 #define FAIO_DETAIL_SYNC_HPP
+#include "faio/detail/sync/broadcast.hpp"
 #include "faio/detail/sync/channel.hpp"
 #include "faio/detail/sync/condition_variable.hpp"
 #include "faio/detail/sync/mutex.hpp"
+#include "faio/detail/sync/oneshot.hpp"
+#include "faio/detail/sync/semaphore.hpp"
+#include "faio/detail/sync/shared_mutex.hpp"
 
 #endif // FAIO_DETAIL_SYNC_HPP
@@ -0,0 +1,335 @@
+#ifndef FAIO_DETAIL_SYNC_BROADCAST_HPP
+#define FAIO_DETAIL_SYNC_BROADCAST_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/runtime/core/poller.hpp"
+#include "faio/detail/sync/wait_cancel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace faio::sync {
+namespace detail {
+
+// 广播通道的共享状态：固定大小的环形缓冲区，每个值发给所有接收者
+//
+// _tail 是已经发送的值的总数，第 n 个值放在槽位 n & _mask；每个接收者记录自己下一个要读的序号。
+// 发送总是成功并覆盖最旧的值，不会因为慢的接收者挂起；接收者落后超过容量时，
+// 被覆盖的值已经丢失，recv 返回一次 Lagged 并跳到最旧的可读值。
+// 发送用于配置更新、缓存失效这类低频事件，缓冲区和等待链表用一把 std::mutex 保护；
+// 接收者没有新值时只读一次原子的 _tail，不加锁。
+// 在 time::timeout 中等到截止时间时，接收者持锁摘出等待链表，以 ECANCELED 返回（见 WaitCancel）
+template <typename T> class BroadcastState {
+public:
+  // 等待链表的节点，嵌入在接收者的 awaiter 中
+  struct Waiter : WaitCancel {
+    Waiter *_next{nullptr};
+  };
+
+  BroadcastState(std::size_t cap, std::size_t num_senders)
+      : _mask{std::bit_ceil(std::max<std::size_t>(cap, 1)) - 1}, _slots(_mask + 1),
+        _num_senders{num_senders} {}
+
+public:
+  // 发送一个值，没有接收者时返回 ClosedChannel
+  auto send(T &&value) -> expected<void> {
+    Waiter *waiters = nullptr;
+    {
+      std::lock_guard lock{_mutex};
+      if (_num_receivers == 0) {
+        return std::unexpected{make_error(Error::ClosedChannel)};
+      }
+      auto tail = _tail.load(std::memory_order::relaxed);
+      _slots[tail & _mask] = std::move(value);
+      _tail.store(tail + 1, std::memory_order::release);
+      waiters = std::exchange(_waiters, nullptr);
+    }
+    wake(waiters);
+    return {};
+  }
+
+  // 读取序号 pos 的值，成功后 pos 前进；没有新值返回 EmptyChannel，
+  // 所有发送者都已销毁且没有新值返回 ClosedChannel
+  auto read(std::uint64_t &pos) -> expected<T> {
+    std::lock_guard lock{_mutex};
+    return read_locked(pos);
+  }
+
+  // 是否有新值或者已经关闭，不加锁
+  [[nodiscard]]
+  auto ready(std::uint64_t pos) const noexcept -> bool {
+    return _tail.load(std::memory_order::acquire) != pos ||
+           _closed.load(std::memory_order::acquire);
+  }
+
+  // 返回是否挂起；不挂起时 result 为读取结果
+  auto wait(Waiter *waiter, std::uint64_t &pos, std::optional<expected<T>> &result) -> bool {
+    std::lock_guard lock{_mutex};
+    auto res = read_locked(pos);
+    if (res || res.error().value() != Error::EmptyChannel) {
+      result.emplace(std::move(res));
+      return false;
+    }
+    waiter->_next = _waiters;
+    _waiters = waiter;
+    return true;
+  }
+
+  // 令牌到期：接收者还在等待链表中时摘除，发送者已经取走链表时返回 false
+  auto cancel(Waiter *waiter) -> bool {
+    std::lock_guard lock{_mutex};
+    for (auto link = &_waiters; *link != nullptr; link = &(*link)->_next) {
+      if (*link == waiter) {
+        *link = waiter->_next;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 新的接收者从下一个发送的值开始
+  auto subscribe() -> std::uint64_t {
+    std::lock_guard lock{_mutex};
+    ++_num_receivers;
+    return _tail.load(std::memory_order::relaxed);
+  }
+
+  void add_receiver() {
+    std::lock_guard lock{_mutex};
+    ++_num_receivers;
+  }
+
+  void sub_receiver() {
+    std::lock_guard lock{_mutex};
+    --_num_receivers;
+  }
+
+  void add_sender() { _num_senders.fetch_add(1, std::memory_order::relaxed); }
+
+  // 最后一个发送者销毁时关闭通道，唤醒所有等待的接收者
+  void sub_sender() {
+    if (_num_senders.fetch_sub(1, std::memory_order::acq_rel) != 1) {
+      return;
+    }
+    Waiter *waiters = nullptr;
+    {
+      std::lock_guard lock{_mutex};
+      _closed.store(true, std::memory_order::release);
+      waiters = std::exchange(_waiters, nullptr);
+    }
+    wake(waiters);
+  }
+
+  [[nodiscard]]
+  auto capacity() const noexcept -> std::size_t {
+    return _mask + 1;
+  }
+
+private:
+  auto read_locked(std::uint64_t &pos) -> expected<T> {
+    auto tail = _tail.load(std::memory_order::relaxed);
+    if (tail - pos > _mask + 1) {
+      // 落后超过容量，跳到最旧的可读值
+      pos = tail - (_mask + 1);
+      return std::unexpected{make_error(Error::Lagged)};
+    }
+    if (pos != tail) {
+      expected<T> value{*_slots[pos & _mask]};
+      ++pos;
+      return value;
+    }
+    if (_closed.load(std::memory_order::relaxed)) {
+      return std::unexpected{make_error(Error::ClosedChannel)};
+    }
+    return std::unexpected{make_error(Error::EmptyChannel)};
+  }
+
+  // 解锁之后再唤醒，恢复之后节点随时可能被销毁，先取出后继
+  static void wake(Waiter *waiters) {
+    while (waiters != nullptr) {
+      auto next = waiters->_next;
+      waiters->resume();
+      waiters = next;
+    }
+  }
+
+private:
+  const std::size_t _mask;
+  std::vector<std::optional<T>> _slots;   // 环形缓冲区
+  std::atomic<std::uint64_t> _tail{0};    // 已经发送的值的总数
+  std::atomic<bool> _closed{false};       // 所有发送者都已销毁
+  std::atomic<std::size_t> _num_senders;  // 发送者数量
+  std::size_t _num_receivers{0};          // 接收者数量，持锁修改
+  Waiter *_waiters{nullptr};              // 等待新值的接收者
+  std::mutex _mutex;                      // 保护缓冲区、接收者数量和等待链表
+};
+
+} // namespace detail
+
+// 广播通道：每个值发给所有接收者，用于把配置更新、缓存失效分发到每个连接。
+// 发送不会挂起，缓冲区满时覆盖最旧的值；落后超过容量的接收者得到一次 Lagged，
+// 之后从最旧的可读值继续。T 需要可拷贝，每个接收者拿到一份拷贝
+template <typename T>
+  requires std::copy_constructible<T>
+class broadcast {
+  using State = detail::BroadcastState<T>;
+
+public:
+  class Receiver;
+
+  class Sender {
+  public:
+    explicit Sender(std::shared_ptr<State> state) : _state{std::move(state)} {}
+
+    Sender(const Sender &other) : _state{other._state} { _state->add_sender(); }
+    auto operator=(const Sender &other) -> Sender & {
+      if (this != &other) {
+        close();
+        _state = other._state;
+        _state->add_sender();
+      }
+      return *this;
+    }
+    Sender(Sender &&) noexcept = default;
+    auto operator=(Sender &&other) noexcept -> Sender & {
+      close();
+      _state = std::move(other._state);
+      return *this;
+    }
+    ~Sender() { close(); }
+
+    // 发送给当前所有接收者，没有接收者时返回 ClosedChannel
+    auto send(T value) -> expected<void> { return _state->send(std::move(value)); }
+
+    // 新建一个接收者，只会收到之后发送的值
+    [[nodiscard]]
+    auto subscribe() -> Receiver {
+      return Receiver{_state, _state->subscribe()};
+    }
+
+    void close() {
+      if (_state) {
+        _state->sub_sender();
+        _state.reset();
+      }
+    }
+
+  private:
+    std::shared_ptr<State> _state;
+  };
+
+  class Receiver {
+    friend Sender;
+    friend broadcast;
+
+    class Awaiter : State::Waiter {
+    public:
+      explicit Awaiter(Receiver &receiver) : _receiver{receiver} {}
+
+      // 快路径：没有新值时只读一次原子变量
+      auto await_ready() -> bool {
+        if (!_receiver._state->ready(_receiver._pos)) {
+          return false;
+        }
+        _result.emplace(_receiver._state->read(_receiver._pos));
+        return true;
+      }
+
+      template <typename Promise>
+      auto await_suspend(std::coroutine_handle<Promise> handle) -> bool {
+        // 令牌已经到期，不再等待
+        if (!this->prepare(handle)) {
+          return false;
+        }
+        if (!_receiver._state->wait(this, _receiver._pos, _result)) {
+          this->disarm();
+          return false;
+        }
+        return true;
+      }
+
+      // 令牌到期时返回 ECANCELED，位置不变，之后的 recv 不会漏掉值
+      auto await_resume() -> expected<T> {
+        if (this->cancelled()) [[unlikely]] {
+          return std::unexpected{make_error(ECANCELED)};
+        }
+        if (_result) {
+          return std::move(*_result);
+        }
+        return _receiver._state->read(_receiver._pos);
+      }
+
+    private:
+      auto cancel() noexcept -> bool override { return _receiver._state->cancel(this); }
+
+    private:
+      Receiver &_receiver;
+      std::optional<expected<T>> _result{};
+    };
+
+    Receiver(std::shared_ptr<State> state, std::uint64_t pos)
+        : _state{std::move(state)}, _pos{pos} {}
+
+  public:
+    // 拷贝出的接收者从同一个位置开始
+    Receiver(const Receiver &other) : _state{other._state}, _pos{other._pos} {
+      _state->add_receiver();
+    }
+    auto operator=(const Receiver &other) -> Receiver & {
+      if (this != &other) {
+        close();
+        _state = other._state;
+        _pos = other._pos;
+        _state->add_receiver();
+      }
+      return *this;
+    }
+    Receiver(Receiver &&) noexcept = default;
+    auto operator=(Receiver &&other) noexcept -> Receiver & {
+      close();
+      _state = std::move(other._state);
+      _pos = other._pos;
+      return *this;
+    }
+    ~Receiver() { close(); }
+
+    // 接收下一个值：落后超过容量返回 Lagged，所有发送者销毁且没有新值返回 ClosedChannel
+    auto recv() -> Awaiter { return Awaiter{*this}; }
+
+    // 尝试接收，不挂起：没有新值返回 EmptyChannel
+    auto try_recv() -> expected<T> { return _state->read(_pos); }
+
+    void close() {
+      if (_state) {
+        _state->sub_receiver();
+        _state.reset();
+      }
+    }
+
+  private:
+    std::shared_ptr<State> _state;
+    std::uint64_t _pos;
+  };
+
+public:
+  // 创建一个广播通道，返回一个 Sender 和一个 Receiver；更多接收者通过 Sender::subscribe 创建
+  [[nodiscard]]
+  static auto make(std::size_t cap) -> std::pair<Sender, Receiver> {
+    auto state = std::make_shared<State>(cap, 1);
+    auto pos = state->subscribe();
+    return std::make_pair(Sender{state}, Receiver{state, pos});
+  }
+};
+
+} // namespace faio::sync
+
+#endif // FAIO_DETAIL_SYNC_BROADCAST_HPP
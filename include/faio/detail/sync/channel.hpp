@@ -4,13 +4,22 @@
 #include "faio/detail/sync/channel/channel.hpp"
 #include "faio/detail/sync/channel/receiver.hpp"
 #include "faio/detail/sync/channel/sender.hpp"
+#include "faio/detail/sync/channel/spsc_ring_buffer.hpp"
 namespace faio::sync {
 template <typename T> class channel {
   using ChannelImpl = detail::Channel<T>;
+  using MpscChannelImpl = detail::Channel<T, detail::MpscRingBuffer<T>>;
+  using SpscChannelImpl = detail::Channel<T, detail::SpscRingBuffer<T>>;
 
 public:
   using Sender = detail::Sender<ChannelImpl>;
   using Receiver = detail::Receiver<ChannelImpl>;
+  // 多生产者单消费者：Receiver 不能拷贝
+  using MpscSender = detail::Sender<MpscChannelImpl>;
+  using MpscReceiver = detail::Receiver<MpscChannelImpl>;
+  // 单生产者单消费者：Sender 和 Receiver 都不能拷贝
+  using SpscSender = detail::Sender<SpscChannelImpl>;
+  using SpscReceiver = detail::Receiver<SpscChannelImpl>;
 
 public:
   // 创建一个通道，并返回一个Sender和Receiver
@@ -19,6 +28,22 @@ public:
     auto counter = std::make_shared<ChannelImpl>(1, 1, max_cap);
     return std::make_pair(Sender{counter}, Receiver{counter});
   }
+
+  // 创建多生产者单消费者通道，消费者出队不需要 CAS
+  [[nodiscard]]
+  static auto make_mpsc(std::size_t max_cap)
+      -> std::pair<MpscSender, MpscReceiver> {
+    auto counter = std::make_shared<MpscChannelImpl>(1, 1, max_cap);
+    return std::make_pair(MpscSender{counter}, MpscReceiver{counter});
+  }
+
+  // 创建单生产者单消费者通道，入队、出队都不需要 CAS
+  [[nodiscard]]
+  static auto make_spsc(std::size_t max_cap)
+      -> std::pair<SpscSender, SpscReceiver> {
+    auto counter = std::make_shared<SpscChannelImpl>(1, 1, max_cap);
+    return std::make_pair(SpscSender{counter}, SpscReceiver{counter});
+  }
 };
 } // namespace faio::sync
 #endif // FAIO_DETAIL_SYNC_CHANNEL_HPP
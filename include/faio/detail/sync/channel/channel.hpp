@@ -2,158 +2,240 @@
 #define FAIO_DETAIL_SYNC__CHANNEL_CHANNEL_HPP
 
 #include "faio/detail/common/error.hpp"
-#include "faio/detail/coroutine/task.hpp"
 #include "faio/detail/runtime/core/poller.hpp"
 #include "faio/detail/sync/channel/ring_buffer.hpp"
-#include "faio/detail/sync/mutex.hpp"
+#include "faio/detail/sync/wait_cancel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <concepts>
+#include <coroutine>
+#include <mutex>
 namespace faio::sync::detail {
 
-// Channel类：实现有界多生产者多消费者通道，内部使用环形缓冲区实现
-// Channel类通信的本质 ：
-// 1.sender和receiver通过缓冲区和recviver的_result进行通信
-
-// sender和receiver的两种时序 不同的通信过程：
-/*
-1.sender先被调度
-三种发送数据的操作：
-  //（1）将当前值放入对应接收者_result里，恢复receiver拿数据 ->
-条件是已经有等待接受数据的receiver
-  //（2）放入缓冲区 -> 条件是缓冲区没满
-  // (3）什么都不做,只是把自己放入等待发送队列 -> 条件是缓冲区满了且通道未关闭
-
-2.receiver先被调度
-  //（1）将当前值从sender的_value中取走，恢复sender拿数据 ->
-条件是已经有等待发送数据的sender
-  //（2）从缓冲区中取出值 -> 条件是缓冲区不为空
-  // (3）什么都不做,只是把自己放入等待接收队列 -> 条件是缓冲区为空且通道未关闭
-*/
-
-template <typename T> class Channel {
-  // 发送Awaiter
-  struct SendAwaiter {
-    SendAwaiter(Channel &channel, T &value)
-        : _channel{channel}, _value{value} {}
-
-    // 总是挂起
-    auto await_ready() const noexcept -> bool { return false; }
-
-    auto await_suspend(std::coroutine_handle<> handle) -> bool {
-      std::lock_guard lock(_channel._mutex, std::adopt_lock);
-      _handle = handle;
-      // 如果已经有等待着接受数据的receiver，则直接将当前值放入对应接收者的结果中，并恢复其协程
-      if (!_channel._waiting_receivers.empty()) {
-        auto receiver = _channel._waiting_receivers.front();
-        _channel._waiting_receivers.pop_front();
-        receiver->_result = std::move(_value);
-        runtime::detail::push_task_to_local_queue(receiver->_handle);
-        // 设置当前结果为成功
-        _result.emplace();
-        // 返回false，表示不挂起
-        return false;
+// Channel类：实现有界多生产者多消费者通道
+//
+// 快路径只操作无锁环形缓冲区：缓冲区不满时 send、不空时 recv 在 await_ready 中直接完成，
+// 不挂起，也不创建协程帧；try_send / try_recv 是同样的快路径，永远不挂起。
+//
+// 慢路径（缓冲区满或空）才加锁，把 awaiter 自身作为节点挂入等待链表（不分配内存）：
+//   1. 持锁把 _num_waiting 加一，再重新尝试一次；仍然失败才挂入链表并挂起
+//   2. 对方每次成功操作缓冲区后检查 _num_waiting，不为零才加锁，
+//      把缓冲区中的值交给等待的接收者、把等待的发送者的值放入缓冲区，并恢复它们
+// 两边在“修改自己的状态”和“检查对方的状态”之间都有 seq_cst 屏障，
+// 等待者重试失败时，对方一定能看到等待计数，不会丢失唤醒；没有等待者时不碰锁
+//
+// Queue 在编译期选择缓冲区：RingBuffer（多生产者多消费者）、MpscRingBuffer（单消费者）、
+// SpscRingBuffer（单生产者单消费者）。单消费者时，消费者每取出一批才检查一次等待的发送者，
+// 取空时一定检查，避免缓冲区满时每取出一个就加锁唤醒一个发送者
+//
+// 在 time::timeout 中等到截止时间时，等待者持锁摘出等待链表，以 ECANCELED 返回（见 WaitCancel）；
+// 发送者的值没有写入，留在 awaiter 中随之销毁
+//
+// T 的移动构造可以抛出异常：try_send / try_recv 把异常传给调用者，缓冲区保持可用
+// （见 RingBuffer）。co_await 的 send / recv 和等待者之间的交接是 noexcept 的，
+// 其中抛出异常时终止程序，与原来的实现相同
+template <typename T, typename Queue = RingBuffer<T>> class Channel {
+  // 等待链表的节点，嵌入在 awaiter 中
+  struct Waiter : WaitCancel {
+    Waiter *_next{nullptr};
+  };
+
+  // 先进先出的侵入式单链表
+  template <typename W> class WaiterList {
+  public:
+    [[nodiscard]] auto empty() const noexcept -> bool { return _head == nullptr; }
+
+    void push_back(W *waiter) noexcept {
+      waiter->_next = nullptr;
+      if (_tail == nullptr) {
+        _head = waiter;
+      } else {
+        _tail->_next = waiter;
+      }
+      _tail = waiter;
+    }
+
+    auto front() const noexcept -> W * { return _head; }
+
+    void pop_front() noexcept {
+      _head = static_cast<W *>(_head->_next);
+      if (_head == nullptr) {
+        _tail = nullptr;
       }
-      // 如果环形缓冲区已满，则返回true，表示挂起
-      if (_channel._buffer.is_fill()) {
-        // 如果通道已关闭，则返回false，表示不挂起
-        if (_channel._is_closed.load(std::memory_order::acquire)) {
-          return false;
+    }
+
+    // 摘除中间的节点，不在链表中时返回 false；只在令牌到期时调用
+    auto remove(W *waiter) noexcept -> bool {
+      W *prev = nullptr;
+      for (auto node = _head; node != nullptr;
+           prev = node, node = static_cast<W *>(node->_next)) {
+        if (node != waiter) {
+          continue;
+        }
+        if (prev == nullptr) {
+          _head = static_cast<W *>(node->_next);
+        } else {
+          prev->_next = node->_next;
+        }
+        if (_tail == node) {
+          _tail = prev;
         }
-        // 如果缓冲区满了
-        // 且通道未关闭，则将当前发送者加入等待发送者队列，等待receiver取走数据
-        _channel._waiting_senders.push_back(this);
-        // 返回true，表示挂起
         return true;
-      } else {
-        // 将当前值放入环形缓冲区
-        _channel._buffer.safety_push(std::move(_value));
-        // 设置当前结果为成功
+      }
+      return false;
+    }
+
+  private:
+    W *_head{nullptr};
+    W *_tail{nullptr};
+  };
+
+  // 发送Awaiter：持有要发送的值，缓冲区满时挂起
+  struct SendAwaiter : Waiter {
+    SendAwaiter(Channel &channel, T &&value)
+        : _channel{channel}, _value{std::move(value)} {}
+
+    // 快路径：缓冲区不满时直接写入，不挂起；写入失败时 _value 保持不变
+    auto await_ready() noexcept -> bool {
+      if (_channel.push(std::move(_value))) {
         _result.emplace();
+        return true;
+      }
+      return _channel.closed();
+    }
+
+    // 慢路径：持锁重试，仍然满才挂入等待链表
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+      // 令牌已经到期，不再等待
+      if (!this->prepare(handle)) {
+        return false;
+      }
+      if (!_channel.wait_send(this)) {
+        this->disarm();
         return false;
       }
+      return true;
+    }
+
+    // 恢复逻辑：返回结果，令牌到期时为 ECANCELED
+    auto await_resume() const noexcept -> expected<void> {
+      if (this->cancelled()) [[unlikely]] {
+        return std::unexpected{make_error(ECANCELED)};
+      }
+      return _result;
+    }
+
+    auto cancel() noexcept -> bool override {
+      return _channel.cancel(_channel._waiting_senders, this);
     }
-    // 恢复逻辑：返回结果
-    auto await_resume() const noexcept { return _result; }
 
-  public:
     Channel &_channel;
-    T &_value;
-    expected<void> _result{std::unexpected{make_error(
-        Error::ClosedChannel)}}; // 是不是成功发送了，或者是不是成功被接收了
-    std::coroutine_handle<> _handle;
+    T _value;
+    expected<void> _result{std::unexpected{make_error(Error::ClosedChannel)}};
   };
 
-  // 接受Awaiter
-  struct RecvAwaiter {
-    RecvAwaiter(Channel &channel) : _channel{channel} {}
-
-    auto await_ready() const noexcept -> bool { return false; }
-
-    // 挂起逻辑：
-    //  如果等待发送者队列不为空，则取出一个发送者，将其结果设置为当前值，并恢复其协程
-    //  如果环形缓冲区为空，则返回true，表示挂起
-    //  如果环形缓冲区不为空，则将当前值移动到环形缓冲区中，并恢复当前协程
-    //  如果通道已关闭，则返回false，表示不挂起
-    auto await_suspend(std::coroutine_handle<> handle) -> bool {
-      std::lock_guard lock(_channel._mutex, std::adopt_lock);
-      _handle = handle;
-      if (!_channel._waiting_senders.empty()) {
-        auto sender = _channel._waiting_senders.front();
-        _channel._waiting_senders.pop_front();
-        // 设置sender的结果为成功
-        sender->_result.emplace();
-        // 将当前值从sender的_value中取走，恢复sender
-        _result.emplace(std::move(sender->_value));
-        runtime::detail::push_task_to_local_queue(sender->_handle);
+  // 接受Awaiter：缓冲区空时挂起，等待发送者交来的值
+  struct RecvAwaiter : Waiter {
+    explicit RecvAwaiter(Channel &channel) : _channel{channel} {}
+
+    // 快路径：缓冲区不空时直接取出，不挂起
+    auto await_ready() noexcept -> bool {
+      if (auto value = _channel.pop(); value) {
+        _result = std::move(*value);
+        return true;
+      }
+      return false;
+    }
+
+    // 慢路径：持锁重试，仍然空且未关闭才挂入等待链表
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+      // 令牌已经到期，不再等待
+      if (!this->prepare(handle)) {
         return false;
       }
-      // 如果环形缓冲区为空，则返回true，表示挂起
-      if (_channel._buffer.is_empty()) {
-        // 如果通道已关闭，则返回false，表示不挂起
-        if (_channel._is_closed.load(std::memory_order::acquire)) {
-          return false;
-        }
-        // 将当前接收者加入等待接收者队列
-        _channel._waiting_receivers.push_back(this);
-        return true;
-      } else {
-        // 从环形缓冲区中取出值
-        _result.emplace(_channel._buffer.safety_pop());
-        // 设置当前结果为成功
+      if (!_channel.wait_recv(this)) {
+        this->disarm();
         return false;
       }
+      return true;
     }
 
-    // 恢复逻辑：返回结果
-    auto await_resume() noexcept -> expected<T> { return std::move(_result); }
+    // 恢复逻辑：返回结果，令牌到期时为 ECANCELED
+    auto await_resume() noexcept -> expected<T> {
+      if (this->cancelled()) [[unlikely]] {
+        return std::unexpected{make_error(ECANCELED)};
+      }
+      return std::move(_result);
+    }
 
-  public:
-    Channel &_channel; // 通道
-    expected<T> _result{
-        std::unexpected{make_error(Error::ClosedChannel)}}; // 存放接收到的值
-    std::coroutine_handle<> _handle;                        // 协程句柄
+    auto cancel() noexcept -> bool override {
+      return _channel.cancel(_channel._waiting_receivers, this);
+    }
+
+    Channel &_channel;
+    expected<T> _result{std::unexpected{make_error(Error::ClosedChannel)}};
   };
 
 public:
   // 值类型萃取，方便外部使用
   using ValueType = T;
 
+  // 是否允许多个发送者/接收者，决定 Sender/Receiver 能否拷贝
+  static constexpr bool multi_producer = Queue::multi_producer;
+  static constexpr bool multi_consumer = Queue::multi_consumer;
+
   Channel(std::size_t num_senders, std::size_t num_receivers, std::size_t cap)
-      : _num_senders{num_senders}, _num_receivers{num_receivers}, _buffer{cap} {
-  }
+      : _num_senders{num_senders}, _num_receivers{num_receivers}, _buffer{cap},
+        _notify_batch{std::max<std::size_t>(_buffer.capacity() / 4, 1)} {}
 
 public:
-  // 发送数据,是一个协程
-  auto send(T value) -> task<expected<void>> {
-    // 加锁
-    co_await _mutex.lock();
-    auto res = co_await SendAwaiter{*this, value};
-    co_return res;
+  // 发送数据，返回 awaiter，缓冲区不满时不挂起
+  auto send(T value) -> SendAwaiter { return SendAwaiter{*this, std::move(value)}; }
+
+  // 接收数据，返回 awaiter，缓冲区不空时不挂起
+  auto recv() -> RecvAwaiter { return RecvAwaiter{*this}; }
+
+  // 尝试发送，不挂起：缓冲区满返回 FullChannel，通道关闭返回 ClosedChannel；
+  // 失败时 value 保持不变
+  template <typename U>
+    requires std::constructible_from<T, U &&>
+  auto try_send(U &&value) -> expected<void> {
+    if (closed()) {
+      return std::unexpected{make_error(Error::ClosedChannel)};
+    }
+    if (!push(std::forward<U>(value))) {
+      return std::unexpected{make_error(Error::FullChannel)};
+    }
+    return {};
+  }
+
+  // 尝试接收，不挂起：缓冲区空返回 EmptyChannel，通道关闭且没有剩余数据返回 ClosedChannel
+  auto try_recv() -> expected<T> {
+    if (auto value = pop(); value) {
+      return std::move(*value);
+    }
+    if (closed()) {
+      // 关闭之前写入的值仍然可以取出
+      if (auto value = pop(); value) {
+        return std::move(*value);
+      }
+      return std::unexpected{make_error(Error::ClosedChannel)};
+    }
+    return std::unexpected{make_error(Error::EmptyChannel)};
+  }
+
+  // 缓冲区容量（向上取整到 2 的幂）
+  [[nodiscard]]
+  auto capacity() const noexcept -> std::size_t {
+    return _buffer.capacity();
   }
 
-  // 接收数据,是一个协程
-  auto recv() -> task<expected<T>> {
-    co_await _mutex.lock();
-    auto res = co_await RecvAwaiter{*this};
-    co_return res;
+  [[nodiscard]]
+  auto closed() const noexcept -> bool {
+    return _is_closed.load(std::memory_order::acquire);
   }
 
   void add_sender() { _num_senders.fetch_add(1, std::memory_order::relaxed); }
@@ -175,32 +257,157 @@ public:
   }
 
 private:
+  // 写入缓冲区，成功后只在有等待者时才去唤醒
+  template <typename U> auto push(U &&value) -> bool {
+    if (!_buffer.try_push(std::forward<U>(value))) {
+      return false;
+    }
+    notify();
+    return true;
+  }
+
+  // 从缓冲区取出，成功后只在有等待者时才去唤醒
+  auto pop() -> std::optional<T> {
+    auto value = _buffer.try_pop();
+    if constexpr (multi_consumer) {
+      if (value) {
+        notify();
+      }
+    } else {
+      // 等待的只可能是发送者：攒够一批或取空时才检查
+      if (!value || ++_pops_since_notify >= _notify_batch) {
+        _pops_since_notify = 0;
+        notify();
+      }
+    }
+    return value;
+  }
+
+  void notify() {
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    if (_num_waiting.load(std::memory_order::relaxed) != 0) [[unlikely]] {
+      std::lock_guard lock{_waiters_mutex};
+      transfer();
+    }
+  }
+
+  // 返回是否挂起
+  auto wait_send(SendAwaiter *sender) noexcept -> bool {
+    std::unique_lock lock{_waiters_mutex};
+    _num_waiting.fetch_add(1, std::memory_order::seq_cst);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    if (!closed() && !_buffer.try_push(std::move(sender->_value))) {
+      _waiting_senders.push_back(sender);
+      return true;
+    }
+    _num_waiting.fetch_sub(1, std::memory_order::relaxed);
+    if (!closed()) {
+      sender->_result.emplace();
+      // 刚写入的值可能正有接收者在等
+      transfer();
+    }
+    return false;
+  }
+
+  // 返回是否挂起
+  auto wait_recv(RecvAwaiter *receiver) noexcept -> bool {
+    std::unique_lock lock{_waiters_mutex};
+    _num_waiting.fetch_add(1, std::memory_order::seq_cst);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    if (auto value = _buffer.try_pop(); value) {
+      _num_waiting.fetch_sub(1, std::memory_order::relaxed);
+      receiver->_result = std::move(*value);
+      // 刚腾出的位置可能正有发送者在等
+      transfer();
+      return false;
+    }
+    if (closed()) {
+      _num_waiting.fetch_sub(1, std::memory_order::relaxed);
+      return false;
+    }
+    _waiting_receivers.push_back(receiver);
+    return true;
+  }
+
+  // 持锁调用：把缓冲区的值交给等待的接收者，把等待的发送者的值放入缓冲区，直到没有进展
+  void transfer() noexcept {
+    bool progress = true;
+    while (progress) {
+      progress = false;
+      while (!_waiting_receivers.empty()) {
+        auto value = _buffer.try_pop();
+        if (!value) {
+          break;
+        }
+        auto receiver = _waiting_receivers.front();
+        _waiting_receivers.pop_front();
+        receiver->_result = std::move(*value);
+        wake(receiver);
+        progress = true;
+      }
+      while (!_waiting_senders.empty()) {
+        auto sender = _waiting_senders.front();
+        if (!_buffer.try_push(std::move(sender->_value))) {
+          break;
+        }
+        _waiting_senders.pop_front();
+        sender->_result.emplace();
+        wake(sender);
+        progress = true;
+      }
+    }
+  }
+
+  // 持锁调用，恢复之后 waiter 随时可能被销毁，不再访问
+  void wake(Waiter *waiter) {
+    _num_waiting.fetch_sub(1, std::memory_order::relaxed);
+    waiter->resume();
+  }
+
+  // 令牌到期：等待者还在链表中时摘除，已经被唤醒时返回 false
+  template <typename W> auto cancel(WaiterList<W> &waiters, W *waiter) -> bool {
+    std::lock_guard lock{_waiters_mutex};
+    if (!waiters.remove(waiter)) {
+      return false;
+    }
+    _num_waiting.fetch_sub(1, std::memory_order::relaxed);
+    return true;
+  }
+
   // 销毁通道
   void destroy() {
+    std::lock_guard lock{_waiters_mutex};
     if (_is_closed.exchange(true, std::memory_order::acq_rel) == false) {
-      // 唤醒所有等待发送者
-      for (auto sender : _waiting_senders) {
-        runtime::detail::push_task_to_local_queue(sender->_handle);
+      // 缓冲区里剩下的值先交给等待的接收者
+      transfer();
+      // 唤醒所有等待发送者，结果保持 ClosedChannel
+      while (!_waiting_senders.empty()) {
+        auto sender = _waiting_senders.front();
+        _waiting_senders.pop_front();
+        wake(sender);
       }
       // 唤醒所有等待接收者
-      for (auto receiver : _waiting_receivers) {
-        runtime::detail::push_task_to_local_queue(receiver->_handle);
+      while (!_waiting_receivers.empty()) {
+        auto receiver = _waiting_receivers.front();
+        _waiting_receivers.pop_front();
+        wake(receiver);
       }
-      // 清空等待发送者队列
-      _waiting_senders.clear();
     }
   }
 
 private:
-  std::atomic<std::size_t> _num_senders;         // 发送者数量
-  std::atomic<std::size_t> _num_receivers;       // 接收者数量
-  RingBuffer<T> _buffer;                         // 环形缓冲区
-  std::list<SendAwaiter *> _waiting_senders{};   // 等待发送者链
-  std::list<RecvAwaiter *> _waiting_receivers{}; // 等待接收者链
-  std::atomic<bool> _is_closed{false};           // 关闭标志
-  mutex _mutex{};                                // 互斥锁
+  std::atomic<std::size_t> _num_senders;        // 发送者数量
+  std::atomic<std::size_t> _num_receivers;      // 接收者数量
+  Queue _buffer;                                // 无锁环形缓冲区
+  std::atomic<std::size_t> _num_waiting{0};     // 等待中的发送者和接收者总数
+  std::mutex _waiters_mutex;                    // 只在慢路径上保护等待链表
+  WaiterList<SendAwaiter> _waiting_senders{};   // 等待发送者链
+  WaiterList<RecvAwaiter> _waiting_receivers{}; // 等待接收者链
+  std::atomic<bool> _is_closed{false};          // 关闭标志
+  const std::size_t _notify_batch;              // 单消费者时每批取出的数量
+  std::size_t _pops_since_notify{0};            // 单消费者时本批已取出的数量
 };
 
 } // namespace faio::sync::detail
 
-#endif // FAIO_DETAIL_SYNC__CHANNEL_CHANNEL_HPP
\ No newline at end of file
+#endif // FAIO_DETAIL_SYNC__CHANNEL_CHANNEL_HPP
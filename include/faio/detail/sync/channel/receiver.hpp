@@ -13,12 +13,17 @@ public:
 
   ~Receiver() { close(); }
 
-  Receiver(const Receiver &other) : _channel_ptr{other._channel_ptr} {
+  // 单消费者的通道不能拷贝接收端，只能移动
+  Receiver(const Receiver &other)
+    requires Channel::multi_consumer
+      : _channel_ptr{other._channel_ptr} {
     _channel_ptr->add_receiver();
   }
 
   // 拷贝构造函数
-  auto operator=(const Receiver &other) -> Receiver & {
+  auto operator=(const Receiver &other) -> Receiver &
+    requires Channel::multi_consumer
+  {
     // 先减去当前receiver的引用计数
     _channel_ptr->sub_receiver();
     // 然后赋值为other的channel
@@ -38,6 +43,9 @@ public:
 
   auto recv() { return _channel_ptr->recv(); }
 
+  // 尝试接收，不挂起
+  auto try_recv() { return _channel_ptr->try_recv(); }
+
   void close() {
     if (_channel_ptr) {
       _channel_ptr->sub_receiver();
@@ -1,104 +1,171 @@
 #ifndef FAIO_DETAIL_SYNC_CHANNEL_RING_BUFFER_HPP
 #define FAIO_DETAIL_SYNC_CHANNEL_RING_BUFFER_HPP
 
+#include "faio/detail/common/util/noncopyable.hpp"
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
 #include <optional>
-#include <vector>
+#include <type_traits>
 
 namespace faio::sync::detail {
 
-template <typename T> class RingBuffer {
+// 有界多生产者无锁环形队列（Vyukov）
+//
+// 每个槽位带一个序号：序号等于入队位置时可写，等于入队位置 + 1 时可读，
+// 出队后序号加上容量，留给下一圈的生产者。生产者和消费者各自用 CAS 抢位置，
+// 只读写自己抢到的槽位，不加锁。容量向上取整到 2 的幂，用掩码代替取模。
+// MultiConsumer 为 false 时只有一个消费者，出队位置不需要 CAS，是 wait-free 的
+//
+// T 的构造可能抛出异常：生产者已经抢到的位置不能退回，槽位标记为跳过后照常发布，
+// 消费者取到它时直接释放、继续取下一个；出队时移动抛出异常，元素丢失，槽位照常释放。
+// 两种情况下异常都传给调用者，队列保持可用
+template <typename T, bool MultiConsumer = true> class RingBuffer : util::Noncopyable {
 public:
-  explicit RingBuffer(std::size_t size) : data_(size + 1) {}
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = MultiConsumer;
 
-  [[nodiscard]]
-  auto is_empty() const -> bool {
-    return start_ == end_;
-  }
-
-  [[nodiscard]]
-  auto is_fill() const -> bool {
-    return (end_ + 1) % data_.size() == start_;
-  }
-
-  template <typename U>
-    requires std::is_nothrow_constructible_v<T, U>
-  void safety_push(U &&val) {
-    assert(!is_fill());
-    data_[end_++] = std::forward<U>(val);
-    end_ %= data_.size();
-  }
-
-  [[nodiscard]]
-  auto safety_pop() -> T {
-    assert(!is_empty());
-    auto ret = std::move(data_[start_++]);
-    start_ %= data_.size();
-    return ret;
+  explicit RingBuffer(std::size_t cap)
+      : _mask{std::bit_ceil(std::max<std::size_t>(cap, 1)) - 1},
+        _slots{std::make_unique<Slot[]>(_mask + 1)} {
+    for (std::size_t i = 0; i <= _mask; ++i) {
+      _slots[i].seq.store(i, std::memory_order::relaxed);
+    }
   }
 
-  template <typename U>
-    requires std::is_nothrow_constructible_v<T, U>
-  auto push(U &&val) -> bool {
-    if (is_fill()) {
-      return false;
+  // 析构剩余的元素
+  ~RingBuffer() {
+    while (try_pop()) {
     }
-    data_[end_++] = std::forward<U>(val);
-    end_ %= data_.size();
-    return true;
   }
 
-  [[nodiscard]]
-  auto pop() -> std::optional<T> {
-    if (is_empty()) {
-      return std::nullopt;
+public:
+  /// 入队，队列满时返回 false，value 保持不变
+  template <typename U> auto try_push(U &&value) -> bool {
+    auto pos = _enqueue_pos.load(std::memory_order::relaxed);
+    while (true) {
+      auto &slot = _slots[pos & _mask];
+      auto seq = slot.seq.load(std::memory_order::acquire);
+      auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        // 槽位可写，抢到这个位置后再写入
+        if (_enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order::relaxed)) {
+          try {
+            std::construct_at(slot.ptr(), std::forward<U>(value));
+          } catch (...) {
+            // 位置已经被占用，发布一个空槽位，消费者跳过它
+            slot.skipped = true;
+            slot.seq.store(pos + 1, std::memory_order::release);
+            throw;
+          }
+          slot.seq.store(pos + 1, std::memory_order::release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // 槽位还没被上一圈的消费者取走，队列满
+        return false;
+      } else {
+        // 位置已经被其他生产者抢走
+        pos = _enqueue_pos.load(std::memory_order::relaxed);
+      }
     }
-    auto res = std::move(data_[start_++]);
-    start_ %= data_.size();
-    return res;
   }
 
-  [[nodiscard]]
-  auto size() const noexcept -> std::size_t {
-    return (end_ - start_ + data_.size()) % data_.size();
+  /// 出队，队列空时返回空
+  auto try_pop() -> std::optional<T> {
+    auto pos = _dequeue_pos.load(std::memory_order::relaxed);
+    if constexpr (!MultiConsumer) {
+      // 只有一个消费者，位置只有自己修改，直接前进
+      while (true) {
+        auto &slot = _slots[pos & _mask];
+        if (slot.seq.load(std::memory_order::acquire) != pos + 1) {
+          return std::nullopt;
+        }
+        _dequeue_pos.store(pos + 1, std::memory_order::relaxed);
+        if (!skip(slot, pos)) [[likely]] {
+          return take(slot, pos);
+        }
+        pos += 1;
+      }
+    }
+    while (true) {
+      auto &slot = _slots[pos & _mask];
+      auto seq = slot.seq.load(std::memory_order::acquire);
+      auto diff =
+          static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (_dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order::relaxed)) {
+          if (!skip(slot, pos)) [[likely]] {
+            return take(slot, pos);
+          }
+          pos += 1;
+        }
+      } else if (diff < 0) {
+        // 槽位还没有写入，队列空
+        return std::nullopt;
+      } else {
+        pos = _dequeue_pos.load(std::memory_order::relaxed);
+      }
+    }
   }
 
   [[nodiscard]]
   auto capacity() const noexcept -> std::size_t {
-    return data_.size() - 1;
+    return _mask + 1;
   }
 
-  [[nodiscard]]
-  auto resize(std::size_t new_size) -> bool {
-    new_size += 1;
-    if (new_size == data_.size()) {
-      return true;
+private:
+  struct Slot {
+    std::atomic<std::size_t> seq;
+    bool skipped{false}; // 生产者构造元素时抛出异常，槽位中没有元素
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    auto ptr() noexcept -> T * {
+      return std::launder(reinterpret_cast<T *>(storage));
     }
-    if (new_size < size()) {
+  };
+
+  // 抢到位置 pos 之后调用：槽位是生产者失败留下的空槽位时直接释放，返回 true
+  auto skip(Slot &slot, std::size_t pos) noexcept -> bool {
+    if (!slot.skipped) [[likely]] {
       return false;
     }
-    std::vector<T> data(new_size);
-    if (start_ < end_) {
-      std::copy(data_.begin() + start_, data_.begin() + end_, data.begin());
-      end_ = end_ - start_;
-      start_ = 0;
-    } else if (start_ > end_) {
-      std::copy(data_.begin() + start_, data_.end(), data.begin());
-      std::copy(data_.begin(), data_.begin() + end_,
-                data.begin() + data_.size() - start_);
-      end_ += data_.size() - start_;
-      start_ = 0;
-    }
-    data_.swap(data);
+    slot.skipped = false;
+    slot.seq.store(pos + _mask + 1, std::memory_order::release);
     return true;
   }
 
-private:
-  std::size_t start_{0};
-  std::size_t end_{0};
-  std::vector<T> data_{};
+  // 取出位置 pos 的元素并释放槽位；移动抛出异常时元素丢失，槽位照常释放
+  auto take(Slot &slot, std::size_t pos) -> std::optional<T> {
+    struct Release {
+      Slot &slot;
+      std::size_t seq;
+      ~Release() {
+        std::destroy_at(slot.ptr());
+        slot.seq.store(seq, std::memory_order::release);
+      }
+    } release{slot, pos + _mask + 1};
+    return std::optional<T>{std::move(*slot.ptr())};
+  }
+
+  // 生产者和消费者的位置各占一个缓存行，避免互相失效
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  const std::size_t _mask;
+  std::unique_ptr<Slot[]> _slots;
+  alignas(CACHE_LINE) std::atomic<std::size_t> _enqueue_pos{0};
+  alignas(CACHE_LINE) std::atomic<std::size_t> _dequeue_pos{0};
 };
 
+// 有界多生产者单消费者无锁环形队列
+template <typename T> using MpscRingBuffer = RingBuffer<T, false>;
+
 } // namespace faio::sync::detail
 
-#endif // FAIO_DETAIL_SYNC_CHANNEL_RING_BUFFER_HPP
\ No newline at end of file
+#endif // FAIO_DETAIL_SYNC_CHANNEL_RING_BUFFER_HPP
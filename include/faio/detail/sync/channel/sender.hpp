@@ -1,6 +1,7 @@
 #ifndef FAIO_DETAIL_SYNC__channel_ptrSENDER_HPP
 #define FAIO_DETAIL_SYNC__channel_ptrSENDER_HPP
 #include <memory>
+#include <utility>
 
 namespace faio::sync::detail {
 
@@ -12,11 +13,16 @@ public:
 
   ~Sender() { close(); }
 
-  Sender(const Sender &other) : _channel_ptr{other._channel_ptr} {
+  // 单生产者的通道不能拷贝发送端，只能移动
+  Sender(const Sender &other)
+    requires Channel::multi_producer
+      : _channel_ptr{other._channel_ptr} {
     _channel_ptr->add_sender();
   }
 
-  auto operator=(const Sender &other) -> Sender & {
+  auto operator=(const Sender &other) -> Sender &
+    requires Channel::multi_producer
+  {
     _channel_ptr->sub_sender();
     _channel_ptr = other._channel_ptr;
     _channel_ptr->add_sender();
@@ -35,6 +41,11 @@ public:
     return _channel_ptr->send(std::move(value));
   }
 
+  // 尝试发送，不挂起，失败时 value 保持不变
+  template <typename U> auto try_send(U &&value) {
+    return _channel_ptr->try_send(std::forward<U>(value));
+  }
+
   void close() {
     if (_channel_ptr) {
       _channel_ptr->sub_sender();
@@ -0,0 +1,101 @@
+#ifndef FAIO_DETAIL_SYNC_CHANNEL_SPSC_RING_BUFFER_HPP
+#define FAIO_DETAIL_SYNC_CHANNEL_SPSC_RING_BUFFER_HPP
+
+#include "faio/detail/common/util/noncopyable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+namespace faio::sync::detail {
+
+// 有界单生产者单消费者无锁环形队列
+//
+// 生产者只写尾位置，消费者只写头位置，入队、出队都是 wait-free 的，没有 CAS。
+// 两边各自缓存一份对方的位置，只有缓存显示满/空时才去读对方的原子变量，
+// 队列不满也不空时两边不会互相读对方的缓存行。容量向上取整到 2 的幂
+template <typename T> class SpscRingBuffer : util::Noncopyable {
+public:
+  static constexpr bool multi_producer = false;
+  static constexpr bool multi_consumer = false;
+
+  explicit SpscRingBuffer(std::size_t cap)
+      : _mask{std::bit_ceil(std::max<std::size_t>(cap, 1)) - 1},
+        _slots{std::make_unique<Slot[]>(_mask + 1)} {}
+
+  // 析构剩余的元素
+  ~SpscRingBuffer() {
+    while (try_pop()) {
+    }
+  }
+
+public:
+  /// 入队，队列满时返回 false，value 保持不变
+  /// T 的构造抛出异常时位置不前进，异常传给调用者
+  template <typename U> auto try_push(U &&value) -> bool {
+    auto tail = _tail.load(std::memory_order::relaxed);
+    if (tail - _cached_head > _mask) {
+      _cached_head = _head.load(std::memory_order::acquire);
+      if (tail - _cached_head > _mask) {
+        return false;
+      }
+    }
+    std::construct_at(_slots[tail & _mask].ptr(), std::forward<U>(value));
+    _tail.store(tail + 1, std::memory_order::release);
+    return true;
+  }
+
+  /// 出队，队列空时返回空
+  auto try_pop() -> std::optional<T> {
+    auto head = _head.load(std::memory_order::relaxed);
+    if (head == _cached_tail) {
+      _cached_tail = _tail.load(std::memory_order::acquire);
+      if (head == _cached_tail) {
+        return std::nullopt;
+      }
+    }
+    // 移动抛出异常时元素丢失，位置照常前进
+    struct Release {
+      SpscRingBuffer &self;
+      std::size_t head;
+      ~Release() {
+        std::destroy_at(self._slots[head & self._mask].ptr());
+        self._head.store(head + 1, std::memory_order::release);
+      }
+    } release{*this, head};
+    return std::optional<T>{std::move(*_slots[head & _mask].ptr())};
+  }
+
+  [[nodiscard]]
+  auto capacity() const noexcept -> std::size_t {
+    return _mask + 1;
+  }
+
+private:
+  struct Slot {
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    auto ptr() noexcept -> T * {
+      return std::launder(reinterpret_cast<T *>(storage));
+    }
+  };
+
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  const std::size_t _mask;
+  std::unique_ptr<Slot[]> _slots;
+  // 生产者的缓存行：尾位置和它看到的头位置
+  alignas(CACHE_LINE) std::atomic<std::size_t> _tail{0};
+  std::size_t _cached_head{0};
+  // 消费者的缓存行：头位置和它看到的尾位置
+  alignas(CACHE_LINE) std::atomic<std::size_t> _head{0};
+  std::size_t _cached_tail{0};
+};
+
+} // namespace faio::sync::detail
+
+#endif // FAIO_DETAIL_SYNC_CHANNEL_SPSC_RING_BUFFER_HPP
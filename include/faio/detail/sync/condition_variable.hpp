@@ -1,45 +1,90 @@
 #ifndef FAIO_DETAIL_SYNC_CONDITION_VARIABLE_HPP
 #define FAIO_DETAIL_SYNC_CONDITION_VARIABLE_HPP
 
+#include "faio/detail/common/error.hpp"
 #include "faio/detail/coroutine/task.hpp"
 #include "faio/detail/sync/mutex.hpp"
+#include "faio/detail/sync/wait_cancel.hpp"
+#include <cerrno>
+#include <utility>
 namespace faio::sync {
 
 class condition_variable {
-  class Awaiter {
+  // 等待链表的节点
+  struct Waiter {
+    Waiter *_next{nullptr};
+    std::coroutine_handle<> _handle{nullptr};
+    bool _proxied{false}; // 是否为 time::timeout 中等待的代理节点
+  };
+
+  // 在 time::timeout 中等待时改为挂入堆上的代理节点，令牌到期时以 ECANCELED 返回，
+  // 通知时跳过它（见 detail::WaitProxy）
+  class Awaiter : Waiter, detail::WaitCancel {
     friend condition_variable;
+    using Proxy = detail::WaitProxy<Waiter>;
 
   public:
     Awaiter(condition_variable &cv, mutex &mutex) : _cv{cv}, _mutex{mutex} {}
 
     auto await_ready() const noexcept -> bool { return false; }
 
-    void await_suspend(std::coroutine_handle<> handle) noexcept {
-      // 赋值
-      _handle = handle;
+    // 挂入等待链表之后解锁；令牌已经到期时不挂起，同样解锁
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
       // 持锁
       std::lock_guard<mutex> lock{_mutex, std::adopt_lock};
+      if (!prepare(handle)) {
+        return false;
+      }
+      // 赋值
+      _handle = handle;
+      Waiter *node = this;
+      if (armed()) [[unlikely]] {
+        _proxy = new Proxy{*this};
+        node = _proxy;
+      }
       // 头插法：将自己的next指针指向当前链表的头部
-      _next = _cv._awaiters.load(std::memory_order::relaxed);
+      node->_next = _cv._awaiters.load(std::memory_order::relaxed);
       // 尝试更新当前链表的头部
-      while (!_cv._awaiters.compare_exchange_weak(_next, this,
+      while (!_cv._awaiters.compare_exchange_weak(node->_next, node,
                                                   std::memory_order::acquire,
                                                   std::memory_order::relaxed)) {
       }
+      return true;
+    }
+
+    // 被通知时返回成功，令牌到期时返回 ECANCELED
+    auto await_resume() const noexcept -> expected<void> {
+      if (cancelled()) [[unlikely]] {
+        return std::unexpected{make_error(ECANCELED)};
+      }
+      return {};
+    }
+
+  private:
+    auto cancel() noexcept -> bool override {
+      return _proxy->transit(detail::WaitState::Cancelled);
     }
 
-    void await_resume() const noexcept {}
+    void settled() noexcept override { _proxy->release(); }
 
   private:
     condition_variable &_cv;
     mutex &_mutex;
-    std::coroutine_handle<> _handle;
-    Awaiter *_next{nullptr};
+    Proxy *_proxy{nullptr}; // 令牌下等待时挂入链表的代理节点
   };
 
 public:
   condition_variable() = default;
 
+  // 被取消的等待者留下的代理节点可能一直没有被通知到
+  ~condition_variable() {
+    auto awaiters = _awaiters.load(std::memory_order::acquire);
+    while (awaiters != nullptr) {
+      detail::drop_node(std::exchange(awaiters, awaiters->_next));
+    }
+  }
+
   // Delete copy
   condition_variable(const condition_variable &) = delete;
   auto operator=(const condition_variable &) -> condition_variable & = delete;
@@ -47,64 +92,62 @@ public:
   condition_variable(condition_variable &&) = delete;
   auto operator=(condition_variable &&) -> condition_variable & = delete;
 
-  // 唤醒一个等待的协程
+  // 唤醒一个等待的协程，被 time::timeout 取消的等待者不计入
   void notify_one() noexcept {
     // 获取等待链表的头部
     auto awaiters = _awaiters.load(std::memory_order::relaxed);
-    // 如果等待链表为空，则返回
-    if (awaiters == nullptr) {
-      return;
-    }
-
-    // 更新等待链表的头部，将下一个节点设置为等待链表的头部
-    while (!_awaiters.compare_exchange_weak(awaiters, awaiters->_next,
-                                            std::memory_order::acq_rel,
-                                            std::memory_order::relaxed)) {
+    // 等待链表为空时返回
+    while (awaiters != nullptr) {
+      // 更新等待链表的头部，将下一个节点设置为等待链表的头部
+      if (!_awaiters.compare_exchange_weak(awaiters, awaiters->_next,
+                                           std::memory_order::acq_rel,
+                                           std::memory_order::relaxed)) {
+        continue;
+      }
+      // 唤醒协程，等待者已经被取消时唤醒下一个
+      if (detail::wake_node(awaiters)) {
+        return;
+      }
+      awaiters = _awaiters.load(std::memory_order::relaxed);
     }
-    // 将下一个节点设置为空
-    awaiters->_next = nullptr;
-    // 唤醒协程
-    condition_variable::resume(awaiters);
   }
 
   // 唤醒所有等待的协程
   void notify_all() noexcept {
-    // 获取等待链表的头部
-    auto awaiters = _awaiters.load(std::memory_order::relaxed);
-    // 更新等待链表的头部，将等待链表设置为空
-    while (!_awaiters.compare_exchange_weak(awaiters, nullptr,
-                                            std::memory_order::acq_rel,
-                                            std::memory_order::relaxed)) {
-    }
+    // 将等待链表设置为空，取下整个链表
+    auto awaiters = _awaiters.exchange(nullptr, std::memory_order::acq_rel);
     // 唤醒协程
     condition_variable::resume(awaiters);
   }
 
-  // 等待条件变量
+  // 等待条件变量，返回时总是持有锁
+  // 在 time::timeout 中等到截止时间时重新加锁后返回 ECANCELED，条件可能仍然不成立
   template <class Predicate>
     requires std::is_invocable_r_v<bool, Predicate>
-  auto wait(mutex &mutex, Predicate &&predicate) -> task<void> {
+  auto wait(mutex &mutex, Predicate &&predicate) -> task<expected<void>> {
     while (!predicate()) {
-      co_await Awaiter{*this, mutex};
-      co_await mutex.lock();
+      auto woken = co_await Awaiter{*this, mutex};
+      // 重新加锁不响应令牌，调用者总是持锁返回
+      co_await mutex.lock_uncancellable();
+      if (!woken) {
+        co_return woken;
+      }
     }
-    co_return;
+    co_return expected<void>{};
   }
 
 private:
-  // 唤醒一个等待的协程
-  static void resume(Awaiter *awaiter) {
+  // 唤醒链表上的所有协程
+  static void resume(Waiter *awaiter) {
     // 循环唤醒等待的协程
     while (awaiter != nullptr) {
-      // 唤醒协程
-      runtime::detail::push_task_to_local_queue(awaiter->_handle);
-      // 移动到下一个等待的协程
-      awaiter = awaiter->_next;
+      // 恢复之后节点随时可能被销毁，先移动到下一个等待的协程
+      detail::wake_node(std::exchange(awaiter, awaiter->_next));
     }
   }
 
 private:
-  std::atomic<Awaiter *> _awaiters{nullptr}; // 等待链表的头部
+  std::atomic<Waiter *> _awaiters{nullptr}; // 等待链表的头部
 };
 
 } // namespace faio::sync
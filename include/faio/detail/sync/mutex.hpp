@@ -1,29 +1,57 @@
 #ifndef FAIO_DETAIL_SYNC__mutexHPP
 #define FAIO_DETAIL_SYNC__mutexHPP
 
+#include "faio/detail/common/error.hpp"
 #include "faio/detail/runtime/core/poller.hpp"
+#include "faio/detail/sync/wait_cancel.hpp"
+#include <cerrno>
 #include <coroutine>
+#include <utility>
 
 namespace faio::sync {
 
+class condition_variable;
+
 class mutex {
+  friend condition_variable;
+
+  // 等待链表的节点
+  struct Waiter {
+    Waiter *_next{nullptr};                   // 指向下一个等待的协程,形成一个链表
+    std::coroutine_handle<> _handle{nullptr}; // 当前等待的协程的句柄,用于在解锁时恢复协程
+    bool _proxied{false};                     // 是否为 time::timeout 中等待的代理节点
+  };
 
   // Awaiter类：实现mutex的等待机制，本身是一个链表节点，用于存储等待获取锁的协程。
   // 基于头插法的链表设计：先进后出的lifo设计。
   // 如果是A，B，C按顺序等待加锁，则链表是C->B->A。
-  class Awaiter {
+  // 在 time::timeout 中等待时改为挂入堆上的代理节点，令牌到期时以 ECANCELED 返回，
+  // 解锁时跳过它，把锁交给下一个等待者（见 detail::WaitProxy）
+  class Awaiter : Waiter, detail::WaitCancel {
     friend mutex;
+    using Proxy = detail::WaitProxy<Waiter>;
 
   public:
-    explicit Awaiter(mutex &mutex) : _mutex{mutex} {}
+    explicit Awaiter(mutex &mutex, bool cancellable = true)
+        : _mutex{mutex}, _cancellable{cancellable} {}
 
     // 总是挂起
     auto await_ready() const noexcept -> bool { return false; }
 
     // 当协程被挂起时,尝试获取锁.如果获取锁成功,则不挂起协程,直接返回false;否则挂起协程,返回true.
-    auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool {
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+      // 令牌已经到期，不再等待
+      if (!(_cancellable ? prepare(handle) : prepare(std::coroutine_handle<>{handle}))) {
+        return false;
+      }
       // 赋值
       _handle = handle;
+      Waiter *node = this;
+      if (armed()) [[unlikely]] {
+        _proxy = new Proxy{*this};
+        node = _proxy;
+      }
       // 获取当前锁状态
       auto state = _mutex._state.load(std::memory_order::relaxed);
       // 死循环
@@ -35,14 +63,17 @@ class mutex {
           if (_mutex._state.compare_exchange_weak(state, _mutex.locking_state(),
                                                   std::memory_order::acquire,
                                                   std::memory_order::relaxed)) {
+            // 代理节点没有挂入链表，直接释放
+            delete std::exchange(_proxy, nullptr);
+            disarm();
             return false;
           }
         } else {
           // 如果锁状态已经是已锁定状态
           // 头插法：将自己的next指针指向当前链表的头部
-          _next = state;
+          node->_next = state;
           // 尝试更新当前链表的头部
-          if (_mutex._state.compare_exchange_weak(state, this,
+          if (_mutex._state.compare_exchange_weak(state, node,
                                                   std::memory_order::acquire,
                                                   std::memory_order::relaxed)) {
             break;
@@ -52,13 +83,25 @@ class mutex {
       return true;
     }
 
-    constexpr void await_resume() const noexcept {}
+    // 拿到锁时返回成功，time::timeout 的令牌到期时返回 ECANCELED，此时没有持有锁
+    auto await_resume() const noexcept -> expected<void> {
+      if (cancelled()) [[unlikely]] {
+        return std::unexpected{make_error(ECANCELED)};
+      }
+      return {};
+    }
+
+  private:
+    auto cancel() noexcept -> bool override {
+      return _proxy->transit(detail::WaitState::Cancelled);
+    }
+
+    void settled() noexcept override { _proxy->release(); }
 
   private:
-    mutex &_mutex;  // 指向所属的mutex对象
-    Awaiter *_next; // 指向下一个等待的协程,形成一个链表
-    std::coroutine_handle<>
-        _handle; // 当前等待的协程的句柄,用于在解锁时恢复协程
+    mutex &_mutex;          // 指向所属的mutex对象
+    bool _cancellable;      // 是否响应 time::timeout 的令牌
+    Proxy *_proxy{nullptr}; // 令牌下等待时挂入链表的代理节点
   };
 
 public:
@@ -73,7 +116,8 @@ public:
   // 这不是awaiter，无法使用co_await mutex.try_lock()。
   [[nodiscard]]
   auto try_lock() noexcept -> bool {
-    auto state = _state.load(std::memory_order::relaxed);
+    // 只有解锁状态才能抢锁，已锁定（无论有没有等待者）时失败
+    auto state = unlocking_state();
     return _state.compare_exchange_strong(state, locking_state(),
                                           std::memory_order::acquire,
                                           std::memory_order::relaxed);
@@ -81,7 +125,8 @@ public:
 
   // 加锁
   // 直接返回一个Awaiter对象，用于等待获取锁。
-  // 可以使用co_await mutex.lock()来等待获取锁。
+  // 可以使用co_await mutex.lock()来等待获取锁，结果为 expected<void>：
+  // 在 time::timeout 中等到截止时间时返回 ECANCELED，没有拿到锁
   [[nodiscard]]
   auto lock() noexcept {
     return Awaiter{*this};
@@ -95,52 +140,64 @@ public:
       fastlog::console.error("unlocking an unlocked mutex");
       std::terminate();
     }
-    // 如果等待队列为空,说明没有协程需要等待获取锁,则直接将锁状态设置为解锁状态.
-    if (_fifo_awaiters == nullptr) {
-      auto state = _state.load(std::memory_order::relaxed);
-      // 如果当前锁状态为已锁定状态,则使用CAS将锁状态设置为解锁状态.
-      if (state == locking_state() &&
-          _state.compare_exchange_strong(state, unlocking_state(),
-                                         std::memory_order::acquire,
-                                         std::memory_order::relaxed)) {
+    while (true) {
+      // 如果等待队列为空,说明没有协程需要等待获取锁,则直接将锁状态设置为解锁状态.
+      if (_fifo_awaiters == nullptr) {
+        auto state = _state.load(std::memory_order::relaxed);
+        // 如果当前锁状态为已锁定状态,则使用CAS将锁状态设置为解锁状态.
+        if (state == locking_state() &&
+            _state.compare_exchange_strong(state, unlocking_state(),
+                                           std::memory_order::acquire,
+                                           std::memory_order::relaxed)) {
+          return;
+        }
+        // 获取到等待队列的头部
+        auto lifo_awaiters =
+            _state.exchange(locking_state(), std::memory_order::acquire);
+
+        // 利用std::tie反转链表，得到fifo等待链表
+        // 循环赋值：
+        //  lifo_awaiters赋值给_fifo_awaiters，第一轮：lifo链表头部赋值给fifo链表头部
+        // lifo链表的下一个节点赋值给lifo_awaiters
+        // 将_fifo_awaiters赋值给lifo_awaiters的next指针。
+        do {
+          std::tie(_fifo_awaiters, lifo_awaiters, lifo_awaiters->_next) =
+              std::tuple{lifo_awaiters, lifo_awaiters->_next, _fifo_awaiters};
+        } while (lifo_awaiters != nullptr);
+      }
+      // 恢复之后节点随时可能被销毁，先取出后继
+      auto awaiter = std::exchange(_fifo_awaiters, _fifo_awaiters->_next);
+      // 等待者已经被 time::timeout 取消时不再需要锁，交给下一个
+      if (detail::wake_node(awaiter)) {
         return;
       }
-      // 获取到等待队列的头部
-      auto lifo_awaiters =
-          _state.exchange(locking_state(), std::memory_order::acquire);
-
-      // 利用std::tie反转链表，得到fifo等待链表
-      // 循环赋值：
-      //  lifo_awaiters赋值给_fifo_awaiters，第一轮：lifo链表头部赋值给fifo链表头部
-      // lifo链表的下一个节点赋值给lifo_awaiters
-      // 将_fifo_awaiters赋值给lifo_awaiters的next指针。
-      do {
-        std::tie(_fifo_awaiters, lifo_awaiters, lifo_awaiters->_next) =
-            std::tuple{lifo_awaiters, lifo_awaiters->_next, _fifo_awaiters};
-      } while (lifo_awaiters != nullptr);
     }
-    runtime::detail::push_task_to_local_queue(_fifo_awaiters->_handle);
-    _fifo_awaiters = _fifo_awaiters->_next;
   }
 
 private:
   [[nodiscard]]
   // 已锁定状态
   // 表示当前锁状态为已锁定状态，没有等待者。
-  auto locking_state() -> Awaiter * {
+  auto locking_state() -> Waiter * {
     return nullptr;
   }
 
   // 解锁状态
   // 表示当前锁状态为解锁状态，有等待者。
   [[nodiscard]]
-  auto unlocking_state() -> Awaiter * {
-    return reinterpret_cast<Awaiter *>(this);
+  auto unlocking_state() -> Waiter * {
+    return reinterpret_cast<Waiter *>(this);
+  }
+
+  // 不响应 time::timeout 的加锁，condition_variable 等待结束后重新加锁时使用
+  [[nodiscard]]
+  auto lock_uncancellable() noexcept -> Awaiter {
+    return Awaiter{*this, false};
   }
 
 private:
-  std::atomic<Awaiter *> _state;    // 当前锁状态,同时是Awaiter链表的链头
-  Awaiter *_fifo_awaiters{nullptr}; // fifo等待链表头节点，保证先进先出
+  std::atomic<Waiter *> _state;    // 当前锁状态,同时是等待链表的链头
+  Waiter *_fifo_awaiters{nullptr}; // fifo等待链表头节点，保证先进先出
 };
 
 } // namespace faio::sync
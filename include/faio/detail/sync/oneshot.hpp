@@ -0,0 +1,247 @@
+#ifndef FAIO_DETAIL_SYNC_ONESHOT_HPP
+#define FAIO_DETAIL_SYNC_ONESHOT_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/runtime/core/poller.hpp"
+#include "faio/detail/sync/wait_cancel.hpp"
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace faio::sync {
+namespace detail {
+
+// 一次性通道的共享状态：一次分配，一个原子状态字
+//
+// 状态字的每一位：
+//   VALUE      值已经写入（发送时置位，接收方取走后清除）
+//   WAITING    接收方已经挂起，_waiter 可读
+//   TX_CLOSED  发送端已经发送或被销毁，之后不会再有值
+//   RX_CLOSED  接收端已经被销毁，发送会失败
+// 写值/写句柄在置位之前完成，置位用 acq_rel，对方读到该位时一定能看到对应的数据。
+// 在 time::timeout 中等到截止时间时，接收方在发送端完成之前清除 WAITING 位，以 ECANCELED 返回
+template <typename T> class OneshotState {
+public:
+  static constexpr std::uint32_t VALUE = 1;
+  static constexpr std::uint32_t WAITING = 2;
+  static constexpr std::uint32_t TX_CLOSED = 4;
+  static constexpr std::uint32_t RX_CLOSED = 8;
+
+  OneshotState() = default;
+  OneshotState(const OneshotState &) = delete;
+  auto operator=(const OneshotState &) -> OneshotState & = delete;
+
+  ~OneshotState() {
+    if (_state.load(std::memory_order::acquire) & VALUE) {
+      std::destroy_at(ptr());
+    }
+  }
+
+public:
+  // 发送端：写入值并唤醒等待的接收方，接收端已经销毁时返回 ClosedChannel
+  auto send(T &&value) -> expected<void> {
+    if (_state.load(std::memory_order::acquire) & RX_CLOSED) {
+      close_sender();
+      return std::unexpected{make_error(Error::ClosedChannel)};
+    }
+    std::construct_at(ptr(), std::move(value));
+    auto prev = _state.fetch_or(VALUE | TX_CLOSED, std::memory_order::acq_rel);
+    if (prev & WAITING) {
+      _waiter->resume();
+    }
+    if (prev & RX_CLOSED) {
+      // 接收端在写入期间被销毁，值由析构函数释放
+      return std::unexpected{make_error(Error::ClosedChannel)};
+    }
+    return {};
+  }
+
+  // 发送端没有发送就被销毁
+  void close_sender() {
+    auto prev = _state.fetch_or(TX_CLOSED, std::memory_order::acq_rel);
+    if ((prev & (WAITING | TX_CLOSED)) == WAITING) {
+      _waiter->resume();
+    }
+  }
+
+  void close_receiver() { _state.fetch_or(RX_CLOSED, std::memory_order::acq_rel); }
+
+  [[nodiscard]]
+  auto receiver_closed() const noexcept -> bool {
+    return _state.load(std::memory_order::acquire) & RX_CLOSED;
+  }
+
+  // 接收端：发送端已经发送或销毁时为 true
+  [[nodiscard]]
+  auto completed() const noexcept -> bool {
+    return _state.load(std::memory_order::acquire) & (VALUE | TX_CLOSED);
+  }
+
+  // 接收端挂起，返回 false 表示发送端已经完成，不需要挂起
+  auto wait(WaitCancel *waiter) noexcept -> bool {
+    _waiter = waiter;
+    auto prev = _state.fetch_or(WAITING, std::memory_order::acq_rel);
+    return (prev & (VALUE | TX_CLOSED)) == 0;
+  }
+
+  // 令牌到期：发送端还没完成时清除 WAITING 位，已经完成（正在唤醒接收方）时返回 false
+  auto cancel_wait() noexcept -> bool {
+    auto state = _state.load(std::memory_order::acquire);
+    while ((state & (VALUE | TX_CLOSED)) == 0) {
+      if (_state.compare_exchange_weak(state, state & ~WAITING, std::memory_order::acq_rel,
+                                       std::memory_order::acquire)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 接收端取走值，没有值时返回 ClosedChannel（发送端未发送就被销毁，或值已经取走）；
+  // 发送端还没完成时返回 EmptyChannel
+  auto take() -> expected<T> {
+    auto state = _state.load(std::memory_order::acquire);
+    if (state & VALUE) {
+      expected<T> result{std::move(*ptr())};
+      std::destroy_at(ptr());
+      _state.fetch_and(~(VALUE | WAITING), std::memory_order::acq_rel);
+      return result;
+    }
+    if (state & TX_CLOSED) {
+      return std::unexpected{make_error(Error::ClosedChannel)};
+    }
+    return std::unexpected{make_error(Error::EmptyChannel)};
+  }
+
+private:
+  auto ptr() noexcept -> T * { return std::launder(reinterpret_cast<T *>(_storage)); }
+
+private:
+  std::atomic<std::uint32_t> _state{0};     // 状态字
+  WaitCancel *_waiter{nullptr};              // 挂起的接收方
+  alignas(T) unsigned char _storage[sizeof(T)];
+};
+
+} // namespace detail
+
+// 一次性通道：只发送一个值，用于请求/响应的配对。
+// 发送不会挂起；接收端可以直接 co_await，得到 expected<T>，
+// 发送端没有发送就被销毁时得到 ClosedChannel，在 time::timeout 中等到截止时间时得到 ECANCELED
+template <typename T> class oneshot {
+  using State = detail::OneshotState<T>;
+
+public:
+  class Sender {
+  public:
+    explicit Sender(std::shared_ptr<State> state) : _state{std::move(state)} {}
+    Sender(Sender &&) noexcept = default;
+    auto operator=(Sender &&other) noexcept -> Sender & {
+      close();
+      _state = std::move(other._state);
+      return *this;
+    }
+    ~Sender() { close(); }
+
+    // 发送值，只能调用一次；接收端已经销毁或已经发送过时返回 ClosedChannel
+    auto send(T value) -> expected<void> {
+      if (!_state) {
+        return std::unexpected{make_error(Error::ClosedChannel)};
+      }
+      auto state = std::move(_state);
+      return state->send(std::move(value));
+    }
+
+    // 接收端是否已经销毁，此时不必再计算要发送的值
+    [[nodiscard]]
+    auto is_closed() const noexcept -> bool {
+      return !_state || _state->receiver_closed();
+    }
+
+    void close() {
+      if (_state) {
+        _state->close_sender();
+        _state.reset();
+      }
+    }
+
+  private:
+    std::shared_ptr<State> _state;
+  };
+
+  class Receiver {
+    class Awaiter : detail::WaitCancel {
+    public:
+      explicit Awaiter(State &state) : _state{state} {}
+
+      auto await_ready() const noexcept -> bool { return _state.completed(); }
+
+      template <typename Promise>
+      auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+        // 令牌已经到期，不再等待
+        if (!prepare(handle)) {
+          return false;
+        }
+        if (!_state.wait(this)) {
+          disarm();
+          return false;
+        }
+        return true;
+      }
+
+      // 令牌到期时返回 ECANCELED，之后仍然可以再次等待
+      auto await_resume() -> expected<T> {
+        if (cancelled()) [[unlikely]] {
+          return std::unexpected{make_error(ECANCELED)};
+        }
+        return _state.take();
+      }
+
+    private:
+      auto cancel() noexcept -> bool override { return _state.cancel_wait(); }
+
+    private:
+      State &_state;
+    };
+
+  public:
+    explicit Receiver(std::shared_ptr<State> state) : _state{std::move(state)} {}
+    Receiver(Receiver &&) noexcept = default;
+    auto operator=(Receiver &&other) noexcept -> Receiver & {
+      close();
+      _state = std::move(other._state);
+      return *this;
+    }
+    ~Receiver() { close(); }
+
+    // 等待发送端的值
+    auto operator co_await() noexcept -> Awaiter { return Awaiter{*_state}; }
+
+    // 尝试取值，不挂起：还没有发送返回 EmptyChannel
+    auto try_recv() -> expected<T> { return _state->take(); }
+
+    void close() {
+      if (_state) {
+        _state->close_receiver();
+        _state.reset();
+      }
+    }
+
+  private:
+    std::shared_ptr<State> _state;
+  };
+
+public:
+  // 创建一个一次性通道，发送端和接收端共享一次分配
+  [[nodiscard]]
+  static auto make() -> std::pair<Sender, Receiver> {
+    auto state = std::make_shared<State>();
+    return std::make_pair(Sender{state}, Receiver{state});
+  }
+};
+
+} // namespace faio::sync
+
+#endif // FAIO_DETAIL_SYNC_ONESHOT_HPP
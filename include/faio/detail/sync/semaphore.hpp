@@ -0,0 +1,368 @@
+#ifndef FAIO_DETAIL_SYNC_SEMAPHORE_HPP
+#define FAIO_DETAIL_SYNC_SEMAPHORE_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/runtime/core/poller.hpp"
+#include "faio/detail/sync/wait_cancel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace faio::sync {
+
+// 协程信号量：限制同时进行的工作数量
+//
+// 与 mutex 相同的无锁侵入式等待链表设计：_state 要么是剩余许可数（最低位为 1），
+// 要么是等待者 Awaiter 链表的头部（头插法，LIFO）。许可不够时，awaiter 先拿走剩余的许可，
+// 再把自己头插进链表并挂起，记下还差多少个。
+//
+// 释放许可先累加到 _pending；把 _pending 从 0 变为非 0 的释放者负责分发，
+// 其他释放者只做一次 fetch_add 就返回。分发者独占 _fifo_awaiters：把新挂入的 LIFO 链表
+// 反转后接在 FIFO 链表尾部，按先来后到把许可交给队头，只唤醒许可已经凑齐的等待者，
+// 没有惊群；没有等待者时才把剩余的许可放回 _state
+//
+// 在 time::timeout 中等待时挂入堆上的代理节点（见 detail::WaitProxy），令牌到期时以 ECANCELED 返回。
+// 被取消的等待者恢复时向 _pending 提交一次清扫请求（高位计数），像释放许可一样由分发者处理：
+// 分发者把被取消的节点摘出链表，收回它已经凑到的许可交给后面的等待者，
+// 没有等待者时放回 _state，不必等到下一次 release
+class semaphore {
+public:
+  // 持有的许可，析构时归还；可以移动，不能拷贝
+  class Permit {
+  public:
+    Permit() = default;
+    Permit(semaphore &semaphore, std::size_t permits)
+        : _semaphore{&semaphore}, _permits{permits} {}
+    Permit(Permit &&other) noexcept
+        : _semaphore{std::exchange(other._semaphore, nullptr)},
+          _permits{std::exchange(other._permits, 0)} {}
+    auto operator=(Permit &&other) noexcept -> Permit & {
+      if (this != &other) {
+        release();
+        _semaphore = std::exchange(other._semaphore, nullptr);
+        _permits = std::exchange(other._permits, 0);
+      }
+      return *this;
+    }
+    Permit(const Permit &) = delete;
+    auto operator=(const Permit &) -> Permit & = delete;
+    ~Permit() { release(); }
+
+    // 持有的许可数
+    [[nodiscard]]
+    auto count() const noexcept -> std::size_t {
+      return _permits;
+    }
+
+    // 提前归还
+    void release() noexcept {
+      if (_semaphore != nullptr) {
+        std::exchange(_semaphore, nullptr)->release(std::exchange(_permits, 0));
+      }
+    }
+
+    // 不归还许可，用于永久减少可用的许可
+    void forget() noexcept {
+      _semaphore = nullptr;
+      _permits = 0;
+    }
+
+  private:
+    semaphore *_semaphore{nullptr};
+    std::size_t _permits{0};
+  };
+
+private:
+  // 等待链表的节点
+  struct Waiter {
+    std::size_t _permits;                     // 需要的许可数
+    std::size_t _needed{0};                   // 挂起时还差的许可数
+    Waiter *_next{nullptr};                   // 链表的下一个等待者
+    std::coroutine_handle<> _handle{nullptr}; // 许可凑齐时恢复
+    bool _proxied{false};                     // 是否为 time::timeout 中等待的代理节点
+  };
+
+  class Awaiter : Waiter, detail::WaitCancel {
+    friend semaphore;
+    using Proxy = detail::WaitProxy<Waiter>;
+
+  public:
+    Awaiter(semaphore &semaphore, std::size_t permits)
+        : Waiter{permits}, _semaphore{semaphore} {}
+
+    // 许可足够时直接拿走，不挂起
+    auto await_ready() noexcept -> bool { return _semaphore.try_take(_permits); }
+
+    // 许可不够时拿走剩余的许可，挂入等待链表
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+      // 令牌已经到期，不再等待
+      if (!prepare(handle)) {
+        return false;
+      }
+      _handle = handle;
+      Waiter *node = this;
+      if (armed()) [[unlikely]] {
+        _proxy = new Proxy{*this};
+        _proxy->_permits = _permits;
+        node = _proxy;
+      }
+      auto state = _semaphore._state.load(std::memory_order::relaxed);
+      while (true) {
+        if (is_count(state)) {
+          auto available = count_of(state);
+          if (available >= _permits) {
+            if (_semaphore._state.compare_exchange_weak(
+                    state, make_count(available - _permits),
+                    std::memory_order::acquire, std::memory_order::relaxed)) {
+              // 代理节点没有挂入链表，直接释放
+              delete std::exchange(_proxy, nullptr);
+              disarm();
+              return false;
+            }
+            continue;
+          }
+          // 有剩余许可说明没有其他等待者，拿走剩余的许可成为第一个等待者
+          node->_needed = _permits - available;
+          node->_next = nullptr;
+        } else {
+          node->_needed = _permits;
+          node->_next = reinterpret_cast<Waiter *>(state);
+        }
+        if (_semaphore._state.compare_exchange_weak(
+                state, reinterpret_cast<std::uintptr_t>(node),
+                std::memory_order::acq_rel, std::memory_order::relaxed)) {
+          return true;
+        }
+      }
+    }
+
+    // 恢复时许可已经凑齐；令牌到期时返回 ECANCELED，不持有许可
+    auto await_resume() noexcept -> expected<Permit> {
+      if (cancelled()) [[unlikely]] {
+        // 挂入过链表时收回已经凑到的许可。不在 cancel() 中做：那里正在执行时间轮，
+        // 分发时恢复同一时刻到期的其他等待者会摘除同一槽位的节点
+        if (_proxy != nullptr) {
+          _semaphore.sweep();
+        }
+        return std::unexpected{make_error(ECANCELED)};
+      }
+      return expected<Permit>{std::in_place, _semaphore, _permits};
+    }
+
+  private:
+    auto cancel() noexcept -> bool override {
+      return _proxy->transit(detail::WaitState::Cancelled);
+    }
+
+    void settled() noexcept override { _proxy->release(); }
+
+  private:
+    semaphore &_semaphore;
+    Proxy *_proxy{nullptr}; // 令牌下等待时挂入链表的代理节点
+  };
+
+public:
+  explicit semaphore(std::size_t permits) : _state{make_count(permits)} {}
+  // 被取消的等待者留下的代理节点可能一直没有等到分发
+  ~semaphore() {
+    auto state = _state.load(std::memory_order::acquire);
+    auto lifo_awaiters = is_count(state) ? nullptr : reinterpret_cast<Waiter *>(state);
+    for (auto awaiters : {_fifo_awaiters, lifo_awaiters}) {
+      while (awaiters != nullptr) {
+        detail::drop_node(std::exchange(awaiters, awaiters->_next));
+      }
+    }
+  }
+  semaphore(const semaphore &) = delete;
+  semaphore &operator=(const semaphore &) = delete;
+  semaphore(semaphore &&) = delete;
+  semaphore &operator=(semaphore &&) = delete;
+
+  // 获取 permits 个许可，不够时按先来后到挂起
+  // 可以使用 auto permit = co_await sem.acquire(n)，结果为 expected<Permit>：
+  // 在 time::timeout 中等到截止时间时返回 ECANCELED
+  [[nodiscard]]
+  auto acquire(std::size_t permits = 1) noexcept -> Awaiter {
+    return Awaiter{*this, permits};
+  }
+
+  // 尝试获取许可，不挂起；已经有等待者时也会失败，不插队
+  [[nodiscard]]
+  auto try_acquire(std::size_t permits = 1) noexcept -> std::optional<Permit> {
+    if (!try_take(permits)) {
+      return std::nullopt;
+    }
+    return std::optional<Permit>{std::in_place, *this, permits};
+  }
+
+  // 归还许可，通常由 Permit 析构时调用
+  void release(std::size_t permits = 1) noexcept {
+    if (permits == 0) {
+      return;
+    }
+    // 已经有释放者在分发，许可交给它
+    if (_pending.fetch_add(permits, std::memory_order::acq_rel) != 0) {
+      return;
+    }
+    drain(permits);
+  }
+
+  // 当前可以直接拿到的许可数，有等待者时为 0
+  [[nodiscard]]
+  auto available() const noexcept -> std::size_t {
+    auto state = _state.load(std::memory_order::relaxed);
+    return is_count(state) ? count_of(state) : 0;
+  }
+
+private:
+  static constexpr auto is_count(std::uintptr_t state) noexcept -> bool {
+    return (state & 1) != 0;
+  }
+
+  static constexpr auto count_of(std::uintptr_t state) noexcept -> std::size_t {
+    return static_cast<std::size_t>(state >> 1);
+  }
+
+  static constexpr auto make_count(std::size_t permits) noexcept
+      -> std::uintptr_t {
+    return (static_cast<std::uintptr_t>(permits) << 1) | 1;
+  }
+
+  // 许可足够时 CAS 拿走；有等待者时不插队
+  auto try_take(std::size_t permits) noexcept -> bool {
+    auto state = _state.load(std::memory_order::relaxed);
+    while (is_count(state) && count_of(state) >= permits) {
+      if (_state.compare_exchange_weak(state, make_count(count_of(state) - permits),
+                                       std::memory_order::acquire,
+                                       std::memory_order::relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 等待者被取消之后调用：提交一次清扫请求，已经有分发者时交给它
+  void sweep() noexcept {
+    if (_pending.fetch_add(sweep_request, std::memory_order::acq_rel) != 0) {
+      return;
+    }
+    drain(sweep_request);
+  }
+
+  // 分发者：把 _pending 中的许可交给等待者、处理清扫请求，直到 _pending 归零
+  void drain(std::uint64_t pending) noexcept {
+    while (true) {
+      hand_out(static_cast<std::size_t>(pending & permits_mask), pending >= sweep_request);
+      auto remaining = _pending.fetch_sub(pending, std::memory_order::acq_rel) - pending;
+      if (remaining == 0) {
+        return;
+      }
+      pending = remaining;
+    }
+  }
+
+  // 把被取消的等待者摘出 FIFO 链表，返回它们已经凑到的许可
+  auto remove_cancelled() noexcept -> std::size_t {
+    take_new_awaiters();
+    std::size_t reclaimed = 0;
+    Waiter *prev = nullptr;
+    for (auto node = _fifo_awaiters; node != nullptr;) {
+      auto next = node->_next;
+      if (detail::cancelled_node(node)) {
+        (prev == nullptr ? _fifo_awaiters : prev->_next) = next;
+        if (_fifo_tail == node) {
+          _fifo_tail = prev;
+        }
+        reclaimed += node->_permits - node->_needed;
+        // 令牌一方已经胜出，这里只释放唤醒者持有的引用
+        detail::wake_node(node);
+      } else {
+        prev = node;
+      }
+      node = next;
+    }
+    return reclaimed;
+  }
+
+  void hand_out(std::size_t budget, bool sweep) noexcept {
+    if (sweep) {
+      budget += remove_cancelled();
+    }
+    while (budget > 0) {
+      if (_fifo_awaiters == nullptr && !take_new_awaiters()) {
+        // 没有等待者，剩余的许可放回 _state；期间有新的等待者挂入时 CAS 失败，重新分发
+        auto state = _state.load(std::memory_order::relaxed);
+        if (is_count(state) &&
+            _state.compare_exchange_strong(state, make_count(count_of(state) + budget),
+                                           std::memory_order::release,
+                                           std::memory_order::relaxed)) {
+          return;
+        }
+        continue;
+      }
+      auto head = _fifo_awaiters;
+      if (!detail::cancelled_node(head)) {
+        auto given = std::min(budget, head->_needed);
+        head->_needed -= given;
+        budget -= given;
+        if (head->_needed != 0) {
+          continue;
+        }
+      }
+      _fifo_awaiters = head->_next;
+      if (_fifo_awaiters == nullptr) {
+        _fifo_tail = nullptr;
+      }
+      // 等待者已经被取消时收回它凑到的许可，交给后面的等待者
+      auto held = head->_permits - head->_needed;
+      if (!detail::wake_node(head)) {
+        budget += held;
+      }
+    }
+  }
+
+  // 取下 _state 上新挂入的 LIFO 链表，反转后接在 FIFO 链表尾部；没有新的等待者时返回 false
+  auto take_new_awaiters() noexcept -> bool {
+    auto state = _state.load(std::memory_order::relaxed);
+    if (is_count(state)) {
+      return false;
+    }
+    auto lifo_awaiters = reinterpret_cast<Waiter *>(
+        _state.exchange(make_count(0), std::memory_order::acquire));
+    Waiter *fifo_awaiters = nullptr;
+    auto tail = lifo_awaiters;
+    while (lifo_awaiters != nullptr) {
+      std::tie(fifo_awaiters, lifo_awaiters, lifo_awaiters->_next) =
+          std::tuple{lifo_awaiters, lifo_awaiters->_next, fifo_awaiters};
+    }
+    if (_fifo_tail == nullptr) {
+      _fifo_awaiters = fifo_awaiters;
+    } else {
+      _fifo_tail->_next = fifo_awaiters;
+    }
+    _fifo_tail = tail;
+    return true;
+  }
+
+private:
+  std::atomic<std::uintptr_t> _state;      // 剩余许可数，或者等待者链表的头部
+  // 低位为待分发的许可数，高位为清扫请求数；非 0 时有一个分发者
+  static constexpr std::uint64_t sweep_request = std::uint64_t{1} << 48;
+  static constexpr std::uint64_t permits_mask = sweep_request - 1;
+
+  std::atomic<std::uint64_t> _pending{0};
+  Waiter *_fifo_awaiters{nullptr};         // 分发者独占的 FIFO 等待链表
+  Waiter *_fifo_tail{nullptr};             // FIFO 等待链表的尾部
+};
+
+} // namespace faio::sync
+
+#endif // FAIO_DETAIL_SYNC_SEMAPHORE_HPP
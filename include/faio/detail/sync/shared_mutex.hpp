@@ -0,0 +1,337 @@
+#ifndef FAIO_DETAIL_SYNC_SHARED_MUTEX_HPP
+#define FAIO_DETAIL_SYNC_SHARED_MUTEX_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/runtime/core/poller.hpp"
+#include "faio/detail/sync/wait_cancel.hpp"
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace faio::sync {
+
+// 协程读写锁：用于路由表、配置快照、进程内缓存这类读多写少的共享状态
+//
+// _state 的低位是持有读锁的读者数，最高位 WRITER 表示有写者持有锁或正在等待读者退出。
+// 读者的快路径只有一次 fetch_add：加完之后没有 WRITER 位就拿到了读锁，不碰等待链表；
+// 有 WRITER 位时在锁内撤销这次加一，挂入读者等待链表。
+//
+// 写者优先：写者一旦置上 WRITER 位，新的读者都要排队，已经持有读锁的读者退出之后写者拿到锁，
+// 源源不断的读者不会饿死写者。写者解锁时先放行所有排队的读者，再轮到下一个写者，
+// 读者也不会被连续的写者饿死。
+// 写者、读者的慢路径和解锁时的交接都用一把 std::mutex 保护，写本来就少，不影响读的快路径。
+// 在 time::timeout 中等到截止时间时持锁把等待者摘出链表，以 ECANCELED 返回（见 detail::WaitCancel）
+class shared_mutex {
+  static constexpr std::uint64_t WRITER = std::uint64_t{1} << 63;
+
+  // 等待链表的节点，嵌入在 awaiter 中
+  struct Waiter : detail::WaitCancel {
+    Waiter *_next{nullptr};
+  };
+
+  // 先进先出的侵入式单链表
+  class WaiterList {
+  public:
+    [[nodiscard]] auto empty() const noexcept -> bool { return _head == nullptr; }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return _size; }
+
+    void push_back(Waiter *waiter) noexcept {
+      waiter->_next = nullptr;
+      if (_tail == nullptr) {
+        _head = waiter;
+      } else {
+        _tail->_next = waiter;
+      }
+      _tail = waiter;
+      ++_size;
+    }
+
+    auto pop_front() noexcept -> Waiter * {
+      auto waiter = _head;
+      _head = _head->_next;
+      if (_head == nullptr) {
+        _tail = nullptr;
+      }
+      --_size;
+      return waiter;
+    }
+
+    // 摘除中间的节点，不在链表中时返回 false；只在令牌到期时调用
+    auto remove(Waiter *waiter) noexcept -> bool {
+      Waiter *prev = nullptr;
+      for (auto node = _head; node != nullptr; prev = node, node = node->_next) {
+        if (node != waiter) {
+          continue;
+        }
+        (prev == nullptr ? _head : prev->_next) = node->_next;
+        if (_tail == node) {
+          _tail = prev;
+        }
+        --_size;
+        return true;
+      }
+      return false;
+    }
+
+  private:
+    Waiter *_head{nullptr};
+    Waiter *_tail{nullptr};
+    std::size_t _size{0};
+  };
+
+  // 读锁Awaiter
+  class SharedAwaiter : Waiter {
+    friend shared_mutex;
+
+  public:
+    explicit SharedAwaiter(shared_mutex &mutex) : _mutex{mutex} {}
+
+    // 快路径：一次 fetch_add，没有写者就拿到了读锁
+    auto await_ready() noexcept -> bool {
+      return (_mutex._state.fetch_add(1, std::memory_order::acquire) & WRITER) == 0;
+    }
+
+    // 慢路径：持锁撤销加一，仍然有写者时排队；令牌已经到期时只撤销加一
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+      auto waiting = this->prepare(handle);
+      if (!_mutex.wait_shared(this, waiting)) {
+        this->disarm();
+        return false;
+      }
+      return true;
+    }
+
+    // 拿到读锁时返回成功，令牌到期时返回 ECANCELED，此时没有持有锁
+    auto await_resume() const noexcept -> expected<void> {
+      if (this->cancelled()) [[unlikely]] {
+        return std::unexpected{make_error(ECANCELED)};
+      }
+      return {};
+    }
+
+  private:
+    auto cancel() noexcept -> bool override { return _mutex.cancel_shared(this); }
+
+  private:
+    shared_mutex &_mutex;
+  };
+
+  // 写锁Awaiter
+  class Awaiter : Waiter {
+    friend shared_mutex;
+
+  public:
+    explicit Awaiter(shared_mutex &mutex) : _mutex{mutex} {}
+
+    // 快路径：没有读者也没有写者时一次 CAS 拿到写锁
+    auto await_ready() noexcept -> bool { return _mutex.try_lock(); }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+      // 令牌已经到期，不再等待
+      if (!this->prepare(handle)) {
+        return false;
+      }
+      if (!_mutex.wait(this)) {
+        this->disarm();
+        return false;
+      }
+      return true;
+    }
+
+    // 拿到写锁时返回成功，令牌到期时返回 ECANCELED，此时没有持有锁
+    auto await_resume() const noexcept -> expected<void> {
+      if (this->cancelled()) [[unlikely]] {
+        return std::unexpected{make_error(ECANCELED)};
+      }
+      return {};
+    }
+
+  private:
+    auto cancel() noexcept -> bool override { return _mutex.cancel_writer(this); }
+
+  private:
+    shared_mutex &_mutex;
+  };
+
+public:
+  shared_mutex() = default;
+  shared_mutex(const shared_mutex &) = delete;
+  shared_mutex &operator=(const shared_mutex &) = delete;
+  shared_mutex(shared_mutex &&) = delete;
+  shared_mutex &operator=(shared_mutex &&) = delete;
+
+  // 加读锁，可以使用 co_await mutex.lock_shared()
+  [[nodiscard]]
+  auto lock_shared() noexcept -> SharedAwaiter {
+    return SharedAwaiter{*this};
+  }
+
+  // 尝试加读锁，不挂起；有写者持有或等待时失败
+  [[nodiscard]]
+  auto try_lock_shared() noexcept -> bool {
+    auto state = _state.load(std::memory_order::relaxed);
+    while ((state & WRITER) == 0) {
+      if (_state.compare_exchange_weak(state, state + 1, std::memory_order::acquire,
+                                       std::memory_order::relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 解读锁：最后一个退出的读者唤醒等待的写者
+  void unlock_shared() noexcept {
+    auto prev = _state.fetch_sub(1, std::memory_order::release);
+    if ((prev & WRITER) != 0 && readers_of(prev) == 1) [[unlikely]] {
+      std::lock_guard lock{_waiters_mutex};
+      wake_draining_writer();
+    }
+  }
+
+  // 加写锁，可以使用 co_await mutex.lock()
+  [[nodiscard]]
+  auto lock() noexcept -> Awaiter {
+    return Awaiter{*this};
+  }
+
+  // 尝试加写锁，不挂起；有读者或写者时失败
+  [[nodiscard]]
+  auto try_lock() noexcept -> bool {
+    std::uint64_t state = 0;
+    return _state.compare_exchange_strong(state, WRITER, std::memory_order::acquire,
+                                          std::memory_order::relaxed);
+  }
+
+  // 解写锁：先放行所有排队的读者，再交给下一个写者
+  void unlock() noexcept {
+    std::lock_guard lock{_waiters_mutex};
+    if (!_waiting_readers.empty()) {
+      // 先把读者计入，再决定 WRITER 位：有写者排队时保留，让它等这批读者退出
+      _state.fetch_add(_waiting_readers.size(), std::memory_order::relaxed);
+      if (!_waiting_writers.empty()) {
+        _draining_writer = _waiting_writers.pop_front();
+      } else {
+        _state.fetch_and(~WRITER, std::memory_order::release);
+      }
+      wake_all(_waiting_readers);
+      return;
+    }
+    if (!_waiting_writers.empty()) {
+      // 直接交给下一个写者，WRITER 位保持不变
+      wake(_waiting_writers.pop_front());
+      return;
+    }
+    _state.fetch_and(~WRITER, std::memory_order::release);
+  }
+
+private:
+  static constexpr auto readers_of(std::uint64_t state) noexcept -> std::uint64_t {
+    return state & ~WRITER;
+  }
+
+  // 读者慢路径，返回是否挂起；waiting 为 false 时令牌已经到期，只撤销加一
+  auto wait_shared(SharedAwaiter *reader, bool waiting) noexcept -> bool {
+    std::lock_guard lock{_waiters_mutex};
+    // 撤销 await_ready 中的加一；这可能正好让等待的写者等到了最后一个读者
+    auto prev = _state.fetch_sub(1, std::memory_order::relaxed);
+    if (readers_of(prev) == 1) {
+      wake_draining_writer();
+    }
+    if (!waiting) {
+      return false;
+    }
+    auto state = _state.load(std::memory_order::relaxed);
+    while ((state & WRITER) == 0) {
+      // 期间写者已经解锁
+      if (_state.compare_exchange_weak(state, state + 1, std::memory_order::acquire,
+                                       std::memory_order::relaxed)) {
+        return false;
+      }
+    }
+    // WRITER 位只在持锁时清除，写者解锁时一定能看到这个读者
+    _waiting_readers.push_back(reader);
+    return true;
+  }
+
+  // 写者慢路径，返回是否挂起
+  auto wait(Awaiter *writer) noexcept -> bool {
+    std::lock_guard lock{_waiters_mutex};
+    auto prev = _state.fetch_or(WRITER, std::memory_order::acq_rel);
+    if ((prev & WRITER) != 0) {
+      // 已经有写者，排队
+      _waiting_writers.push_back(writer);
+      return true;
+    }
+    if (readers_of(prev) == 0) {
+      return false;
+    }
+    // 新的读者已经进不来，等持有读锁的读者退出
+    _draining_writer = writer;
+    return true;
+  }
+
+  // 令牌到期：读者还在排队时摘除，已经被唤醒时返回 false
+  auto cancel_shared(SharedAwaiter *reader) noexcept -> bool {
+    std::lock_guard lock{_waiters_mutex};
+    return _waiting_readers.remove(reader);
+  }
+
+  // 令牌到期：写者还在排队时摘除；已经置上 WRITER 位、在等读者退出时，
+  // 把 WRITER 位交给下一个写者，没有写者时清除它并放行排队的读者
+  auto cancel_writer(Awaiter *writer) noexcept -> bool {
+    std::lock_guard lock{_waiters_mutex};
+    if (_waiting_writers.remove(writer)) {
+      return true;
+    }
+    if (_draining_writer != writer) {
+      // 已经被唤醒
+      return false;
+    }
+    _draining_writer = nullptr;
+    if (!_waiting_writers.empty()) {
+      _draining_writer = _waiting_writers.pop_front();
+      wake_draining_writer();
+      return true;
+    }
+    _state.fetch_add(_waiting_readers.size(), std::memory_order::relaxed);
+    _state.fetch_and(~WRITER, std::memory_order::release);
+    wake_all(_waiting_readers);
+    return true;
+  }
+
+  // 持锁调用：读者全部退出时唤醒等待的写者。
+  // 读者数可能因为慢路径上尚未撤销的加一而暂时不为零，撤销的一方会再检查一次
+  void wake_draining_writer() noexcept {
+    if (_draining_writer != nullptr &&
+        readers_of(_state.load(std::memory_order::acquire)) == 0) {
+      wake(std::exchange(_draining_writer, nullptr));
+    }
+  }
+
+  // 恢复之后节点随时可能被销毁，先取出后继
+  static void wake_all(WaiterList &waiters) noexcept {
+    while (!waiters.empty()) {
+      wake(waiters.pop_front());
+    }
+  }
+
+  static void wake(Waiter *waiter) noexcept { waiter->resume(); }
+
+private:
+  std::atomic<std::uint64_t> _state{0}; // 读者数，最高位为 WRITER
+  std::mutex _waiters_mutex;            // 只在慢路径上保护等待链表
+  WaiterList _waiting_readers{};        // 等待写者解锁的读者
+  WaiterList _waiting_writers{};        // 等待前一个写者解锁的写者
+  Waiter *_draining_writer{nullptr};    // 已经置上 WRITER 位、等读者退出的写者
+};
+
+} // namespace faio::sync
+
+#endif // FAIO_DETAIL_SYNC_SHARED_MUTEX_HPP
@@ -0,0 +1,189 @@
+#ifndef FAIO_DETAIL_SYNC_WAIT_CANCEL_HPP
+#define FAIO_DETAIL_SYNC_WAIT_CANCEL_HPP
+
+#include "faio/detail/runtime/core/poller.hpp"
+#include "faio/detail/runtime/core/timer/timer.hpp"
+#include "faio/detail/time/cancel.hpp"
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+
+namespace faio::sync::detail {
+
+// 在 time::timeout 中等待同步原语：令牌到期时把等待者摘出等待链表，以 ECANCELED 恢复
+//
+// 嵌在 awaiter 中（作为基类），不在 time::timeout 中时只多读一次令牌，唤醒照常放入本地队列。
+// 在其中时，挂起前把令牌截止时间的节点挂到当前 worker 的时间轮上，之后两方竞争：
+//   - 令牌先到期：定时器在这个 worker 上调用 cancel()，原语把等待者摘下，
+//     之后不会再把锁、许可或值交给它，等待者以 ECANCELED 恢复
+//   - 唤醒者先摘下等待者：cancel() 返回 false，等待者照常拿到资源。
+//     节点只能由所属的 worker 摘除，唤醒者在其他线程上时经由定时器的收件箱
+//     把恢复交给所属的 worker，摘除节点之后才恢复，节点不会随协程帧一起失效
+class WaitCancel : runtime::detail::timer::TimerHandler,
+                   runtime::detail::timer::TimerReschedule {
+  using Timer = runtime::detail::timer::Timer;
+
+public:
+  /// 在 await_suspend 开头、挂入等待链表之前调用，记下句柄并挂上令牌的节点；
+  /// 令牌已经到期时返回 false，不再挂起，结果为 ECANCELED
+  template <typename Promise>
+  auto prepare(std::coroutine_handle<Promise> handle) noexcept -> bool {
+    _caller = handle;
+    _cancel_token = time::detail::cancel_token_of(handle);
+    if (_cancel_token == nullptr) [[likely]] {
+      return true;
+    }
+    if (_cancel_token->expired()) {
+      _cancel_token->mark_cancelled();
+      _cancelled = true;
+      return false;
+    }
+    _timer = runtime::detail::timer::current_timer;
+    _cancel_task = runtime::detail::timer::TimerTask{
+        _cancel_token->deadline(), static_cast<runtime::detail::timer::TimerHandler *>(this)};
+    _timer->add_task(&_cancel_task);
+    return true;
+  }
+
+  /// prepare 之后没有挂起（重试时拿到了资源）时调用，摘除令牌的节点
+  void disarm() noexcept {
+    if (_cancel_task.linked()) {
+      _timer->remove_task(&_cancel_task);
+    }
+  }
+
+  /// 是否在令牌下等待
+  [[nodiscard]]
+  auto armed() const noexcept -> bool {
+    return _cancel_token != nullptr;
+  }
+
+  /// 唤醒者摘下等待者之后调用，等待者拿到了资源
+  void resume() noexcept {
+    if (_cancel_token == nullptr) [[likely]] {
+      runtime::detail::push_task_to_local_queue(_caller);
+      return;
+    }
+    if (_timer == runtime::detail::timer::current_timer) {
+      apply(*_timer);
+      return;
+    }
+    _timer->post(this, true);
+  }
+
+  /// 是否被令牌取消
+  [[nodiscard]]
+  auto cancelled() const noexcept -> bool {
+    return _cancelled;
+  }
+
+protected:
+  WaitCancel() = default;
+  WaitCancel(WaitCancel &&) noexcept = default;
+  ~WaitCancel() = default;
+
+private:
+  /// 令牌到期时在所属 worker 上调用：把等待者摘出等待链表，唤醒者已经先摘下时返回 false
+  virtual auto cancel() noexcept -> bool = 0;
+
+  /// 节点执行或摘除之后调用，用于释放代理节点
+  virtual void settled() noexcept {}
+
+  auto on_expire() noexcept -> std::coroutine_handle<> override {
+    auto cancelled = cancel();
+    settled();
+    if (!cancelled) {
+      // 唤醒者负责恢复
+      return nullptr;
+    }
+    _cancel_token->mark_cancelled();
+    _cancelled = true;
+    return _caller;
+  }
+
+  // 唤醒者的恢复请求，在所属 worker 上执行
+  void apply(Timer &timer) noexcept override {
+    if (_cancel_task.linked()) {
+      timer.remove_task(&_cancel_task);
+      settled();
+    }
+    runtime::detail::push_task_to_local_queue(_caller);
+  }
+
+private:
+  std::coroutine_handle<> _caller{nullptr};          // 等待的协程
+  time::detail::CancelToken *_cancel_token{nullptr}; // 所在 time::timeout 的取消令牌
+  Timer *_timer{nullptr};                            // 挂着令牌节点的定时器
+  runtime::detail::timer::TimerTask _cancel_task{};  // 令牌截止时间的节点
+  bool _cancelled{false};                            // 被令牌取消
+};
+
+enum class WaitState : std::uint8_t {
+  Waiting,   // 在等待链表中
+  Woken,     // 唤醒者已经交出资源
+  Cancelled, // 令牌已经到期
+};
+
+// 无锁等待链表的代理节点
+//
+// mutex、condition_variable、semaphore 的等待链表是无锁的，不能从中间摘除节点，
+// 被取消的等待者的节点只能留在链表里，等唤醒者走到它时再跳过。
+// 节点因此不能嵌在随协程恢复而销毁的 awaiter 中：在令牌下等待时改为挂入堆上的代理节点，
+// 由唤醒者和令牌的节点各持有一份引用，唤醒者和定时器对 _state 做 CAS 决出胜者。
+// Node 需要有 bool _proxied 和 _handle 成员
+template <typename Node> struct WaitProxy final : Node {
+  explicit WaitProxy(WaitCancel &waiter) : _waiter{&waiter} { this->_proxied = true; }
+
+  /// 从 Waiting 转到 state，另一方已经先转走时返回 false
+  auto transit(WaitState state) noexcept -> bool {
+    auto expected = WaitState::Waiting;
+    return _state.compare_exchange_strong(expected, state, std::memory_order::acq_rel);
+  }
+
+  [[nodiscard]]
+  auto cancelled() const noexcept -> bool {
+    return _state.load(std::memory_order::acquire) == WaitState::Cancelled;
+  }
+
+  void release() noexcept {
+    if (_refs.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  std::atomic<WaitState> _state{WaitState::Waiting};
+  std::atomic<int> _refs{2}; // 唤醒者和令牌的节点各一份
+  WaitCancel *_waiter;       // 等待者的 awaiter，只在唤醒者胜出时访问
+};
+
+/// 唤醒者摘下节点之后调用，恢复等待者并返回 true；
+/// 等待者已经被令牌取消时返回 false，资源不能交给它
+template <typename Node> auto wake_node(Node *node) noexcept -> bool {
+  if (!node->_proxied) [[likely]] {
+    runtime::detail::push_task_to_local_queue(node->_handle);
+    return true;
+  }
+  auto proxy = static_cast<WaitProxy<Node> *>(node);
+  auto woken = proxy->transit(WaitState::Woken);
+  if (woken) {
+    proxy->_waiter->resume();
+  }
+  proxy->release();
+  return woken;
+}
+
+/// 节点是否属于已经被取消的等待者
+template <typename Node> auto cancelled_node(Node *node) noexcept -> bool {
+  return node->_proxied && static_cast<WaitProxy<Node> *>(node)->cancelled();
+}
+
+/// 原语销毁时释放链表中剩下的节点，只可能是被取消的等待者留下的代理
+template <typename Node> void drop_node(Node *node) noexcept {
+  if (node->_proxied) {
+    static_cast<WaitProxy<Node> *>(node)->release();
+  }
+}
+
+} // namespace faio::sync::detail
+
+#endif // FAIO_DETAIL_SYNC_WAIT_CANCEL_HPP
@@ -0,0 +1,147 @@
+#ifndef FAIO_DETAIL_TIME_CANCEL_HPP
+#define FAIO_DETAIL_TIME_CANCEL_HPP
+
+#include "faio/detail/io/uring/io_uring.hpp"
+#include "faio/detail/io/uring/io_user_data.hpp"
+#include "faio/detail/runtime/core/timer/timer.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <liburing.h>
+#include <memory>
+#include <vector>
+
+namespace faio::time::detail {
+// 取消令牌：time::timeout 为被限时的任务创建，记录整个任务的截止时间
+//
+// 令牌挂在任务的 promise 上，co_await 子任务时沿调用链传下去（见 task.hpp）。
+// awaiter 在 await_suspend 中通过调用者的句柄取出令牌：IO 提交时把令牌的节点
+// 挂到当前 worker 的时间轮，到期后在提交 IO 的 worker 上取消，不需要跨线程操作 io_uring；
+// 截止时间已经过去时 IO 不再提交，直接以 -ECANCELED 返回；sleep 的唤醒时间不晚于截止时间。
+// 每个在途的 IO 占用一个节点：通常只有一个，内嵌在令牌里依次复用；
+// 一个 awaiter 同时提交多个 IO 时按需在堆上追加，随令牌释放。
+// 等待被截止时间截断时记下标志，time::timeout 据此区分任务是否被打断
+class CancelToken {
+  // 在途 IO 的定时器节点：到期时记下令牌截断了等待，
+  // 还在等待 sqe 的请求直接摘除，已经提交的请求取消，都以 -ECANCELED 返回
+  struct IoNode final : runtime::detail::timer::TimerHandler {
+    auto on_expire() noexcept -> std::coroutine_handle<> override {
+      token->mark_cancelled();
+      user_data->timer_task = nullptr;
+      auto uring = io::detail::current_uring;
+      if (uring->unpark(user_data)) {
+        user_data->result = -ECANCELED;
+        return user_data->handle;
+      }
+      auto sqe = uring->get_detached_sqe();
+      io_uring_prep_cancel(sqe, user_data, 0);
+      io_uring_sqe_set_data(sqe, nullptr);
+      return nullptr;
+    }
+
+    CancelToken *token{nullptr};
+    io::detail::io_user_data_t *user_data{nullptr};
+    runtime::detail::timer::TimerTask task{};
+  };
+
+public:
+  explicit CancelToken(std::chrono::steady_clock::time_point deadline)
+      : _deadline(deadline) {
+    _io_node.token = this;
+  }
+
+  // IO 等待期间节点挂在时间轮上，地址不能改变
+  CancelToken(const CancelToken &) = delete;
+  CancelToken &operator=(const CancelToken &) = delete;
+
+public:
+  /// 截止时间
+  [[nodiscard]]
+  auto deadline() const noexcept -> std::chrono::steady_clock::time_point {
+    return _deadline;
+  }
+
+  /// 截止时间是否已经过去
+  [[nodiscard]]
+  auto expired() const noexcept -> bool {
+    return _deadline <= std::chrono::steady_clock::now();
+  }
+
+  /// 截止时间截断了任务中的一次等待（IO 被取消或不再提交、sleep 提前醒来、
+  /// 同步原语的等待被摘除）时调用
+  void mark_cancelled() noexcept {
+    _cancelled.store(true, std::memory_order::relaxed);
+  }
+
+  /// 任务中是否有等待被截止时间截断
+  [[nodiscard]]
+  auto cancelled() const noexcept -> bool {
+    return _cancelled.load(std::memory_order::relaxed);
+  }
+
+  /// IO 提交时调用，到期时取消 user_data 对应的请求；
+  /// IO 先完成时 drive 通过 user_data.timer_task 摘除节点
+  void arm(io::detail::io_user_data_t &user_data) noexcept {
+    auto node = idle_node();
+    node->user_data = &user_data;
+    node->task = runtime::detail::timer::TimerTask{
+        _deadline, static_cast<runtime::detail::timer::TimerHandler *>(node)};
+    runtime::detail::timer::current_timer->add_task(&node->task);
+    user_data.deadline = _deadline;
+    user_data.timer_task = &node->task;
+  }
+
+private:
+  // 取一个没有挂在时间轮上的节点，内嵌的节点被占用时复用或追加堆上的节点
+  auto idle_node() -> IoNode * {
+    if (!_io_node.task.linked()) [[likely]] {
+      return &_io_node;
+    }
+    for (auto &node : _more_nodes) {
+      if (!node->task.linked()) {
+        return node.get();
+      }
+    }
+    auto &node = _more_nodes.emplace_back(std::make_unique<IoNode>());
+    node->token = this;
+    return node.get();
+  }
+
+private:
+  std::chrono::steady_clock::time_point _deadline;
+  std::atomic<bool> _cancelled{false};             // 有等待被截止时间截断
+  IoNode _io_node{};                               // 在途 IO 的定时器节点
+  std::vector<std::unique_ptr<IoNode>> _more_nodes; // 同时在途的其余 IO 的节点
+};
+
+/// 调用者所在 time::timeout 的取消令牌，不在其中或调用者不是任务时为空
+template <typename Promise>
+auto cancel_token_of(std::coroutine_handle<Promise> caller) noexcept
+    -> CancelToken * {
+  if constexpr (requires { caller.promise()._cancel_token; }) {
+    return caller.promise()._cancel_token;
+  } else {
+    return nullptr;
+  }
+}
+
+// 取出当前任务的取消令牌，不会挂起
+class CurrentCancelToken {
+public:
+  constexpr auto await_ready() const noexcept -> bool { return false; }
+
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> caller) noexcept -> bool {
+    _token = cancel_token_of(caller);
+    return false;
+  }
+
+  auto await_resume() const noexcept -> CancelToken * { return _token; }
+
+private:
+  CancelToken *_token{nullptr};
+};
+} // namespace faio::time::detail
+
+#endif // FAIO_DETAIL_TIME_CANCEL_HPP
@@ -0,0 +1,172 @@
+#ifndef FAIO_DETAIL_TIME_DEADLINE_HPP
+#define FAIO_DETAIL_TIME_DEADLINE_HPP
+
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/runtime/core/timer/timer.hpp"
+#include "faio/detail/time/cancel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+
+namespace faio::time::detail {
+// 可以反复修改的截止时间，持有自己的定时器节点
+//
+// 典型用法是保活连接的空闲超时：一个任务 co_await 截止时间，
+// 处理请求时调用 reset 延长。等待期间延长只是一次赋值，节点留在原位置，
+// 到期时定时器发现截止时间已经推迟，再挂到新的位置；提前时才立即重新挂入。
+//
+// reset 可以在任意线程上调用。节点挂在等待方所在 worker 的时间轮上，只能由那个 worker 修改：
+// 在其他线程上调用时截止时间原子地写入，再把改期请求投递到那个 worker 的定时器，
+// 它在下一次 poll 开头处理；截止时间提前时同时唤醒它，不会等到原来的到期时间。
+// 投递的请求还没处理时节点可能按旧的时间到期，到期时再读一次最新的截止时间，
+// 已经推迟就重新挂入，不恢复等待方；恢复之后的 reset 只影响下一次等待
+class Deadline : runtime::detail::timer::TimerReschedule,
+                 runtime::detail::timer::TimerHandler {
+  using Timer = runtime::detail::timer::Timer;
+  using time_point = std::chrono::steady_clock::time_point;
+
+public:
+  explicit Deadline(time_point deadline) : _deadline(deadline) {}
+
+  ~Deadline() { retract(); }
+
+  // 节点挂在时间轮上时地址不能改变
+  Deadline(const Deadline &) = delete;
+  Deadline &operator=(const Deadline &) = delete;
+
+public:
+  /// 当前的截止时间
+  [[nodiscard]]
+  auto deadline() const noexcept -> time_point {
+    return _deadline.load();
+  }
+
+  /// 截止时间是否已经过去
+  [[nodiscard]]
+  auto expired() const noexcept -> bool {
+    return deadline() <= std::chrono::steady_clock::now();
+  }
+
+  /// 修改截止时间到 deadline
+  void reset(time_point deadline) noexcept {
+    auto prev = _deadline.exchange(deadline);
+    auto owner = _owner.load();
+    if (owner == nullptr) {
+      return;
+    }
+    if (owner == runtime::detail::timer::current_timer) {
+      reschedule(*owner);
+      return;
+    }
+    // 已经投递过、尚未处理时不再重复投递，处理时读取最新的截止时间；
+    // 上一次投递到了之前等待所在的 worker 时，再投递给现在的
+    const auto earlier = deadline < prev;
+    _posted.store(true);
+    Timer *posted = nullptr;
+    if (_posted_to.compare_exchange_strong(posted, owner) || posted != owner) {
+      owner->post(this, earlier);
+    } else if (earlier) {
+      owner->wake();
+    }
+  }
+
+  /// 修改截止时间到 after 之后
+  void reset_after(std::chrono::nanoseconds after) noexcept {
+    reset(std::chrono::steady_clock::now() + after);
+  }
+
+  /// 截止时间已经过去时无需挂起
+  auto await_ready() const noexcept -> bool { return expired(); }
+
+  /// 挂起到截止时间，期间的 reset 都会生效
+  /// 在 time::timeout 中时不晚于令牌的截止时间唤醒，截止时间已经过去时不挂起
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+    _token = cancel_token_of(handle);
+    _limit = time_point::max();
+    if (_token != nullptr) [[unlikely]] {
+      if (_token->expired()) {
+        _token->mark_cancelled();
+        return false;
+      }
+      _limit = _token->deadline();
+    }
+    // 上一次在其他 worker 上等待时投递的改期请求不能留到节点挂入本 worker 之后
+    retract();
+    auto timer = runtime::detail::timer::current_timer;
+    _handle = handle;
+    _task = runtime::detail::timer::TimerTask{
+        std::min(deadline(), _limit), static_cast<runtime::detail::timer::TimerHandler *>(this)};
+    timer->add_task(&_task);
+    _owner.store(timer);
+    // 挂入之前其他线程的 reset 可能没有看到 owner，再检查一次
+    reschedule(*timer);
+    return true;
+  }
+
+  /// 截止时间到达时成功；time::timeout 的截止时间先到时返回 ECANCELED
+  auto await_resume() const noexcept -> expected<void> {
+    if (_token != nullptr && _token->expired() && !expired()) [[unlikely]] {
+      _token->mark_cancelled();
+      return std::unexpected{make_error(ECANCELED)};
+    }
+    return {};
+  }
+
+private:
+  // 节点到期：其他线程推迟了截止时间、改期请求还没处理时重新挂入
+  auto on_expire() noexcept -> std::coroutine_handle<> override {
+    if (auto deadline = std::min(this->deadline(), _limit); deadline > _task._deadline) {
+      _task._deadline = deadline;
+      runtime::detail::timer::current_timer->add_task(&_task);
+      return nullptr;
+    }
+    return _handle;
+  }
+
+  // 处理投递的改期请求
+  void apply(Timer &timer) noexcept override {
+    auto posted = &timer;
+    _posted_to.compare_exchange_strong(posted, nullptr);
+    if (_owner.load() == &timer) {
+      reschedule(timer);
+    }
+  }
+
+  // 在所属 worker 上把节点改到最新的截止时间
+  void reschedule(Timer &timer) noexcept {
+    if (auto deadline = std::min(this->deadline(), _limit);
+        _task.linked() && deadline != _task._deadline) {
+      timer.reset_task(&_task, deadline);
+    }
+  }
+
+  // 撤回尚未处理的改期请求：投递过的目标只可能是记录的 _posted_to 和最近一次等待所在的 worker
+  void retract() noexcept {
+    if (!_posted.exchange(false)) [[likely]] {
+      return;
+    }
+    auto owner = _owner.load();
+    if (owner != nullptr) {
+      owner->retract(this);
+    }
+    if (auto posted = _posted_to.exchange(nullptr); posted != nullptr && posted != owner) {
+      posted->retract(this);
+    }
+  }
+
+private:
+  std::atomic<time_point> _deadline;
+  std::atomic<Timer *> _owner{nullptr};     // 最近一次等待所在 worker 的定时器
+  std::atomic<Timer *> _posted_to{nullptr}; // 改期请求投递到的定时器，尚未处理
+  std::atomic<bool> _posted{false};         // 投递过改期请求，撤回时需要加锁检查
+  time_point _limit{time_point::max()};     // 令牌的截止时间，节点不晚于它到期
+  CancelToken *_token{nullptr};             // 等待所在 time::timeout 的取消令牌
+  std::coroutine_handle<> _handle{nullptr}; // 等待的协程
+  runtime::detail::timer::TimerTask _task{}; // 定时器节点，等待期间挂在时间轮上
+};
+} // namespace faio::time::detail
+
+#endif // FAIO_DETAIL_TIME_DEADLINE_HPP
@@ -1,9 +1,14 @@
 #ifndef FAIO_DETAIL_TIME_SLEEP_HPP
 #define FAIO_DETAIL_TIME_SLEEP_HPP
 
+#include "faio/detail/common/error.hpp"
 #include "faio/detail/runtime/core/timer/timer.hpp"
+#include "faio/detail/time/cancel.hpp"
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <coroutine>
+#include <utility>
 
 namespace faio::time::detail {
 class Sleep {
@@ -17,21 +22,50 @@ public:
     return _deadline;
   }
 
+  /// 允许推迟 slack 唤醒，与相近的定时器合并到期，减少 worker 的唤醒次数
+  /// 适合空闲超时、心跳之类不要求精确时间的场景
+  auto with_slack(std::chrono::nanoseconds slack) && noexcept -> Sleep && {
+    _slack = slack;
+    return std::move(*this);
+  }
+
   /// 如果 deadline 已经过期或恰好到期，则无需挂起
   auto await_ready() const noexcept -> bool {
     return _deadline <= std::chrono::steady_clock::now();
   }
 
   /// 将协程注册到定时器，在 deadline 到达时恢复
-  auto await_suspend(std::coroutine_handle<> handle) noexcept -> void {
-    runtime::detail::timer::current_timer->add_task(_deadline, handle);
+  /// 在 time::timeout 中时不晚于令牌的截止时间唤醒，截止时间已经过去时不挂起
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool {
+    auto wake_at = _deadline;
+    if (_token = cancel_token_of(handle); _token != nullptr) [[unlikely]] {
+      if (_token->expired()) {
+        _token->mark_cancelled();
+        return false;
+      }
+      wake_at = std::min(wake_at, _token->deadline());
+    }
+    _task = runtime::detail::timer::TimerTask{wake_at, handle};
+    runtime::detail::timer::current_timer->add_task(&_task, _slack);
+    return true;
   }
 
-  /// sleep 正常唤醒，始终返回成功
-  auto await_resume() const noexcept -> void {}
+  /// 睡满时返回成功；令牌先于 deadline 到期时返回 ECANCELED，
+  /// 在 time::timeout 中反复 sleep 的循环据此退出，不会在到期之后空转
+  auto await_resume() const noexcept -> expected<void> {
+    if (_token != nullptr && _token->deadline() < _deadline) [[unlikely]] {
+      _token->mark_cancelled();
+      return std::unexpected{make_error(ECANCELED)};
+    }
+    return {};
+  }
 
 private:
   std::chrono::steady_clock::time_point _deadline;
+  CancelToken *_token{nullptr};       // 所在 time::timeout 的取消令牌
+  std::chrono::nanoseconds _slack{0}; // 允许推迟唤醒的时长
+  runtime::detail::timer::TimerTask _task{}; // 定时器节点，随协程帧存活
 };
 } // namespace faio::time::detail
 
@@ -1,25 +1,108 @@
 #ifndef FAIO_DETAIL_TIME_TIME_HPP
 #define FAIO_DETAIL_TIME_TIME_HPP
 
+#include "faio/detail/common/concepts.hpp"
+#include "faio/detail/common/error.hpp"
+#include "faio/detail/coroutine/task.hpp"
+#include "faio/detail/time/cancel.hpp"
+#include "faio/detail/time/deadline.hpp"
 #include "faio/detail/time/interval.hpp"
 #include "faio/detail/time/sleep.hpp"
 #include "faio/detail/time/timeout.hpp"
+#include <algorithm>
 #include <chrono>
+#include <type_traits>
+
+namespace faio::time::detail {
+// 把任意 awaiter 包装成任务，交给 time::timeout
+template <class A>
+auto into_task(A awaitable)
+    -> task<std::remove_cvref_t<decltype(awaitable.await_resume())>> {
+  co_return co_await std::move(awaitable);
+}
+
+// 任务的结果是否表示成功：expected、optional 看是否有值，其他类型无从判断
+template <typename T> auto succeeded(const T &value) noexcept -> bool {
+  if constexpr (requires { value.has_value(); }) {
+    return value.has_value();
+  } else {
+    return false;
+  }
+}
+} // namespace faio::time::detail
 
 namespace faio::time {
 
 /// 为 IO 操作设置绝对时间点超时
+/// slack 为允许推迟到期的时长，相近的超时合并到期，减少 worker 的唤醒次数
 template <class T>
   requires std::derived_from<T, io::detail::IORegistrantAwaiter<T>>
-auto timeout_at(T &&io, std::chrono::steady_clock::time_point deadline) {
-  return io.set_timeout_at(deadline);
+auto timeout_at(T &&io, std::chrono::steady_clock::time_point deadline,
+                std::chrono::nanoseconds slack = {}) {
+  return io.set_timeout_at(deadline, slack);
 }
 
 /// 为 IO 操作设置相对时间超时
 template <class T>
   requires std::derived_from<T, io::detail::IORegistrantAwaiter<T>>
-auto timeout(T &&io, std::chrono::milliseconds interval) {
-  return io.set_timeout(interval);
+auto timeout(T &&io, std::chrono::milliseconds interval,
+             std::chrono::nanoseconds slack = {}) {
+  return io.set_timeout(interval, slack);
+}
+
+/// 给整个任务加上截止时间，返回任务的结果；截止时间截断了任务中的等待、
+/// 任务又没有成功完成时返回 Error::TimedOut
+///
+/// 任务及其 co_await 的子任务共享一个取消令牌：截止时间到达时在途的 IO
+/// 在提交它的 worker 上被取消（以 -ECANCELED 返回），之后的 IO 不再提交，
+/// sleep 提前唤醒。任务总是运行到结束，不会留下悬空的协程帧；
+/// 等待锁、信号量、条件变量、通道的协程被摘出等待队列，同样以 ECANCELED 返回。
+/// 嵌套时以较早的截止时间为准。
+///
+/// 任务在截止时间之后才结束、但没有被截断（或者截断之后仍然返回了值）时返回任务的结果。
+///
+/// 只有读取令牌的等待会被截断，下面这些等待不会超时，截止时间过后仍然等到结束：
+///   - spawn 出去的任务（不继承截止时间）以及等待它们结束的 join
+///   - multishot 的 recv_stream、copy_bidirectional 内部的 join 等自行管理完成的等待
+///   - 不读取令牌的第三方 awaiter
+/// 需要限时时在它们内部逐个 IO 使用 timeout，或者让被等待的一方自己加上截止时间
+template <typename T>
+auto timeout_at(std::chrono::steady_clock::time_point deadline, task<T> inner)
+    -> task<expected<T>> {
+  if (auto outer = co_await detail::CurrentCancelToken{}; outer != nullptr) {
+    deadline = std::min(deadline, outer->deadline());
+  }
+  detail::CancelToken token{deadline};
+  inner.handle().promise()._cancel_token = &token;
+  if constexpr (std::is_void_v<T>) {
+    co_await std::move(inner);
+    if (token.cancelled()) {
+      co_return std::unexpected{make_error(Error::TimedOut)};
+    }
+    co_return expected<void>{};
+  } else {
+    auto value = co_await std::move(inner);
+    if (token.cancelled() && !detail::succeeded(value)) {
+      co_return std::unexpected{make_error(Error::TimedOut)};
+    }
+    co_return std::move(value);
+  }
+}
+
+/// 给整个任务加上相对时间的截止时间，见 timeout_at
+template <typename T>
+auto timeout(std::chrono::nanoseconds duration, task<T> inner)
+    -> task<expected<T>> {
+  return timeout_at(std::chrono::steady_clock::now() + duration,
+                    std::move(inner));
+}
+
+/// 给任意 awaiter 加上截止时间，awaiter 在包装出的任务中等待，规则同 timeout_at；
+/// awaiter 不读取令牌时不会被截断
+template <class A>
+  requires is_awaiter<A>
+auto timeout(std::chrono::nanoseconds duration, A awaitable) {
+  return timeout(duration, detail::into_task(std::move(awaitable)));
 }
 
 /// 挂起当前协程指定时长
@@ -38,6 +121,14 @@ sleep_until(std::chrono::steady_clock::time_point expired_time) {
   return detail::Sleep{expired_time};
 }
 
+/// 可以反复延长的截止时间，见 detail::Deadline
+using Deadline = detail::Deadline;
+
+/// 创建一个在 after 之后到期的截止时间
+static inline auto deadline_after(std::chrono::nanoseconds after) {
+  return detail::Deadline{std::chrono::steady_clock::now() + after};
+}
+
 /// 创建一个周期性定时器，首次 tick 在一个 period 之后触发
 static inline auto interval(std::chrono::nanoseconds period) {
   return detail::Interval{std::chrono::steady_clock::now(), period};
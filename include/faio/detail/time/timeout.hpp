@@ -1,9 +1,15 @@
 #ifndef FAIO_DETAIL_TIME_TIMEOUT_HPP
 #define FAIO_DETAIL_TIME_TIMEOUT_HPP
 
+#include "faio/detail/io/uring/io_uring.hpp"
 #include "faio/detail/runtime/core/timer/timer.hpp"
+#include "faio/detail/time/cancel.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
 #include <coroutine>
+#include <liburing.h>
 
 namespace faio::io::detail {
 template <class T> class IORegistrantAwaiter;
@@ -14,19 +20,128 @@ template <class T>
   requires std::derived_from<T, io::detail::IORegistrantAwaiter<T>>
 class Timeout : public T {
 public:
-  Timeout(T &&io) : T{std::move(io)} {}
+  Timeout(T &&io, std::chrono::nanoseconds slack = {})
+      : T{std::move(io)}, _slack{slack} {}
 
 public:
-  auto await_suspend(std::coroutine_handle<> handle) -> bool {
-    // 将定时器任务注册到当前 worker 的 Timer 中
-    // add_task 返回 TimerTask* 裸指针（Timer 拥有所有权）
-    auto *timer_task = runtime::detail::timer::current_timer->add_task(
-        this->_user_data.deadline, &this->_user_data);
-    this->_user_data.timer_task = timer_task;
-    T::await_suspend(handle);
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) -> bool {
+    // 在 time::timeout 中时不晚于令牌的截止时间，仍然由自己的节点计时
+    if (_token = cancel_token_of(handle); _token != nullptr) [[unlikely]] {
+      _token_first = _token->deadline() < this->_user_data.deadline;
+      this->_user_data.deadline =
+          std::min(this->_user_data.deadline, _token->deadline());
+    }
+    // 配置了内核计时并且可以链接时，不再占用时间轮；
+    // IO 和超时各有一个 CQE，两个都到了才恢复协程
+    _linked = io::detail::current_uring->link_timeout_enabled() && link_timeout();
+    if (_linked) {
+      _group.handle = handle;
+      _group.pending = 2;
+      this->_user_data.group = &_group;
+      _timeout_data.group = &_group;
+    } else {
+      // 将嵌入的定时器节点注册到当前 worker 的 Timer 中，
+      // IO 先完成时 drive 通过 _user_data.timer_task 摘除
+      _timer_task = runtime::detail::timer::TimerTask{this->_user_data.deadline,
+                                                      &this->_user_data};
+      runtime::detail::timer::current_timer->add_task(&_timer_task, _slack);
+      this->_user_data.timer_task = &_timer_task;
+    }
+    // 句柄原样交给被包装的 IO，它据此看到令牌（已经计时的 IO 不再挂令牌的节点）。
+    // IO 不挂起（令牌已经到期、建连时创建 socket 失败）时没有 CQE 会到来，撤掉超时
+    if (!T::await_suspend(handle)) [[unlikely]] {
+      disarm();
+      return false;
+    }
     return true;
   }
+
+  /// 超时后 IO 以 -ECANCELED 完成，转换成 -ETIMEDOUT。
+  /// 只转换自己的超时触发的取消：cancel_fd、关闭 fd 造成的取消仍然返回 -ECANCELED；
+  /// 截止时间取的是 time::timeout 令牌的截止时间时，返回 -ECANCELED 并记在令牌上
+  auto await_resume() noexcept -> decltype(auto) {
+    auto &result = this->_user_data.result;
+    if ((result == -ECANCELED || result == -ETIMEDOUT) && fired()) {
+      if (_token_first) {
+        _token->mark_cancelled();
+        result = -ECANCELED;
+      } else {
+        result = -ETIMEDOUT;
+      }
+    }
+    return T::await_resume();
+  }
+
+private:
+  /// 时间轮节点到期时由定时器记下标志；内核计时时看超时的 CQE，
+  /// -ETIME 表示计时器到期取消了 IO，IO 先完成时为 -ECANCELED
+  [[nodiscard]] auto fired() const noexcept -> bool {
+    if (_linked) {
+      return _timeout_data.result == -ETIME;
+    }
+    return this->_user_data.timed_out;
+  }
+
+  /// 撤掉还没有交给内核的超时：链接的超时改成 nop，时间轮节点摘除
+  void disarm() noexcept {
+    if (_linked) {
+      this->_sqe->flags &= ~IOSQE_IO_LINK;
+      io_uring_prep_nop(_link_sqe);
+      io_uring_sqe_set_data(_link_sqe, nullptr);
+      this->_user_data.group = nullptr;
+      return;
+    }
+    runtime::detail::timer::current_timer->remove_task(&_timer_task);
+    this->_user_data.timer_task = nullptr;
+  }
+
+  /// 在 IO 后面紧跟一个 IORING_OP_LINK_TIMEOUT，由内核负责到期取消
+  /// IO 的 sqe 必须是提交队列里最后一个未提交的 sqe，且后面还有空位，
+  /// 否则链接不成立，返回 false 退回时间轮
+  auto link_timeout() noexcept -> bool {
+    auto uring = io::detail::current_uring;
+    if (!uring->is_last_sqe(this->_sqe)) {
+      return false;
+    }
+    auto sqe = uring->try_get_sqe();
+    if (sqe == nullptr) {
+      return false;
+    }
+    // steady_clock 即 CLOCK_MONOTONIC，使用绝对时间避免换算误差
+    auto since_epoch = this->_user_data.deadline.time_since_epoch();
+    auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    _ts.tv_sec = secs.count();
+    _ts.tv_nsec =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - secs)
+            .count();
+    this->_sqe->flags |= IOSQE_IO_LINK;
+    io_uring_prep_link_timeout(sqe, &_ts, IORING_TIMEOUT_ABS);
+    io_uring_sqe_set_data(sqe, &_timeout_data);
+    _link_sqe = sqe;
+    return true;
+  }
+
+private:
+  // 内核在提交时拷贝，只需要活到提交之后
+  struct __kernel_timespec _ts{};
+  // 时间轮超时允许推迟的时长，内核计时时不使用
+  std::chrono::nanoseconds _slack{0};
+  // 时间轮超时的定时器节点，随协程帧存活
+  runtime::detail::timer::TimerTask _timer_task{};
+  // 内核计时时 IO 和超时组成的组，最后一个 CQE 恢复协程
+  io::detail::io_user_data_t _group{};
+  // 超时的 CQE，结果为 -ETIME 时是超时触发的取消
+  io::detail::io_user_data_t _timeout_data{};
+  // 链接的超时的 sqe，IO 不挂起时改成 nop；刷新之前有效
+  io_uring_sqe *_link_sqe{nullptr};
+  // 所在 time::timeout 的取消令牌
+  CancelToken *_token{nullptr};
+  // 是否链接了内核计时
+  bool _linked{false};
+  // time::timeout 令牌的截止时间早于自己的超时
+  bool _token_first{false};
 };
 } // namespace faio::time::detail
 
-#endif // FAIO_DETAIL_TIME_TIMEOUT_HPP
\ No newline at end of file
+#endif // FAIO_DETAIL_TIME_TIMEOUT_HPP
@@ -1,5 +1,6 @@
 #ifndef FAIO_FAIO_HPP
 #define FAIO_FAIO_HPP
+#include "faio/detail/fs.hpp"
 #include "faio/detail/io.hpp"
 #include "faio/detail/net.hpp"
 #include "faio/detail/runtime/context.hpp"
@@ -10,6 +11,11 @@
 namespace faio {
 
 using runtime_context = runtime::detail::runtime_context;
+using TimeoutBackend = runtime::detail::TimeoutBackend;
+using SubmitPolicy = runtime::detail::SubmitPolicy;
+using IOBackend = runtime::detail::IOBackend;
+using RuntimeMetrics = runtime::detail::RuntimeMetrics;
+using LatencyHistogram = runtime::detail::LatencyHistogram;
 
 // spawn: 轻量提交协程
 template <typename T> inline void spawn(task<T> &&t) {
@@ -60,6 +66,79 @@ public:
     return *this;
   }
 
+  ConfigBuilder &
+  set_timeout_backend(runtime::detail::TimeoutBackend timeout_backend) {
+    _config._timeout_backend = timeout_backend;
+    return *this;
+  }
+
+  ConfigBuilder &
+  set_submit_policy(runtime::detail::SubmitPolicy submit_policy) {
+    _config._submit_policy = submit_policy;
+    return *this;
+  }
+
+  /// IO 后端，默认 Auto：io_uring 创建失败时退化为 epoll
+  ConfigBuilder &set_io_backend(runtime::detail::IOBackend io_backend) {
+    _config._io_backend = io_backend;
+    return *this;
+  }
+
+  ConfigBuilder &set_fixed_buffer_size(std::size_t fixed_buffer_size) {
+    _config._fixed_buffer_size = fixed_buffer_size;
+    return *this;
+  }
+
+  /// 是否让所有worker的ring共享第一个ring的io-wq（IORING_SETUP_ATTACH_WQ）
+  ConfigBuilder &set_share_iowq(bool share_iowq) {
+    _config._share_iowq = share_iowq;
+    return *this;
+  }
+
+  /// io-wq 线程上限：bounded 用于文件等有界请求，unbounded 用于 socket 等
+  /// 可能无限阻塞的请求；0 表示保持内核默认值
+  ConfigBuilder &set_iowq_max_workers(uint32_t bounded, uint32_t unbounded) {
+    _config._iowq_max_bounded = bounded;
+    _config._iowq_max_unbounded = unbounded;
+    return *this;
+  }
+
+  /// io-wq 线程的CPU亲和性，第i个worker的io-wq绑定到 cpus[i % cpus.size()]
+  ConfigBuilder &set_iowq_cpus(std::vector<std::size_t> cpus) {
+    _config._iowq_cpus = std::move(cpus);
+    return *this;
+  }
+
+  /// 在每个worker的ring上注册 NAPI 忙轮询（6.9+ 内核）
+  /// 等待完成事件时先在内核中忙轮询网卡队列 timeout 再休眠，用CPU换尾延迟；
+  /// prefer_busy_poll 为true时忙轮询期间推迟网卡中断。内核不支持时输出warn并忽略
+  ConfigBuilder &set_napi_busy_poll(std::chrono::microseconds timeout,
+                                    bool prefer_busy_poll = false) {
+    _config._napi_busy_poll_us = static_cast<uint32_t>(timeout.count());
+    _config._napi_prefer_busy_poll = prefer_busy_poll;
+    return *this;
+  }
+
+  /// worker 没有任务时先自旋 window 再休眠；开启 NAPI 时自旋期间忙轮询网卡队列
+  ConfigBuilder &set_spin_window(std::chrono::microseconds window) {
+    _config._spin_window_us = static_cast<uint32_t>(window.count());
+    return *this;
+  }
+
+  /// 定时器时间轮的基本 tick，默认 1ms；sleep 和时间轮超时按 tick 向上取整到期
+  /// 调小到 50us、100us 可以得到亚毫秒精度的 sleep，代价是级联更频繁、最远范围按比例缩短
+  ConfigBuilder &set_timer_tick(std::chrono::microseconds tick) {
+    _config._timer_tick_us = static_cast<uint32_t>(std::max<std::int64_t>(tick.count(), 1));
+    return *this;
+  }
+
+  /// 按 opcode 统计请求的内核延迟（提交 → 收割到 CQE）和调度延迟（CQE → 协程恢复），
+  /// 通过 runtime_context::metrics() 读取；关闭时只多一次分支判断
+  ConfigBuilder &set_latency_tracing(bool enabled) {
+    _config._latency_tracing = enabled;
+    return *this;
+  }
+
   runtime::detail::Config build() { return _config; }
 
 private:
@@ -26,6 +26,7 @@ using detail::http::HttpErrorHandler;
 using detail::http::HttpMiddleware;
 using detail::http::HttpMiddlewareResult;
 using detail::http::HttpRouter;
+using detail::http::limit_concurrency;
 using detail::http::HttpServer;
 
 } // namespace faio::http
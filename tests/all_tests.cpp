@@ -2,3 +2,4 @@
 #include "test_sync_primitives.cpp"
 #include "test_time_and_net.cpp"
 #include "test_http_router.cpp"
+#include "test_fs.cpp"
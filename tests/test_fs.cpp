@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "faio/faio.hpp"
+
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+auto temp_path(const char* name) -> std::string {
+  return std::string{"/tmp/faio_test_fs_"} + std::to_string(::getpid()) + "_" + name;
+}
+
+auto write_then_read(std::string path) -> faio::task<bool> {
+  std::string content(100000, 'x');
+  for (std::size_t i = 0; i < content.size(); i += 97) {
+    content[i] = static_cast<char>('a' + i % 26);
+  }
+  if (!co_await faio::fs::write(path, content)) {
+    co_return false;
+  }
+  auto meta = co_await faio::fs::metadata(path);
+  if (!meta || meta.value().size() != content.size() || !meta.value().is_file()) {
+    co_return false;
+  }
+  auto whole = co_await faio::fs::read(path);
+  co_return whole && whole.value() == content;
+}
+
+auto positional_io(std::string path) -> faio::task<bool> {
+  auto file = co_await faio::fs::File::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (!file) {
+    co_return false;
+  }
+  auto& f = file.value();
+  if (!co_await f.write_all_at(std::string_view{"world"}, 5) || !co_await f.write_all_at(std::string_view{"hello"}, 0)) {
+    co_return false;
+  }
+  char buf[10]{};
+  if (!co_await f.read_exact_at(buf, 0) || std::string_view{buf, 10} != "helloworld") {
+    co_return false;
+  }
+  // 读越过文件末尾
+  auto eof = co_await f.read_exact_at(buf, 5);
+  if (eof || eof.error().value() != faio::Error::UnexpectedEOF) {
+    co_return false;
+  }
+  if (!co_await f.set_len(4) || !co_await f.sync_data()) {
+    co_return false;
+  }
+  auto rest = co_await f.read_to_end();
+  co_return rest && rest.value() == "hell" && co_await f.close();
+}
+
+auto small_file_chain(std::string path, std::string moved) -> faio::task<bool> {
+  if (!co_await faio::fs::write(path, "small file")) {
+    co_return false;
+  }
+  auto small = co_await faio::fs::read_small(path);
+  // 超过 max_size 时退化为完整读取
+  auto truncated = co_await faio::fs::read_small(path, 4);
+  if (!small || small.value() != "small file" || !truncated ||
+      truncated.value() != "small file") {
+    co_return false;
+  }
+  if (!co_await faio::fs::rename(path, moved)) {
+    co_return false;
+  }
+  auto missing = co_await faio::fs::read_small(path);
+  if (missing || missing.error().value() != ENOENT) {
+    co_return false;
+  }
+  co_return co_await faio::fs::remove_file(moved) &&
+      !co_await faio::fs::metadata(moved);
+}
+
+}  // namespace
+
+TEST(FsTest, WriteThenReadWholeFile) {
+  faio::runtime_context ctx;
+  auto path = temp_path("whole");
+  EXPECT_TRUE(faio::block_on(ctx, write_then_read(path)));
+  ::unlink(path.c_str());
+}
+
+TEST(FsTest, PositionalReadWriteAndTruncate) {
+  faio::runtime_context ctx;
+  auto path = temp_path("positional");
+  EXPECT_TRUE(faio::block_on(ctx, positional_io(path)));
+  ::unlink(path.c_str());
+}
+
+TEST(FsTest, LinkedSmallFileReadAndRename) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  auto path = temp_path("small");
+  auto moved = temp_path("moved");
+  EXPECT_TRUE(faio::block_on(ctx, small_file_chain(path, moved)));
+  ::unlink(path.c_str());
+  ::unlink(moved.c_str());
+}
+
+TEST(FsTest, AlignedBufferRoundsUpToAlignment) {
+  auto buf = faio::fs::aligned_buffer(5000, 512);
+  EXPECT_EQ(buf.size(), 5120u);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buf.data()) % 512, 0u);
+  faio::fs::AlignedBuffer moved{std::move(buf)};
+  EXPECT_EQ(buf.data(), nullptr);
+  EXPECT_EQ(moved.size(), 5120u);
+}
@@ -86,3 +86,78 @@ TEST(HttpRouterTest, FallbackReturnsResponse) {
   EXPECT_EQ(resp.status(), 404);
   EXPECT_EQ(body_to_string(resp), "fallback");
 }
+
+TEST(HttpRouterTest, RequestTimeoutReturnsGatewayTimeout) {
+  faio::runtime_context ctx;
+  faio::http::HttpRouter router;
+  router.request_timeout(std::chrono::milliseconds(20));
+
+  router.get("/slow", [](const faio::http::HttpRequest&) -> faio::task<faio::http::HttpResponse> {
+    co_await faio::time::sleep(std::chrono::seconds(10));
+    co_return faio::http::HttpResponseBuilder(200).body("late").build();
+  });
+  router.get("/fast", [](const faio::http::HttpRequest&) -> faio::task<faio::http::HttpResponse> {
+    co_return faio::http::HttpResponseBuilder(200).body("ok").build();
+  });
+
+  faio::http::HttpRequest slow(faio::http::HttpMethod::GET, "/slow");
+  EXPECT_EQ(dispatch(ctx, router, slow).status(), 504);
+
+  faio::http::HttpRequest fast(faio::http::HttpMethod::GET, "/fast");
+  auto resp = dispatch(ctx, router, fast);
+  EXPECT_EQ(resp.status(), 200);
+  EXPECT_EQ(body_to_string(resp), "ok");
+}
+
+TEST(HttpRouterTest, LimitConcurrencyQueuesRequests) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(2).build()};
+  faio::http::HttpRouter router;
+  std::atomic<int> in_flight{0};
+  std::atomic<int> max_in_flight{0};
+  auto slow = [&](const faio::http::HttpRequest&) -> faio::task<faio::http::HttpResponse> {
+    auto now = in_flight.fetch_add(1) + 1;
+    auto prev = max_in_flight.load();
+    while (prev < now && !max_in_flight.compare_exchange_weak(prev, now)) {
+    }
+    co_await faio::time::sleep(std::chrono::milliseconds(5));
+    in_flight.fetch_sub(1);
+    co_return faio::http::HttpResponseBuilder(200).body("ok").build();
+  };
+  // 整个路由器最多 2 个，/one 单独限制为 1 个
+  router.limit_concurrency(2);
+  router.get("/one", faio::http::limit_concurrency(1, slow));
+  router.get("/two", slow);
+
+  faio::http::HttpRequest one(faio::http::HttpMethod::GET, "/one");
+  auto [a, b, c] = faio::wait_all(ctx, router.dispatch(one), router.dispatch(one),
+                                  router.dispatch(one));
+  EXPECT_EQ(a.status() + b.status() + c.status(), 600);
+  EXPECT_EQ(max_in_flight.load(), 1);
+
+  max_in_flight = 0;
+  faio::http::HttpRequest two(faio::http::HttpMethod::GET, "/two");
+  auto [d, e, f, g] = faio::wait_all(ctx, router.dispatch(two), router.dispatch(two),
+                                     router.dispatch(two), router.dispatch(two));
+  EXPECT_EQ(d.status() + e.status() + f.status() + g.status(), 800);
+  EXPECT_EQ(max_in_flight.load(), 2);
+}
+
+TEST(HttpRouterTest, LimitConcurrencyRejectsBeyondQueueCap) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  faio::http::HttpRouter router;
+  // 1 个在处理，1 个排队，第 3 个直接 503
+  router.limit_concurrency(1, 1);
+  router.get("/slow", [](const faio::http::HttpRequest&) -> faio::task<faio::http::HttpResponse> {
+    co_await faio::time::sleep(std::chrono::milliseconds(5));
+    co_return faio::http::HttpResponseBuilder(200).body("ok").build();
+  });
+
+  faio::http::HttpRequest slow(faio::http::HttpMethod::GET, "/slow");
+  auto [a, b, c] = faio::wait_all(ctx, router.dispatch(slow), router.dispatch(slow),
+                                  router.dispatch(slow));
+  EXPECT_EQ(a.status() + b.status() + c.status(), 903);
+
+  // 队列空出来之后照常排队
+  auto [d, e] = faio::wait_all(ctx, router.dispatch(slow), router.dispatch(slow));
+  EXPECT_EQ(d.status() + e.status(), 400);
+}
@@ -58,6 +58,7 @@ TEST(RuntimeTaskTest, ConfigBuilderAppliesValues) {
                  .set_submit_interval(3)
                  .set_io_interval(5)
                  .set_global_queue_interval(7)
+                 .set_submit_policy(faio::SubmitPolicy::Interval)
                  .build();
 
   EXPECT_EQ(cfg._num_events, 2048u);
@@ -65,4 +66,5 @@ TEST(RuntimeTaskTest, ConfigBuilderAppliesValues) {
   EXPECT_EQ(cfg._submit_interval, 3u);
   EXPECT_EQ(cfg._io_interval, 5u);
   EXPECT_EQ(cfg._global_queue_interval, 7u);
+  EXPECT_EQ(cfg._submit_policy, faio::SubmitPolicy::Interval);
 }
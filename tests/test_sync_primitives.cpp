@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "faio/faio.hpp"
+#include <stdexcept>
 
 namespace {
 
@@ -62,6 +63,517 @@ auto channel_run() -> faio::task<int> {
   co_return recv_res.value();
 }
 
+// 移动构造可能抛出异常的元素，fail_moves 为 true 时每次移动都抛出
+struct Fragile {
+  static inline bool fail_moves = false;
+
+  explicit Fragile(int v) : value{v} {}
+  Fragile(Fragile&& other) : value{other.value} {
+    if (fail_moves) {
+      throw std::runtime_error{"move failed"};
+    }
+  }
+  Fragile& operator=(Fragile&&) = default;
+
+  int value;
+};
+
+// co_await 的 send / recv 同样接受移动可能抛出异常的类型
+auto fragile_channel_await() -> faio::task<int> {
+  auto [sender, receiver] = faio::sync::channel<Fragile>::make(1);
+  auto sent = co_await sender.send(Fragile{9});
+  auto value = co_await receiver.recv();
+  co_return sent && value ? value->value : -1;
+}
+
+// 发送、接收时移动抛出异常之后，通道仍然可以继续使用
+template <typename Pair>
+auto fragile_channel_run(Pair channel) -> std::vector<int> {
+  auto& [sender, receiver] = channel;
+  std::vector<int> values;
+  (void)sender.try_send(Fragile{1});
+  Fragile::fail_moves = true;
+  try {
+    (void)sender.try_send(Fragile{2});
+    values.push_back(-1);
+  } catch (const std::runtime_error&) {
+  }
+  Fragile::fail_moves = false;
+  (void)sender.try_send(Fragile{3});
+  // 1 在出队时丢失
+  Fragile::fail_moves = true;
+  try {
+    (void)receiver.try_recv();
+    values.push_back(-1);
+  } catch (const std::runtime_error&) {
+  }
+  Fragile::fail_moves = false;
+  for (int i = 4; i < 8; ++i) {
+    (void)sender.try_send(Fragile{i});
+  }
+  while (true) {
+    auto value = receiver.try_recv();
+    if (!value) {
+      break;
+    }
+    values.push_back(value->value);
+  }
+  return values;
+}
+
+auto channel_try_run() -> faio::task<std::vector<int>> {
+  // 容量向上取整到 2 的幂：3 -> 4
+  auto [sender, receiver] = faio::sync::channel<int>::make(3);
+  std::vector<int> codes;
+  for (int i = 0; i < 4; ++i) {
+    codes.push_back(sender.try_send(i) ? 0 : -1);
+  }
+  auto full = sender.try_send(4);
+  codes.push_back(full ? 0 : full.error().value());
+  for (int i = 0; i < 4; ++i) {
+    auto res = receiver.try_recv();
+    codes.push_back(res ? res.value() : -1);
+  }
+  auto empty = receiver.try_recv();
+  codes.push_back(empty ? 0 : empty.error().value());
+
+  // 关闭之后仍然能取出之前写入的值
+  codes.push_back(sender.try_send(7) ? 0 : -1);
+  sender.close();
+  auto rest = co_await receiver.recv();
+  codes.push_back(rest ? rest.value() : -1);
+  auto closed = receiver.try_recv();
+  codes.push_back(closed ? 0 : closed.error().value());
+  co_return codes;
+}
+
+template <typename Sender>
+auto channel_producer(Sender sender, int base, int count) -> faio::task<void> {
+  for (int i = 0; i < count; ++i) {
+    if (!co_await sender.send(base + i)) {
+      co_return;
+    }
+  }
+  sender.close();
+}
+
+auto channel_consumer(faio::sync::channel<int>::Receiver receiver,
+                      std::atomic<long>& sum,
+                      std::atomic<int>& received) -> faio::task<void> {
+  while (true) {
+    auto res = co_await receiver.recv();
+    if (!res) {
+      break;
+    }
+    sum.fetch_add(res.value(), std::memory_order_relaxed);
+    received.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+auto channel_mpmc_run(std::atomic<long>& sum, std::atomic<int>& received,
+                      int producers, int consumers, int count) -> faio::task<void> {
+  // 容量远小于总量，发送和接收都会频繁走慢路径
+  auto [sender, receiver] = faio::sync::channel<int>::make(4);
+  for (int i = 0; i < consumers; ++i) {
+    faio::spawn(channel_consumer(receiver, sum, received));
+  }
+  for (int i = 0; i < producers; ++i) {
+    faio::spawn(channel_producer(sender, i * count, count));
+  }
+  sender.close();
+  receiver.close();
+  co_return;
+}
+
+// 单消费者：检查每个生产者的值按发送顺序到达
+template <typename Receiver>
+auto channel_ordered_consumer(Receiver receiver, int producers, int count,
+                              int& received, bool& in_order) -> faio::task<void> {
+  std::vector<int> last(producers, -1);
+  while (true) {
+    auto res = co_await receiver.recv();
+    if (!res) {
+      break;
+    }
+    const int value = res.value();
+    const int offset = value % count;
+    auto& prev = last[value / count];
+    in_order = in_order && offset == prev + 1;
+    prev = offset;
+    ++received;
+  }
+}
+
+template <typename Channel>
+auto channel_single_consumer_run(Channel channel, int producers, int count,
+                                 int& received, bool& in_order) -> faio::task<void> {
+  auto& [sender, receiver] = channel;
+  faio::spawn(channel_ordered_consumer(std::move(receiver), producers, count, received,
+                                       in_order));
+  if constexpr (std::is_copy_constructible_v<typename Channel::first_type>) {
+    for (int i = 0; i + 1 < producers; ++i) {
+      faio::spawn(channel_producer(sender, i * count, count));
+    }
+  }
+  faio::spawn(channel_producer(std::move(sender), (producers - 1) * count, count));
+  co_return;
+}
+
+auto oneshot_reply(faio::sync::oneshot<int>::Sender sender) -> faio::task<void> {
+  co_await faio::time::sleep(std::chrono::milliseconds(5));
+  (void)sender.send(42);
+}
+
+auto oneshot_run() -> faio::task<std::vector<int>> {
+  std::vector<int> codes;
+  // 接收方先挂起，发送方稍后回复
+  auto [sender, receiver] = faio::sync::oneshot<int>::make();
+  faio::spawn(oneshot_reply(std::move(sender)));
+  auto reply = co_await receiver;
+  codes.push_back(reply ? reply.value() : -1);
+  // 值只能取走一次
+  auto again = co_await receiver;
+  codes.push_back(again ? 0 : again.error().value());
+
+  // 发送端没有发送就被销毁
+  auto [dropped, waiting] = faio::sync::oneshot<int>::make();
+  dropped.close();
+  auto closed = co_await waiting;
+  codes.push_back(closed ? 0 : closed.error().value());
+
+  // 接收端已经销毁
+  auto [orphan, gone] = faio::sync::oneshot<int>::make();
+  gone.close();
+  codes.push_back(orphan.is_closed() ? 1 : 0);
+  auto sent = orphan.send(1);
+  codes.push_back(sent ? 0 : sent.error().value());
+  co_return codes;
+}
+
+auto broadcast_listener(faio::sync::broadcast<int>::Receiver receiver, std::atomic<long>& sum,
+                        std::atomic<int>& received) -> faio::task<void> {
+  while (true) {
+    auto res = co_await receiver.recv();
+    if (!res) {
+      if (res.error().value() == faio::Error::Lagged) {
+        continue;
+      }
+      break;
+    }
+    sum.fetch_add(res.value(), std::memory_order_relaxed);
+    received.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+auto broadcast_publisher(faio::sync::broadcast<int>::Sender sender, int count)
+    -> faio::task<void> {
+  for (int i = 0; i < count; ++i) {
+    (void)sender.send(i);
+    co_await faio::time::sleep(std::chrono::microseconds(100));
+  }
+  sender.close();
+}
+
+auto broadcast_run(std::atomic<long>& sum, std::atomic<int>& received, int listeners,
+                   int count) -> faio::task<void> {
+  // 容量大于总量，接收者不会落后
+  auto [sender, receiver] = faio::sync::broadcast<int>::make(static_cast<std::size_t>(count));
+  for (int i = 1; i < listeners; ++i) {
+    faio::spawn(broadcast_listener(sender.subscribe(), sum, received));
+  }
+  faio::spawn(broadcast_listener(std::move(receiver), sum, received));
+  faio::spawn(broadcast_publisher(std::move(sender), count));
+  co_return;
+}
+
+auto semaphore_worker(faio::sync::semaphore& sem, std::atomic<int>& in_flight,
+                      std::atomic<int>& max_in_flight, int loops) -> faio::task<int> {
+  for (int i = 0; i < loops; ++i) {
+    auto permit = co_await sem.acquire();
+    auto now = in_flight.fetch_add(1) + 1;
+    auto prev = max_in_flight.load();
+    while (prev < now && !max_in_flight.compare_exchange_weak(prev, now)) {
+    }
+    co_await faio::time::sleep(std::chrono::milliseconds(1));
+    in_flight.fetch_sub(1);
+  }
+  co_return loops;
+}
+
+auto semaphore_waiter(faio::sync::semaphore& sem, std::size_t permits, int id,
+                      std::vector<int>& order) -> faio::task<void> {
+  auto permit = co_await sem.acquire(permits);
+  order.push_back(id);
+  // 不归还，方便按释放的数量推算谁会被唤醒
+  permit->forget();
+}
+
+auto semaphore_fifo_run() -> faio::task<std::vector<int>> {
+  faio::sync::semaphore sem{0};
+  std::vector<int> order;
+  // 依次挂起：第一个要 2 个许可，后两个各要 1 个
+  faio::spawn(semaphore_waiter(sem, 2, 0, order));
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  faio::spawn(semaphore_waiter(sem, 1, 1, order));
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  faio::spawn(semaphore_waiter(sem, 1, 2, order));
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+
+  // 1 个许可不够队头，后面的等待者也不能插队
+  sem.release(1);
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  order.push_back(-1);
+  order.push_back(sem.try_acquire() ? -100 : -2);
+
+  sem.release(1);
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  order.push_back(-3);
+  // 一次只放一个许可，观察交接顺序而不是同时唤醒后的调度顺序
+  sem.release(1);
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  order.push_back(-4);
+  sem.release(1);
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  co_return order;
+}
+
+struct SharedMutexStats {
+  std::atomic<int> readers{0};      // 持有读锁的读者数
+  std::atomic<int> max_readers{0};  // 同时持有读锁的最大读者数
+  std::atomic<bool> writing{false}; // 写者持有锁
+  std::atomic<int> violations{0};   // 读写同时进行的次数
+};
+
+auto shared_mutex_reader(faio::sync::shared_mutex& mtx, SharedMutexStats& stats,
+                         int loops) -> faio::task<int> {
+  for (int i = 0; i < loops; ++i) {
+    co_await mtx.lock_shared();
+    auto now = stats.readers.fetch_add(1) + 1;
+    auto prev = stats.max_readers.load();
+    while (prev < now && !stats.max_readers.compare_exchange_weak(prev, now)) {
+    }
+    if (stats.writing.load()) {
+      stats.violations.fetch_add(1);
+    }
+    co_await faio::time::sleep(std::chrono::milliseconds(1));
+    stats.readers.fetch_sub(1);
+    mtx.unlock_shared();
+  }
+  co_return loops;
+}
+
+auto shared_mutex_writer(faio::sync::shared_mutex& mtx, SharedMutexStats& stats,
+                         int loops) -> faio::task<int> {
+  for (int i = 0; i < loops; ++i) {
+    co_await mtx.lock();
+    if (stats.writing.exchange(true) || stats.readers.load() != 0) {
+      stats.violations.fetch_add(1);
+    }
+    co_await faio::time::sleep(std::chrono::milliseconds(1));
+    stats.writing.store(false);
+    mtx.unlock();
+    co_await faio::time::sleep(std::chrono::milliseconds(1));
+  }
+  co_return loops;
+}
+
+auto shared_mutex_holder(faio::sync::shared_mutex& mtx) -> faio::task<void> {
+  co_await mtx.lock_shared();
+  co_await faio::time::sleep(std::chrono::milliseconds(5));
+  mtx.unlock_shared();
+}
+
+auto shared_mutex_locker(faio::sync::shared_mutex& mtx, bool exclusive, int id,
+                         std::vector<int>& order) -> faio::task<void> {
+  if (exclusive) {
+    co_await mtx.lock();
+    order.push_back(id);
+    mtx.unlock();
+  } else {
+    co_await mtx.lock_shared();
+    order.push_back(id);
+    mtx.unlock_shared();
+  }
+}
+
+auto shared_mutex_writer_preference_run() -> faio::task<std::vector<int>> {
+  faio::sync::shared_mutex mtx;
+  std::vector<int> order;
+  // 读者持有读锁，写者等它退出
+  faio::spawn(shared_mutex_holder(mtx));
+  co_await faio::time::sleep(std::chrono::milliseconds(1));
+  faio::spawn(shared_mutex_locker(mtx, true, 1, order));
+  co_await faio::time::sleep(std::chrono::milliseconds(1));
+  // 写者在等，新的读者不能插队
+  order.push_back(mtx.try_lock_shared() ? -100 : -1);
+  faio::spawn(shared_mutex_locker(mtx, false, 2, order));
+  co_await faio::time::sleep(std::chrono::milliseconds(10));
+  co_return order;
+}
+
+// 单生产者/单消费者通道的发送端、接收端只能移动
+static_assert(!std::is_copy_constructible_v<faio::sync::channel<int>::SpscSender>);
+static_assert(!std::is_copy_constructible_v<faio::sync::channel<int>::SpscReceiver>);
+static_assert(std::is_copy_constructible_v<faio::sync::channel<int>::MpscSender>);
+static_assert(!std::is_copy_constructible_v<faio::sync::channel<int>::MpscReceiver>);
+
+
+// 在 time::timeout 中等锁，记下等待的结果
+auto lock_under_timeout(faio::sync::mutex& mtx, int& error) -> faio::task<void> {
+  auto locked = co_await mtx.lock();
+  if (!locked) {
+    error = locked.error().value();
+    co_return;
+  }
+  mtx.unlock();
+}
+
+auto lock_then_mark(faio::sync::mutex& mtx, bool& locked) -> faio::task<void> {
+  co_await mtx.lock();
+  locked = true;
+  mtx.unlock();
+}
+
+// 截止时间到达时等锁的协程以 ECANCELED 返回；解锁时跳过它，把锁交给后面的等待者
+auto mutex_timeout_run() -> faio::task<bool> {
+  faio::sync::mutex mtx;
+  co_await mtx.lock();
+  int error = 0;
+  bool later = false;
+  faio::spawn(lock_then_mark(mtx, later));
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(20),
+                                          lock_under_timeout(mtx, error));
+  mtx.unlock();
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  auto relocked = mtx.try_lock();
+  if (relocked) {
+    mtx.unlock();
+  }
+  co_return !res && error == ECANCELED && later && relocked;
+}
+
+auto wait_under_timeout(faio::sync::condition_variable& cv, faio::sync::mutex& mtx, int& error,
+                        bool& holding) -> faio::task<void> {
+  co_await mtx.lock();
+  auto woken = co_await cv.wait(mtx, [] { return false; });
+  error = woken ? 0 : woken.error().value();
+  // 被取消时仍然持锁返回
+  holding = !mtx.try_lock();
+  mtx.unlock();
+}
+
+// 条件变量的等待被取消之后，通知交给下一个等待者
+auto condition_timeout_run() -> faio::task<bool> {
+  faio::sync::condition_variable cv;
+  faio::sync::mutex mtx;
+  bool ready = false;
+  int observed = 0;
+  int error = 0;
+  bool holding = false;
+  // 被取消的等待者排在链表头部，通知时要跳过它
+  faio::spawn(condition_waiter(cv, mtx, ready, observed));
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(20),
+                                          wait_under_timeout(cv, mtx, error, holding));
+  co_await mtx.lock();
+  ready = true;
+  mtx.unlock();
+  cv.notify_one();
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  co_return !res && error == ECANCELED && holding && observed == 1;
+}
+
+auto acquire_under_timeout(faio::sync::semaphore& sem, std::size_t permits, int& error)
+    -> faio::task<void> {
+  auto permit = co_await sem.acquire(permits);
+  error = permit ? 0 : permit.error().value();
+}
+
+// 被取消的等待者已经凑到的许可在取消时收回，不必等到下一次 release
+auto semaphore_timeout_run() -> faio::task<bool> {
+  faio::sync::semaphore sem{2};
+  auto held = sem.try_acquire();
+  int error = 0;
+  // 拿走剩下的 1 个许可，还差 1 个
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(20),
+                                          acquire_under_timeout(sem, 2, error));
+  auto returned = sem.available() == 1;
+  held.reset();
+  co_return !res && error == ECANCELED && returned && sem.available() == 2;
+}
+
+auto recv_under_timeout(faio::sync::channel<int>::Receiver& receiver, int& error)
+    -> faio::task<void> {
+  auto value = co_await receiver.recv();
+  error = value ? 0 : value.error().value();
+}
+
+// 被取消的接收者不会拿走之后发送的值
+auto channel_timeout_run() -> faio::task<bool> {
+  auto [sender, receiver] = faio::sync::channel<int>::make(1);
+  int error = 0;
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(20),
+                                          recv_under_timeout(receiver, error));
+  auto sent = co_await sender.send(7);
+  auto value = receiver.try_recv();
+  co_return !res && error == ECANCELED && sent && value && value.value() == 7;
+}
+
+auto reply_later(faio::sync::oneshot<int>::Sender sender) -> faio::task<void> {
+  co_await faio::time::sleep(std::chrono::milliseconds(40));
+  (void)sender.send(42);
+}
+
+auto await_reply(faio::sync::oneshot<int>::Receiver& receiver, int& error) -> faio::task<void> {
+  auto value = co_await receiver;
+  error = value ? 0 : value.error().value();
+}
+
+// 接收被取消之后仍然可以再次等待同一个值
+auto oneshot_timeout_run() -> faio::task<bool> {
+  auto [sender, receiver] = faio::sync::oneshot<int>::make();
+  faio::spawn(reply_later(std::move(sender)));
+  int error = 0;
+  auto first = co_await faio::time::timeout(std::chrono::milliseconds(10),
+                                            await_reply(receiver, error));
+  auto second = co_await receiver;
+  co_return !first && error == ECANCELED && second && second.value() == 42;
+}
+
+auto write_under_timeout(faio::sync::shared_mutex& mtx, int& error) -> faio::task<void> {
+  auto locked = co_await mtx.lock();
+  if (!locked) {
+    error = locked.error().value();
+    co_return;
+  }
+  mtx.unlock();
+}
+
+auto read_then_mark(faio::sync::shared_mutex& mtx, bool& read) -> faio::task<void> {
+  co_await mtx.lock_shared();
+  read = true;
+  mtx.unlock_shared();
+}
+
+// 等读者退出的写者被取消时清除 WRITER 位，排在它后面的读者进入
+auto shared_mutex_timeout_run() -> faio::task<bool> {
+  faio::sync::shared_mutex mtx;
+  co_await mtx.lock_shared();
+  int error = 0;
+  bool read = false;
+  // 读者在写者开始等待之后才运行，排在 WRITER 位后面
+  faio::spawn(read_then_mark(mtx, read));
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(20),
+                                          write_under_timeout(mtx, error));
+  co_await faio::time::sleep(std::chrono::milliseconds(2));
+  mtx.unlock_shared();
+  auto writable = mtx.try_lock();
+  if (writable) {
+    mtx.unlock();
+  }
+  co_return !res && error == ECANCELED && read && writable;
+}
+
 }  // namespace
 
 TEST(SyncTest, MutexProtectsSharedState) {
@@ -86,3 +598,201 @@ TEST(SyncTest, ChannelSendRecvWorks) {
   const int value = faio::block_on(ctx, channel_run());
   EXPECT_EQ(value, 52);
 }
+
+TEST(SyncTest, ChannelTrySendRecvNeverSuspend) {
+  faio::runtime_context ctx;
+  const auto codes = faio::block_on(ctx, channel_try_run());
+  const std::vector<int> expected{0, 0, 0, 0, faio::Error::FullChannel,
+                                  0, 1, 2, 3, faio::Error::EmptyChannel,
+                                  0, 7, faio::Error::ClosedChannel};
+  EXPECT_EQ(codes, expected);
+}
+
+TEST(SyncTest, ChannelSurvivesThrowingMoves) {
+  // 容量 8：失败的发送在 MPMC/MPSC 中留下一个跳过的槽位
+  const std::vector<int> expected{3, 4, 5, 6, 7};
+  EXPECT_EQ(fragile_channel_run(faio::sync::channel<Fragile>::make(8)), expected);
+  EXPECT_EQ(fragile_channel_run(faio::sync::channel<Fragile>::make_mpsc(8)), expected);
+  EXPECT_EQ(fragile_channel_run(faio::sync::channel<Fragile>::make_spsc(8)), expected);
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_EQ(faio::block_on(ctx, fragile_channel_await()), 9);
+}
+
+TEST(SyncTest, ChannelMpmcDeliversEveryValueOnce) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(4).build()};
+  constexpr int producers = 4;
+  constexpr int consumers = 4;
+  constexpr int count = 5000;
+  std::atomic<long> sum{0};
+  std::atomic<int> received{0};
+  faio::block_on(ctx, channel_mpmc_run(sum, received, producers, consumers, count));
+  constexpr long total = static_cast<long>(producers) * count;
+  EXPECT_EQ(received.load(), total);
+  EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+}
+
+TEST(SyncTest, SpscChannelPreservesOrder) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(2).build()};
+  constexpr int count = 20000;
+  int received = 0;
+  bool in_order = true;
+  faio::block_on(ctx, channel_single_consumer_run(faio::sync::channel<int>::make_spsc(4), 1,
+                                                  count, received, in_order));
+  EXPECT_EQ(received, count);
+  EXPECT_TRUE(in_order);
+}
+
+TEST(SyncTest, MpscChannelDeliversEveryValueInProducerOrder) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(4).build()};
+  constexpr int producers = 4;
+  constexpr int count = 5000;
+  int received = 0;
+  bool in_order = true;
+  faio::block_on(ctx, channel_single_consumer_run(faio::sync::channel<int>::make_mpsc(8),
+                                                  producers, count, received, in_order));
+  EXPECT_EQ(received, producers * count);
+  EXPECT_TRUE(in_order);
+}
+
+TEST(SyncTest, OneshotDeliversValueOnce) {
+  faio::runtime_context ctx;
+  const auto codes = faio::block_on(ctx, oneshot_run());
+  const std::vector<int> expected{42, faio::Error::ClosedChannel, faio::Error::ClosedChannel,
+                                  1, faio::Error::ClosedChannel};
+  EXPECT_EQ(codes, expected);
+}
+
+TEST(SyncTest, BroadcastDeliversEveryValueToEveryReceiver) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(2).build()};
+  constexpr int listeners = 3;
+  constexpr int count = 200;
+  std::atomic<long> sum{0};
+  std::atomic<int> received{0};
+  faio::block_on(ctx, broadcast_run(sum, received, listeners, count));
+  EXPECT_EQ(received.load(), listeners * count);
+  EXPECT_EQ(sum.load(), static_cast<long>(listeners) * count * (count - 1) / 2);
+}
+
+TEST(SyncTest, BroadcastLaggedReceiverSkipsToOldest) {
+  auto [sender, receiver] = faio::sync::broadcast<int>::make(4);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(sender.send(i));
+  }
+  auto lagged = receiver.try_recv();
+  ASSERT_FALSE(lagged);
+  EXPECT_EQ(lagged.error().value(), faio::Error::Lagged);
+  for (int i = 6; i < 10; ++i) {
+    auto res = receiver.try_recv();
+    ASSERT_TRUE(res);
+    EXPECT_EQ(res.value(), i);
+  }
+  auto empty = receiver.try_recv();
+  ASSERT_FALSE(empty);
+  EXPECT_EQ(empty.error().value(), faio::Error::EmptyChannel);
+
+  sender.close();
+  auto closed = receiver.try_recv();
+  ASSERT_FALSE(closed);
+  EXPECT_EQ(closed.error().value(), faio::Error::ClosedChannel);
+}
+
+TEST(SyncTest, SemaphoreLimitsConcurrency) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(4).build()};
+  faio::sync::semaphore sem{2};
+  std::atomic<int> in_flight{0};
+  std::atomic<int> max_in_flight{0};
+  auto [a, b, c, d] = faio::wait_all(ctx,
+                                     semaphore_worker(sem, in_flight, max_in_flight, 8),
+                                     semaphore_worker(sem, in_flight, max_in_flight, 8),
+                                     semaphore_worker(sem, in_flight, max_in_flight, 8),
+                                     semaphore_worker(sem, in_flight, max_in_flight, 8));
+  EXPECT_EQ(a + b + c + d, 32);
+  EXPECT_LE(max_in_flight.load(), 2);
+  EXPECT_EQ(sem.available(), 2u);
+}
+
+TEST(SyncTest, SemaphoreWakesWaitersInFifoOrder) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  const auto order = faio::block_on(ctx, semaphore_fifo_run());
+  const std::vector<int> expected{-1, -2, 0, -3, 1, -4, 2};
+  EXPECT_EQ(order, expected);
+}
+
+TEST(SyncTest, SemaphorePermitReturnsOnDestruction) {
+  faio::sync::semaphore sem{3};
+  {
+    auto permit = sem.try_acquire(2);
+    ASSERT_TRUE(permit);
+    EXPECT_EQ(permit->count(), 2u);
+    EXPECT_EQ(sem.available(), 1u);
+    EXPECT_FALSE(sem.try_acquire(2));
+  }
+  EXPECT_EQ(sem.available(), 3u);
+}
+
+TEST(SyncTest, SharedMutexAllowsConcurrentReaders) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(4).build()};
+  faio::sync::shared_mutex mtx;
+  SharedMutexStats stats;
+  auto [a, b, c, d] = faio::wait_all(ctx,
+                                     shared_mutex_reader(mtx, stats, 16),
+                                     shared_mutex_reader(mtx, stats, 16),
+                                     shared_mutex_reader(mtx, stats, 16),
+                                     shared_mutex_writer(mtx, stats, 8));
+  EXPECT_EQ(a + b + c + d, 56);
+  EXPECT_GT(stats.max_readers.load(), 1);
+  EXPECT_EQ(stats.violations.load(), 0);
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+TEST(SyncTest, SharedMutexPendingWriterBlocksNewReaders) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  const auto order = faio::block_on(ctx, shared_mutex_writer_preference_run());
+  const std::vector<int> expected{-1, 1, 2};
+  EXPECT_EQ(order, expected);
+}
+
+TEST(SyncTest, SharedMutexTryLock) {
+  faio::sync::shared_mutex mtx;
+  ASSERT_TRUE(mtx.try_lock_shared());
+  ASSERT_TRUE(mtx.try_lock_shared());
+  EXPECT_FALSE(mtx.try_lock());
+  mtx.unlock_shared();
+  mtx.unlock_shared();
+  ASSERT_TRUE(mtx.try_lock());
+  EXPECT_FALSE(mtx.try_lock_shared());
+  mtx.unlock();
+  EXPECT_TRUE(mtx.try_lock_shared());
+  mtx.unlock_shared();
+}
+
+TEST(SyncTest, MutexLockIsCutShortByTimeout) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_TRUE(faio::block_on(ctx, mutex_timeout_run()));
+}
+
+TEST(SyncTest, ConditionVariableWaitIsCutShortByTimeout) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_TRUE(faio::block_on(ctx, condition_timeout_run()));
+}
+
+TEST(SyncTest, SemaphoreAcquireIsCutShortByTimeout) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_TRUE(faio::block_on(ctx, semaphore_timeout_run()));
+}
+
+TEST(SyncTest, ChannelRecvIsCutShortByTimeout) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_TRUE(faio::block_on(ctx, channel_timeout_run()));
+}
+
+TEST(SyncTest, OneshotRecvIsCutShortByTimeout) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_TRUE(faio::block_on(ctx, oneshot_timeout_run()));
+}
+
+TEST(SyncTest, SharedMutexWriterIsCutShortByTimeout) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_TRUE(faio::block_on(ctx, shared_mutex_timeout_run()));
+}
@@ -2,7 +2,550 @@
 
 #include "faio/faio.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+auto write_null_loop(int fd, std::atomic<int>& completed) -> faio::task<void> {
+  static constexpr char buf[64]{};
+  for (int i = 0; i < 16; ++i) {
+    auto res = co_await faio::io::write(fd, buf, sizeof(buf), 0);
+    if (res && res.value() == sizeof(buf)) {
+      completed.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+auto burst_writes(int fd, std::atomic<int>& completed) -> faio::task<void> {
+  for (int i = 0; i < 256; ++i) {
+    faio::spawn(write_null_loop(fd, completed));
+  }
+  co_return;
+}
+
+auto chained_ping(int a, int b) -> faio::task<bool> {
+  char buf[4]{};
+  auto [sent, received] = co_await faio::io::chain(
+      faio::io::send(a, "ping", 4, 0), faio::io::recv(b, buf, sizeof(buf), 0));
+  co_return sent && received && received.value() == 4 &&
+      std::string_view{buf, 4} == "ping";
+}
+
+auto recv_with_timeout(int fd) -> faio::task<int> {
+  char buf[4]{};
+  auto res = co_await faio::time::timeout(
+      faio::io::recv(fd, buf, sizeof(buf), 0), std::chrono::milliseconds(20));
+  co_return res ? 0 : res.error().value();
+}
+
+// set_timeout 和 io::chain 会移动已经 prep 的 awaiter，
+// sqe 中指向 awaiter 自身 msghdr、statx 缓冲区的地址要在挂起时重新填写
+auto moved_awaiters_roundtrip(int a, int b) -> faio::task<bool> {
+  if (::send(a, "ping", 4, 0) != 4) {
+    co_return false;
+  }
+  char buf[4]{};
+  struct sockaddr_storage addr{};
+  socklen_t addrlen = sizeof(addr);
+  auto received = co_await faio::io::recvfrom(
+      b, buf, sizeof(buf), 0, reinterpret_cast<struct sockaddr *>(&addr), &addrlen)
+      .set_timeout(std::chrono::seconds(1));
+  if (!received || received.value() != 4 || std::string_view{buf, 4} != "ping") {
+    co_return false;
+  }
+  if (::send(a, "pong", 4, 0) != 4) {
+    co_return false;
+  }
+  auto [stat, again] = co_await faio::io::chain(
+      faio::io::statx(AT_FDCWD, "/", 0, STATX_TYPE),
+      faio::io::recvfrom(b, buf, sizeof(buf), 0, nullptr, nullptr));
+  co_return stat && S_ISDIR(stat.value().stx_mode) && again && again.value() == 4 &&
+      std::string_view{buf, 4} == "pong";
+}
+
+// 带超时的 recv 在超时之前被 cancel_fd 取消，结果是 -ECANCELED 而不是 -ETIMEDOUT
+auto recv_with_timeout_into(int fd, int& error) -> faio::task<void> {
+  char buf[4]{};
+  auto res = co_await faio::time::timeout(
+      faio::io::recv(fd, buf, sizeof(buf), 0), std::chrono::seconds(5));
+  error = res ? 0 : res.error().value();
+}
+
+auto cancel_before_timeout(int fd) -> faio::task<int> {
+  int error = -1;
+  faio::spawn(recv_with_timeout_into(fd, error));
+  co_await faio::time::sleep(std::chrono::milliseconds(20));
+  auto cancelled = co_await faio::io::cancel_fd(fd);
+  co_await faio::time::sleep(std::chrono::milliseconds(20));
+  co_return cancelled && cancelled.value() == 1 ? error : -1;
+}
+
+auto fixed_roundtrip(int fd) -> faio::task<bool> {
+  // 小 arena 上租借三块 8KB：前两块来自注册区，第三块退化为普通内存
+  auto a = faio::io::fixed_buffer(8192);
+  auto b = faio::io::fixed_buffer(8192);
+  auto c = faio::io::fixed_buffer(8192);
+  std::memset(a.data(), 'a', a.size());
+  std::memset(c.data(), 'c', c.size());
+  auto wa = co_await faio::io::write_fixed(fd, a, a.size(), 0);
+  auto wc = co_await faio::io::write_fixed(fd, c, c.size(), a.size());
+  auto rb = co_await faio::io::read_fixed(fd, b, b.size(), a.size());
+  co_return !c.registered() && wa && wa.value() == 8192 && wc &&
+      wc.value() == 8192 && rb && rb.value() == 8192 &&
+      std::memcmp(b.data(), c.data(), b.size()) == 0;
+}
+
+// 从注册缓冲区 send，旧内核不支持时返回 -1
+auto fixed_send_roundtrip(int a, int b) -> faio::task<int> {
+  auto buf = faio::io::fixed_buffer(4096);
+  std::memset(buf.data(), 's', buf.size());
+  auto sent = co_await faio::io::send(a, buf, buf.size(), MSG_NOSIGNAL);
+  if (!sent && sent.error().value() == EINVAL) {
+    co_return -1;
+  }
+  std::string out(buf.size(), '\0');
+  std::size_t got = 0;
+  while (sent && got < sent.value()) {
+    auto n = co_await faio::io::recv(b, out.data() + got, out.size() - got, 0);
+    if (!n || n.value() == 0) {
+      co_return 0;
+    }
+    got += n.value();
+  }
+  co_return sent && sent.value() == buf.size() && out == std::string(buf.size(), 's') ? 1 : 0;
+}
+
+auto vectored_roundtrip(int a, int b) -> faio::task<bool> {
+  faio::net::TcpStream writer{faio::net::detail::Socket{a}};
+  faio::net::TcpStream reader{faio::net::detail::Socket{b}};
+
+  // 20 段超过内部容量，会转移到堆上
+  std::string expected;
+  std::vector<std::string> segments;
+  for (int i = 0; i < 20; ++i) {
+    segments.emplace_back(static_cast<std::size_t>(i * 7 + 1), static_cast<char>('a' + i));
+    expected += segments.back();
+  }
+  faio::io::BufferChain out;
+  for (const auto& segment : segments) {
+    out.push_back(std::span<const char>(segment.data(), segment.size()));
+  }
+  if (!co_await writer.write_all_vectored(out) || !out.empty()) {
+    co_return false;
+  }
+
+  std::string received(expected.size(), '\0');
+  auto half = received.size() / 2;
+  faio::io::BufferChain in{std::span<const char>(received.data(), half),
+                           std::span<const char>(received.data() + half, received.size() - half)};
+  while (!in.empty()) {
+    auto res = co_await reader.read_vectored(in);
+    if (!res || res.value() == 0) {
+      co_return false;
+    }
+    in.advance(res.value());
+  }
+  co_return received == expected;
+}
+
+auto send_all_then_close(int fd, std::string data) -> faio::task<bool> {
+  std::string_view rest{data};
+  while (!rest.empty()) {
+    auto sent = co_await faio::io::send(fd, rest.data(), rest.size(), MSG_NOSIGNAL);
+    if (!sent || sent.value() == 0) {
+      co_return false;
+    }
+    rest.remove_prefix(sent.value());
+  }
+  co_return ::shutdown(fd, SHUT_WR) == 0;
+}
+
+auto recv_until_eof(int fd) -> faio::task<std::string> {
+  std::string out;
+  char buf[8192];
+  while (true) {
+    auto n = co_await faio::io::recv(fd, buf, sizeof(buf), 0);
+    if (!n || n.value() == 0) {
+      co_return out;
+    }
+    out.append(buf, n.value());
+  }
+}
+
+auto run_proxy(int a, int b, faio::expected<faio::net::CopyStats>& stats) -> faio::task<void> {
+  faio::net::TcpStream left{faio::net::detail::Socket{a}};
+  faio::net::TcpStream right{faio::net::detail::Socket{b}};
+  stats = co_await faio::net::copy_bidirectional(left, right);
+}
+
+auto proxied_exchange(int client, int a, int b, int server,
+                      faio::expected<faio::net::CopyStats>& stats) -> faio::task<bool> {
+  faio::spawn(run_proxy(a, b, stats));
+  // 请求比管道容量大，splice 需要多轮
+  std::string request(300 * 1024, 'q');
+  std::string response(70 * 1024, 'r');
+  if (!co_await send_all_then_close(client, request)) {
+    co_return false;
+  }
+  // 客户端半关闭之后服务端仍然可以回包
+  if (co_await recv_until_eof(server) != request) {
+    co_return false;
+  }
+  if (!co_await send_all_then_close(server, response)) {
+    co_return false;
+  }
+  co_return co_await recv_until_eof(client) == response;
+}
+
+auto udp_batch_roundtrip() -> faio::task<bool> {
+  auto any = faio::net::address::parse("127.0.0.1", 0).value();
+  auto receiver = faio::net::UdpDatagram::bind(any);
+  auto sender = faio::net::UdpDatagram::bind(any);
+  if (!receiver || !sender) {
+    co_return false;
+  }
+  auto target = receiver.value().local_addr().value();
+
+  // 10 个 100 字节 + 1 个 50 字节，可以合并成一次 GSO 发送
+  std::vector<std::string> payloads;
+  std::vector<faio::net::datagram> datagrams;
+  for (int i = 0; i < 11; ++i) {
+    payloads.emplace_back(i == 10 ? 50 : 100, static_cast<char>('a' + i));
+  }
+  for (const auto& payload : payloads) {
+    datagrams.push_back({std::span<const char>(payload), target});
+  }
+  auto sent = co_await sender.value().send_batch(datagrams);
+  if (!sent || sent.value() != datagrams.size()) {
+    co_return false;
+  }
+
+  std::vector<char> buf(64 * 1024);
+  std::size_t received = 0;
+  while (received < payloads.size()) {
+    auto batch = co_await receiver.value().recv_batch(buf);
+    if (!batch || batch.value().truncated) {
+      co_return false;
+    }
+    for (std::size_t i = 0; i < batch.value().size(); ++i, ++received) {
+      auto segment = batch.value()[i];
+      if (std::string_view{segment.data(), segment.size()} != payloads[received]) {
+        co_return false;
+      }
+    }
+  }
+  co_return true;
+}
+
+auto udp_recv_stream_roundtrip() -> faio::task<bool> {
+  auto any = faio::net::address::parse("127.0.0.1", 0).value();
+  auto receiver = faio::net::UdpDatagram::bind(any);
+  auto sender = faio::net::UdpDatagram::bind(any);
+  if (!receiver || !sender) {
+    co_return false;
+  }
+  auto target = receiver.value().local_addr().value();
+  auto from = sender.value().local_addr().value();
+
+  // 只有 4 个缓冲区，8 个数据报会耗尽缓冲区环，触发重新提交；最后一个被截断
+  auto stream = receiver.value().recv_stream({.buffer_size = 512, .buffer_count = 4});
+  if (!stream) {
+    // 内核不支持缓冲区环
+    co_return stream.error().value() == EINVAL || stream.error().value() == ENOSYS;
+  }
+  std::vector<std::string> payloads;
+  for (int i = 0; i < 8; ++i) {
+    payloads.emplace_back(i == 7 ? 1000 : 64, static_cast<char>('a' + i));
+    if (!co_await sender.value().send_to(payloads.back(), target)) {
+      co_return false;
+    }
+  }
+  for (int i = 0; i < 8; ++i) {
+    auto packet = co_await stream.value().next();
+    if (!packet || packet.value().addr.port() != from.port()) {
+      co_return false;
+    }
+    const auto& expected = payloads[i];
+    auto data = packet.value().data;
+    if (packet.value().truncated != (i == 7) ||
+        std::string_view{data.data(), data.size()} !=
+            std::string_view{expected}.substr(0, data.size())) {
+      co_return false;
+    }
+  }
+  auto stats = stream.value().stats();
+  co_return stats.received == 8 && stats.truncated == 1 && stats.rearmed >= 1;
+}
+
+auto pending_recv(int fd, int& error) -> faio::task<void> {
+  char buf[16];
+  auto res = co_await faio::io::recv(fd, buf, sizeof(buf), 0);
+  error = res ? 0 : res.error().value();
+}
+
+// 两个挂起的 recv 被 cancel_all 一次取消，之后连接仍然可用
+auto cancel_pending_reads(int fd, int peer) -> faio::task<bool> {
+  faio::net::TcpStream stream{faio::net::detail::Socket{fd}};
+  int first = -1;
+  int second = -1;
+  faio::spawn(pending_recv(fd, first));
+  faio::spawn(pending_recv(fd, second));
+  co_await faio::time::sleep(std::chrono::milliseconds(20));
+  auto cancelled = co_await stream.cancel_all();
+  co_await faio::time::sleep(std::chrono::milliseconds(20));
+  if (!cancelled || cancelled.value() != 2 || first != ECANCELED || second != ECANCELED) {
+    co_return false;
+  }
+  // 没有在途请求时结果为0
+  auto none = co_await stream.cancel_all();
+  if (!none || none.value() != 0) {
+    co_return false;
+  }
+  if (::send(peer, "ok", 2, 0) != 2) {
+    co_return false;
+  }
+  char buf[2];
+  auto n = co_await stream.read(buf);
+  co_return n && n.value() == 2;
+}
+
+// 让出当前 worker：放回全局队列，由任意一个 worker 取走继续运行
+struct YieldToGlobal {
+  auto await_ready() const noexcept -> bool { return false; }
+  void await_suspend(std::coroutine_handle<> handle) const {
+    faio::runtime::detail::push_task_to_global_queue(handle);
+  }
+  void await_resume() const noexcept {}
+};
+
+// 挂起在 recv 上，并记下提交它的 ring
+auto pending_recv_on(int fd, std::atomic<faio::io::detail::IOuring*>& ring,
+                     std::atomic<int>& error) -> faio::task<void> {
+  char buf[16];
+  ring.store(faio::io::detail::current_uring);
+  auto res = co_await faio::io::recv(fd, buf, sizeof(buf), 0);
+  error.store(res ? 0 : res.error().value());
+}
+
+// 等到挂起的 recv 提交之后，转移到另一个 worker 上
+auto move_off_ring(std::atomic<faio::io::detail::IOuring*>& ring) -> faio::task<bool> {
+  for (int i = 0; i < 500 && ring.load() == nullptr; ++i) {
+    co_await faio::time::sleep(std::chrono::milliseconds(1));
+  }
+  co_await faio::time::sleep(std::chrono::milliseconds(10));
+  for (int i = 0; i < 10000 && faio::io::detail::current_uring == ring.load(); ++i) {
+    co_await YieldToGlobal{};
+  }
+  co_return ring.load() != nullptr && faio::io::detail::current_uring != ring.load();
+}
+
+auto wait_for_error(std::atomic<int>& error) -> faio::task<int> {
+  for (int i = 0; i < 500 && error.load() == -1; ++i) {
+    co_await faio::time::sleep(std::chrono::milliseconds(1));
+  }
+  co_return error.load();
+}
+
+// 在一个 worker 上挂起的 recv，被另一个 worker 上的 cancel_fd 和 close 取消
+auto cancel_reads_from_other_worker(int fd) -> faio::task<bool> {
+  std::atomic<faio::io::detail::IOuring*> ring{nullptr};
+  std::atomic<int> error{-1};
+  faio::spawn(pending_recv_on(fd, ring, error));
+  if (!co_await move_off_ring(ring)) {
+    co_return false;
+  }
+  auto cancelled = co_await faio::io::cancel_fd(fd);
+  if (!cancelled || cancelled.value() != 1 || co_await wait_for_error(error) != ECANCELED) {
+    co_return false;
+  }
+  // cancel_on_close 的 socket 关闭时同样取消其他 worker 上的请求
+  faio::net::TcpStream stream{faio::net::detail::Socket{fd}};
+  ring.store(nullptr);
+  error.store(-1);
+  faio::spawn(pending_recv_on(fd, ring, error));
+  if (!co_await move_off_ring(ring)) {
+    co_return false;
+  }
+  auto closed = co_await stream.close();
+  co_return closed && co_await wait_for_error(error) == ECANCELED;
+}
+
+// 回环上的 TCP 往返：accept/connect 需要等待就绪，读写走 socket 的非阻塞路径
+auto tcp_loopback_roundtrip() -> faio::task<bool> {
+  auto listener =
+      faio::net::TcpListener::bind(faio::net::address::parse("127.0.0.1", 0).value());
+  if (!listener) {
+    co_return false;
+  }
+  auto target = listener.value().local_addr().value();
+  auto client = co_await faio::net::TcpStream::connect(target);
+  auto accepted = co_await listener.value().accept();
+  if (!client || !accepted) {
+    co_return false;
+  }
+  auto& [server, _peer] = accepted.value();
+  std::string payload(4096, 't');
+  if (!co_await client.value().write_all(payload)) {
+    co_return false;
+  }
+  std::string echoed(payload.size(), '\0');
+  if (!co_await server.read_bytes(echoed)) {
+    co_return false;
+  }
+  co_return echoed == payload;
+}
+
+// 阻塞在没有数据的 recv 上的子任务，之后的 sleep 也在同一个取消令牌下
+auto nested_pending_recv(int fd, int& error) -> faio::task<int> {
+  co_await pending_recv(fd, error);
+  co_await faio::time::sleep(std::chrono::seconds(10));
+  co_return 1;
+}
+
+// 外层 timeout 到期时取消子任务在途的 recv，之后的 sleep 不再挂起
+auto timeout_cancels_nested_recv(int fd) -> faio::task<bool> {
+  int error = 0;
+  const auto start = std::chrono::steady_clock::now();
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(30),
+                                          nested_pending_recv(fd, error));
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  if (res || res.error().value() != faio::Error::TimedOut) {
+    co_return false;
+  }
+  co_return error == ECANCELED && elapsed < std::chrono::seconds(1);
+}
+
+// 按时完成的任务原样返回结果；通用 awaiter 同样可以限时
+auto timeout_passes_results() -> faio::task<bool> {
+  auto quick = co_await faio::time::timeout(
+      std::chrono::milliseconds(200), []() -> faio::task<int> {
+        co_await faio::time::sleep(std::chrono::milliseconds(5));
+        co_return 42;
+      }());
+  auto slept = co_await faio::time::timeout(std::chrono::milliseconds(20),
+                                            faio::time::sleep(std::chrono::seconds(10)));
+  co_return quick && quick.value() == 42 && !slept &&
+      slept.error().value() == faio::Error::TimedOut;
+}
+
+// 没有被截断的任务即使超过截止时间才结束也返回结果；
+// 被截断之后仍然返回了值的任务同样返回结果，没有值时才是超时
+auto timeout_keeps_uncut_results() -> faio::task<bool> {
+  auto blocked = co_await faio::time::timeout(
+      std::chrono::milliseconds(10), []() -> faio::task<int> {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        co_return 5;
+      }());
+  auto recovered = co_await faio::time::timeout(
+      std::chrono::milliseconds(10), []() -> faio::task<faio::expected<int>> {
+        auto slept = co_await faio::time::sleep(std::chrono::seconds(10));
+        co_return slept ? 0 : 7;
+      }());
+  auto cut = co_await faio::time::timeout(
+      std::chrono::milliseconds(10), []() -> faio::task<int> {
+        co_await faio::time::sleep(std::chrono::seconds(10));
+        co_return 1;
+      }());
+  co_return blocked && blocked.value() == 5 && recovered && recovered.value() &&
+      recovered.value().value() == 7 && !cut && cut.error().value() == faio::Error::TimedOut;
+}
+
+// 令牌到期之后带超时的 IO 不再挂起，撤掉自己的超时后以 ECANCELED 返回
+auto late_recv_with_timeout(int fd, int& error) -> faio::task<void> {
+  co_await faio::time::sleep(std::chrono::seconds(10));
+  char buf[4]{};
+  auto res = co_await faio::time::timeout(
+      faio::io::recv(fd, buf, sizeof(buf), 0), std::chrono::seconds(5));
+  error = res ? 0 : res.error().value();
+}
+
+auto timed_io_after_deadline(int fd) -> faio::task<bool> {
+  int error = 0;
+  const auto start = std::chrono::steady_clock::now();
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(10),
+                                          late_recv_with_timeout(fd, error));
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  co_return !res && error == ECANCELED && elapsed < std::chrono::seconds(1);
+}
+
+// 一个令牌下同时在途的多个 IO 各占一个节点，到期时都被取消
+auto token_arms_several_ios() -> faio::task<bool> {
+  faio::io::detail::io_user_data_t first{};
+  faio::io::detail::io_user_data_t second{};
+  faio::time::detail::CancelToken token{std::chrono::steady_clock::now() +
+                                        std::chrono::milliseconds(10)};
+  token.arm(first);
+  token.arm(second);
+  const auto armed = first.timer_task != nullptr && second.timer_task != nullptr &&
+      first.timer_task != second.timer_task;
+  co_await faio::time::sleep(std::chrono::milliseconds(30));
+  co_return armed && first.timer_task == nullptr && second.timer_task == nullptr &&
+      token.cancelled();
+}
+
+// 截止时间之后 sleep 以 ECANCELED 返回，反复 sleep 的循环据此退出
+auto sleep_loop(int& rounds) -> faio::task<void> {
+  while (true) {
+    auto slept = co_await faio::time::sleep(std::chrono::milliseconds(5));
+    if (!slept) {
+      co_return;
+    }
+    ++rounds;
+  }
+}
+
+auto sleep_loop_under_timeout() -> faio::task<bool> {
+  int rounds = 0;
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(30), sleep_loop(rounds));
+  co_return !res && res.error().value() == faio::Error::TimedOut && rounds > 0 && rounds < 10;
+}
+
+// 链上的两个 recv 都等不到数据，截止时间到达时整条链被取消
+auto chained_recvs(int fd, int& first, int& second) -> faio::task<void> {
+  char a[4]{};
+  char b[4]{};
+  auto [x, y] = co_await faio::io::chain(faio::io::recv(fd, a, sizeof(a), 0),
+                                         faio::io::recv(fd, b, sizeof(b), 0));
+  first = x ? 0 : x.error().value();
+  second = y ? 0 : y.error().value();
+}
+
+auto chain_under_timeout(int fd) -> faio::task<bool> {
+  int first = 0;
+  int second = 0;
+  const auto start = std::chrono::steady_clock::now();
+  auto res = co_await faio::time::timeout(std::chrono::milliseconds(30),
+                                          chained_recvs(fd, first, second));
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  co_return !res && first == ECANCELED && second == ECANCELED &&
+      elapsed < std::chrono::seconds(1);
+}
+
+// 记录定时器任务恢复顺序的假任务队列
+struct RecordingQueue {
+  std::vector<void*> fired;
+  void push_back(std::coroutine_handle<> handle, RecordingQueue&) {
+    fired.push_back(handle.address());
+  }
+};
+
+auto fake_handle(std::uintptr_t id) -> std::coroutine_handle<> {
+  return std::coroutine_handle<>::from_address(reinterpret_cast<void*>(id));
+}
+
+}  // namespace
 
 TEST(TimeTest, SleepSuspendsAtLeastRequestedDuration) {
   faio::runtime_context ctx;
@@ -17,6 +560,230 @@ TEST(TimeTest, SleepSuspendsAtLeastRequestedDuration) {
   EXPECT_GE(elapsed_ms, 8);
 }
 
+TEST(TimeTest, TimerWheelFiresAcrossLevelsAndCancelsAfterTimeAdvances) {
+  using faio::runtime::detail::timer::TimerTask;
+  faio::runtime::detail::timer::Timer timer;
+  const auto start = std::chrono::steady_clock::now();
+  auto at = [&](long long ms) { return start + std::chrono::milliseconds(ms); };
+
+  // 分别落在 0、1、2、3 层
+  const long long deadlines[] = {3, 70, 5000, 300000};
+  std::vector<TimerTask> tasks;
+  tasks.reserve(5);
+  for (std::uintptr_t i = 0; i < 4; ++i) {
+    tasks.emplace_back(at(deadlines[i]), fake_handle(i + 1));
+  }
+  tasks.emplace_back(at(70), fake_handle(99));
+  for (auto& task : tasks) {
+    timer.add_task(&task);
+  }
+  EXPECT_EQ(timer.num_entries(), 5u);
+
+  RecordingQueue queue;
+  timer.poll_at(at(40), queue, queue);
+  ASSERT_EQ(queue.fired, std::vector<void*>{fake_handle(1).address()});
+  // 时间推进之后取消，节点按记下的位置摘除
+  timer.remove_task(&tasks[4]);
+  EXPECT_FALSE(tasks[4].linked());
+  EXPECT_EQ(timer.num_entries(), 3u);
+
+  for (std::uintptr_t i = 1; i < 4; ++i) {
+    timer.poll_at(at(deadlines[i] - 1), queue, queue);
+    EXPECT_EQ(queue.fired.size(), i) << "fired early: " << deadlines[i];
+    timer.poll_at(at(deadlines[i] + 1), queue, queue);
+    ASSERT_EQ(queue.fired.size(), i + 1) << "not fired: " << deadlines[i];
+    EXPECT_EQ(queue.fired.back(), fake_handle(i + 1).address());
+  }
+  EXPECT_TRUE(timer.empty());
+
+  // 节点在到期前析构时从时间轮中摘除
+  {
+    TimerTask task{at(400000), fake_handle(7)};
+    timer.add_task(&task);
+    EXPECT_EQ(timer.num_entries(), 1u);
+  }
+  EXPECT_TRUE(timer.empty());
+}
+
+TEST(TimeTest, SubMillisecondTickFiresWithinOneTick) {
+  using faio::runtime::detail::timer::TimerTask;
+  faio::runtime::detail::timer::Timer timer{std::chrono::microseconds(100)};
+  const auto start = std::chrono::steady_clock::now();
+  auto at = [&](long long us) { return start + std::chrono::microseconds(us); };
+
+  TimerTask task{at(250), fake_handle(1)};
+  timer.add_task(&task);
+  // 下一次唤醒不晚于到期时间，且误差不超过一个 tick
+  auto next = timer.next_deadline();
+  ASSERT_TRUE(next.has_value());
+  EXPECT_LE(*next, at(250) + std::chrono::microseconds(100));
+  EXPECT_GE(*next, at(250) - std::chrono::microseconds(100));
+
+  RecordingQueue queue;
+  timer.poll_at(at(200), queue, queue);
+  EXPECT_TRUE(queue.fired.empty());
+  timer.poll_at(at(400), queue, queue);
+  ASSERT_EQ(queue.fired.size(), 1u);
+  EXPECT_FALSE(timer.next_deadline().has_value());
+}
+
+TEST(TimeTest, TimerSlackCoalescesNearbyDeadlines) {
+  using faio::runtime::detail::timer::TimerTask;
+  faio::runtime::detail::timer::Timer timer;
+  const auto start = std::chrono::steady_clock::now();
+  auto at = [&](long long ms) { return start + std::chrono::milliseconds(ms); };
+
+  // 64ms 的 slack 把三个到期时间对齐到同一个窗口
+  TimerTask tasks[] = {{at(3), fake_handle(1)}, {at(10), fake_handle(2)}, {at(50), fake_handle(3)}};
+  for (auto& task : tasks) {
+    timer.add_task(&task, std::chrono::milliseconds(64));
+  }
+  // 不会提前到期
+  RecordingQueue queue;
+  timer.poll_at(at(49), queue, queue);
+  EXPECT_TRUE(queue.fired.empty());
+  // 一次 poll 全部到期，且不晚于 deadline + slack
+  timer.poll_at(at(67), queue, queue);
+  EXPECT_EQ(queue.fired.size(), 3u);
+  EXPECT_TRUE(timer.empty());
+}
+
+TEST(TimeTest, TimerResetDefersLaterAndRelocatesEarlier) {
+  using faio::runtime::detail::timer::TimerTask;
+  faio::runtime::detail::timer::Timer timer;
+  const auto start = std::chrono::steady_clock::now();
+  auto at = [&](long long ms) { return start + std::chrono::milliseconds(ms); };
+
+  TimerTask later{at(10), fake_handle(1)};
+  TimerTask earlier{at(5000), fake_handle(2)};
+  timer.add_task(&later);
+  timer.add_task(&earlier);
+  // 推迟只记下新的时间，原位置到期时重新挂入
+  timer.reset_task(&later, at(100));
+  // 提前立即重新挂入
+  timer.reset_task(&earlier, at(50));
+
+  RecordingQueue queue;
+  timer.poll_at(at(20), queue, queue);
+  EXPECT_TRUE(queue.fired.empty());
+  EXPECT_EQ(timer.num_entries(), 2u);
+  timer.poll_at(at(60), queue, queue);
+  ASSERT_EQ(queue.fired, std::vector<void*>{fake_handle(2).address()});
+  timer.poll_at(at(99), queue, queue);
+  EXPECT_EQ(queue.fired.size(), 1u);
+  timer.poll_at(at(101), queue, queue);
+  EXPECT_EQ(queue.fired.size(), 2u);
+  EXPECT_TRUE(timer.empty());
+}
+
+TEST(TimeTest, DeadlineWaitsForExtendedDeadline) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  auto t = []() -> faio::task<long long> {
+    const auto start = std::chrono::steady_clock::now();
+    auto idle = faio::time::deadline_after(std::chrono::milliseconds(20));
+    // 等待期间延长两次
+    faio::spawn([](faio::time::Deadline& idle) -> faio::task<void> {
+      for (int i = 0; i < 2; ++i) {
+        co_await faio::time::sleep(std::chrono::milliseconds(10));
+        idle.reset_after(std::chrono::milliseconds(20));
+      }
+    }(idle));
+    co_await idle;
+    const auto end = std::chrono::steady_clock::now();
+    co_return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+  };
+
+  const auto elapsed_ms = faio::block_on(ctx, t());
+  EXPECT_GE(elapsed_ms, 38);
+}
+
+TEST(TimeTest, DeadlineResetFromAnotherThreadTakesEffect) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  // 不在运行时中的线程调用 reset，改期请求投递给等待方所在的 worker
+  auto wait = [](std::chrono::milliseconds initial, std::chrono::milliseconds reset_to)
+      -> faio::task<long long> {
+    const auto start = std::chrono::steady_clock::now();
+    auto idle = faio::time::deadline_after(initial);
+    std::thread resetter{[&idle, reset_to] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      idle.reset_after(reset_to);
+    }};
+    auto res = co_await idle;
+    const auto end = std::chrono::steady_clock::now();
+    resetter.join();
+    if (!res) {
+      co_return -1;
+    }
+    co_return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+  };
+
+  // 提前：唤醒休眠的 worker，不等原来的 10 秒
+  const auto earlier = faio::block_on(
+      ctx, wait(std::chrono::milliseconds(10000), std::chrono::milliseconds(20)));
+  EXPECT_GE(earlier, 25);
+  EXPECT_LT(earlier, 2000);
+  // 推迟：原来的到期时间到达时重新挂入
+  const auto later = faio::block_on(
+      ctx, wait(std::chrono::milliseconds(20), std::chrono::milliseconds(60)));
+  EXPECT_GE(later, 65);
+}
+
+TEST(TimeTest, DeadlineNodeRechecksPostponedDeadline) {
+  namespace timer_ns = faio::runtime::detail::timer;
+  timer_ns::Timer timer;
+  const auto start = std::chrono::steady_clock::now();
+  auto at = [&](long long ms) { return start + std::chrono::milliseconds(ms); };
+
+  faio::time::Deadline idle{at(10)};
+  ASSERT_TRUE(idle.await_suspend(fake_handle(1)));
+  // 模拟其他线程上的 reset：截止时间已经写入，改期请求还没处理
+  timer_ns::current_timer = nullptr;
+  idle.reset(at(50));
+  timer_ns::current_timer = &timer;
+
+  RecordingQueue queue;
+  timer.poll_at(at(20), queue, queue);
+  EXPECT_TRUE(queue.fired.empty());
+  timer.poll_at(at(60), queue, queue);
+  EXPECT_EQ(queue.fired, std::vector<void*>{fake_handle(1).address()});
+}
+
+TEST(TimeTest, DeadlineIsCutShortByTimeout) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  auto t = []() -> faio::task<bool> {
+    auto idle = faio::time::deadline_after(std::chrono::seconds(10));
+    int error = 0;
+    const auto start = std::chrono::steady_clock::now();
+    auto res = co_await faio::time::timeout(
+        std::chrono::milliseconds(20),
+        [](faio::time::Deadline& idle, int& error) -> faio::task<void> {
+          auto waited = co_await idle;
+          error = waited ? 0 : waited.error().value();
+        }(idle, error));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    co_return !res && res.error().value() == faio::Error::TimedOut && error == ECANCELED &&
+        elapsed < std::chrono::seconds(2);
+  };
+  EXPECT_TRUE(faio::block_on(ctx, t()));
+}
+
+TEST(TimeTest, SubMillisecondSleepWithFineTick) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}
+                                .set_num_workers(1)
+                                .set_timer_tick(std::chrono::microseconds(50))
+                                .build()};
+  auto t = []() -> faio::task<long long> {
+    const auto start = std::chrono::steady_clock::now();
+    co_await faio::time::sleep(std::chrono::microseconds(300));
+    const auto end = std::chrono::steady_clock::now();
+    co_return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  };
+
+  // 不再向上取整到整毫秒
+  const auto elapsed_us = faio::block_on(ctx, t());
+  EXPECT_GE(elapsed_us, 300);
+}
+
 TEST(NetAddressTest, ParseIpv4AndPort) {
   auto addr = faio::net::address::parse("127.0.0.1", 8080);
   ASSERT_TRUE(addr.has_value());
@@ -37,3 +804,327 @@ TEST(NetAddressTest, ParseHostname) {
   ASSERT_TRUE(addr.has_value());
   EXPECT_EQ(addr->port(), 1234);
 }
+
+TEST(IoTest, TinyRingParksInsteadOfFailing) {
+  // 2 个 sqe 的 ring 上并发 256 个协程，提交队列耗尽时请求应当排队而不是失败
+  faio::runtime_context ctx{
+      faio::ConfigBuilder{}.set_num_events(2).set_num_workers(1).build()};
+  const int fd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+  ASSERT_GE(fd, 0);
+  std::atomic<int> completed{0};
+  faio::block_on(ctx, burst_writes(fd, completed));
+  ::close(fd);
+  EXPECT_EQ(completed.load(std::memory_order_relaxed), 256 * 16);
+}
+
+TEST(IoTest, UnparkRemovesWaitersAtAnyPosition) {
+  namespace io_ns = faio::io::detail;
+  faio::runtime::detail::IOMetrics metrics;
+  io_ns::IOuring uring{faio::ConfigBuilder{}.set_num_events(4).build(), metrics};
+  io_ns::io_user_data_t data[4];
+  io_ns::io_sqe_waiter_t waiters[4];
+  for (int i = 0; i < 4; ++i) {
+    io_uring_prep_nop(&waiters[i].sqe);
+    io_uring_sqe_set_data(&waiters[i].sqe, nullptr);
+    waiters[i].user_data = &data[i];
+    uring.park(&waiters[i]);
+  }
+  // 中间、尾部、头部各摘除一个，重复摘除时返回 false
+  EXPECT_TRUE(uring.unpark(&data[1]));
+  EXPECT_TRUE(uring.unpark(&data[3]));
+  EXPECT_TRUE(uring.unpark(&data[0]));
+  EXPECT_FALSE(uring.unpark(&data[1]));
+  // 摘空尾部之后重新挂入的节点接在剩下的节点后面
+  uring.park(&waiters[3]);
+  uring.drain_waiters();
+  EXPECT_EQ(io_uring_sq_ready(uring.uring()), 2u);
+  EXPECT_FALSE(uring.unpark(&data[2]));
+  EXPECT_FALSE(uring.unpark(&data[3]));
+  uring.reset_and_submit();
+}
+
+TEST(IoTest, SubmitPoliciesReportSyscalls) {
+  for (auto policy : {faio::SubmitPolicy::Tick, faio::SubmitPolicy::Interval}) {
+    faio::runtime_context ctx{faio::ConfigBuilder{}
+                                  .set_num_workers(1)
+                                  .set_submit_policy(policy)
+                                  .build()};
+    const int fd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    ASSERT_GE(fd, 0);
+    std::atomic<int> completed{0};
+    faio::block_on(ctx, burst_writes(fd, completed));
+    ::close(fd);
+    EXPECT_EQ(completed.load(std::memory_order_relaxed), 256 * 16);
+
+    auto metrics = ctx.metrics();
+    EXPECT_EQ(metrics.num_workers, 1u);
+    EXPECT_GE(metrics.submitted_sqes, 256u * 16u);
+    EXPECT_GE(metrics.completed_cqes, 256u * 16u);
+    EXPECT_GT(metrics.syscalls(), 0u);
+  }
+}
+
+TEST(IoTest, FixedBufferArenaReusesReleasedChunks) {
+  faio::io::detail::FixedBufferArena arena{8 * faio::io::detail::FIXED_BUFFER_CHUNK};
+  auto* a = arena.allocate(3);
+  auto* b = arena.allocate(3);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(arena.allocate(3), nullptr);
+  arena.deallocate(a, 3);
+  EXPECT_NE(arena.allocate(2), nullptr);
+  EXPECT_EQ(arena.allocate(3), a);
+  EXPECT_EQ(arena.allocate(1), nullptr);
+  arena.deallocate(b, 3);
+  EXPECT_EQ(arena.allocate(3), b);
+}
+
+TEST(IoTest, FixedBuffersFallBackWhenArenaIsFull) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}
+                                .set_num_workers(1)
+                                .set_fixed_buffer_size(16 * 1024)
+                                .build()};
+  const int fd = ::open("/tmp", O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+  ASSERT_GE(fd, 0);
+  EXPECT_TRUE(faio::block_on(ctx, fixed_roundtrip(fd)));
+  ::close(fd);
+}
+
+TEST(IoTest, SendFromFixedBuffer) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  const auto res = faio::block_on(ctx, fixed_send_roundtrip(fds[0], fds[1]));
+  ::close(fds[0]);
+  ::close(fds[1]);
+  if (res < 0) {
+    GTEST_SKIP() << "kernel does not support IORING_RECVSEND_FIXED_BUF for send";
+  }
+  EXPECT_EQ(res, 1);
+}
+
+TEST(IoTest, BufferChainAdvancesAcrossSegments) {
+  const std::string a = "hello";
+  const std::string b = "world";
+  faio::io::BufferChain chain{std::span<const char>(a), std::span<const char>(),
+                              std::span<const char>(b)};
+  EXPECT_EQ(chain.size(), 2u);
+  EXPECT_EQ(chain.total_bytes(), 10u);
+  chain.advance(3);
+  EXPECT_EQ(chain.size(), 2u);
+  EXPECT_EQ(chain.data()->iov_len, 2u);
+  chain.advance(4);
+  EXPECT_EQ(chain.size(), 1u);
+  EXPECT_EQ(std::string_view(static_cast<const char*>(chain.data()->iov_base), 3), "rld");
+  chain.advance(3);
+  EXPECT_TRUE(chain.empty());
+}
+
+TEST(NetTest, VectoredWriteAndReadRoundTrip) {
+  faio::runtime_context ctx;
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, vectored_roundtrip(fds[0], fds[1])));
+}
+
+TEST(IoTest, ChainRunsLinkedOperationsInOrder) {
+  faio::runtime_context ctx;
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, chained_ping(fds[0], fds[1])));
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST(IoTest, LatencyTracingRecordsPerOpcode) {
+  faio::runtime_context ctx{
+      faio::ConfigBuilder{}.set_num_workers(1).set_latency_tracing(true).build()};
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, chained_ping(fds[0], fds[1])));
+  ::close(fds[0]);
+  ::close(fds[1]);
+
+  auto metrics = ctx.metrics();
+  auto send = metrics.op_latency(IORING_OP_SEND);
+  auto recv = metrics.op_latency(IORING_OP_RECV);
+  ASSERT_NE(send, nullptr);
+  ASSERT_NE(recv, nullptr);
+  EXPECT_EQ(send->kernel.count(), 1u);
+  EXPECT_EQ(recv->kernel.count(), 1u);
+  // 链只恢复一次协程，调度延迟只记在最后完成的请求上
+  EXPECT_EQ(send->schedule.count() + recv->schedule.count(), 1u);
+  EXPECT_EQ(metrics.op_latency(IORING_OP_NOP), nullptr);
+
+  faio::LatencyHistogram histogram;
+  histogram.buckets[3] = 99;  // [4, 8)ns
+  histogram.buckets[10] = 1;  // [512, 1024)ns
+  EXPECT_EQ(histogram.percentile(0.5), std::chrono::nanoseconds(7));
+  EXPECT_EQ(histogram.percentile(1.0), std::chrono::nanoseconds(1023));
+}
+
+TEST(IoTest, LatencyTracingIsOffByDefault) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, chained_ping(fds[0], fds[1])));
+  ::close(fds[0]);
+  ::close(fds[1]);
+  EXPECT_TRUE(ctx.metrics().latency.empty());
+}
+
+TEST(IoTest, LinkTimeoutBackendTimesOut) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}
+                                .set_timeout_backend(faio::TimeoutBackend::LinkTimeout)
+                                .build()};
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_EQ(faio::block_on(ctx, recv_with_timeout(fds[0])), ETIMEDOUT);
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST(IoTest, MovedAwaitersRebindSqePointers) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, moved_awaiters_roundtrip(fds[0], fds[1])));
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST(IoTest, ExplicitCancelIsNotReportedAsTimeout) {
+  for (auto backend : {faio::TimeoutBackend::Timer, faio::TimeoutBackend::LinkTimeout}) {
+    faio::runtime_context ctx{
+        faio::ConfigBuilder{}.set_num_workers(1).set_timeout_backend(backend).build()};
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+    EXPECT_EQ(faio::block_on(ctx, cancel_before_timeout(fds[0])), ECANCELED);
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+}
+
+TEST(NetTest, CancelAllCancelsPendingReads) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, cancel_pending_reads(fds[0], fds[1])));
+  ::close(fds[1]);
+}
+
+TEST(NetTest, CancelReachesReadsSubmittedOnOtherWorker) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(2).build()};
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, cancel_reads_from_other_worker(fds[0])));
+  ::close(fds[1]);
+}
+
+TEST(NetTest, FdRingsRecordsSubmittingWorkers) {
+  using faio::io::detail::FdRings;
+  FdRings rings{4};
+  rings.record(5, 0);
+  rings.record(5, 2);
+  rings.record(5, 2);
+  EXPECT_EQ(rings.of(5), 0b101u);
+  EXPECT_EQ(rings.of(6), 0u);
+  // 关闭时取出并清零，号码复用之后从头记录
+  EXPECT_EQ(rings.take(5), 0b101u);
+  EXPECT_EQ(rings.of(5), 0u);
+  // 无法记录的 fd 和超过 64 个 worker 时视为所有 ring 都提交过
+  EXPECT_EQ(rings.of(-1), FdRings::all);
+  FdRings many{65};
+  many.record(5, 0);
+  EXPECT_EQ(many.take(5), FdRings::all);
+}
+
+TEST(TimeTest, TimeoutCancelsInFlightIoOfNestedTask) {
+  faio::runtime_context ctx;
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, timeout_cancels_nested_recv(fds[0])));
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST(TimeTest, TimeoutReturnsResultOfTaskOrAwaiter) {
+  faio::runtime_context ctx;
+  EXPECT_TRUE(faio::block_on(ctx, timeout_passes_results()));
+}
+
+TEST(TimeTest, TimeoutKeepsResultsOfTasksItDidNotCut) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_TRUE(faio::block_on(ctx, timeout_keeps_uncut_results()));
+}
+
+TEST(TimeTest, TimedIoDoesNotSuspendAfterDeadline) {
+  for (auto backend : {faio::TimeoutBackend::Timer, faio::TimeoutBackend::LinkTimeout}) {
+    faio::runtime_context ctx{
+        faio::ConfigBuilder{}.set_num_workers(1).set_timeout_backend(backend).build()};
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+    EXPECT_TRUE(faio::block_on(ctx, timed_io_after_deadline(fds[0])));
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+}
+
+TEST(TimeTest, CancelTokenTracksSeveralInFlightIos) {
+  faio::runtime_context ctx{faio::ConfigBuilder{}.set_num_workers(1).build()};
+  EXPECT_TRUE(faio::block_on(ctx, token_arms_several_ios()));
+}
+
+TEST(TimeTest, SleepLoopEndsWhenTimeoutExpires) {
+  faio::runtime_context ctx;
+  EXPECT_TRUE(faio::block_on(ctx, sleep_loop_under_timeout()));
+}
+
+TEST(TimeTest, TimeoutCancelsChainedOperations) {
+  faio::runtime_context ctx;
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, chain_under_timeout(fds[0])));
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST(NetTest, CopyBidirectionalPropagatesHalfClose) {
+  faio::runtime_context ctx;
+  int front[2];
+  int back[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, front), 0);
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, back), 0);
+  faio::expected<faio::net::CopyStats> stats{std::unexpected{faio::Error{faio::Error::ClosedChannel}}};
+  EXPECT_TRUE(faio::block_on(ctx, proxied_exchange(front[0], front[1], back[0], back[1], stats)));
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats.value().a_to_b, 300u * 1024u);
+  EXPECT_EQ(stats.value().b_to_a, 70u * 1024u);
+  ::close(front[0]);
+  ::close(back[1]);
+}
+
+TEST(NetTest, UdpBatchSendAndReceiveOnLoopback) {
+  faio::runtime_context ctx;
+  EXPECT_TRUE(faio::block_on(ctx, udp_batch_roundtrip()));
+}
+
+TEST(NetTest, UdpRecvStreamRearmsAndReportsTruncation) {
+  faio::runtime_context ctx;
+  EXPECT_TRUE(faio::block_on(ctx, udp_recv_stream_roundtrip()));
+}
+
+TEST(IoTest, EpollBackendRunsSocketIoChainsAndTimeouts) {
+  // 强制使用 epoll 后端，awaiter 不变
+  faio::runtime_context ctx{faio::ConfigBuilder{}
+                                .set_io_backend(faio::IOBackend::Epoll)
+                                .set_timeout_backend(faio::TimeoutBackend::LinkTimeout)
+                                .build()};
+  EXPECT_TRUE(faio::block_on(ctx, tcp_loopback_roundtrip()));
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+  EXPECT_TRUE(faio::block_on(ctx, chained_ping(fds[0], fds[1])));
+  EXPECT_EQ(faio::block_on(ctx, recv_with_timeout(fds[0])), ETIMEDOUT);
+  ::close(fds[0]);
+  ::close(fds[1]);
+}